@@ -50,6 +50,25 @@ auto make_any_field(Args&&... args) {
     return AnyField(std::move(pimpl));
 }
 
+/** @brief Lets AnyFields load saved values of type @p T.
+ *
+ *  Saved values can only be loaded if their type is known to the process (see
+ *  AnyField::load). Creating an AnyField wrapping a @p T makes it known, this
+ *  function does so without creating one. Modules call it for the types of
+ *  their inputs and results, so that cached values can be loaded before any
+ *  value of that type has been created. Types which can't be serialized are
+ *  ignored.
+ *
+ *  @tparam T The type to register. Cv-qualifiers and references are ignored.
+ *
+ *  @throw std::bad_alloc if there is a problem registering the type. Strong
+ *                        throw guarantee.
+ */
+template<typename T>
+void register_any_field_type() {
+    detail_::AnyFieldWrapper<std::decay_t<T>>::register_type();
+}
+
 /** @brief Returns the object wrapped in an AnyField.
  *
  *  @tparam T The qualified type (i.e. including cv-qualifiers and references)
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "detail_/any_field_base.hpp"
+#include <string>
 
 namespace pluginplay::any {
 
@@ -35,6 +36,10 @@ namespace pluginplay::any {
  *  Optionally the type may:
  *
  *  - overload std::ostream::operator<< for printing the value.
+ *  - be hashable (see pluginplay_hash.hpp), which lets the cache find equal
+ *    values quickly.
+ *  - be serializable with Cereal and default constructible, which lets the
+ *    cache save the value to disk.
  *
  *  AnyField defines default implementations for any optional properties the
  *  type does not satisfy.
@@ -47,6 +52,9 @@ public:
     /// Type used for runtime type information (RTTI) purposes
     using rtti_type = typename pimpl_type::rtti_type;
 
+    /// Type of a hash of the wrapped value
+    using content_hash_type = typename pimpl_type::content_hash_type;
+
     /// Type of the smart pointer holding a PIMPL, typedef of unique_ptr
     using pimpl_pointer = typename pimpl_type::field_base_pointer;
 
@@ -277,17 +285,90 @@ public:
      */
     bool owns_value() const noexcept;
 
+    /** @brief Estimates the number of bytes the wrapped value occupies.
+     *
+     *  This method is used by the cache to account for the memory held by
+     *  cached values. If *this aliases its value, the returned estimate is
+     *  the size of the aliased value (i.e., the size a copy of *this would
+     *  occupy).
+     *
+     *  @return An estimate of the size of the wrapped value in bytes. If this
+     *          instance does not have a value, 0 is returned.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
+    /** @brief Hashes the wrapped value.
+     *
+     *  The hash comes from the `pluginplay_hash` customization point (see
+     *  pluginplay_hash.hpp) and is consistent with operator==, i.e., equal
+     *  values have equal hashes regardless of how they are held. Values which
+     *  can't be hashed, as well as Python objects (whose C++ type isn't known
+     *  until they are unwrapped), have no hash.
+     *
+     *  @return The hash of the wrapped value. If this instance does not have a
+     *          value, or the value can't be hashed, std::nullopt is returned.
+     *
+     *  @throw None No throw guarantee.
+     */
+    content_hash_type content_hash() const noexcept;
+
+    /** @brief Can the wrapped value be serialized?
+     *
+     *  See the class documentation for the requirements on the wrapped type.
+     *  Instances without a value are serializable.
+     *
+     *  @return True if save() will succeed and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_serializable() const noexcept;
+
+    /** @brief Serializes *this.
+     *
+     *  The name of the wrapped type is saved along with the value, so that
+     *  load() can recreate it. @p ar must be able to serialize `std::string`.
+     *
+     *  @tparam Archive The type of the Cereal archive.
+     *
+     *  @param[in,out] ar The archive to save *this to.
+     *
+     *  @throw std::runtime_error if the wrapped value can't be serialized.
+     */
     template<typename Archive>
     void save(Archive& ar) const {
-        std::runtime_error("NYI");
+        std::string tag, bytes;
+        to_bytes_(tag, bytes);
+        ar(tag, bytes);
     }
 
+    /** @brief Deserializes a value saved by save().
+     *
+     *  The loaded value is owned by *this. Loading a value requires an
+     *  AnyField of the same type to have been created (or the type to have
+     *  been set as the type of a module's input or result) in this process.
+     *
+     *  @tparam Archive The type of the Cereal archive.
+     *
+     *  @param[in,out] ar The archive to load *this from.
+     *
+     *  @throw std::runtime_error if the type of the saved value is unknown.
+     */
     template<typename Archive>
     void load(Archive& ar) {
-        std::runtime_error("NYI");
+        std::string tag, bytes;
+        ar(tag, bytes);
+        from_bytes_(tag, bytes);
     }
 
 private:
+    /// Type-independent part of save, @p tag is empty if there's no value
+    void to_bytes_(std::string& tag, std::string& bytes) const;
+
+    /// Type-independent part of load
+    void from_bytes_(const std::string& tag, const std::string& bytes);
+
     /// Allows any_cast to actually cast the AnyField
     template<typename T, typename AnyType>
     friend T any_cast(AnyType&&);
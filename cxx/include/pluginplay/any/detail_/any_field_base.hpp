@@ -16,10 +16,13 @@
 
 #pragma once
 #include <boost/any.hpp>
+#include <cstddef>
 #include <exception>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <pluginplay/python/python_wrapper.hpp>
+#include <pluginplay/utility/pluginplay_hash.hpp>
 #include <typeindex>
 
 namespace pluginplay::any::detail_ {
@@ -37,6 +40,9 @@ public:
     /// The type we use for holding Python objects
     using python_value = python::PythonWrapper;
 
+    /// Type of a hash of the wrapped value
+    using content_hash_type = pluginplay::content_hash_type;
+
     /// A read/write reference to a Python object
     using python_reference = python_value&;
 
@@ -46,6 +52,9 @@ public:
     /// The type used to store the value
     using value_type = boost::any;
 
+    /// Type of a function which recreates a value from its serialized form
+    using loader_type = field_base_pointer (*)(const std::string&);
+
     /** @brief Polymorphic copy
      *
      *  This method returns a pointer to a newly allocated AnyFieldBase instance
@@ -257,6 +266,90 @@ public:
      */
     std::ostream& print(std::ostream& os) const { return print_(os); }
 
+    /** @brief Estimates how many bytes the wrapped value occupies.
+     *
+     *  The cache needs to know how big the values it stores are in order to
+     *  decide whether it's worth storing them. This function returns an
+     *  estimate of the number of bytes the wrapped value occupies. If *this
+     *  wraps a reference, the estimate is for the referenced value (i.e., the
+     *  number of bytes a copy of *this would occupy). The estimate comes from
+     *  the `pluginplay_sizeof` customization point (see
+     *  pluginplay_sizeof.hpp).
+     *
+     *  @return An estimate of the number of bytes the wrapped value occupies.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept {
+        return memory_footprint_();
+    }
+
+    /** @brief Hashes the wrapped value.
+     *
+     *  The cache uses the hash to find equal values without comparing them to
+     *  every value it knows about. The hash comes from the `pluginplay_hash`
+     *  customization point (see pluginplay_hash.hpp). If *this wraps a
+     *  reference, the referenced value is hashed.
+     *
+     *  @return The hash of the wrapped value, or std::nullopt if it can't be
+     *          hashed.
+     *
+     *  @throw None No throw guarantee.
+     */
+    content_hash_type content_hash() const noexcept { return content_hash_(); }
+
+    /** @brief Can the wrapped value be serialized?
+     *
+     *  Values can be serialized if their type can be serialized with Cereal
+     *  and is default constructible (so it can be loaded). Python objects
+     *  can't be serialized.
+     *
+     *  @return True if serialize() will succeed and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_serializable() const noexcept { return is_serializable_(); }
+
+    /** @brief Serializes the wrapped value.
+     *
+     *  The value is written with a binary Cereal archive. The result can be
+     *  turned back into an AnyFieldBase by deserialize(), using the name of
+     *  type() as the tag.
+     *
+     *  @return The bytes of the serialized value.
+     *
+     *  @throw std::runtime_error if the value can't be serialized. Strong
+     *                            throw guarantee.
+     */
+    std::string serialize() const { return serialize_(); }
+
+    /** @brief Records how to load values of the type with tag @p tag.
+     *
+     *  AnyFieldWrapper registers a loader for each serializable type it
+     *  wraps. Registering a tag more than once keeps the first loader.
+     *
+     *  @param[in] tag The name of the type, as given by `typeid(T).name()`.
+     *  @param[in] loader The function which recreates values of that type.
+     *
+     *  @throw std::bad_alloc if there is a problem recording the loader.
+     *                        Strong throw guarantee.
+     */
+    static void register_loader(const std::string& tag, loader_type loader);
+
+    /** @brief Recreates a value serialized by serialize().
+     *
+     *  @param[in] tag The name of the type of the serialized value.
+     *  @param[in] bytes The value, as returned by serialize().
+     *
+     *  @return An AnyFieldBase wrapping (and owning) the value.
+     *
+     *  @throw std::runtime_error if no loader is registered for @p tag, or if
+     *                            the value can't be loaded. Strong throw
+     *                            guarantee.
+     */
+    static field_base_pointer deserialize(const std::string& tag,
+                                          const std::string& bytes);
+
     /** @brief Retrieves the value as an instance of type T.
      *
      *  @tparam T The exact type to retrieve the value as. @p T should include
@@ -337,6 +430,18 @@ private:
     /// To be overridden by derived class to implement type
     virtual rtti_type type_() const noexcept = 0;
 
+    /// To be overridden by derived class to implement memory_footprint
+    virtual std::size_t memory_footprint_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement content_hash
+    virtual content_hash_type content_hash_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement is_serializable
+    virtual bool is_serializable_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement serialize
+    virtual std::string serialize_() const = 0;
+
     /// To be overridden by derived class to implement as_python_wrapper
     virtual python_value as_python_wrapper_() const = 0;
 
@@ -17,6 +17,7 @@
 #pragma once
 #include "pluginplay/any/detail_/any_field_base.hpp"
 #include "pluginplay/any/detail_/any_field_wrapper_traits.hpp"
+#include <parallelzone/serialization.hpp>
 
 namespace pluginplay::any::detail_ {
 
@@ -29,7 +30,8 @@ namespace pluginplay::any::detail_ {
  *
  *  @tparam T The type of the wrapped object. Let U = std::decay_t<T>, then T
  *            can be: U, const U, or const U&. U must be copyable, comaprable
- *            via operator== and operator<, and serializable.
+ *            via operator== and operator<. If U is serializable with Cereal
+ *            and default constructible, the wrapped value can be serialized.
  */
 template<typename T>
 class AnyFieldWrapper : public AnyFieldBase {
@@ -62,6 +64,15 @@ private:
     /// Type we're actually wrapping if we need to use a reference wrapper
     using ref_wrapper_t = std::reference_wrapper<const_value_type>;
 
+    /// Can values of clean_type be saved and loaded?
+    static constexpr bool serializable_v =
+      !std::is_same_v<clean_type, python::PythonWrapper> &&
+      std::is_default_constructible_v<clean_type> &&
+      cereal::traits::is_output_serializable<
+        clean_type, cereal::BinaryOutputArchive>::value &&
+      cereal::traits::is_input_serializable<clean_type,
+                                            cereal::BinaryInputArchive>::value;
+
 public:
     /// Pointer to the base class of this hierarchy
     using typename base_type::field_base_pointer;
@@ -72,6 +83,9 @@ public:
     /// Type used to store values
     using typename base_type::value_type;
 
+    /// Type of a hash of the wrapped value
+    using typename base_type::content_hash_type;
+
     /// This is the type of the object actually in the any
     using wrapped_type = std::conditional_t<wrap_const_ref_v, ref_wrapper_t, T>;
 
@@ -107,6 +121,19 @@ public:
              typename = disable_if_any_field_wrapper_t<std::decay_t<U>>>
     AnyFieldWrapper(U&& value2wrap);
 
+    /** @brief Makes values of type @p T loadable.
+     *
+     *  Serialized values are loaded by the loader registered for their type
+     *  (see AnyFieldBase::deserialize). Every AnyFieldWrapper registers its
+     *  type when it is constructed; this function lets the type be registered
+     *  before any value of it exists (e.g., when a module declares it). It
+     *  does nothing if @p T can't be serialized.
+     *
+     *  @throw std::bad_alloc if there is a problem registering the type.
+     *                        Strong throw guarantee.
+     */
+    static void register_type();
+
 protected:
     /// Implements polymorphic clone
     field_base_pointer clone_() const override;
@@ -136,6 +163,21 @@ private:
     /// Implements type() for both AnyResultWrapper and AnyInputWrapper
     rtti_type type_() const noexcept override { return {typeid(T)}; }
 
+    /// Implements memory_footprint()
+    std::size_t memory_footprint_() const noexcept override;
+
+    /// Implements content_hash()
+    content_hash_type content_hash_() const noexcept override;
+
+    /// Implements is_serializable()
+    bool is_serializable_() const noexcept override { return serializable_v; }
+
+    /// Implements serialize()
+    std::string serialize_() const override;
+
+    /// The loader registered by register_type
+    static field_base_pointer load_(const std::string& bytes);
+
     /// Implements as_python_wrapper()
     python_value as_python_wrapper_() const override;
 
@@ -16,6 +16,9 @@
 
 #include <iostream>
 #include <pluginplay/python/python_wrapper.hpp>
+#include <pluginplay/utility/pluginplay_sizeof.hpp>
+#include <sstream>
+#include <stdexcept>
 #include <utilities/printing/print_stl.hpp>
 
 namespace pluginplay::any::detail_ {
@@ -25,7 +28,21 @@ namespace pluginplay::any::detail_ {
 
 TEMPLATE_PARAMS template<typename U, typename>
 ANY_FIELD_WRAPPER::AnyFieldWrapper(U&& value2wrap) :
-  base_type(wrap_value_(std::forward<U>(value2wrap))) {}
+  base_type(wrap_value_(std::forward<U>(value2wrap))) {
+    register_type();
+}
+
+TEMPLATE_PARAMS
+void ANY_FIELD_WRAPPER::register_type() {
+    if constexpr(serializable_v) {
+        // Only the first call registers the loader
+        static const bool registered = [] {
+            base_type::register_loader(typeid(clean_type).name(), &load_);
+            return true;
+        }();
+        (void)registered;
+    }
+}
 
 TEMPLATE_PARAMS
 typename ANY_FIELD_WRAPPER::field_base_pointer ANY_FIELD_WRAPPER::clone_()
@@ -88,6 +105,62 @@ typename ANY_FIELD_WRAPPER::python_value ANY_FIELD_WRAPPER::as_python_wrapper_()
     return python::make_python_wrapper(my_value);
 }
 
+TEMPLATE_PARAMS
+std::size_t ANY_FIELD_WRAPPER::memory_footprint_() const noexcept {
+    if constexpr(std::is_same_v<clean_type, python_value>) {
+        return sizeof(clean_type);
+    } else {
+        const auto& value = base_type::template cast<const_ref_type>();
+        return pluginplay::memory_footprint(value);
+    }
+}
+
+TEMPLATE_PARAMS
+typename ANY_FIELD_WRAPPER::content_hash_type ANY_FIELD_WRAPPER::content_hash_()
+  const noexcept {
+    // The C++ type of a Python object isn't known, so it can't be hashed
+    // consistently with equal C++ objects
+    if constexpr(std::is_same_v<clean_type, python_value>) {
+        return std::nullopt;
+    } else {
+        const auto& value = base_type::template cast<const_ref_type>();
+        return pluginplay::content_hash(value);
+    }
+}
+
+TEMPLATE_PARAMS
+std::string ANY_FIELD_WRAPPER::serialize_() const {
+    if constexpr(serializable_v) {
+        std::ostringstream os;
+        {
+            cereal::BinaryOutputArchive ar(os);
+            ar(base_type::template cast<const_ref_type>());
+        }
+        return os.str();
+    } else {
+        std::string msg = "Values of type ";
+        msg += typeid(T).name();
+        msg += " can't be serialized.";
+        throw std::runtime_error(msg);
+    }
+}
+
+TEMPLATE_PARAMS
+typename ANY_FIELD_WRAPPER::field_base_pointer ANY_FIELD_WRAPPER::load_(
+  const std::string& bytes) {
+    if constexpr(serializable_v) {
+        clean_type value;
+        std::istringstream is(bytes);
+        {
+            cereal::BinaryInputArchive ar(is);
+            ar(value);
+        }
+        return std::make_unique<AnyFieldWrapper<clean_type>>(std::move(value));
+    } else {
+        return nullptr; // Never registered
+    }
+}
+
 TEMPLATE_PARAMS
 bool ANY_FIELD_WRAPPER::storing_const_ref_() const noexcept {
     return wrap_const_ref_v;
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <limits>
+
+namespace pluginplay::cache {
+
+/// Where, if anywhere, a freshly computed result should be cached
+enum class Admission {
+    /// The result is not cached
+    skip,
+    /// The result is cached in memory, but never saved to disk
+    memory_only,
+    /// The result is cached and saved to disk (if the cache saves to disk)
+    persistent
+};
+
+/** @brief Decides where newly computed results should be cached.
+ *
+ *  Caching a result is only worthwhile if the time it saves justifies the
+ *  space it occupies. AdmissionPolicy measures the worth of a result by its
+ *  "value density", i.e., the time it took to compute the result divided by
+ *  the size of the result (in seconds per byte). Results whose value density
+ *  is at least `persistent_threshold` are admitted to persistent storage,
+ *  results whose value density is at least `memory_threshold` (but less than
+ *  `persistent_threshold`) are only kept in memory, and all other results are
+ *  not cached.
+ *
+ *  For reference, a threshold of 1.0E-9 requires a result to take at least 1
+ *  ns per byte (i.e., 1 ms per MB) to compute.
+ *
+ *  The default policy admits every result to persistent storage.
+ */
+struct AdmissionPolicy {
+    /// Minimum value density (in s/byte) for a result to be cached at all
+    double memory_threshold = 0.0;
+
+    /// Minimum value density (in s/byte) for a result to be saved to disk
+    double persistent_threshold = 0.0;
+
+    /** @brief Does this policy admit every result to persistent storage?
+     *
+     *  Callers can use this to skip measuring the size of results.
+     *
+     *  @return True if every result will be admitted to persistent storage
+     *          and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool admits_everything() const noexcept {
+        return persistent_threshold <= 0.0;
+    }
+
+    /** @brief Decides where to cache a result.
+     *
+     *  @param[in] compute_time How long (in seconds) it took to compute the
+     *                          result.
+     *  @param[in] bytes The (estimated) size of the result in bytes.
+     *
+     *  @return Where the result should be cached.
+     *
+     *  @throw None No throw guarantee.
+     */
+    Admission operator()(double compute_time,
+                         std::size_t bytes) const noexcept {
+        const double density = bytes ? compute_time / bytes :
+                                       std::numeric_limits<double>::infinity();
+        if(density >= persistent_threshold) return Admission::persistent;
+        if(density >= memory_threshold) return Admission::memory_only;
+        return Admission::skip;
+    }
+};
+
+} // namespace pluginplay::cache
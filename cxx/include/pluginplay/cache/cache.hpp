@@ -15,6 +15,11 @@
  */
 
 #pragma once
+#include <pluginplay/cache/admission_policy.hpp>
+#include <pluginplay/cache/cache_stats.hpp>
+#include <pluginplay/cache/compression_policy.hpp>
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
+#include <pluginplay/cache/rocksdb_options.hpp>
 #include <pluginplay/cache/user_cache.hpp>
+#include <pluginplay/cache/write_behind_policy.hpp>
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace pluginplay::cache {
+
+/** @brief A snapshot of a cache's usage statistics.
+ *
+ *  ModuleCache and ModuleManagerCache instances keep track of how they are
+ *  being used. Calling `stats()` on either returns an instance of this class
+ *  which holds the values of the counters at the time of the call. The
+ *  counters are meant to help users determine whether memoization is actually
+ *  helping a particular module.
+ *
+ *  N.B. The "key" time is the time spent determining whether a set of inputs
+ *       is in the cache. This includes converting the inputs into the key
+ *       actually used by the database backend (which is usually the dominant
+ *       cost). Similarly the "deserialize" time is the time spent retrieving
+ *       cached results, which includes any conversion from the stored
+ *       representation back into a result map.
+ *
+ *  N.B. Objects saved to disk are content-addressed, i.e., identical inputs
+ *       and results are only saved once. The "deduplicated" counters track
+ *       how often a result reused an object which was already saved (inputs
+ *       are reused whenever a module is called with them again, so their
+ *       reuse isn't counted). They are shared by all of a
+ *       ModuleManagerCache's module caches and are thus only filled in by
+ *       ModuleManagerCache. The same goes for the "interned" counters, which
+ *       track how many inputs were made to share an instance of an equal
+ *       value the cache had already seen (i.e., were hash-consed).
+ *
+ *  N.B. The "resident" counters track what is currently in memory, i.e.,
+ *       they go down when results are overwritten, demoted, evicted (see
+ *       QuotaPolicy), or expire. Evictions to respect a quota or a memory
+ *       budget are counted as evictions. The "entries" and "bytes_in_memory"
+ *       counters are the same values, they are kept for backwards
+ *       compatibility.
+ *
+ *  N.B. Each hit is attributed to the tier (see TierPolicy) which served it.
+ *       A hit is attributed to L3 if retrieving the result required loading
+ *       it from disk, to L1 if it was found in the calling thread's L1, and
+ *       to L2 otherwise.
+ */
+struct CacheStats {
+    /// Type used for the counters
+    using counter_type = std::uint64_t;
+
+    /// Number of lookups which found a cached result
+    counter_type hits = 0;
+
+    /// Number of lookups which did not find a cached result
+    counter_type misses = 0;
+
+    /// Number of hits served by the calling thread's L1
+    counter_type l1_hits = 0;
+
+    /// Number of hits served by the in-memory database (L2)
+    counter_type l2_hits = 0;
+
+    /// Number of hits served by the on-disk database (L3)
+    counter_type l3_hits = 0;
+
+    /// Number of results loaded from disk into memory
+    counter_type promotions = 0;
+
+    /// Number of results removed from memory to respect the L2 capacity
+    counter_type demotions = 0;
+
+    /// Number of results in L2 which went cold (see TierPolicy)
+    counter_type compressions = 0;
+
+    /// Number of cold results which were inflated to be retrieved
+    counter_type decompressions = 0;
+
+    /// Do results in L2 go cold, i.e., does the TierPolicy ask for it and can
+    /// the cache compress results (which requires zlib)?
+    bool cooling = false;
+
+    /// Number of stale results removed from memory (see ModuleManagerCache)
+    counter_type expirations = 0;
+
+    /// Number of results currently in memory
+    counter_type resident_entries = 0;
+
+    /// Approximate number of bytes the results currently in memory use
+    counter_type resident_bytes = 0;
+
+    /// Number of key/value pairs added to the cache
+    counter_type insertions = 0;
+
+    /// Number of key/value pairs removed from the cache
+    counter_type evictions = 0;
+
+    /// Number of key/value pairs in memory (same as resident_entries)
+    counter_type entries = 0;
+
+    /// Number of results the admission policy kept out of the cache
+    counter_type rejections = 0;
+
+    /// Approximate number of bytes the results in memory use (resident_bytes)
+    counter_type bytes_in_memory = 0;
+
+    /// Number of bytes the cache occupies on disk (if it's saved to disk)
+    counter_type bytes_on_disk = 0;
+
+    /// Number of times an already saved object was reused instead of saved
+    counter_type deduplicated = 0;
+
+    /// Approximate number of bytes not saved to disk thanks to reuse
+    counter_type bytes_deduplicated = 0;
+
+    /// Number of inputs which were made to share an instance of their value
+    counter_type interned = 0;
+
+    /// Approximate number of bytes freed by sharing instances of inputs
+    counter_type bytes_interned = 0;
+
+    /// Total time, in nanoseconds, spent looking up keys
+    counter_type key_time_ns = 0;
+
+    /// Total time, in nanoseconds, spent retrieving cached results
+    counter_type deserialize_time_ns = 0;
+
+    /** @brief The fraction of lookups which were hits.
+     *
+     *  @return The number of hits divided by the total number of lookups. If
+     *          there have been no lookups the result is 0.0.
+     *
+     *  @throw None No throw guarantee.
+     */
+    double hit_rate() const noexcept {
+        const auto total = hits + misses;
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    /** @brief The fraction of lookups which were served by a given tier.
+     *
+     *  @param[in] tier Which tier: 1, 2, or 3.
+     *
+     *  @return The number of hits served by @p tier divided by the total
+     *          number of lookups. If there have been no lookups, or @p tier
+     *          is not 1, 2, or 3, the result is 0.0.
+     *
+     *  @throw None No throw guarantee.
+     */
+    double tier_hit_rate(std::size_t tier) const noexcept {
+        const auto total = hits + misses;
+        if(!total) return 0.0;
+        switch(tier) {
+            case 1: return static_cast<double>(l1_hits) / total;
+            case 2: return static_cast<double>(l2_hits) / total;
+            case 3: return static_cast<double>(l3_hits) / total;
+            default: return 0.0;
+        }
+    }
+
+    /** @brief Adds the counters in @p other to this instance's counters.
+     *
+     *  This is used to aggregate the statistics of several caches. The
+     *  aggregate is cooling if any of the caches is.
+     *
+     *  @param[in] other The statistics to add to this instance.
+     *
+     *  @return The current instance after adding @p other to it.
+     *
+     *  @throw None No throw guarantee.
+     */
+    CacheStats& operator+=(const CacheStats& other) noexcept {
+        hits += other.hits;
+        misses += other.misses;
+        l1_hits += other.l1_hits;
+        l2_hits += other.l2_hits;
+        l3_hits += other.l3_hits;
+        promotions += other.promotions;
+        demotions += other.demotions;
+        compressions += other.compressions;
+        decompressions += other.decompressions;
+        cooling = cooling || other.cooling;
+        expirations += other.expirations;
+        resident_entries += other.resident_entries;
+        resident_bytes += other.resident_bytes;
+        insertions += other.insertions;
+        evictions += other.evictions;
+        entries += other.entries;
+        rejections += other.rejections;
+        bytes_in_memory += other.bytes_in_memory;
+        bytes_on_disk += other.bytes_on_disk;
+        deduplicated += other.deduplicated;
+        bytes_deduplicated += other.bytes_deduplicated;
+        interned += other.interned;
+        bytes_interned += other.bytes_interned;
+        key_time_ns += other.key_time_ns;
+        deserialize_time_ns += other.deserialize_time_ns;
+        return *this;
+    }
+};
+
+} // namespace pluginplay::cache
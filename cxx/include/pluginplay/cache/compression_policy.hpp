@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace pluginplay::cache {
+
+/** @brief The algorithms which can be used to compress cached values.
+ *
+ *  Both compressing codecs are zlib, they only differ in the compression
+ *  level they use. `fast` is thus not as fast as a dedicated fast codec (e.g.,
+ *  LZ4) and `best` does not reach the ratio of a dedicated high-ratio codec
+ *  (e.g., zstd or xz). Values record the codec they were compressed with, so
+ *  codecs may be added without invalidating existing caches.
+ */
+enum class Codec : std::uint8_t {
+    /// The value is stored as is
+    none = 0,
+    /// zlib at level 1, favors speed over size
+    fast = 1,
+    /// zlib at level 9, favors size over speed
+    best = 2
+};
+
+/** @brief Decides how values are compressed before being saved to disk.
+ *
+ *  Compressing small values rarely saves much space, but always costs time.
+ *  CompressionPolicy thus picks the codec for each value based on the value's
+ *  (serialized) size: values smaller than `min_size` bytes are not compressed,
+ *  values of at least `large_size` bytes are compressed with `large_codec`,
+ *  and all other values are compressed with `codec`. Regardless of the codec
+ *  picked, values which do not get smaller when compressed are stored as is.
+ *
+ *  The default policy does not compress anything. Compression requires
+ *  PluginPlay to have been built with zlib (the default, see BUILD_ZLIB), which
+ *  is the only codec available.
+ */
+struct CompressionPolicy {
+    /// Codec used for values of at least `min_size` bytes
+    Codec codec = Codec::none;
+
+    /// Values smaller than this (in bytes) are not compressed
+    std::size_t min_size = 1024;
+
+    /// Codec used for values of at least `large_size` bytes
+    Codec large_codec = Codec::best;
+
+    /// Values of at least this size (in bytes) are compressed with large_codec
+    std::size_t large_size = std::numeric_limits<std::size_t>::max();
+
+    /** @brief Does this policy compress anything?
+     *
+     *  @return True if at least some values are compressed and false
+     *          otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool enabled() const noexcept {
+        constexpr auto never = std::numeric_limits<std::size_t>::max();
+        if(codec != Codec::none) return true;
+        return large_codec != Codec::none && large_size != never;
+    }
+
+    /** @brief Picks the codec for a value.
+     *
+     *  @param[in] bytes The size of the value in bytes.
+     *
+     *  @return The codec to compress the value with.
+     *
+     *  @throw None No throw guarantee.
+     */
+    Codec operator()(std::size_t bytes) const noexcept {
+        if(bytes >= large_size) return large_codec;
+        if(bytes >= min_size) return codec;
+        return Codec::none;
+    }
+};
+
+} // namespace pluginplay::cache
@@ -15,8 +15,14 @@
  */
 
 #pragma once
+#include <chrono>
 #include <memory>
+#include <pluginplay/cache/admission_policy.hpp>
+#include <pluginplay/cache/cache_stats.hpp>
+#include <pluginplay/cache/compression_policy.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
+#include <pluginplay/cache/quota_policy.hpp>
+#include <pluginplay/cache/tier_policy.hpp>
 #include <pluginplay/fields/fields.hpp>
 #include <pluginplay/types.hpp>
 
@@ -33,6 +39,8 @@ struct ModuleCachePIMPL;
  *  are where calls to the module get memoized to. Instances of ModuleCache
  *  behave like a map from input maps to result maps.
  *
+ *  The member functions which look up, add, or remove results can be called
+ *  by several threads at once (see ModuleManagerCache for details).
  */
 class ModuleCache {
 public:
@@ -140,6 +148,152 @@ public:
      */
     void cache(key_type key, mapped_type value);
 
+    /** @brief Stores the provided key/value pair where @p admission says to.
+     *
+     *  This overload is used in conjunction with `admit`. If @p admission is
+     *  Admission::skip this is a no-op. If it is Admission::memory_only the
+     *  key/value pair will be cached, but never saved to disk. Otherwise this
+     *  overload behaves like the two argument overload. Key/value pairs which
+     *  could not be read back from disk, i.e., which have an input or result
+     *  that can't be serialized, are always cached as if @p admission were
+     *  Admission::memory_only. Results previously cached under @p key are
+     *  replaced, regardless of the admission they were cached with.
+     *
+     *  @param[in] key The inputs which generated @p value.
+     *  @param[in] value The results generated by running the module with the
+     *                   inputs in @p key.
+     *  @param[in] admission Where to cache the key/value pair.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     *  @throw ??? If the backend throws. Strong throw guarantee.
+     */
+    void cache(key_type key, mapped_type value, Admission admission);
+
+    /** @brief Decides where a freshly computed result should be cached.
+     *
+     *  This method applies the cache's admission policy to @p value. The size
+     *  of @p value is estimated with pluginplay::memory_footprint, which is
+     *  only called if the policy does not admit every result. Rejected
+     *  results are counted in stats().
+     *
+     *  @param[in] value The results the module computed.
+     *  @param[in] compute_time How long (in seconds) the module took to
+     *                          compute @p value.
+     *
+     *  @return Where @p value should be cached. If this instance does not
+     *          have a PIMPL, Admission::skip is returned.
+     *
+     *  @throw None No throw guarantee.
+     */
+    Admission admit(const mapped_type& value,
+                    double compute_time) const noexcept;
+
+    /** @brief Changes the policy used to decide where results are cached.
+     *
+     *  @param[in] policy The new admission policy.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    void set_admission_policy(AdmissionPolicy policy);
+
+    /** @brief Returns the policy used to decide where results are cached.
+     *
+     *  @return A copy of the current admission policy.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    AdmissionPolicy admission_policy() const;
+
+    /** @brief Changes how this module's results are compressed on disk.
+     *
+     *  By default results are compressed according to the policy of the
+     *  ModuleManagerCache which made this instance. This method overrides that
+     *  policy for results of this module which are saved after this call.
+     *  Since identical objects are only saved once, an object which another
+     *  module already saved is not compressed again. This method has no effect
+     *  if the cache does not save to disk.
+     *
+     *  @param[in] policy How to compress this module's results.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL or
+     *                            if @p policy compresses values and
+     *                            PluginPlay was not built with zlib. Strong
+     *                            throw guarantee.
+     */
+    void set_compression_policy(CompressionPolicy policy);
+
+    /** @brief Changes how this module's results are spread over the tiers.
+     *
+     *  See TierPolicy for a description of the tiers. Changing the policy
+     *  empties every thread's L1. If the new L2 capacity is smaller than the
+     *  number of results in memory, results are demoted the next time a
+     *  result is added to memory.
+     *
+     *  @param[in] policy The new tier policy.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    void set_tier_policy(TierPolicy policy);
+
+    /** @brief Returns how this module's results are spread over the tiers.
+     *
+     *  @return A copy of the current tier policy.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    TierPolicy tier_policy() const;
+
+    /** @brief Sets how long this module's results stay valid.
+     *
+     *  Results cached more than @p ttl ago are stale. Stale results are
+     *  treated as if they were not in the cache, and are removed from memory
+     *  a few at a time as the cache is used. Results loaded from disk are
+     *  taken to be as old as the cache. Since L1 does not know how old its
+     *  results are, L1 is not used while @p ttl is nonzero.
+     *
+     *  @param[in] ttl How long results stay valid. 0 (the default) means
+     *                 forever.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    void set_time_to_live(std::chrono::milliseconds ttl);
+
+    /** @brief Returns how long this module's results stay valid.
+     *
+     *  @return The time to live, 0 means forever.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    std::chrono::milliseconds time_to_live() const;
+
+    /** @brief Changes how much memory this module's results may use.
+     *
+     *  See QuotaPolicy for details. The new quotas are enforced the next time
+     *  a result is added to memory.
+     *
+     *  @param[in] policy The new quotas and priority.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    void set_quota_policy(QuotaPolicy policy);
+
+    /** @brief Returns how much memory this module's results may use.
+     *
+     *  @return A copy of the current quota policy.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     */
+    QuotaPolicy quota_policy() const;
+
     /** @brief Retrieves previously cached results.
      *
      *  This method is used to retrieve the results which were generated with
@@ -166,11 +320,64 @@ public:
      *  make no attempt to save the results to long-term storage.
      *
      *  N.B. This is a no-op if this instance does not contain a PIMPL.
+     *  N.B. If the cache is backed by long-term storage, results which were
+     *       saved are not deleted from the long-term storage and may be
+     *       loaded again by subsequent lookups.
      *
      *  @throw ??? Throws if the backend throws.
      */
     void clear();
 
+    /** @brief Saves the cached results to long-term storage.
+     *
+     *  Results which the admission policy admitted to persistent storage are
+     *  written to the cache's long-term storage (if it has any). Results
+     *  remain in memory. Results which were loaded from long-term storage, and
+     *  have not changed since, are not rewritten.
+     *
+     *  N.B. This is a no-op if this instance does not contain a PIMPL.
+     *
+     *  @throw ??? Throws if the backend throws. Same throw guarantee.
+     */
+    void backup();
+
+    /** @brief Returns the usage statistics of this cache.
+     *
+     *  Each call to count is recorded as a hit or a miss (and the time it took
+     *  is recorded as key time), each call to cache is recorded as an
+     *  insertion, each call to uncache has its time recorded as deserialize
+     *  time, and clear records all entries in memory as evicted. Hits are also
+     *  broken down by the tier which served them (see CacheStats). The number
+     *  and size of the results currently in memory are reported as entries
+     *  and bytes_in_memory respectively. The counters are
+     *  lock-free and can be read while other threads are using the cache.
+     *
+     *  N.B. Module caches share their on-disk storage so the returned object
+     *       does not report bytes on disk. See ModuleManagerCache::stats.
+     *
+     *  @return A snapshot of the counters. If this instance has no PIMPL all
+     *          counters will be zero.
+     *
+     *  @throw None No throw guarantee.
+     */
+    CacheStats stats() const noexcept;
+
+    /** @brief Estimates how many bytes the cached results occupy in memory.
+     *
+     *  The size of each result is estimated with pluginplay::memory_footprint
+     *  (and hence the pluginplay_sizeof customization point) when it enters
+     *  memory and is subtracted when it leaves it (i.e., when it's
+     *  overwritten, demoted, evicted, or expires). Cold results count their
+     *  compressed size. This is the same value stats() reports as
+     *  bytes_in_memory.
+     *
+     *  @return The estimated number of bytes. If this instance has no PIMPL
+     *          the result is 0.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
 private:
     /// Type of a modifiable PIMPL
     using pimpl_reference = pimpl_type&;
@@ -15,8 +15,19 @@
  */
 
 #pragma once
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
+#include <pluginplay/cache/cache_stats.hpp>
+#include <pluginplay/cache/compression_policy.hpp>
+#include <pluginplay/cache/quota_policy.hpp>
+#include <pluginplay/cache/rocksdb_options.hpp>
+#include <pluginplay/cache/tier_policy.hpp>
+#include <pluginplay/cache/write_behind_policy.hpp>
 #include <string>
+#include <vector>
 
 namespace pluginplay::cache {
 namespace detail_ {
@@ -48,10 +59,16 @@ class UserCache;
  *    same cache (for example by providing a path on a parallel filesystem), or
  *    if there multiple caches (for example by providing paths that are only
  *    visible to a proper subset of processes).
- *  - in most cases functions are not thread-safe. For memoization this may lead
- *    to cache-misses on account of data races (e.g., thread 1 is computing, but
- *    hasn't cached a result that thread 2 is looking for. The result is thread
- *    2 will duplicate the effort, but otherwise there's no harm done).
+ *  - the module (and user) caches made by an instance can be used by several
+ *    threads at once. Since they share their storage (and memory budget),
+ *    they share a single lock, which is held while a cache's in-memory or
+ *    on-disk tier is accessed. Only hits in the calling thread's L1 (see
+ *    TierPolicy) avoid the lock. This may still lead to cache-misses on
+ *    account of races (e.g., thread 1 is computing, but hasn't cached a
+ *    result that thread 2 is looking for. The result is thread 2 will
+ *    duplicate the effort, but otherwise there's no harm done).
+ *  - the other member functions are not meant to be called concurrently with
+ *    each other.
  */
 class ModuleManagerCache {
 public:
@@ -99,10 +116,28 @@ public:
      */
     explicit ModuleManagerCache(path_type disk_location);
 
-    /** @brief Default dtor.
+    /** @brief Creates a new instance which saves to disk in the background.
      *
-     *  This desctructor simply cleans up the memory. In particular it does not
-     *  force a save or anything like that.
+     *  This ctor works like the ctor which only takes a path, except that the
+     *  writes to disk are performed according to @p policy (see
+     *  WriteBehindPolicy). If @p policy is enabled, results are handed to the
+     *  disk as soon as they are cached and written on a background thread, so
+     *  running a module does not wait on the disk.
+     *
+     *  @param[in] disk_location The (ideally full) path to the directory where
+     *                           cached results will be saved.
+     *  @param[in] policy How to write to the disk.
+     *
+     *  @throw std::system_error if the background threads can not be started.
+     */
+    ModuleManagerCache(path_type disk_location, WriteBehindPolicy policy);
+
+    /** @brief Saves the cache and releases its memory.
+     *
+     *  If this instance saves to disk, the destructor calls backup so that
+     *  the results are available the next time a ModuleManagerCache is
+     *  created with the same disk location. Errors which occur while saving
+     *  are ignored.
      *
      *  @throw None No throw guarantee.
      */
@@ -122,6 +157,326 @@ public:
      */
     void change_save_location(path_type disk_location);
 
+    /** @brief Uses a cache saved by another run, without modifying it.
+     *
+     *  Persistent backends only let one process open a cache for writing at a
+     *  time. This method instead opens the cache saved at @p shared_location
+     *  read-only, which any number of processes can do at once. This lets,
+     *  e.g., the processes of an array job all take hits from one pre-warmed
+     *  cache. Results computed by this process are saved to a writable
+     *  overlay, private to this process, which is consulted before the shared
+     *  cache.
+     *
+     *  Like change_save_location, this only affects caches made after the
+     *  call. No process should write to @p shared_location while it's open
+     *  read-only.
+     *
+     *  @param[in] shared_location Where the cache was saved to, e.g., by a
+     *                             ModuleManagerCache constructed with the same
+     *                             path. Must already exist.
+     *  @param[in] overlay_location Where this process's results should be
+     *                              saved. Should differ for each process. If
+     *                              empty (the default), the results only live
+     *                              in memory.
+     *
+     *  @throw std::runtime_error if @p shared_location does not hold a saved
+     *                            cache (or can't be opened). Weak throw
+     *                            guarantee.
+     */
+    void open_read_only(path_type shared_location,
+                        path_type overlay_location = "");
+
+    /** @brief Saves the contents of the cache to disk.
+     *
+     *  Cached results live in memory and are only written to disk when they
+     *  are backed up. This method backs up every module and user cache made
+     *  by this instance, along with the databases they share. Results saved
+     *  by one run are loaded, on demand, by subsequent runs which use the
+     *  same disk location. This is a no-op for caches which do not save to
+     *  disk. If the disk is written to in the background, this method waits
+     *  for the writes to finish (i.e., it also calls flush).
+     *
+     *  @throw ??? If the backends throw. Same throw guarantee.
+     */
+    void backup();
+
+    /** @brief Sets how disk locations set from now on are written to.
+     *
+     *  Like change_save_location, this only affects caches created after the
+     *  next call to change_save_location. Hence, it's usually easier to use
+     *  the ctor which takes a WriteBehindPolicy.
+     *
+     *  @param[in] policy How to write to the disk.
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and allocating one
+     *                        fails. Strong throw guarantee.
+     */
+    void set_write_behind_policy(WriteBehindPolicy policy);
+
+    /** @brief Sets how values saved to disk locations set from now on are
+     *         compressed.
+     *
+     *  Like set_write_behind_policy, this only affects the disk location set
+     *  by the next call to change_save_location. Individual module caches
+     *  can override the policy for their results (see
+     *  ModuleCache::set_compression_policy). Values which were compressed
+     *  with a different policy (e.g., by a previous run) can still be read.
+     *
+     *  @param[in] policy How to compress the values.
+     *
+     *  @throw std::runtime_error if @p policy compresses values and
+     *                            PluginPlay was not built with zlib. Strong
+     *                            throw guarantee.
+     */
+    void set_compression_policy(CompressionPolicy policy);
+
+    /** @brief Sets how RocksDB stores results in disk locations set from now
+     *         on.
+     *
+     *  When PluginPlay is built with RocksDB, each module's results are saved
+     *  in their own column family, whose I/O can be tuned (see
+     *  RocksDBOptions). @p options applies to every module which wasn't given
+     *  its own options. Like set_compression_policy, this only affects the
+     *  disk location set by the next call to change_save_location (or
+     *  open_read_only). This is a no-op if PluginPlay was built without
+     *  RocksDB.
+     *
+     *  @param[in] options The RocksDB options to use.
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and allocating one
+     *                        fails. Strong throw guarantee.
+     */
+    void set_rocksdb_options(RocksDBOptions options);
+
+    /** @brief Sets how RocksDB stores the results of the module @p key in
+     *         disk locations set from now on.
+     *
+     *  This overload works like set_rocksdb_options(RocksDBOptions), except
+     *  that @p options only applies to the module cache for @p key. Typically
+     *  it's used to tune the modules which save the most data.
+     *
+     *  @param[in] key The module whose results @p options applies to.
+     *  @param[in] options The RocksDB options of the module.
+     *
+     *  @throw std::bad_alloc if there is a problem storing @p options. Strong
+     *                        throw guarantee.
+     */
+    void set_rocksdb_options(module_cache_key key, RocksDBOptions options);
+
+    /** @brief Deletes everything cached for the module @p key.
+     *
+     *  The results of the module cache for @p key are removed from memory
+     *  (see ModuleCache::clear) and from the disk (if this instance saves to
+     *  disk). When PluginPlay is built with RocksDB, the module's results are
+     *  removed from the disk by dropping the module's column family, which
+     *  takes the same time no matter how many results there are. The module
+     *  cache itself remains usable.
+     *
+     *  N.B. Inputs and results shared with other modules are not deleted.
+     *
+     *  @param[in] key The module whose results should be deleted.
+     *
+     *  @throw std::runtime_error if the cache was opened with open_read_only.
+     *                            Weak throw guarantee.
+     *  @throw ??? If the backends throw. Weak throw guarantee.
+     */
+    void drop_module_cache(module_cache_key key);
+
+    /** @brief Sets how a module's results are spread over the cache tiers.
+     *
+     *  This is a convenience function for calling
+     *  ModuleCache::set_tier_policy on the module cache for @p key (which is
+     *  created if it does not exist yet). See TierPolicy for details.
+     *
+     *  @param[in] key The module whose cache is being configured.
+     *  @param[in] policy The module's new tier policy.
+     *
+     *  @throw std::bad_alloc if creating the module cache fails. Strong throw
+     *                        guarantee.
+     */
+    void set_tier_policy(module_cache_key key, TierPolicy policy);
+
+    /** @brief Sets how long a module's results stay valid.
+     *
+     *  This is a convenience function for calling
+     *  ModuleCache::set_time_to_live on the module cache for @p key (which is
+     *  created if it does not exist yet).
+     *
+     *  @param[in] key The module whose cache is being configured.
+     *  @param[in] ttl How long the module's results stay valid, 0 means
+     *                 forever.
+     *
+     *  @throw std::bad_alloc if creating the module cache fails. Strong throw
+     *                        guarantee.
+     */
+    void set_time_to_live(module_cache_key key, std::chrono::milliseconds ttl);
+
+    /** @brief Sets how much memory a module's results may use.
+     *
+     *  This is a convenience function for calling
+     *  ModuleCache::set_quota_policy on the module cache for @p key (which is
+     *  created if it does not exist yet). See QuotaPolicy for details.
+     *
+     *  @param[in] key The module whose cache is being configured.
+     *  @param[in] policy The module's new quotas and priority.
+     *
+     *  @throw std::bad_alloc if creating the module cache fails. Strong throw
+     *                        guarantee.
+     */
+    void set_quota_policy(module_cache_key key, QuotaPolicy policy);
+
+    /** @brief Caps the memory used by the results of all modules.
+     *
+     *  The budget is shared by every module (and user) cache made by this
+     *  instance. Whenever a cache adds a result to memory and the caches
+     *  together use more than @p bytes, results are taken from the caches
+     *  in the order described by QuotaPolicy until they fit again. The new
+     *  budget is enforced immediately.
+     *
+     *  N.B. Enforcing the budget removes results from caches other than the
+     *       one being used. This is safe while other threads use those
+     *       caches, since all caches made by this instance share a lock (see
+     *       the class description).
+     *
+     *  @param[in] bytes The approximate number of bytes the results in memory
+     *                   may use, 0 (the default) means no limit.
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and allocating one
+     *                        fails. Strong throw guarantee.
+     */
+    void set_memory_budget(std::size_t bytes);
+
+    /** @brief The cap on the memory used by the results of all modules.
+     *
+     *  See set_memory_budget() for details.
+     *
+     *  @return The budget in bytes, 0 means no limit.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_budget() const noexcept;
+
+    /** @brief The current generation of the cache.
+     *
+     *  Results can depend on things the inputs of the module do not capture
+     *  (e.g., the version of a parameter file). To invalidate such results,
+     *  users bump the generation. Every result cached (by any module or user
+     *  cache made by this instance) before the generation was bumped is
+     *  stale. Stale results are treated as if they were not in the cache and
+     *  are removed from memory a few at a time as the caches are used, i.e.,
+     *  unlike clearing the caches, bumping the generation is O(1). Results
+     *  which were moved to disk by this instance keep their generation,
+     *  results saved by earlier runs are taken to be from the generation when
+     *  their module cache was made.
+     *
+     *  The generation is saved next to the cache by backup() (for read-only
+     *  caches, in the overlay). Opening a saved cache advances the generation
+     *  to the saved one, if it's behind, so the generation never goes back.
+     *
+     *  @return The current generation, the generation starts at 0.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::uint64_t generation() const noexcept;
+
+    /** @brief Makes every result cached so far stale.
+     *
+     *  See generation() for details.
+     *
+     *  @return The new generation.
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and allocating one
+     *                        fails. Strong throw guarantee.
+     */
+    std::uint64_t bump_generation();
+
+    /** @brief Waits for the results handed to the disk to be written.
+     *
+     *  If the disk is written to in the background (see WriteBehindPolicy),
+     *  results cached so far may not have been written yet. This method waits
+     *  until they have been. Unlike backup, it does not hand any more results
+     *  to the disk. This is a no-op if the disk is not written to in the
+     *  background.
+     *
+     *  @throw ??? Rethrows the first error which occurred while writing to the
+     *             disk in the background.
+     */
+    void flush();
+
+    /** @brief Writes a checkpoint of the cache to @p path.
+     *
+     *  A checkpoint is a single, self-describing file (a "bundle") holding
+     *  everything needed to recreate the cache's contents: the identities of
+     *  the module (and user) caches made by this instance, the proxy maps of
+     *  every module, and the serialized inputs/results. The bundle only
+     *  contains live records, so it is typically smaller than the save
+     *  location. Passing the bundle to restore (possibly in a different job,
+     *  or on a different machine) makes the checkpointed results available as
+     *  cache hits. Results whose inputs or results can't be serialized are
+     *  never saved to disk (see ModuleCache::cache), so they are not part of
+     *  the checkpoint.
+     *
+     *  This method first calls backup, so the checkpoint includes everything
+     *  cached so far. The bundle is written to a temporary file which is then
+     *  renamed to @p path, so a job which is killed while checkpointing never
+     *  leaves a partial bundle at @p path.
+     *
+     *  @param[in] path Where to write the bundle. If a file already exists at
+     *                  @p path it will be replaced.
+     *  @param[in] compress Should the bundle be compressed? Compression
+     *                      requires PluginPlay to have been built with zlib.
+     *                      Default is false.
+     *
+     *  @throw std::runtime_error if this instance does not save to disk, if
+     *                            @p compress is true and PluginPlay was not
+     *                            built with zlib, or if there is a problem
+     *                            writing the bundle. Strong throw guarantee.
+     */
+    void checkpoint(path_type path, bool compress = false);
+
+    /** @brief Writes a checkpoint of the cache to @p path in the background.
+     *
+     *  This method works like checkpoint, except that only the snapshot of
+     *  the cache is taken on the calling thread. Compressing and writing the
+     *  bundle happen on a background thread. Since the snapshot is taken
+     *  before this method returns, the cache can be used (and modified) while
+     *  the bundle is being written, without affecting the bundle.
+     *
+     *  @param[in] path Where to write the bundle.
+     *  @param[in] compress Should the bundle be compressed? Default is false.
+     *
+     *  @return A future which becomes ready once the bundle has been written.
+     *          Errors which occur while writing are rethrown by the future's
+     *          get method.
+     *
+     *  @throw std::runtime_error if this instance does not save to disk.
+     *                            Strong throw guarantee.
+     */
+    std::future<void> checkpoint_async(path_type path, bool compress = false);
+
+    /** @brief Adds the contents of a checkpoint to the cache.
+     *
+     *  This method reads a bundle written by checkpoint (or checkpoint_async)
+     *  and adds its records to this instance's save location. Afterwards,
+     *  calls which were cached when the checkpoint was made will be cache
+     *  hits. Records in the bundle replace records in the cache with the same
+     *  key. Restoring is intended to be done before the cache is used, e.g.,
+     *  when restarting a failed job, since results which this instance has
+     *  already cached in memory take precedence over the restored ones.
+     *
+     *  @param[in] path The bundle to restore.
+     *
+     *  @return The identities of the module (and user) caches which were
+     *          checkpointed.
+     *
+     *  @throw std::runtime_error if this instance does not save to disk, or if
+     *                            @p path is not a valid bundle (including if
+     *                            it is compressed and PluginPlay was not built
+     *                            with zlib). Strong throw guarantee if the
+     *                            bundle can not be read, weak otherwise.
+     */
+    std::vector<module_cache_key> restore(path_type path);
+
     /** @brief Retrieves the module cache for @p key.
      *
      *  For module implementations which can be memoized, the cache holds a
@@ -164,6 +519,38 @@ public:
      */
     user_cache_pointer get_or_make_user_cache(module_cache_key key);
 
+    /** @brief Returns the aggregate usage statistics of the module caches.
+     *
+     *  This method sums the statistics of every module cache made by this
+     *  instance (see ModuleCache::stats for the statistics of a single
+     *  module). If this instance saves to disk, the number of bytes in the
+     *  save location, and how much deduplicating the saved objects saved, are
+     *  also reported, as is how many inputs were hash-consed.
+     *
+     *  @return A snapshot of the aggregate statistics.
+     *
+     *  @throw std::filesystem::filesystem_error if there is a problem walking
+     *                                           the save location. Strong
+     *                                           throw guarantee.
+     */
+    CacheStats stats() const;
+
+    /** @brief Returns the usage statistics of each module cache.
+     *
+     *  Unlike stats(), this method does not sum the statistics, which makes
+     *  it possible to see how much memory each module currently uses (see
+     *  CacheStats::resident_bytes) and how many of its results were evicted
+     *  to respect its quotas or the memory budget. The disk counters are not
+     *  filled in.
+     *
+     *  @return A map from each module cache's key to a snapshot of its
+     *          statistics.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the map. Strong
+     *                        throw guarantee.
+     */
+    std::map<module_cache_key, CacheStats> module_stats() const;
+
 private:
     /// Type of the object actually implementing this class
     using pimpl_type = detail_::ModuleManagerCachePIMPL;
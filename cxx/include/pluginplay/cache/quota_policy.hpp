@@ -0,0 +1,55 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+
+namespace pluginplay::cache {
+
+/// How reluctant the memory budget is to take memory from a module's cache
+enum class CachePriority { low, normal, high };
+
+/** @brief Limits how much memory a module cache uses.
+ *
+ *  Each module cache may be given quotas on the number of results, and on the
+ *  number of bytes (as estimated by pluginplay::memory_footprint), which it
+ *  keeps in memory (L2, see TierPolicy). A cache which exceeds a quota removes
+ *  its least recently used results from memory until it is back under 7/8 of
+ *  the quota (so the cost of finding them is amortized). If the cache saves to
+ *  disk, the removed results are demoted (i.e., they are saved and can be
+ *  loaded again), otherwise they are evicted. The most recently used result is
+ *  never removed.
+ *
+ *  The module caches of a ModuleManagerCache may also share a memory budget
+ *  (see ModuleManagerCache::set_memory_budget). Once the caches together use
+ *  more bytes than the budget, memory is taken from the caches which are over
+ *  one of their quotas first, then from caches with lower priorities, and
+ *  then from caches using more memory.
+ *
+ *  The default policy has no quotas and normal priority.
+ */
+struct QuotaPolicy {
+    /// Results kept in memory, 0 means no limit
+    std::size_t max_entries = 0;
+
+    /// Bytes of results kept in memory, 0 means no limit
+    std::size_t max_bytes = 0;
+
+    /// Priority when memory is taken to respect the budget
+    CachePriority priority = CachePriority::normal;
+};
+
+} // namespace pluginplay::cache
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace pluginplay::cache {
+
+/// How RocksDB merges the files a column family is stored in
+enum class CompactionStyle : std::uint8_t {
+    /// Files are organized in levels of increasing size, favors reads
+    level = 0,
+    /// All files are merged at once, favors writes
+    universal = 1,
+    /// The oldest files are deleted, the data is treated as a bounded cache
+    fifo = 2
+};
+
+/** @brief Tunes how RocksDB stores the results of a module.
+ *
+ *  When PluginPlay is built with RocksDB, each module's results are saved in
+ *  their own RocksDB column family. This lets the I/O of each module be tuned
+ *  separately, e.g., a module with many large results can be given a bigger
+ *  write buffer than a module with a few small ones. Members which are zero
+ *  keep RocksDB's default.
+ *
+ *  Column families with the same `block_cache_size` share one block cache.
+ *  The options are ignored when PluginPlay is built without RocksDB.
+ */
+struct RocksDBOptions {
+    /// Size (in bytes) of the cache of uncompressed blocks read from disk
+    std::size_t block_cache_size = 0;
+
+    /// Bits per key of the Bloom filter of each file, zero means no filter
+    double bloom_bits_per_key = 0.0;
+
+    /// How the files are compacted
+    CompactionStyle compaction_style = CompactionStyle::level;
+
+    /// Size (in bytes) results are buffered in memory before being written
+    std::size_t write_buffer_size = 0;
+};
+
+} // namespace pluginplay::cache
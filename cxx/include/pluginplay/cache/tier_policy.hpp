@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+namespace pluginplay::cache {
+
+/** @brief Describes how a module cache spreads its results over its tiers.
+ *
+ *  Module caches are organized as a hierarchy of up to three tiers:
+ *
+ *  - L1 is a small cache each thread keeps of the results it most recently
+ *    retrieved. Looking up a result in L1 compares inputs directly, i.e., it
+ *    skips converting the inputs into the key used by the database, and does
+ *    not need to synchronize with other threads.
+ *  - L2 is the in-memory database shared by all threads. Since even
+ *    retrieving a result changes L2 (e.g., it records that the result was
+ *    used), threads take turns using it.
+ *  - L3 is the on-disk database (only present if the cache saves to disk).
+ *
+ *  Results found in a lower tier are promoted to the higher tiers when they
+ *  are retrieved. If L2 holds more than `l2_capacity` results, the least
+ *  recently used results are demoted, i.e., saved to L3 (if they are not
+ *  already there) and removed from memory. They are loaded again the next
+ *  time they are retrieved.
+ *
+ *  Results in L2 which have not been retrieved for a while can also be kept
+ *  "cold", i.e., serialized and compressed, but still in memory. A result
+ *  goes cold once `cold_after_accesses` other results have been retrieved
+ *  from, or added to, L2 since it was last used, or once it has not been used
+ *  for `cold_after`. Retrieving a cold result inflates it again. Results
+ *  which can not be serialized are never made cold. Results only go cold if
+ *  PluginPlay was built with zlib, CacheStats::cooling says whether they do.
+ *
+ *  The default policy disables L1, does not limit L2, and keeps every result
+ *  in L2 inflated.
+ */
+struct TierPolicy {
+    /// Results each thread keeps in L1, 0 disables L1
+    std::size_t l1_capacity = 0;
+
+    /// Results kept in L2, 0 means no limit. Ignored if there is no L3.
+    std::size_t l2_capacity = 0;
+
+    /// Accesses of L2 before an unused result goes cold, 0 means never
+    std::size_t cold_after_accesses = 0;
+
+    /// Time before an unused result in L2 goes cold, 0 means never
+    std::chrono::milliseconds cold_after{0};
+};
+
+} // namespace pluginplay::cache
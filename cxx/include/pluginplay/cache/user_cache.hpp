@@ -174,6 +174,14 @@ public:
      */
     void reset_cache() { m_cache_.clear(); }
 
+    /** @brief Saves the contents of the cache to long-term storage.
+     *
+     *  This method simply calls ModuleCache::backup on the wrapped cache.
+     *
+     *  @throw ??? Throws if the backend throws. Same throw guarantee.
+     */
+    void backup() { m_cache_.backup(); }
+
 private:
     /// Type of the keys in the wrapped ModuleCache
     using input_map_type = typename sub_cache_type::key_type;
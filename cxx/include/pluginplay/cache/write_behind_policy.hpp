@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+namespace pluginplay::cache {
+
+/** @brief Controls how caches which save to disk write their data.
+ *
+ *  By default a cache which saves to disk only writes to disk when it is
+ *  backed up, and the backup happens on the calling thread. With write-behind
+ *  enabled, each result is handed to the persistent backend as soon as it is
+ *  cached, and the writes are queued and performed on a background thread.
+ *  The background thread writes the queued writes in batches of (up to)
+ *  `batch_size`, waiting at most `max_delay` for a batch to fill up. At most
+ *  `queue_capacity` writes may be waiting. If the queue is full, the thread
+ *  caching a result waits for room, which bounds the memory used by the
+ *  queue.
+ *
+ *  Write-behind is disabled when `queue_capacity` is 0, which is the default.
+ */
+struct WriteBehindPolicy {
+    /// Maximum number of queued writes, 0 disables write-behind
+    std::size_t queue_capacity = 0;
+
+    /// Maximum number of writes performed per batch
+    std::size_t batch_size = 64;
+
+    /// Longest time a queued write waits for its batch to fill up
+    std::chrono::milliseconds max_delay{50};
+
+    /** @brief Is write-behind enabled?
+     *
+     *  @return True if writes should be performed on a background thread and
+     *          false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool enabled() const noexcept { return queue_capacity > 0; }
+};
+
+} // namespace pluginplay::cache
@@ -40,6 +40,14 @@ namespace pluginplay {
  */
 bool with_rocksdb();
 
+/** @brief Was PluginPlay built with zlib support?
+ *
+ *  @return True if the PluginPlay library distributed with this header was
+ *               built with zlib support (and can thus compress cached data)
+ *               and false otherwise.
+ */
+bool with_zlib();
+
 /** @brief Was PluginPlay built with pybind11 support?
  *
  *  @return True if the PluginPlay library distributed with this header was
@@ -16,10 +16,12 @@
 
 #pragma once
 #include <functional>
+#include <memory>
 #include <pluginplay/any/any.hpp>
 #include <pluginplay/fields/bounds_checking/bounds_checking.hpp>
 #include <pluginplay/types.hpp>
 #include <pluginplay/utility.hpp>
+#include <pluginplay/utility/pluginplay_sizeof.hpp>
 #include <set>
 #include <sstream>
 
@@ -70,6 +72,12 @@ public:
     /// Type of a check that operates on a type-erased value
     using any_check = validity_check<type::any>;
 
+    /// The type of a `shared_ptr` to a type-erased value
+    using shared_any = std::shared_ptr<const type::any>;
+
+    /// The type of the hash of the bound value
+    using content_hash_type = typename type::any::content_hash_type;
+
     /** @brief Makes a new, null ModuleInput instance
      *
      *  The instance resulting from this call will have no type, value, or
@@ -124,6 +132,32 @@ public:
      */
     bool has_value() const noexcept;
 
+    /** @brief Estimates the number of bytes the bound value occupies.
+     *
+     *  This function defers to AnyField::memory_footprint for the bound value.
+     *
+     *  @return An estimate of the size of the bound value in bytes. If no value
+     *          is bound, 0 is returned.
+     *
+     *  @throw none No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
+    /** @brief Returns the hash of the bound value.
+     *
+     *  The hash is computed by AnyField::content_hash once, and is then kept
+     *  (and copied) with the value until the value is changed. Small values
+     *  are hashed when they are bound, larger ones the first time this
+     *  function is called. The cache uses the hash to find equal values
+     *  without comparing them to every value it knows about.
+     *
+     *  @return The hash of the bound value. If no value is bound, or it can't
+     *          be hashed, std::nullopt is returned.
+     *
+     *  @throw none No throw guarantee.
+     */
+    content_hash_type content_hash() const noexcept;
+
     /** @brief Has the description of this input field been set?
      *
      *  Developers are encouraged to provide human-readable descriptions for
@@ -447,6 +481,12 @@ public:
      *  particular overload allows you to get the value back as either a copy
      *  of the bound value or a read-only reference to the the bound value.
      *
+     *  If @p T is `shared_any` the value is returned as a `shared_ptr` to the
+     *  instance this input holds, which can then be shared with other inputs
+     *  via intern. From then on the instance is never modified (asking for a
+     *  read/write reference to the value makes a private copy first) and
+     *  copies of this input share it rather than copying it.
+     *
      * @tparam T The type to cast the type-erased input to.
      *
      * @return The value bound to this field as an instance of type @p T.
@@ -485,6 +525,37 @@ public:
      */
     bounds_check_desc_t check_descriptions() const;
 
+    /** @brief Makes this input share an instance of its value.
+     *
+     *  Many inputs hold equal values (e.g., the same large object passed to
+     *  several calls as separate copies). Hash-consing those values (which is
+     *  what the cache does once it has matched an input's value to a value it
+     *  already knows about) makes them share one instance. This saves memory
+     *  and lets comparisons between the inputs skip comparing the values.
+     *
+     *  This function does not change the value of the input (only where the
+     *  value lives), hence it is const. The value is not re-validated.
+     *
+     *  @param[in] value The instance to share, typically obtained by calling
+     *                   `value<shared_any>()` on another input. It must be
+     *                   equal to this input's value.
+     *
+     *  @throw std::runtime_error if this input has no value or @p value is
+     *                            null. Strong throw guarantee.
+     */
+    void intern(shared_any value) const;
+
+    /** @brief Does this input share its value with @p rhs?
+     *
+     *  @param[in] rhs The input to compare to.
+     *
+     *  @return True if both inputs have a value and it is the same instance
+     *          (see intern), false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool shares_value(const ModuleInput& rhs) const noexcept;
+
     /** @brief Compares two ModuleInput instances for equality
      *
      *  Two ModuleInput instances are equivalent if their states are
@@ -526,6 +597,9 @@ private:
     /// Retrieves a read-only any from the PIMPL
     const type::any& get_() const;
 
+    /// Retrieves the any from the PIMPL, flagging it as shared
+    shared_any share_() const;
+
     /// Forwards a new value to the PIMPL
     void change_(type::any new_value);
 
@@ -556,6 +630,23 @@ private:
     std::unique_ptr<detail_::ModuleInputPIMPL> m_pimpl_;
 };
 
+/** @brief Estimates the number of bytes a ModuleInput occupies.
+ *
+ *  @relates ModuleInput
+ *
+ *  This overload of the pluginplay_sizeof customization point allows
+ *  memory_footprint to be called on containers of inputs (e.g., input maps).
+ *
+ *  @param[in] input The input whose size is being estimated.
+ *
+ *  @return sizeof(ModuleInput) plus the estimated size of the bound value.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t pluginplay_sizeof(const ModuleInput& input) noexcept {
+    return sizeof(input) + input.memory_footprint();
+}
+
 } // namespace pluginplay
 
 #include "module_input.ipp"
@@ -49,10 +49,12 @@ T ModuleInput::value() {
 
 template<typename T>
 T ModuleInput::value() const {
-    const auto& any = get_();
-    if constexpr(std::is_same_v<std::decay_t<T>, type::any>) {
-        return any;
+    if constexpr(std::is_same_v<T, shared_any>) {
+        return share_();
+    } else if constexpr(std::is_same_v<std::decay_t<T>, type::any>) {
+        return get_();
     } else {
+        const auto& any = get_();
         return any::any_cast<T>(any);
     }
 }
@@ -108,6 +110,9 @@ auto& ModuleInput::set_type() {
     // get it down to just cv qualifified.
     using no_ref = std::remove_reference_t<T>;
 
+    // So that cached values of this type can be loaded
+    any::register_any_field_type<no_ref>();
+
     m_is_cref_ = is_c_ref;
     set_type_(typeid(no_ref));        // Sets type as seen by outside world
     return add_type_check_<no_ref>(); // Set
@@ -134,11 +139,6 @@ inline bool ModuleInput::operator!=(const ModuleInput& rhs) const noexcept {
     return !((*this) == rhs);
 }
 
-inline type::any& ModuleInput::get_() {
-    const auto& temp = const_cast<const ModuleInput&>(*this).get_();
-    return const_cast<type::any&>(temp);
-}
-
 template<typename T>
 type::any ModuleInput::wrap_value_(T&& new_value) const {
     using clean_type = std::decay_t<T>;
@@ -20,6 +20,7 @@
 #include <pluginplay/any/any.hpp>
 #include <pluginplay/types.hpp>
 #include <pluginplay/utility.hpp>
+#include <pluginplay/utility/pluginplay_sizeof.hpp>
 #include <string>
 
 namespace pluginplay {
@@ -121,6 +122,17 @@ public:
      */
     bool has_description() const noexcept;
 
+    /** @brief Estimates the number of bytes the bound value occupies.
+     *
+     *  This function defers to AnyField::memory_footprint for the bound value.
+     *
+     *  @return An estimate of the size of the bound value in bytes. If no value
+     *          is bound, 0 is returned.
+     *
+     *  @throw none No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
     /** @brief Sets the type this result field must have.
      *
      *  Result fields are always types akin to std::shared_ptr<const T>. This
@@ -161,6 +173,28 @@ public:
     template<typename T>
     void change(T&& new_value);
 
+    /** @brief Binds a type-erased value to this result, setting the type from
+     *         the value if the type has not been set.
+     *
+     *  The typical workflow is to set the type of a result and then bind a
+     *  value to it. When results are restored from a cache the type is not
+     *  known at compile time, but it is known by the type-erased value. This
+     *  function will set the type of the result to that of @p new_value (if
+     *  the type has not already been set) and then bind @p new_value to the
+     *  result.
+     *
+     *  @param[in] new_value The value to bind to this field.
+     *
+     *  @return The current instance with @p new_value bound to it.
+     *
+     *  @throw std::runtime_error if @p new_value is a null pointer. Strong
+     *                            throw guarantee.
+     *  @throw std::invalid_argument if the type was already set and
+     *                               @p new_value does not have that type.
+     *                               Strong throw guarantee.
+     */
+    ModuleResult& set_type_and_change(shared_any new_value);
+
     /** @brief Sets this result field's description.
      *
      *  This function is used to set the human-readable description of what this
@@ -292,6 +326,23 @@ private:
     pimpl_pointer m_pimpl_;
 }; // class ModuleResult
 
+/** @brief Estimates the number of bytes a ModuleResult occupies.
+ *
+ *  @relates ModuleResult
+ *
+ *  This overload of the pluginplay_sizeof customization point allows
+ *  memory_footprint to be called on containers of results (e.g., result maps).
+ *
+ *  @param[in] result The result whose size is being estimated.
+ *
+ *  @return sizeof(ModuleResult) plus the estimated size of the bound value.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t pluginplay_sizeof(const ModuleResult& result) noexcept {
+    return sizeof(result) + result.memory_footprint();
+}
+
 } // namespace pluginplay
 
 #include "module_result.ipp"
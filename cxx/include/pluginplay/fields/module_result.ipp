@@ -32,6 +32,7 @@ auto& ModuleResult::set_type() {
     bounds_checking::TypeCheck<T> check;
     auto l = [=](const type::any& value) { return check(value); };
     set_type_check_(std::move(l));
+    any::register_any_field_type<T>(); // So cached values can be loaded
     return set_type_(typeid(T));
 }
 
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "pluginplay/types.hpp"
+#include <optional>
 #include <pluginplay/fields/fields.hpp>
 #include <pluginplay/property_type/python_only_property_type.hpp>
 #include <pluginplay/utility/uuid.hpp>
@@ -64,6 +65,9 @@ public:
     /// Type of a submodule to UUID map
     using submod_uuid_map = std::map<type::key, uuid_type>;
 
+    /// Type of a fingerprint of the module's configuration
+    using fingerprint_type = std::size_t;
+
     /** @brief Makes a module with no implementation.
      *
      *  The Module instance resulting from this ctor wraps no algorithm, has no
@@ -370,6 +374,36 @@ public:
      */
     void turn_on_memoization();
 
+    /** @brief Is memoization for this module adaptive?
+     *
+     *  @return True if adaptive memoization is on and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_memoization_adaptive() const noexcept;
+
+    /** @brief Lets the module decide for itself whether to memoize calls
+     *
+     *  Memoization has a cost (building the key, looking it up, and storing
+     *  the results). For modules which run quickly, or which are seldom called
+     *  with the same inputs, that cost can exceed the time memoization saves.
+     *  With adaptive memoization on, the module keeps moving averages of its
+     *  run time, its cache overhead, and its hit rate and bypasses the cache
+     *  when memoization is a net loss. The cache is periodically re-probed in
+     *  case that changes. The current decision is reported by profile_info.
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_on_adaptive_memoization();
+
+    /** @brief Turns off adaptive memoization (the default).
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_off_adaptive_memoization();
+
     /** @brief Locks the module and all submodules
      *
      *  A locked module can no longer have its inputs or submodules modified.
@@ -712,6 +746,28 @@ public:
 
     uuid_type uuid() const;
 
+    /** @brief Returns a fingerprint of the module's configuration.
+     *
+     *  The fingerprint is a Merkle-style hash of the module: it combines the
+     *  implementation, the bound inputs, the property types, and the
+     *  fingerprints of the submodules. Equal modules (ignoring their names and
+     *  lockedness) have equal fingerprints, so modules with different
+     *  fingerprints are known to differ without comparing them. Changing an
+     *  input only rehashes that input, and while the module is locked the
+     *  fingerprint is computed once and then reused.
+     *
+     *  Values which can't be hashed would break that guarantee, so the
+     *  fingerprint of a module with such a value bound to an input (or with a
+     *  submodule whose fingerprint is unknown) is unknown. Modules with an
+     *  unknown fingerprint have to be compared to be told apart.
+     *
+     *  @return The fingerprint of this module, or std::nullopt if it is
+     *          unknown.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::optional<fingerprint_type> fingerprint() const noexcept;
+
     /** @brief Compares two Module instances for equality
      *
      * Two modules are equivalent if they contain the same algorithm (determined
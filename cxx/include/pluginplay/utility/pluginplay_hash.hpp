@@ -0,0 +1,164 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @file pluginplay_hash.hpp
+ *
+ *  PluginPlay hashes the values of module inputs so that the cache can find
+ *  equal values without comparing them to every value it knows about. It does
+ *  this by calling `pluginplay_hash(value)` unqualified, meaning the function
+ *  is a customization point. Users who want PluginPlay to hash their types
+ *  should overload:
+ *
+ *  ```
+ *  std::optional<std::size_t> pluginplay_hash(const MyType& value) noexcept;
+ *  ```
+ *
+ *  in the namespace MyType lives in (so that it can be found by argument
+ *  dependent lookup). The hash must be consistent with MyType's operator==,
+ *  i.e., equal values must have equal hashes. The overloads in this file hash
+ *  vectors, pairs, and (unordered) maps element by element, and defer to
+ *  `std::hash` for everything else. Types `std::hash` does not know about are
+ *  not hashed (the hash is std::nullopt), which simply means the cache has to
+ *  compare their values. To recurse into the elements of a container, use
+ *  `pluginplay::content_hash`, which makes the unqualified call for you.
+ */
+
+namespace pluginplay {
+
+/// Type of a hash, std::nullopt if the value can not be hashed
+using content_hash_type = std::optional<std::size_t>;
+
+// Declared up front so the container overloads can find each other when
+// instantiated for nested containers
+
+/// Fallback, uses std::hash<T> if it is enabled
+template<typename T>
+content_hash_type pluginplay_hash(const T& value) noexcept;
+
+/// Combines the hashes of the elements, in order
+template<typename T, typename Alloc>
+content_hash_type pluginplay_hash(const std::vector<T, Alloc>& value) noexcept;
+
+/// Combines the hashes of the members
+template<typename T, typename U>
+content_hash_type pluginplay_hash(const std::pair<T, U>& value) noexcept;
+
+/// Combines the hashes of the elements, in order
+template<typename K, typename V, typename C, typename A>
+content_hash_type pluginplay_hash(const std::map<K, V, C, A>& value) noexcept;
+
+/// Combines the hashes of the elements, regardless of their order
+template<typename K, typename V, typename H, typename E, typename A>
+content_hash_type pluginplay_hash(
+  const std::unordered_map<K, V, H, E, A>& value) noexcept;
+
+/** @brief Hashes @p value.
+ *
+ *  This is the function PluginPlay calls to hash values. It simply makes an
+ *  unqualified call to pluginplay_hash so that user-provided overloads are
+ *  found.
+ *
+ *  @tparam T The type of the object being hashed.
+ *
+ *  @param[in] value The object to hash.
+ *
+ *  @return The hash of @p value, or std::nullopt if @p value can't be hashed.
+ */
+template<typename T>
+content_hash_type content_hash(const T& value) noexcept {
+    return pluginplay_hash(value);
+}
+
+namespace detail_ {
+
+/// Is std::hash<T> enabled?
+template<typename T>
+inline constexpr bool is_std_hashable_v =
+  std::is_default_constructible_v<std::hash<T>> &&
+  std::is_invocable_r_v<std::size_t, const std::hash<T>&, const T&>;
+
+/// Mixes @p value into @p seed (order-dependent, as boost::hash_combine)
+inline void combine_hash(std::size_t& seed, std::size_t value) noexcept {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+/// Combines the hashes of the elements of @p c, in iteration order
+template<typename Container>
+content_hash_type combine_elements(const Container& c) noexcept {
+    std::size_t seed = c.size();
+    for(const auto& x : c) {
+        const auto h = content_hash(x);
+        if(!h) return std::nullopt;
+        combine_hash(seed, *h);
+    }
+    return seed;
+}
+
+} // namespace detail_
+
+template<typename T>
+content_hash_type pluginplay_hash(const T& value) noexcept {
+    if constexpr(detail_::is_std_hashable_v<T>) {
+        return std::hash<T>{}(value);
+    } else {
+        return std::nullopt;
+    }
+}
+
+template<typename T, typename Alloc>
+content_hash_type pluginplay_hash(const std::vector<T, Alloc>& value) noexcept {
+    return detail_::combine_elements(value);
+}
+
+template<typename T, typename U>
+content_hash_type pluginplay_hash(const std::pair<T, U>& value) noexcept {
+    const auto first  = content_hash(value.first);
+    const auto second = content_hash(value.second);
+    if(!first || !second) return std::nullopt;
+    std::size_t seed = *first;
+    detail_::combine_hash(seed, *second);
+    return seed;
+}
+
+template<typename K, typename V, typename C, typename A>
+content_hash_type pluginplay_hash(const std::map<K, V, C, A>& value) noexcept {
+    return detail_::combine_elements(value);
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+content_hash_type pluginplay_hash(
+  const std::unordered_map<K, V, H, E, A>& value) noexcept {
+    // Equal maps may iterate in different orders, so the hashes are summed
+    std::size_t seed = value.size();
+    for(const auto& x : value) {
+        const auto h = content_hash(x);
+        if(!h) return std::nullopt;
+        seed += *h;
+    }
+    return seed;
+}
+
+} // namespace pluginplay
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @file pluginplay_sizeof.hpp
+ *
+ *  PluginPlay needs to estimate how much memory the objects it caches occupy.
+ *  It does this by calling `pluginplay_sizeof(value)` unqualified, meaning
+ *  the function is a customization point. Users who want PluginPlay to better
+ *  account for their types should overload:
+ *
+ *  ```
+ *  std::size_t pluginplay_sizeof(const MyType& value);
+ *  ```
+ *
+ *  in the namespace MyType lives in (so that it can be found by argument
+ *  dependent lookup). The overloads in this file provide estimates for
+ *  arithmetic types, strings, vectors, pairs, and (unordered) maps, and fall
+ *  back to `sizeof` for everything else. To recurse into the elements of a
+ *  container, use `pluginplay::memory_footprint`, which makes the unqualified
+ *  call for you.
+ *
+ *  All estimates include the `sizeof` of the object itself, so the size of a
+ *  container is `sizeof` the container plus the memory it owns.
+ */
+
+namespace pluginplay {
+
+// Declared up front so the container overloads can find each other when
+// instantiated for nested containers
+
+/// Fallback, returns sizeof(T)
+template<typename T>
+std::size_t pluginplay_sizeof(const T& value) noexcept;
+
+/// sizeof(std::string) plus its heap allocated buffer (if any)
+template<typename CharT, typename Traits, typename Alloc>
+std::size_t pluginplay_sizeof(
+  const std::basic_string<CharT, Traits, Alloc>& value) noexcept;
+
+/// sizeof(std::vector) plus its buffer and what the elements own
+template<typename T, typename Alloc>
+std::size_t pluginplay_sizeof(const std::vector<T, Alloc>& value) noexcept;
+
+/// sizeof(std::pair) plus what the members own
+template<typename T, typename U>
+std::size_t pluginplay_sizeof(const std::pair<T, U>& value) noexcept;
+
+/// sizeof(std::map) plus a node per element
+template<typename K, typename V, typename C, typename A>
+std::size_t pluginplay_sizeof(const std::map<K, V, C, A>& value) noexcept;
+
+/// sizeof(std::unordered_map) plus the buckets and a node per element
+template<typename K, typename V, typename H, typename E, typename A>
+std::size_t pluginplay_sizeof(
+  const std::unordered_map<K, V, H, E, A>& value) noexcept;
+
+/** @brief Estimates the number of bytes @p value occupies.
+ *
+ *  This is the function PluginPlay calls to estimate sizes. It simply makes an
+ *  unqualified call to pluginplay_sizeof so that user-provided overloads are
+ *  found.
+ *
+ *  @tparam T The type of the object whose size is being estimated.
+ *
+ *  @param[in] value The object whose size is being estimated.
+ *
+ *  @return The estimated size of @p value in bytes.
+ */
+template<typename T>
+std::size_t memory_footprint(const T& value) noexcept {
+    return pluginplay_sizeof(value);
+}
+
+namespace detail_ {
+
+/// Approximate bookkeeping (pointers, color/hash) per node of a node container
+inline constexpr std::size_t node_overhead = 4 * sizeof(void*);
+
+/// Memory owned by the elements of a container (beyond their sizeof)
+template<typename Container>
+std::size_t owned_by_elements(const Container& c) noexcept {
+    using value_type = typename Container::value_type;
+    std::size_t rv   = 0;
+    if constexpr(!std::is_arithmetic_v<value_type>) {
+        for(const auto& x : c) rv += memory_footprint(x) - sizeof(value_type);
+    }
+    return rv;
+}
+
+} // namespace detail_
+
+template<typename T>
+std::size_t pluginplay_sizeof(const T&) noexcept {
+    return sizeof(T);
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+std::size_t pluginplay_sizeof(
+  const std::basic_string<CharT, Traits, Alloc>& value) noexcept {
+    // Short strings live inside the object itself
+    const std::basic_string<CharT, Traits, Alloc> empty;
+    const auto heap = value.capacity() > empty.capacity() ?
+                        (value.capacity() + 1) * sizeof(CharT) :
+                        0;
+    return sizeof(value) + heap;
+}
+
+template<typename T, typename Alloc>
+std::size_t pluginplay_sizeof(const std::vector<T, Alloc>& value) noexcept {
+    return sizeof(value) + value.capacity() * sizeof(T) +
+           detail_::owned_by_elements(value);
+}
+
+template<typename T, typename U>
+std::size_t pluginplay_sizeof(const std::pair<T, U>& value) noexcept {
+    return sizeof(value) + (memory_footprint(value.first) - sizeof(T)) +
+           (memory_footprint(value.second) - sizeof(U));
+}
+
+template<typename K, typename V, typename C, typename A>
+std::size_t pluginplay_sizeof(const std::map<K, V, C, A>& value) noexcept {
+    using node_type = typename std::map<K, V, C, A>::value_type;
+    const auto node = sizeof(node_type) + detail_::node_overhead;
+    return sizeof(value) + value.size() * node +
+           detail_::owned_by_elements(value);
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+std::size_t pluginplay_sizeof(
+  const std::unordered_map<K, V, H, E, A>& value) noexcept {
+    using node_type = typename std::unordered_map<K, V, H, E, A>::value_type;
+    const auto node = sizeof(node_type) + detail_::node_overhead;
+    return sizeof(value) + value.bucket_count() * sizeof(void*) +
+           value.size() * node + detail_::owned_by_elements(value);
+}
+
+} // namespace pluginplay
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 
 namespace pluginplay::utility {
 
@@ -32,4 +33,22 @@ using uuid_type = std::string;
  */
 uuid_type generate_uuid();
 
+/** @brief Generates a UUID from the contents of an object.
+ *
+ *  Unlike generate_uuid, the UUID returned by this function depends only on
+ *  @p data: it is the name-based (version 5) UUID of @p data, i.e., it is
+ *  derived from the SHA-1 hash of @p data. Hence identical data always gets
+ *  the same UUID, in any process, and different data gets different UUIDs
+ *  (barring a SHA-1 collision). This is used to content-address objects, by
+ *  passing the serialized form of the object as @p data.
+ *
+ *  @param[in] data The bytes to generate the UUID for.
+ *
+ *  @return The UUID of @p data.
+ *
+ *  @throw std::bad_alloc if there is a problem allocating the UUID. Strong
+ *                        throw guarantee.
+ */
+uuid_type content_uuid(std::string_view data);
+
 } // namespace pluginplay::utility
@@ -16,8 +16,49 @@
 
 #include "pluginplay/any/any_field.hpp"
 #include "pluginplay/any/detail_/any_field_base.hpp"
+#include <map>
+#include <mutex>
+#include <stdexcept>
 
 namespace pluginplay::any {
+namespace detail_ {
+namespace {
+
+/// The loaders registered so far, keyed by type name
+auto& loaders() {
+    static std::map<std::string, AnyFieldBase::loader_type> the_loaders;
+    return the_loaders;
+}
+
+/// Guards loaders(), AnyFields are created from many threads
+std::mutex& loaders_mutex() {
+    static std::mutex the_mutex;
+    return the_mutex;
+}
+
+} // namespace
+
+void AnyFieldBase::register_loader(const std::string& tag,
+                                   loader_type loader) {
+    std::lock_guard<std::mutex> lock(loaders_mutex());
+    loaders().emplace(tag, loader);
+}
+
+typename AnyFieldBase::field_base_pointer AnyFieldBase::deserialize(
+  const std::string& tag, const std::string& bytes) {
+    loader_type loader = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(loaders_mutex());
+        auto itr = loaders().find(tag);
+        if(itr != loaders().end()) loader = itr->second;
+    }
+    if(loader == nullptr)
+        throw std::runtime_error("Don't know how to load a value of type " +
+                                 tag);
+    return loader(bytes);
+}
+
+} // namespace detail_
 
 // -----------------------------------------------------------------------------
 // -- CTors and Assignment
@@ -86,4 +127,41 @@ bool AnyField::owns_value() const noexcept {
     return !m_pimpl_->storing_const_reference();
 }
 
+std::size_t AnyField::memory_footprint() const noexcept {
+    if(!has_value()) return 0;
+    return m_pimpl_->memory_footprint();
+}
+
+typename AnyField::content_hash_type AnyField::content_hash() const noexcept {
+    if(!has_value()) return std::nullopt;
+    return m_pimpl_->content_hash();
+}
+
+bool AnyField::is_serializable() const noexcept {
+    if(!has_value()) return true;
+    return m_pimpl_->is_serializable();
+}
+
+// -----------------------------------------------------------------------------
+// -- Private Methods
+// -----------------------------------------------------------------------------
+
+void AnyField::to_bytes_(std::string& tag, std::string& bytes) const {
+    if(!has_value()) {
+        tag.clear();
+        bytes.clear();
+        return;
+    }
+    bytes = m_pimpl_->serialize(); // Throws if it can't be serialized
+    tag   = m_pimpl_->type().name();
+}
+
+void AnyField::from_bytes_(const std::string& tag, const std::string& bytes) {
+    if(tag.empty()) {
+        reset();
+        return;
+    }
+    m_pimpl_ = pimpl_type::deserialize(tag, bytes);
+}
+
 } // namespace pluginplay::any
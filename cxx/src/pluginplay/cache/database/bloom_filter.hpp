@@ -0,0 +1,273 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+
+// Saved filters start with these bytes
+inline constexpr std::string_view bloom_magic("\x7fPPB", 4);
+
+// Writes @p n to @p os as 8 little-endian bytes
+inline void write_u64(std::ostream& os, std::uint64_t n) {
+    for(std::size_t i = 0; i < 8; ++i, n >>= 8)
+        os.put(static_cast<char>(n & 0xFF));
+}
+
+// Reads 8 little-endian bytes from @p is
+inline std::uint64_t read_u64(std::istream& is) {
+    char buffer[8];
+    if(!is.read(buffer, 8)) throw std::runtime_error("Filter is truncated");
+    std::uint64_t n = 0;
+    for(std::size_t i = 8; i-- > 0;)
+        n = (n << 8) | static_cast<unsigned char>(buffer[i]);
+    return n;
+}
+
+} // namespace detail_
+
+/** @brief A scalable Bloom filter over 64-bit hashes.
+ *
+ *  A Bloom filter answers the question "was this hash inserted?" with either
+ *  "no" (which is always right) or "maybe" (which is wrong with a small,
+ *  configurable probability). Databases on disk use it to answer lookups of
+ *  keys they do not contain without touching the disk.
+ *
+ *  A classic Bloom filter must be sized up front. This class instead grows:
+ *  it is a list of layers, each a classic Bloom filter with twice the
+ *  capacity and half the false positive rate of the previous one, so the
+ *  overall false positive rate stays below twice that of the first layer no
+ *  matter how many hashes are inserted. New hashes go in the last layer, and
+ *  a new layer is added once the last one is full.
+ *
+ *  Like all Bloom filters, hashes can not be removed. Hashes are mixed before
+ *  use, so they need not be well distributed, but equal keys must always
+ *  hash to the same value (including across processes, if the filter is
+ *  saved).
+ */
+class BloomFilter {
+public:
+    /// Type of the inserted hashes
+    using hash_type = std::uint64_t;
+
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /** @brief Creates an empty filter.
+     *
+     *  @param[in] capacity The number of hashes the first layer holds.
+     *                      Default is 1024.
+     *  @param[in] fp_rate The false positive rate of the first layer. Should
+     *                     be in (0, 1). Default is 0.01.
+     *
+     *  @throw std::invalid_argument if @p capacity is 0 or @p fp_rate is not
+     *                               in (0, 1). Strong throw guarantee.
+     */
+    explicit BloomFilter(size_type capacity = 1024, double fp_rate = 0.01) :
+      m_capacity_(capacity), m_fp_rate_(fp_rate) {
+        if(capacity == 0 || !(fp_rate > 0.0 && fp_rate < 1.0))
+            throw std::invalid_argument("Invalid Bloom filter parameters");
+    }
+
+    /** @brief Adds @p h to the filter.
+     *
+     *  Hashes which may already be in the filter are not added again, so
+     *  inserting a hash repeatedly does not use up capacity.
+     *
+     *  @param[in] h The hash to add.
+     *
+     *  @throw std::bad_alloc if a new layer is needed and allocating it fails.
+     *                        Strong throw guarantee.
+     */
+    void insert(hash_type h) {
+        const auto x = mix_(h);
+        if(contains_(x)) return;
+        if(m_layers_.empty() || m_layers_.back().full()) add_layer_();
+        m_layers_.back().insert(x);
+        ++m_size_;
+    }
+
+    /** @brief Could @p h have been inserted?
+     *
+     *  @param[in] h The hash to look for.
+     *
+     *  @return False if @p h was definitely not inserted and true otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool might_contain(hash_type h) const noexcept {
+        return contains_(mix_(h));
+    }
+
+    /// The number of distinct hashes inserted (as far as the filter can tell)
+    size_type size() const noexcept { return m_size_; }
+
+    /// The number of bytes used by the bits of the filter
+    size_type memory_footprint() const noexcept {
+        size_type rv = 0;
+        for(const auto& l : m_layers_) rv += l.bits.size() * sizeof(hash_type);
+        return rv;
+    }
+
+    /** @brief Writes the filter to @p os.
+     *
+     *  @param[in] os The stream to write to, should be in binary mode.
+     *
+     *  @throw ??? If writing to @p os throws. Weak throw guarantee.
+     */
+    void save(std::ostream& os) const {
+        os.write(detail_::bloom_magic.data(), detail_::bloom_magic.size());
+        detail_::write_u64(os, m_capacity_);
+        detail_::write_u64(os, static_cast<hash_type>(m_fp_rate_ * 1.0e12));
+        detail_::write_u64(os, m_size_);
+        detail_::write_u64(os, m_layers_.size());
+        for(const auto& l : m_layers_) {
+            detail_::write_u64(os, l.capacity);
+            detail_::write_u64(os, l.size);
+            detail_::write_u64(os, l.n_hashes);
+            detail_::write_u64(os, l.bits.size());
+            for(auto word : l.bits) detail_::write_u64(os, word);
+        }
+    }
+
+    /** @brief Reads a filter written by save.
+     *
+     *  @param[in] is The stream to read from, should be in binary mode.
+     *
+     *  @return The filter which was saved.
+     *
+     *  @throw std::runtime_error if @p is does not contain a valid filter.
+     *                            Strong throw guarantee.
+     */
+    static BloomFilter load(std::istream& is) {
+        char magic[4];
+        if(!is.read(magic, 4) ||
+           std::string_view(magic, 4) != detail_::bloom_magic)
+            throw std::runtime_error("Not a saved Bloom filter");
+        const auto capacity = detail_::read_u64(is);
+        const auto fp_rate  = detail_::read_u64(is) * 1.0e-12;
+        BloomFilter rv(capacity, fp_rate);
+        rv.m_size_ = detail_::read_u64(is);
+        rv.m_layers_.resize(detail_::read_u64(is));
+        for(auto& l : rv.m_layers_) {
+            l.capacity = detail_::read_u64(is);
+            l.size     = detail_::read_u64(is);
+            l.n_hashes = detail_::read_u64(is);
+            l.bits.resize(detail_::read_u64(is));
+            for(auto& word : l.bits) word = detail_::read_u64(is);
+            if(l.bits.empty() || l.n_hashes == 0)
+                throw std::runtime_error("Saved Bloom filter is corrupt");
+        }
+        return rv;
+    }
+
+private:
+    /// One classic Bloom filter
+    struct layer_type {
+        /// The number of hashes the layer is sized for
+        size_type capacity = 0;
+
+        /// The number of hashes in the layer
+        size_type size = 0;
+
+        /// The number of bits set per hash
+        size_type n_hashes = 0;
+
+        /// The bits, packed into words
+        std::vector<hash_type> bits;
+
+        bool full() const noexcept { return size >= capacity; }
+
+        // Calls fxn with the index of each bit @p x sets (double hashing)
+        template<typename FxnType>
+        bool each_bit(hash_type x, FxnType&& fxn) const noexcept {
+            const hash_type n_bits = bits.size() * 64;
+            const hash_type step   = (x >> 32) % (n_bits - 1) + 1;
+            hash_type b            = x % n_bits;
+            for(size_type i = 0; i < n_hashes; ++i) {
+                if(!fxn(b)) return false;
+                b = (b + step) % n_bits;
+            }
+            return true;
+        }
+
+        void insert(hash_type x) noexcept {
+            each_bit(x, [this](hash_type b) {
+                bits[b / 64] |= hash_type{1} << (b % 64);
+                return true;
+            });
+            ++size;
+        }
+
+        bool contains(hash_type x) const noexcept {
+            return each_bit(x, [this](hash_type b) {
+                return (bits[b / 64] >> (b % 64)) & 1;
+            });
+        }
+    };
+
+    /// Scrambles @p h (the splitmix64 finalizer)
+    static hash_type mix_(hash_type h) noexcept {
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    /// Is the mixed hash @p x in any layer?
+    bool contains_(hash_type x) const noexcept {
+        for(const auto& l : m_layers_)
+            if(l.contains(x)) return true;
+        return false;
+    }
+
+    /// Adds a layer with twice the capacity and half the false positive rate
+    void add_layer_() {
+        const auto i   = m_layers_.size();
+        const auto n   = m_capacity_ << i;
+        const auto p   = m_fp_rate_ / static_cast<double>(hash_type{1} << i);
+        const auto ln2 = std::log(2.0);
+        // Optimal number of bits and of hashes for n keys at rate p
+        const auto n_bits = std::ceil(-std::log(p) * n / (ln2 * ln2));
+        layer_type l;
+        l.capacity = n;
+        l.n_hashes = static_cast<size_type>(std::ceil(-std::log2(p)));
+        l.bits.resize(static_cast<size_type>(n_bits) / 64 + 1);
+        m_layers_.push_back(std::move(l));
+    }
+
+    /// The capacity of the first layer
+    size_type m_capacity_;
+
+    /// The false positive rate of the first layer
+    double m_fp_rate_;
+
+    /// The number of distinct hashes inserted
+    size_type m_size_ = 0;
+
+    /// The layers, each twice as big as the previous one
+    std::vector<layer_type> m_layers_;
+};
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <map>
+#include <mutex>
+#include <pluginplay/cache/compression_policy.hpp>
+
+namespace pluginplay::cache::database {
+
+/** @brief Remembers how particular values should be compressed.
+ *
+ *  Module caches store their inputs/results in databases which are shared by
+ *  all modules. If a module wants its results compressed differently than the
+ *  rest, the shared database needs to know which values belong to that
+ *  module. CodecHints maps the keys of those values to the policy to use. The
+ *  databases belonging to the module record the hints (see CodecRecorder) and
+ *  the Compressed instance wrapping the shared database reads them.
+ *
+ *  Hints may be read by the background thread of a WriteBehind instance, so
+ *  the hints are guarded by a mutex.
+ *
+ *  @tparam KeyType The type of the keys of the hinted values.
+ */
+template<typename KeyType>
+class CodecHints {
+public:
+    /// Type of the keys of the hinted values
+    using key_type = KeyType;
+
+    /// Type of the hints
+    using policy_type = CompressionPolicy;
+
+    /** @brief Records that the value of @p key should be compressed with
+     *         @p policy.
+     *
+     *  @param[in] key The key of the value.
+     *  @param[in] policy How the value of @p key should be compressed.
+     *
+     *  @throw std::bad_alloc if there is a problem storing the hint. Strong
+     *                        throw guarantee.
+     */
+    void set(key_type key, policy_type policy) {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_hints_.insert_or_assign(std::move(key), std::move(policy));
+    }
+
+    /** @brief Returns the policy for the value of @p key.
+     *
+     *  @param[in] key The key of the value.
+     *  @param[in] otherwise Returned if there is no hint for @p key.
+     *
+     *  @return The policy recorded for @p key, or @p otherwise if none was.
+     *
+     *  @throw std::bad_alloc if there is a problem copying the policy. Strong
+     *                        throw guarantee.
+     */
+    policy_type get(const key_type& key, const policy_type& otherwise) const {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        auto itr = m_hints_.find(key);
+        return itr == m_hints_.end() ? otherwise : itr->second;
+    }
+
+    /// Have any hints been recorded?
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        return m_hints_.empty();
+    }
+
+private:
+    /// Guards m_hints_
+    mutable std::mutex m_mutex_;
+
+    /// The hints
+    std::map<key_type, policy_type> m_hints_;
+};
+
+} // namespace pluginplay::cache::database
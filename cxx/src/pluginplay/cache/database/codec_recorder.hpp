@@ -0,0 +1,147 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "codec_hints.hpp"
+#include "database_api.hpp"
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace pluginplay::cache::database {
+
+/** @brief Records how the values inserted through it should be compressed.
+ *
+ *  CodecRecorder forwards everything to a (typically shared) database. When a
+ *  key/value pair is inserted, it additionally records a hint that the value
+ *  should be compressed with the current policy. The policy is held by a
+ *  shared pointer so that the owner (e.g., a ModuleCache) can change it after
+ *  the recorder is created. No hints are recorded while the policy is unset.
+ *
+ *  The values are recorded (rather than the keys) because the databases
+ *  module caches share map objects to UUIDs, and it's the UUIDs which are
+ *  the keys of the database the objects are eventually saved in.
+ *
+ *  @tparam KeyType The type of the keys in the database.
+ *  @tparam ValueType The type of the values in the database. Must be less-than
+ *                    comparable.
+ */
+template<typename KeyType, typename ValueType>
+class CodecRecorder : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the database being wrapped
+    using sub_db_type = base_type;
+
+    /// Type of a pointer to the database being wrapped
+    using sub_db_pointer = std::shared_ptr<sub_db_type>;
+
+    /// Type of the hints
+    using hints_type = CodecHints<ValueType>;
+
+    /// Type of a pointer to the hints
+    using hints_pointer = std::shared_ptr<hints_type>;
+
+    /// Type of the policy being recorded, empty means don't record
+    using policy_type = std::optional<CompressionPolicy>;
+
+    /// Type of a read-only pointer to the policy
+    using policy_pointer = std::shared_ptr<const policy_type>;
+
+    /// Typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Typedef of const key_type&
+    using typename base_type::const_key_reference;
+
+    /// Typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Typedef of ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /** @brief Wraps @p sub_db, recording hints in @p hints.
+     *
+     *  @param[in] sub_db The database to forward to.
+     *  @param[in] hints Where the hints are recorded.
+     *  @param[in] policy The policy recorded for inserted values.
+     *
+     *  @throw std::runtime_error if any of the pointers are null. Strong throw
+     *                            guarantee.
+     */
+    CodecRecorder(sub_db_pointer sub_db, hints_pointer hints,
+                  policy_pointer policy);
+
+protected:
+    /// Calls m_db_->cursor()
+    cursor_pointer cursor_() const override { return m_db_->cursor(); }
+
+    /// Calls m_db_->range(first, last)
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override {
+        return m_db_->range(first, last);
+    }
+
+    /// Calls m_db_->prefix(prefix)
+    cursor_pointer prefix_(const_key_reference prefix) const override {
+        return m_db_->prefix(prefix);
+    }
+
+    /// Calls m_db_->count(key)
+    bool count_(const_key_reference key) const noexcept override {
+        return m_db_->count(key);
+    }
+
+    /// Inserts into m_db_, then records the hint for @p value
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Calls m_db_->free(key)
+    void free_(const_key_reference key) override { m_db_->free(key); }
+
+    /// Calls m_db_->at(key)
+    const_mapped_reference at_(const_key_reference key) const override {
+        return m_db_->at(key);
+    }
+
+    /// Calls m_db_->backup()
+    void backup_() override { m_db_->backup(); }
+
+    /// Calls m_db_->dump()
+    void dump_() override { m_db_->dump(); }
+
+private:
+    /// The database being forwarded to
+    sub_db_pointer m_db_;
+
+    /// Where the hints are recorded
+    hints_pointer m_hints_;
+
+    /// The policy to record
+    policy_pointer m_policy_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "codec_recorder.ipp"
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from codec_recorder.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define CODEC_RECORDER CodecRecorder<KeyType, ValueType>
+
+TPARAMS
+CODEC_RECORDER::CodecRecorder(sub_db_pointer sub_db, hints_pointer hints,
+                              policy_pointer policy) :
+  m_db_(std::move(sub_db)),
+  m_hints_(std::move(hints)),
+  m_policy_(std::move(policy)) {
+    if(m_db_ && m_hints_ && m_policy_) return;
+    throw std::runtime_error("CodecRecorder was given a null pointer.");
+}
+
+TPARAMS
+void CODEC_RECORDER::insert_(key_type key, mapped_type value) {
+    m_db_->insert(std::move(key), value);
+    if(*m_policy_) m_hints_->set(std::move(value), **m_policy_);
+}
+
+#undef CODEC_RECORDER
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail_/codec.hpp"
+#include "database_api.hpp"
+#include <cstdint>
+#include <functional>
+#include <pluginplay/cache/compression_policy.hpp>
+#include <stdexcept>
+#include <string_view>
+
+namespace pluginplay::cache::database {
+
+/** @brief Compresses the values of a binary-based database.
+ *
+ *  This class is meant to sit between Serialized and the database which
+ *  actually stores the bytes. Each value inserted into this database is
+ *  compressed with the codec the CompressionPolicy picks for it (based on the
+ *  value's size) before being inserted into the wrapped database. Values are
+ *  decompressed when they are read. The keys are not compressed.
+ *
+ *  The policy can either be fixed, or be a function of the key. The latter
+ *  allows different kinds of values sharing one database to be compressed
+ *  differently.
+ *
+ *  Compressed values are stored with a small header recording the codec and
+ *  the uncompressed size, so values compressed with different codecs (or with
+ *  codecs since removed from the policy) can be read back. Values which are
+ *  not compressed are stored as is (unless they happen to start with the
+ *  header's magic bytes), so a database which was written without
+ *  compression can still be read, and the overhead for small values is nil.
+ *
+ *  @note Like Serialized, this class is a wrapper around the managed
+ *        database, i.e., all interactions actually occur on the wrapped
+ *        database.
+ *
+ *  @tparam KeyType The type of the keys.
+ *  @tparam ValueType The type of the values. Assumed to be std::string.
+ */
+template<typename KeyType, typename ValueType>
+class Compressed : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the database being wrapped
+    using sub_db_type = base_type;
+
+    /// Type of a managed pointer to the database being wrapped
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /// Type of the object deciding how values are compressed
+    using policy_type = CompressionPolicy;
+
+    /// Typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Typedef of const key_type&
+    using typename base_type::const_key_reference;
+
+    /// Typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Typedef of ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /// Type of a function returning the policy for the value of a key
+    using policy_function = std::function<policy_type(const_key_reference)>;
+
+    /** @brief Wraps @p sub_db, compressing every value with @p policy.
+     *
+     *  @param[in] sub_db The database to store the compressed values in.
+     *  @param[in] policy Decides how each value is compressed.
+     *
+     *  @throw std::runtime_error if @p sub_db is a nullptr or if @p policy
+     *                            requires a codec which is not available.
+     *                            Strong throw guarantee.
+     */
+    Compressed(sub_db_pointer sub_db, policy_type policy);
+
+    /** @brief Wraps @p sub_db, compressing each value with the policy
+     *         @p policy returns for its key.
+     *
+     *  @param[in] sub_db The database to store the compressed values in.
+     *  @param[in] policy Called with each key being inserted, returns how the
+     *                    value of the key is compressed.
+     *
+     *  @throw std::runtime_error if @p sub_db or @p policy is null. Strong
+     *                            throw guarantee.
+     */
+    Compressed(sub_db_pointer sub_db, policy_function policy);
+
+protected:
+    /// Calls m_db_->cursor()
+    cursor_pointer cursor_() const override { return m_db_->cursor(); }
+
+    /// Calls m_db_->range(first, last)
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override {
+        return m_db_->range(first, last);
+    }
+
+    /// Calls m_db_->prefix(prefix)
+    cursor_pointer prefix_(const_key_reference prefix) const override {
+        return m_db_->prefix(prefix);
+    }
+
+    /// Calls m_db_->count(key)
+    bool count_(const_key_reference key) const noexcept override {
+        return m_db_->count(key);
+    }
+
+    /// Compresses @p value, then adds it to the wrapped database
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Calls m_db_->free(key)
+    void free_(const_key_reference key) override { m_db_->free(key); }
+
+    /// Gets the value from the wrapped database and decompresses it
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Calls m_db_->backup()
+    void backup_() override { m_db_->backup(); }
+
+    /// Calls m_db_->dump()
+    void dump_() override { m_db_->dump(); }
+
+private:
+    /// Returns @p value, compressed with @p codec if that makes it smaller
+    mapped_type encode_(mapped_type value, Codec codec) const;
+
+    /// Undoes encode_
+    mapped_type decode_(const mapped_type& stored) const;
+
+    /// The database holding the compressed values
+    sub_db_pointer m_db_;
+
+    /// Decides how the value of a key is compressed
+    policy_function m_policy_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "compressed.ipp"
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from compressed.hpp
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+
+// Compressed values start with these bytes, followed by the codec and the
+// uncompressed size (8 bytes, little-endian)
+inline constexpr std::string_view compressed_magic("\x7fPPZ", 4);
+
+// Size of the header of a compressed value
+inline constexpr std::size_t compressed_header_size =
+  compressed_magic.size() + 1 + 8;
+
+} // namespace detail_
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define COMPRESSED Compressed<KeyType, ValueType>
+
+TPARAMS
+COMPRESSED::Compressed(sub_db_pointer sub_db, policy_type policy) :
+  Compressed(std::move(sub_db),
+             [policy](const_key_reference) { return policy; }) {
+    cache::detail_::assert_codecs_available(policy);
+}
+
+TPARAMS
+COMPRESSED::Compressed(sub_db_pointer sub_db, policy_function policy) :
+  m_db_(std::move(sub_db)), m_policy_(std::move(policy)) {
+    if(!m_db_) throw std::runtime_error("Wrapped database can't be nullptr.");
+    if(!m_policy_) throw std::runtime_error("Policy function can't be null.");
+}
+
+TPARAMS
+void COMPRESSED::insert_(key_type key, mapped_type value) {
+    const auto codec = m_policy_(key)(value.size());
+    m_db_->insert(std::move(key), encode_(std::move(value), codec));
+}
+
+TPARAMS
+typename COMPRESSED::const_mapped_reference COMPRESSED::at_(
+  const_key_reference key) const {
+    return const_mapped_reference(decode_(m_db_->at(key).get()));
+}
+
+TPARAMS
+typename COMPRESSED::mapped_type COMPRESSED::encode_(mapped_type value,
+                                                     Codec codec) const {
+    using detail_::compressed_header_size;
+    using detail_::compressed_magic;
+
+    auto make_header = [&](Codec c) {
+        mapped_type rv(compressed_magic);
+        rv.push_back(static_cast<char>(c));
+        auto n = static_cast<std::uint64_t>(value.size());
+        for(std::size_t i = 0; i < 8; ++i, n >>= 8)
+            rv.push_back(static_cast<char>(n & 0xFF));
+        return rv;
+    };
+
+    if(auto pimpl = cache::detail_::codec_impl(codec)) {
+        auto compressed = pimpl->compress(value);
+        if(compressed.size() + compressed_header_size < value.size())
+            return make_header(codec) + compressed;
+    }
+    // Only values which could be mistaken for compressed ones need a header
+    if(value.compare(0, compressed_magic.size(), compressed_magic) != 0)
+        return value;
+    return make_header(Codec::none) + value;
+}
+
+TPARAMS
+typename COMPRESSED::mapped_type COMPRESSED::decode_(
+  const mapped_type& stored) const {
+    using detail_::compressed_header_size;
+    using detail_::compressed_magic;
+
+    if(stored.compare(0, compressed_magic.size(), compressed_magic) != 0)
+        return stored;
+    if(stored.size() < compressed_header_size)
+        throw std::runtime_error("Compressed value is corrupt");
+
+    const auto codec = static_cast<Codec>(stored[compressed_magic.size()]);
+    const auto last  = compressed_header_size - 1;
+    std::uint64_t n  = 0;
+    for(std::size_t i = 0; i < 8; ++i) {
+        const auto byte = static_cast<unsigned char>(stored[last - i]);
+        n               = (n << 8) | byte;
+    }
+    std::string_view payload(stored);
+    payload.remove_prefix(compressed_header_size);
+
+    auto pimpl = cache::detail_::codec_impl(codec);
+    if(!pimpl) return mapped_type(payload);
+    return pimpl->decompress(payload, n);
+}
+
+#undef COMPRESSED
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,469 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::database {
+
+/** @brief Visits the keys of a database one at a time.
+ *
+ *  DatabaseAPI::keys copies every key of the database into a container,
+ *  which for large (on-disk) databases means holding all of the keys in
+ *  memory at once. Cursors instead walk the keys, so that only the current
+ *  key needs to be in memory. A cursor starts on the first key (if there is
+ *  one). Usage is:
+ *
+ *  ```
+ *  for(auto c = db.cursor(); c->valid(); c->next()) use(c->key());
+ *  ```
+ *
+ *  Like iterators, cursors are tied to the database they came from. They
+ *  must not outlive it and, unless the backend says otherwise, anything
+ *  which changes which keys a backend holds in memory (inserting, freeing,
+ *  and loading or evicting values) invalidates the backend's cursors.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ */
+template<typename KeyType>
+class Cursor {
+public:
+    /// Type of the keys being visited
+    using key_type = KeyType;
+
+    /// Type of a read-only reference to a key
+    using const_key_reference = const key_type&;
+
+    /// Type of a pointer to a cursor, used when cursors wrap other cursors
+    using cursor_pointer = std::unique_ptr<Cursor<KeyType>>;
+
+    /// No-op, no-throw default ctor
+    Cursor() noexcept = default;
+
+    /// No-op, no-throw polymorphic default dtor
+    virtual ~Cursor() noexcept = default;
+
+    /// Does the cursor point at a key? False once the keys are exhausted
+    bool valid() const { return valid_(); }
+
+    /** @brief The key the cursor currently points at.
+     *
+     *  @return A reference to the current key. It is invalidated by next.
+     *          Calling this method when valid() is false is undefined
+     *          behavior.
+     *
+     *  @throw ??? Throws if the key can not be produced (e.g., it fails to
+     *             deserialize). Same throw guarantee.
+     */
+    const_key_reference key() const { return key_(); }
+
+    /// Moves the cursor to the next key, undefined behavior if !valid()
+    void next() { next_(); }
+
+protected:
+    /// Hook for implementing valid
+    virtual bool valid_() const = 0;
+
+    /// Hook for implementing key
+    virtual const_key_reference key_() const = 0;
+
+    /// Hook for implementing next
+    virtual void next_() = 0;
+};
+
+/** @brief Is @p T a type whose values operator< sorts?
+ *
+ *  DatabaseAPI::range can only be implemented for keys which have an order.
+ *  Since the comparison operators of containers are declared whether or not
+ *  their elements can be compared, this trait is true only for the types (and
+ *  containers thereof) we know are ordered.
+ */
+template<typename T>
+struct is_ordered_key : std::is_arithmetic<T> {};
+
+/// Strings are ordered
+template<typename CharT, typename Traits, typename Alloc>
+struct is_ordered_key<std::basic_string<CharT, Traits, Alloc>>
+  : std::true_type {};
+
+/// Pairs are ordered if both of their members are
+template<typename T, typename U>
+struct is_ordered_key<std::pair<T, U>>
+  : std::bool_constant<is_ordered_key<T>::value && is_ordered_key<U>::value> {
+};
+
+/// Vectors are ordered if their elements are
+template<typename T, typename Alloc>
+struct is_ordered_key<std::vector<T, Alloc>> : is_ordered_key<T> {};
+
+/// Maps are ordered if their keys and values are
+template<typename K, typename V, typename Compare, typename Alloc>
+struct is_ordered_key<std::map<K, V, Compare, Alloc>>
+  : is_ordered_key<std::pair<K, V>> {};
+
+/// Convenience variable for getting the value of is_ordered_key
+template<typename T>
+static constexpr bool is_ordered_key_v = is_ordered_key<T>::value;
+
+/// Is @p T a string, i.e., can DatabaseAPI::prefix be used with it?
+template<typename T>
+struct is_string_key : std::false_type {};
+
+/// Strings are strings
+template<typename CharT, typename Traits, typename Alloc>
+struct is_string_key<std::basic_string<CharT, Traits, Alloc>>
+  : std::true_type {};
+
+/// Convenience variable for getting the value of is_string_key
+template<typename T>
+static constexpr bool is_string_key_v = is_string_key<T>::value;
+
+/// Does @p key start with @p prefix?
+template<typename StringType>
+bool has_prefix(const StringType& key, const StringType& prefix) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+}
+
+/** @brief Cursor over keys which have already been put in a container.
+ *
+ *  Used by backends which can not stream their keys.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ */
+template<typename KeyType>
+class VectorCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of the container holding the keys
+    using key_set_type = std::vector<KeyType>;
+
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Takes ownership of @p keys
+    explicit VectorCursor(key_set_type keys = {}) noexcept :
+      m_keys_(std::move(keys)) {}
+
+protected:
+    bool valid_() const override { return m_i_ < m_keys_.size(); }
+
+    const_key_reference key_() const override { return m_keys_[m_i_]; }
+
+    void next_() override { ++m_i_; }
+
+private:
+    /// The keys being visited
+    key_set_type m_keys_;
+
+    /// The index of the current key
+    std::size_t m_i_ = 0;
+};
+
+/** @brief Cursor over a range of iterators.
+ *
+ *  Used by the in-memory backends to walk their containers. The projection
+ *  maps an iterator to the key it refers to, or to nullptr if the element
+ *  should be skipped (e.g., an empty slot of a hash table).
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ *  @tparam IteratorType The type of the iterators.
+ *  @tparam ProjectionType Type of a functor taking an iterator and returning
+ *                         a `const KeyType*`.
+ */
+template<typename KeyType, typename IteratorType, typename ProjectionType>
+class IteratorCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Visits the keys in [@p begin, @p end) which @p proj doesn't skip
+    IteratorCursor(IteratorType begin, IteratorType end, ProjectionType proj) :
+      m_itr_(std::move(begin)),
+      m_end_(std::move(end)),
+      m_proj_(std::move(proj)) {
+        skip_();
+    }
+
+protected:
+    bool valid_() const override { return m_itr_ != m_end_; }
+
+    const_key_reference key_() const override { return *m_proj_(m_itr_); }
+
+    void next_() override {
+        ++m_itr_;
+        skip_();
+    }
+
+private:
+    /// Advances m_itr_ past the elements the projection skips
+    void skip_() {
+        while(m_itr_ != m_end_ && m_proj_(m_itr_) == nullptr) ++m_itr_;
+    }
+
+    /// The current element
+    IteratorType m_itr_;
+
+    /// The element just past the last element
+    IteratorType m_end_;
+
+    /// Maps iterators to keys
+    ProjectionType m_proj_;
+};
+
+/// Deduces the template parameters of IteratorCursor
+template<typename KeyType, typename IteratorType, typename ProjectionType>
+std::unique_ptr<Cursor<KeyType>> make_iterator_cursor(IteratorType begin,
+                                                      IteratorType end,
+                                                      ProjectionType proj) {
+    using cursor_type = IteratorCursor<KeyType, IteratorType, ProjectionType>;
+    return std::make_unique<cursor_type>(std::move(begin), std::move(end),
+                                         std::move(proj));
+}
+
+/** @brief Cursor which visits the keys of another cursor which satisfy a
+ *         predicate.
+ *
+ *  If @p bounded is false keys failing the predicate are skipped. If
+ *  @p bounded is true the first key failing the predicate ends the cursor,
+ *  which is how sorted backends stop range and prefix scans once they have
+ *  passed the last matching key.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ */
+template<typename KeyType>
+class FilteredCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Type of a pointer to the wrapped cursor
+    using typename base_type::cursor_pointer;
+
+    /// Type of the predicate
+    using predicate_type = std::function<bool(const_key_reference)>;
+
+    /// Wraps @p sub, visiting the keys for which @p pred is true
+    FilteredCursor(cursor_pointer sub, predicate_type pred,
+                   bool bounded = false) :
+      m_sub_(std::move(sub)), m_pred_(std::move(pred)), m_bounded_(bounded) {
+        skip_();
+    }
+
+protected:
+    bool valid_() const override { return !m_done_ && m_sub_->valid(); }
+
+    const_key_reference key_() const override { return m_sub_->key(); }
+
+    void next_() override {
+        m_sub_->next();
+        skip_();
+    }
+
+private:
+    /// Advances m_sub_ to the next key satisfying m_pred_
+    void skip_() {
+        for(; m_sub_->valid(); m_sub_->next()) {
+            if(m_pred_(m_sub_->key())) return;
+            if(m_bounded_) {
+                m_done_ = true;
+                return;
+            }
+        }
+    }
+
+    /// The cursor being filtered
+    cursor_pointer m_sub_;
+
+    /// Which keys to visit
+    predicate_type m_pred_;
+
+    /// Does the first failing key end the cursor?
+    bool m_bounded_;
+
+    /// Has a failing key ended the cursor?
+    bool m_done_ = false;
+};
+
+/** @brief Cursor which converts the keys of another cursor.
+ *
+ *  Used by layers which change the key type, e.g., by deserializing keys.
+ *  Keys are converted the first time they are asked for, so only the current
+ *  key is ever held.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ *  @tparam SubKeyType The type of the wrapped cursor's keys.
+ */
+template<typename KeyType, typename SubKeyType>
+class TransformCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of the keys being visited
+    using typename base_type::key_type;
+
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Type of a pointer to the wrapped cursor
+    using sub_cursor_pointer = std::unique_ptr<Cursor<SubKeyType>>;
+
+    /// Type of the function converting keys
+    using transform_type = std::function<key_type(const SubKeyType&)>;
+
+    /// Wraps @p sub, converting its keys with @p fxn
+    TransformCursor(sub_cursor_pointer sub, transform_type fxn) :
+      m_sub_(std::move(sub)), m_fxn_(std::move(fxn)) {}
+
+protected:
+    bool valid_() const override { return m_sub_->valid(); }
+
+    const_key_reference key_() const override {
+        if(!m_key_) m_key_.emplace(m_fxn_(m_sub_->key()));
+        return *m_key_;
+    }
+
+    void next_() override {
+        m_key_.reset();
+        m_sub_->next();
+    }
+
+private:
+    /// The cursor being converted
+    sub_cursor_pointer m_sub_;
+
+    /// Converts the keys
+    transform_type m_fxn_;
+
+    /// The current key, once it has been converted
+    mutable std::optional<key_type> m_key_;
+};
+
+/** @brief Cursor which visits the keys of one cursor, then another.
+ *
+ *  Used by layers which combine databases, e.g., a database and the
+ *  database it reads through to.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ */
+template<typename KeyType>
+class ChainCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Type of a pointer to the wrapped cursors
+    using typename base_type::cursor_pointer;
+
+    /// Visits the keys of @p first, then those of @p second
+    ChainCursor(cursor_pointer first, cursor_pointer second) noexcept :
+      m_first_(std::move(first)), m_second_(std::move(second)) {}
+
+protected:
+    bool valid_() const override { return current_().valid(); }
+
+    const_key_reference key_() const override { return current_().key(); }
+
+    void next_() override { current_().next(); }
+
+private:
+    /// The cursor which holds the current key
+    Cursor<KeyType>& current_() const {
+        return m_first_->valid() ? *m_first_ : *m_second_;
+    }
+
+    /// The cursor visited first
+    cursor_pointer m_first_;
+
+    /// The cursor visited second
+    cursor_pointer m_second_;
+};
+
+/** @brief Cursor which locks a mutex whenever it uses another cursor.
+ *
+ *  Used by layers whose wrapped database is written to by another thread.
+ *  The lock is only held during each call, so the database may be written to
+ *  between calls.
+ *
+ *  @tparam KeyType The type of the keys being visited.
+ */
+template<typename KeyType>
+class LockedCursor : public Cursor<KeyType> {
+private:
+    /// Type this class implements
+    using base_type = Cursor<KeyType>;
+
+public:
+    /// Type of a read-only reference to a key
+    using typename base_type::const_key_reference;
+
+    /// Type of a pointer to the wrapped cursor
+    using typename base_type::cursor_pointer;
+
+    /// Wraps @p sub, which must have been made while holding @p mutex
+    LockedCursor(cursor_pointer sub, std::mutex& mutex) noexcept :
+      m_sub_(std::move(sub)), m_mutex_(mutex) {}
+
+protected:
+    bool valid_() const override {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        return m_sub_->valid();
+    }
+
+    const_key_reference key_() const override {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        return m_sub_->key();
+    }
+
+    void next_() override {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_sub_->next();
+    }
+
+private:
+    /// The cursor being guarded
+    cursor_pointer m_sub_;
+
+    /// Guards the database m_sub_ came from
+    std::mutex& m_mutex_;
+};
+
+} // namespace pluginplay::cache::database
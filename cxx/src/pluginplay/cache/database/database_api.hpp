@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include "cursor.hpp"
 #include "db_value.hpp"
 #include <stdexcept>
 #include <vector>
@@ -80,6 +81,12 @@ public:
      */
     using const_mapped_reference = ConstDBValue<mapped_type>;
 
+    /// Type of an object which visits the keys of the database
+    using cursor_type = Cursor<key_type>;
+
+    /// Type of a pointer to a cursor
+    using cursor_pointer = std::unique_ptr<cursor_type>;
+
     /// No-op, no-throw default ctor
     DatabaseAPI() noexcept = default;
 
@@ -92,10 +99,9 @@ public:
      *  looping over the keys and then retrieving the values ("accessible"
      *  because not all backends expose key/value pairs).
      *
-     *  N.B. This operation, as implemented, can be very expensive because in
-     *  general the keys will need to be copied into the returned object.
-     *  Furthermore, for some of the layers relying on proxies, this method
-     *  can result in multiple copies of the unproxied objects.
+     *  N.B. This operation can be very expensive because every key is copied
+     *  into the returned object. Prefer cursor (and range/prefix) when the
+     *  keys only need to be visited, since those hold one key at a time.
      *
      *  @return A container with the database's keys.
      *
@@ -104,6 +110,66 @@ public:
      */
     key_set_type keys() const { return keys_(); }
 
+    /** @brief Returns a cursor over the keys of the database.
+     *
+     *  The cursor visits the same keys, in the same order, as keys() returns,
+     *  but it produces them one at a time. Backends which store their keys on
+     *  disk stream them, so walking a database with a cursor takes a constant
+     *  amount of memory regardless of the database's size. See Cursor for the
+     *  lifetime rules.
+     *
+     *  N.B. This function is implemented by cursor_
+     *
+     *  @return A cursor positioned on the first key (if any).
+     *
+     *  @throw std::runtime_error if the backend does not support cursors.
+     *                            Strong throw guarantee.
+     */
+    cursor_pointer cursor() const { return cursor_(); }
+
+    /** @brief Returns a cursor over the keys in [@p first, @p last).
+     *
+     *  Backends which keep their keys sorted (e.g., RocksDB) seek to @p first
+     *  and stop at @p last. Other backends visit all of their keys, skipping
+     *  those outside the range, which still takes constant memory, but
+     *  linear time.
+     *
+     *  N.B. This function is implemented by range_
+     *
+     *  @param[in] first The smallest key to visit.
+     *  @param[in] last The first key past the range.
+     *
+     *  @return A cursor positioned on the first key in the range (if any).
+     *
+     *  @throw std::runtime_error if the keys are not ordered (see
+     *                            is_ordered_key) or the backend does not
+     *                            support cursors. Strong throw guarantee.
+     */
+    cursor_pointer range(const_key_reference first,
+                         const_key_reference last) const {
+        return range_(first, last);
+    }
+
+    /** @brief Returns a cursor over the keys starting with @p prefix.
+     *
+     *  This is the scan to use for databases whose keys are namespaced by
+     *  prefix (e.g., by module). Like range, sorted backends seek to the
+     *  prefix, while the other backends filter their keys.
+     *
+     *  N.B. This function is implemented by prefix_
+     *
+     *  @param[in] prefix What the visited keys start with.
+     *
+     *  @return A cursor positioned on the first matching key (if any).
+     *
+     *  @throw std::runtime_error if the keys are not strings or the backend
+     *                            does not support cursors. Strong throw
+     *                            guarantee.
+     */
+    cursor_pointer prefix(const_key_reference prefix) const {
+        return prefix_(prefix);
+    }
+
     /** @brief Public API for determining if a database contains a key.
      *
      *  Databases are viewed as key/value stores. This method is used to
@@ -260,15 +326,54 @@ public:
 protected:
     /** @brief Hook for derived class to implement keys.
      *
-     *  The derived class is responsible for overriding this method with a
-     *  definition consistent with the description of DatabaseAPI::keys.
+     *  The default implementation drains cursor_, derived classes only need
+     *  to override it if they can do better.
      *
      *  @return A container with this database's keys
      *
      *  @throw std::bad_alloc if there is a problem creating the return. Strong
      *         throw guarantee.
      */
-    virtual key_set_type keys_() const { throw std::runtime_error("NYI"); }
+    virtual key_set_type keys_() const;
+
+    /** @brief Hook for derived class to implement cursor.
+     *
+     *  The derived class is responsible for overriding this method with a
+     *  definition consistent with the description of DatabaseAPI::cursor.
+     *
+     *  @return A cursor over this database's keys.
+     *
+     *  @throw std::runtime_error if not overridden.
+     */
+    virtual cursor_pointer cursor_() const { throw std::runtime_error("NYI"); }
+
+    /** @brief Hook for derived class to implement range.
+     *
+     *  The default implementation filters cursor_. Derived classes which can
+     *  seek should override it.
+     *
+     *  @param[in] first The smallest key to visit.
+     *  @param[in] last The first key past the range.
+     *
+     *  @return A cursor over the keys in [@p first, @p last).
+     *
+     *  @throw std::runtime_error if the keys are not ordered.
+     */
+    virtual cursor_pointer range_(const_key_reference first,
+                                  const_key_reference last) const;
+
+    /** @brief Hook for derived class to implement prefix.
+     *
+     *  The default implementation filters cursor_. Derived classes which can
+     *  seek should override it.
+     *
+     *  @param[in] prefix What the visited keys start with.
+     *
+     *  @return A cursor over the keys starting with @p prefix.
+     *
+     *  @throw std::runtime_error if the keys are not strings.
+     */
+    virtual cursor_pointer prefix_(const_key_reference prefix) const;
 
     /** @brief Hook for derived class to implement count.
      *
@@ -345,6 +450,39 @@ void DB_PIMPL::insert(KeyType key, ValueType value) {
     insert_(std::move(key), std::move(value));
 }
 
+TPARAMS
+typename DB_PIMPL::key_set_type DB_PIMPL::keys_() const {
+    key_set_type rv;
+    for(auto c = cursor_(); c->valid(); c->next()) rv.push_back(c->key());
+    return rv;
+}
+
+TPARAMS
+typename DB_PIMPL::cursor_pointer DB_PIMPL::range_(
+  const_key_reference first, const_key_reference last) const {
+    if constexpr(is_ordered_key_v<key_type>) {
+        auto in_range = [first, last](const_key_reference key) {
+            return !(key < first) && key < last;
+        };
+        return std::make_unique<FilteredCursor<key_type>>(cursor_(), in_range);
+    } else {
+        throw std::runtime_error("Range scans require ordered keys");
+    }
+}
+
+TPARAMS
+typename DB_PIMPL::cursor_pointer DB_PIMPL::prefix_(
+  const_key_reference prefix) const {
+    if constexpr(is_string_key_v<key_type>) {
+        auto matches = [prefix](const_key_reference key) {
+            return has_prefix(key, prefix);
+        };
+        return std::make_unique<FilteredCursor<key_type>>(cursor_(), matches);
+    } else {
+        throw std::runtime_error("Prefix scans require string keys");
+    }
+}
+
 TPARAMS
 typename DB_PIMPL::const_mapped_reference DB_PIMPL::at(
   const_key_reference key) const {
@@ -14,16 +14,27 @@
  * limitations under the License.
  */
 
+#include "../detail_/archive_buffers.hpp"
+#include "../detail_/codec.hpp"
+#include "codec_recorder.hpp"
+#include "compressed.hpp"
 #include "database_factory.hpp"
-#include "key_injector.hpp"
+#include "filtered.hpp"
+#include "flat_file/flat_file.hpp"
 #include "key_proxy_mapper.hpp"
 #include "make_any.hpp"
 #include "native.hpp"
-#include "rocksdb/rocksdb.hpp"
+#include "native_hashed.hpp"
+#include "overlay.hpp"
+#include "proxy_map_codec.hpp"
 #include "serialized.hpp"
 #include "transposer.hpp"
 #include "type_eraser.hpp"
 #include "value_proxy_mapper.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <pluginplay/config/config.hpp>
+#include <string_view>
 
 namespace pluginplay::cache::database {
 
@@ -37,67 +48,498 @@ using any_field     = typename DatabaseFactory::any_type;
 using uuid          = typename DatabaseFactory::uuid_type;
 using binary_type   = typename DatabaseFactory::binary_type;
 
-DatabaseFactory::DatabaseFactory() { set_type_eraser_backend(); }
+namespace {
+
+// Key injected into the proxy maps of each module, its value is the module
+constexpr const char* module_key = "__CACHE__ MODULE NAME __CACHE__";
+
+// Name of the column family RocksDB always has
+constexpr const char* default_family = "default";
+
+// Prefix of the names of the modules' column families
+constexpr const char* family_prefix = "module:";
+
+// Prefix of the names the modules' column families are registered under
+constexpr const char* table_prefix = "cache/";
+
+// Key the format of the saved results is recorded under. It starts with
+// ProxyMapCodec::name_marker, so cursors over the results skip it
+constexpr const char* format_key = "\xFE" "format";
+
+// Format of the saved results, i.e., keys encoded by ProxyMapCodec and (with
+// RocksDB) a column family per module. Earlier versions recorded no format.
+constexpr const char* format_version = "2";
+
+// Strips @p prefix from @p name, returns an empty string if it isn't a prefix
+std::string strip_prefix(const std::string& name, const std::string& prefix) {
+    if(name.size() <= prefix.size()) return "";
+    if(name.compare(0, prefix.size(), prefix)) return "";
+    return name.substr(prefix.size());
+}
+
+// Undoes the serialization Serialized<T, ...> applies to its values (and
+// applied to its keys before ProxyMapCodec)
+template<typename T>
+T deserialize_key(const binary_type& key) {
+    cache::detail_::InputBuffer buffer(key);
+    cereal::BinaryInputArchive ar(buffer.stream());
+    T rv;
+    ar >> rv;
+    return rv;
+}
+
+// Splits a saved proxy map into its module and the hash of the module's key
+std::pair<uuid, std::uint64_t> module_key_hash(proxy_map key) {
+    auto node = key.extract(module_key);
+    if(node.empty()) throw std::runtime_error("Proxy map has no module");
+    return {std::move(node.mapped()), DBHash<proxy_map>{}(key)};
+}
+
+// Opens the persistent backend at @p path. RocksDB is used if we have it,
+// otherwise the built-in FlatFile backend is
+std::unique_ptr<DatabaseAPI<binary_type, binary_type>> open_backend(
+  const std::string& path, bool read_only) {
+    if constexpr(with_rocksdb_v) {
+        using rocks_db = RocksDB<binary_type, binary_type>;
+        return std::make_unique<rocks_db>(path, read_only);
+    } else {
+        using flat_file = FlatFile<binary_type, binary_type>;
+        return std::make_unique<flat_file>(path, read_only);
+    }
+}
+
+// Derives the UUID of an input/result from its serialized form. Objects we
+// can't serialize can't be content-addressed, they get a random UUID.
+template<typename T>
+typename UUIDMapper<T>::content_id_type content_id(const T& value) {
+    using rv_type = typename UUIDMapper<T>::content_id_type;
+    auto random   = []() { return rv_type(utility::generate_uuid(), 0); };
+    try {
+        const auto da_any = MakeAny<T>::convert(value);
+        if(!da_any.is_serializable()) return random();
+        cache::detail_::OutputBuffer buffer;
+        {
+            cereal::BinaryOutputArchive ar(buffer.stream());
+            ar << da_any;
+        }
+        const auto& data = buffer.bytes();
+        if(data.empty()) return random();
+        return rv_type(utility::content_uuid(data), data.size());
+    } catch(...) { return random(); }
+}
+
+// Cold results are serialized and, if it helps, compressed. The first byte
+// says whether the rest is compressed, if it is, the next eight bytes are the
+// serialized size (little endian). Results which can't be serialized would
+// be lost, so they throw (and thus stay inflated).
+std::string freeze_results(const result_map& results) {
+    using shared_any = typename module_result::shared_any;
+    for(const auto& [name, result] : results)
+        if(!result.value<shared_any>()->is_serializable())
+            throw std::runtime_error("Result " + name + " can't go cold");
+
+    cache::detail_::OutputBuffer buffer;
+    {
+        cereal::BinaryOutputArchive ar(buffer.stream());
+        ar << static_cast<std::uint64_t>(results.size());
+        for(const auto& [name, result] : results)
+            ar << name << MakeAny<module_result>::convert(result);
+    }
+    const auto& data  = buffer.bytes();
+    const auto* codec = cache::detail_::codec_impl(Codec::fast);
+    auto compressed   = codec->compress(data);
+    if(compressed.size() + 8 < data.size()) {
+        std::string rv(1, '\1');
+        rv.reserve(9 + compressed.size());
+        const std::uint64_t n = data.size();
+        for(int i = 0; i < 8; ++i)
+            rv.push_back(static_cast<char>((n >> (8 * i)) & 0xFF));
+        return rv + compressed;
+    }
+    return std::string(1, '\0') + data;
+}
+
+// Undoes freeze_results
+result_map thaw_results(const std::string& cold) {
+    if(cold.empty() || (cold[0] && cold.size() < 9))
+        throw std::runtime_error("Cold results are corrupt");
+    std::string_view data(cold);
+    data.remove_prefix(1);
+    std::string inflated;
+    if(cold[0]) {
+        std::uint64_t n = 0;
+        for(int i = 0; i < 8; ++i)
+            n |= std::uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+        const auto* codec = cache::detail_::codec_impl(Codec::fast);
+        inflated          = codec->decompress(data.substr(8), n);
+        data              = inflated;
+    }
+
+    cache::detail_::InputBuffer buffer(data);
+    cereal::BinaryInputArchive ar(buffer.stream());
+    std::uint64_t n = 0;
+    ar >> n;
+    result_map rv;
+    for(std::uint64_t i = 0; i < n; ++i) {
+        std::string name;
+        any_field value;
+        ar >> name >> value;
+        module_result r;
+        r.set_type_and_change(std::make_shared<any_field>(std::move(value)));
+        rv.emplace(std::move(name), std::move(r));
+    }
+    return rv;
+}
+
+// How the in-memory results of a module go cold (see TierPolicy). Serialized
+// results would take about as much memory as inflated ones, so without zlib
+// results don't go cold.
+ColdCodec<result_map> cold_results() {
+    ColdCodec<result_map> rv;
+    if(!with_zlib()) return rv;
+    rv.compress   = freeze_results;
+    rv.decompress = thaw_results;
+    return rv;
+}
+
+// How much memory a module's in-memory results use (see QuotaPolicy)
+std::size_t results_size(const result_map& results) {
+    return pluginplay::memory_footprint(results);
+}
+
+} // namespace
+
+DatabaseFactory::DatabaseFactory() :
+  m_codec_hints_(std::make_shared<CodecHints<uuid>>()),
+  m_dedup_(std::make_shared<DedupTable>()) {
+    set_type_eraser_backend();
+}
 
 DatabaseFactory::DatabaseFactory(const std::string& cache_path,
-                                 const std::string& uuid_path) {
+                                 const std::string& uuid_path) :
+  m_codec_hints_(std::make_shared<CodecHints<uuid>>()),
+  m_dedup_(std::make_shared<DedupTable>()) {
     set_serialized_pm_to_pm(cache_path);
     set_type_eraser_backend(uuid_path);
 }
 
 typename DatabaseFactory::module_db_pointer DatabaseFactory::default_module_db(
-  uuid_type module_uuid) const {
+  uuid_type module_uuid, module_compression_pointer compression,
+  tier_pointer tiers) {
+    return module_db_(pm2result_db(std::move(module_uuid),
+                                   std::move(compression), std::move(tiers)));
+}
+
+typename DatabaseFactory::module_db_pointer DatabaseFactory::memory_module_db(
+  tier_pointer tiers) const {
+    using pm_2_result = NativeHashed<proxy_map, result_map>;
+    return module_db_(std::make_unique<pm_2_result>(
+      nullptr, false, std::move(tiers), cold_results(), results_size));
+}
+
+typename DatabaseFactory::module_db_pointer DatabaseFactory::module_db_(
+  pm_2_result_map_pointer pm2result) const {
     using input_2_any = TypeEraser<module_input, uuid>;
     auto pi2any       = std::make_unique<input_2_any>(m_any2uuid_);
 
+    // Inputs are content-addressed too. Nothing releases an input map's
+    // references, so objects which are also inputs are never freed. Inputs
+    // are reused every time a module is called with them again, so only the
+    // reuse of results is reported as deduplication
     using input_2_uuid = UUIDMapper<module_input>;
-    auto pi2uuid       = std::make_unique<input_2_uuid>(std::move(pi2any));
+    typename input_2_uuid::id_function id;
+    typename input_2_uuid::dedup_pointer dedup;
+    if(m_serial_pm_) {
+        id    = content_id<module_input>;
+        dedup = m_dedup_;
+    }
+    auto pi2uuid = std::make_unique<input_2_uuid>(
+      std::move(pi2any), std::move(id), dedup, m_interns_, false);
 
     using input_2_pm = ProxyMapMaker<input_map>;
     auto pi2pm       = std::make_unique<input_2_pm>(std::move(pi2uuid));
 
     using key_proxy_mapper = KeyProxyMapper<input_map, result_map>;
     return std::make_unique<key_proxy_mapper>(std::move(pi2pm),
-                                              pm2result_db(module_uuid));
+                                              std::move(pm2result));
+}
+
+std::unique_ptr<typename DatabaseFactory::binary_db>
+DatabaseFactory::make_binary_db_(const std::string& name,
+                                 const std::string& path,
+                                 compression_function policy) {
+    const std::filesystem::path root(m_overlay_root_);
+    const bool read_only = m_read_only_;
+    auto open = [&](bool overlay) -> std::unique_ptr<binary_db> {
+        if(!overlay) return open_backend(path, read_only);
+        if(root.empty())
+            return std::make_unique<Native<binary_type, binary_type>>();
+        return open_backend((root / name).string(), false);
+    };
+    return make_binary_db_(name, open, std::move(policy), read_only);
+}
+
+std::unique_ptr<typename DatabaseFactory::binary_db>
+DatabaseFactory::make_binary_db_(const std::string& name,
+                                 const open_function& open,
+                                 compression_function policy, bool read_only) {
+    auto rv = open(false);
+    if(read_only) {
+        using overlay = Overlay<binary_type, binary_type>;
+        rv = std::make_unique<overlay>(std::move(rv), open(true));
+    }
+
+    // Always wrapped, so values compressed by an earlier run can be read
+    using compressed = Compressed<binary_type, binary_type>;
+    rv = std::make_unique<compressed>(std::move(rv), std::move(policy));
+
+    m_write_behind_dbs_.erase(name);
+    if(m_write_behind_.enabled()) {
+        const auto& p = m_write_behind_;
+        auto pwb      = std::make_unique<write_behind_db>(
+          std::move(rv), p.queue_capacity, p.batch_size, p.max_delay);
+        m_write_behind_dbs_[name] = pwb.get();
+        rv                        = std::move(pwb);
+    }
+    m_binary_dbs_[name] = rv.get();
+    return rv;
+}
+
+typename DatabaseFactory::open_function DatabaseFactory::column_family_(
+  std::string family) const {
+    auto base          = m_rocks_cache_;
+    auto overlay       = m_rocks_overlay_;
+    const bool rd_only = m_cache_read_only_;
+    return [=](bool is_overlay) -> std::unique_ptr<binary_db> {
+        // Read-only storage may not have the family, and can't create it
+        const auto& pdb = is_overlay ? overlay : base;
+        if(pdb && (is_overlay || !rd_only || pdb->has_column_family(family)))
+            return pdb->column_family(family);
+        return std::make_unique<Native<binary_type, binary_type>>();
+    };
 }
 
 typename DatabaseFactory::pm_2_result_map_pointer DatabaseFactory::pm2result_db(
-  uuid_type module_uuid) const {
-    // Short-term storage type
-    using pm_2_result = Native<proxy_map, result_map>;
+  uuid_type module_uuid, module_compression_pointer compression,
+  tier_pointer tiers) {
+    // Short-term storage type. Nothing relies on the proxy maps being ordered
+    // so we use a hash table to avoid O(log n) comparisons of whole maps.
+    using pm_2_result = NativeHashed<proxy_map, result_map>;
 
     if(m_serial_pm_) { // This pointer means we have long-term storage
-        const std::string key = "__CACHE__ MODULE NAME __CACHE__";
+        auto pfilter = m_filters_->get(module_uuid);
+
+        // With column families each module's results are kept apart by
+        // RocksDB, otherwise the module is injected into the keys
+        std::unique_ptr<pm_2_pm> pstore;
+        if(m_rocks_cache_) {
+            auto open  = column_family_(family_prefix + module_uuid);
+            auto pdisk = make_binary_db_(table_prefix + module_uuid, open,
+                                         m_cache_compression_,
+                                         m_cache_read_only_);
+            using serial_pm = Serialized<proxy_map, proxy_map>;
+            pstore          = std::make_unique<serial_pm>(std::move(pdisk));
+        } else {
+            // The module is added to each key as it's encoded, so looking up
+            // a key doesn't copy it (as KeyInjector would)
+            using serial_pm = Serialized<proxy_map, proxy_map>;
+            typename serial_pm::field_type field(module_key,
+                                                 std::move(module_uuid));
+            pstore = std::make_unique<serial_pm>(m_cache_db_, std::move(field));
+        }
 
-        using injector_type = KeyInjector<proxy_map, proxy_map>;
-        auto pinjector      = std::make_unique<injector_type>(
-          key, std::move(module_uuid), m_serial_pm_);
+        // Results go in the shared DB, so note how the module wants them
+        // compressed (if it has a preference)
+        auto pany2uuid = m_any2uuid_;
+        if(compression) {
+            using recorder = CodecRecorder<any_field, uuid>;
+            pany2uuid      = std::make_shared<recorder>(
+              std::move(pany2uuid), m_codec_hints_, std::move(compression));
+        }
 
         using result_2_any = TypeEraser<module_result, uuid>;
-        auto pr2any        = std::make_unique<result_2_any>(m_any2uuid_);
+        auto pr2any        = std::make_unique<result_2_any>(pany2uuid);
 
+        // Identical results are stored once and freed when the last result
+        // map referring to them is
         using result_2_uuid = UUIDMapper<module_result>;
-        auto pr2uuid = std::make_unique<result_2_uuid>(std::move(pr2any));
+        auto pr2uuid        = std::make_unique<result_2_uuid>(
+          std::move(pr2any), content_id<module_result>, m_dedup_);
 
+        // Results saved by previous runs are restored from their UUIDs
+        auto uuid2any = m_uuid2any_;
+        auto un_proxy = [uuid2any](const uuid& u) {
+            module_result r;
+            r.set_type_and_change(
+              std::make_shared<any_field>(uuid2any->at(u).get()));
+            return r;
+        };
         using result_2_pm = ProxyMapMaker<result_map>;
-        auto pr2pm        = std::make_unique<result_2_pm>(std::move(pr2uuid));
+        auto pr2pm        = std::make_unique<result_2_pm>(std::move(pr2uuid),
+                                                   std::move(un_proxy));
 
         using value_proxy_mapper = ValueProxyMapper<proxy_map, result_map>;
         auto ppm2r = std::make_unique<value_proxy_mapper>(std::move(pr2pm),
-                                                          std::move(pinjector));
+                                                          std::move(pstore));
 
-        return std::make_unique<pm_2_result>(std::move(ppm2r));
+        // Most lookups of a cold cache are misses, the filter answers those
+        // without going to disk. The saved filters are out of date once a key
+        // is saved, until they are saved again.
+        std::weak_ptr<FilterTable> wfilters = m_filters_;
+        auto invalidate                     = [wfilters]() {
+            if(auto pfilters = wfilters.lock()) pfilters->invalidate_saved();
+        };
+        using filtered = Filtered<proxy_map, result_map>;
+        auto pfiltered = std::make_unique<filtered>(
+          std::move(ppm2r), std::move(pfilter), std::move(invalidate));
+
+        // Reading through means results from previous runs are loaded lazily
+        return std::make_unique<pm_2_result>(std::move(pfiltered), true,
+                                             std::move(tiers), cold_results(),
+                                             results_size);
     }
-    // There's no long-term storage, so we don't actually need the module's uuid
-    return std::make_unique<pm_2_result>();
+    // There's no long-term storage, so we don't actually need the module's
+    // uuid. Without a backup the tiers can't demote, but results can go cold.
+    return std::make_unique<pm_2_result>(nullptr, false, std::move(tiers),
+                                         cold_results(), results_size);
 }
 
 void DatabaseFactory::set_serialized_pm_to_pm(const std::string& path) {
-    using rocks_db = RocksDB<binary_type, binary_type>;
-    auto pRDB_io   = std::make_unique<rocks_db>(path);
+    const bool fresh     = !std::filesystem::exists(path);
+    auto policy          = m_compression_;
+    m_cache_compression_ = [policy](const binary_type&) { return policy; };
+    m_cache_read_only_   = m_read_only_;
+
+    // The modules' column families belong to the previous storage
+    for(auto itr = m_binary_dbs_.begin(); itr != m_binary_dbs_.end();) {
+        if(strip_prefix(itr->first, table_prefix).empty()) {
+            ++itr;
+            continue;
+        }
+        m_write_behind_dbs_.erase(itr->first);
+        itr = m_binary_dbs_.erase(itr);
+    }
+
+    m_rocks_cache_.reset();
+    m_rocks_overlay_.reset();
+    std::unique_ptr<binary_db> pdisk;
+    if constexpr(with_rocksdb_v) {
+        auto defaults = m_rocksdb_options_;
+        auto modules  = m_module_rocksdb_options_;
+        auto options  = [defaults, modules](const std::string& family) {
+            auto itr = modules.find(strip_prefix(family, family_prefix));
+            return itr == modules.end() ? defaults : itr->second;
+        };
+        m_rocks_cache_ =
+          std::make_shared<rocks_db>(path, m_read_only_, options);
+        if(m_read_only_ && !m_overlay_root_.empty()) {
+            const auto p = std::filesystem::path(m_overlay_root_) / "cache";
+            m_rocks_overlay_ =
+              std::make_shared<rocks_db>(p.string(), false, options);
+        }
+        pdisk = make_binary_db_("cache", column_family_(default_family),
+                                m_cache_compression_, m_read_only_);
+    } else {
+        pdisk = make_binary_db_("cache", path, m_cache_compression_);
+    }
 
     using serial_pm = Serialized<proxy_map, proxy_map>;
-    m_serial_pm_    = std::make_shared<serial_pm>(std::move(pRDB_io));
+    m_cache_db_     = std::move(pdisk);
+    m_serial_pm_    = std::make_shared<serial_pm>(m_cache_db_);
+
+    // Storage without a format was saved by an earlier version (or is new)
+    if(m_cache_db_->count(format_key)) {
+        if(m_cache_db_->at(format_key).get() != format_version)
+            throw std::runtime_error("The cache at " + path +
+                                     " was saved in an unknown format");
+    } else {
+        if(!fresh) upgrade_keys_();
+        if(!m_cache_read_only_) {
+            m_cache_db_->insert(format_key, format_version);
+            m_cache_db_->backup();
+            flush();
+        }
+    }
+
+    // The filters are saved next to the storage (or its overlay)
+    std::string save_dir = path + "_filters";
+    std::string shared_dir;
+    if(m_read_only_) {
+        namespace fs = std::filesystem;
+        const fs::path root(m_overlay_root_);
+        shared_dir = std::move(save_dir);
+        save_dir   = root.empty() ? "" : (root / "cache_filters").string();
+    }
+    std::weak_ptr<pm_2_pm> wdb = m_serial_pm_;
+    std::vector<std::weak_ptr<rocks_db>> wrocks{m_rocks_cache_,
+                                                m_rocks_overlay_};
+    auto scan = [wdb, wrocks]() {
+        FilterTable::saved_keys rv;
+        if(auto pdb = wdb.lock())
+            for(auto c = pdb->cursor(); c->valid(); c->next())
+                rv.push_back(module_key_hash(c->key()));
+        for(const auto& wrock : wrocks) {
+            auto procks = wrock.lock();
+            if(!procks) continue;
+            for(const auto& family : procks->column_families()) {
+                auto module = strip_prefix(family, family_prefix);
+                if(module.empty()) continue;
+                Serialized<proxy_map, proxy_map> db(
+                  procks->column_family(family));
+                for(auto c = db.cursor(); c->valid(); c->next())
+                    rv.emplace_back(module, DBHash<proxy_map>{}(c->key()));
+            }
+        }
+        return rv;
+    };
+    const auto check = DBHash<proxy_map>{}(proxy_map{{"check", "filter"}});
+    m_filters_       = std::make_shared<FilterTable>(
+      std::move(save_dir), std::move(shared_dir), check, fresh, scan);
+}
+
+void DatabaseFactory::upgrade_keys_() {
+    // Keys serialized by cereal start with neither of ProxyMapCodec's markers.
+    // Only they are held, since writing invalidates the cursor.
+    std::vector<binary_type> legacy;
+    for(auto c = m_cache_db_->cursor(); c->valid(); c->next()) {
+        const auto& k = c->key();
+        if(!ProxyMapCodec::is_encoded(k) && !ProxyMapCodec::is_name(k))
+            legacy.push_back(k);
+    }
+    if(legacy.empty()) return;
+    if(m_cache_read_only_)
+        throw std::runtime_error(
+          "The cache was saved by an earlier version of PluginPlay. It must "
+          "be opened for writing once, so it can be upgraded.");
+
+    // Earlier versions kept every module's results in the default column
+    // family, the key's module field says which family they now belong in
+    using serial_pm  = Serialized<proxy_map, proxy_map>;
+    using compressed = Compressed<binary_type, binary_type>;
+    std::map<uuid, std::unique_ptr<pm_2_pm>> families;
+    for(const auto& k : legacy) {
+        auto key   = deserialize_key<proxy_map>(k);
+        auto value = deserialize_key<proxy_map>(m_cache_db_->at(k).get());
+        if(m_rocks_cache_) {
+            auto node = key.extract(module_key);
+            if(node.empty())
+                throw std::runtime_error("Proxy map has no module");
+            auto& pdb = families[node.mapped()];
+            if(!pdb) {
+                auto family = family_prefix + node.mapped();
+                auto pdisk  = std::make_unique<compressed>(
+                  m_rocks_cache_->column_family(family), m_cache_compression_);
+                pdb = std::make_unique<serial_pm>(std::move(pdisk));
+            }
+            pdb->insert(std::move(key), std::move(value));
+        } else {
+            m_serial_pm_->insert(std::move(key), std::move(value));
+        }
+        m_cache_db_->free(k);
+    }
+    for(const auto& [_, pdb] : families) pdb->backup();
+    m_serial_pm_->backup();
+    flush();
 }
 
 void DatabaseFactory::set_type_eraser_backend() {
@@ -105,21 +547,179 @@ void DatabaseFactory::set_type_eraser_backend() {
     auto puuid2any   = std::make_unique<uuid_2_any>();
 
     using transposer = Transposer<any_field, uuid>;
-    m_any2uuid_      = std::make_shared<transposer>(std::move(puuid2any));
+    auto ptransposer = std::make_shared<transposer>(std::move(puuid2any));
+    const auto& uuid2any = ptransposer->transposed_db();
+    m_uuid2any_          = uuid_2_any_pointer(ptransposer, &uuid2any);
+    m_any2uuid_          = std::move(ptransposer);
+    m_interns_           = std::make_shared<InternTable>();
+    for(const auto name : {"uuid", "uuid_index"}) {
+        m_binary_dbs_.erase(name);
+        m_write_behind_dbs_.erase(name);
+    }
 }
 
 void DatabaseFactory::set_type_eraser_backend(const std::string& path) {
-    using rocks_db = RocksDB<binary_type, binary_type>;
-    auto pRDB_uuid = std::make_unique<rocks_db>(path);
+    auto policy = m_compression_;
+    auto fixed  = [policy](const binary_type&) { return policy; };
+
+    // The values of modules with their own policy are compressed per it
+    auto hints = m_codec_hints_;
+    auto hint  = [hints, policy](const binary_type& key) {
+        if(hints->empty()) return policy;
+        return hints->get(deserialize_key<uuid>(key), policy);
+    };
+
+    auto pdisk = make_binary_db_("uuid", path, std::move(hint));
+    auto pidx  = make_binary_db_("uuid_index", path + "_index", fixed);
 
     using serial_uuid2any = Serialized<uuid, any_field>;
-    auto pserial_uuid = std::make_unique<serial_uuid2any>(std::move(pRDB_uuid));
+    auto pserial_uuid = std::make_unique<serial_uuid2any>(std::move(pdisk));
 
+    // Values are only deserialized when they are needed
     using uuid_2_any = Native<uuid, any_field>;
-    auto puuid2any   = std::make_unique<uuid_2_any>(std::move(pserial_uuid));
+    auto puuid2any =
+      std::make_unique<uuid_2_any>(std::move(pserial_uuid), true);
+
+    // Lets objects saved by previous runs be found without a linear search
+    using serial_any2uuid = Serialized<any_field, uuid>;
+    auto pindex           = std::make_unique<serial_any2uuid>(std::move(pidx));
 
     using transposer = Transposer<any_field, uuid>;
-    m_any2uuid_      = std::make_shared<transposer>(std::move(puuid2any));
+    auto ptransposer =
+      std::make_shared<transposer>(std::move(puuid2any), std::move(pindex));
+    const auto& uuid2any = ptransposer->transposed_db();
+    m_uuid2any_          = uuid_2_any_pointer(ptransposer, &uuid2any);
+    m_any2uuid_          = std::move(ptransposer);
+    m_interns_           = std::make_shared<InternTable>();
+}
+
+void DatabaseFactory::backup() {
+    if(m_any2uuid_) m_any2uuid_->backup();
+    if(m_serial_pm_) m_serial_pm_->backup();
+    if(m_filters_) m_filters_->save();
+}
+
+void DatabaseFactory::drop_module(const uuid_type& module_uuid) {
+    if(!m_serial_pm_) return;
+    if(m_cache_read_only_)
+        throw std::runtime_error("Results can not be dropped from read-only "
+                                 "storage");
+
+    // Writes still in flight would otherwise land after the drop
+    flush();
+    if(m_rocks_cache_) {
+        m_rocks_cache_->drop_column_family(family_prefix + module_uuid);
+        return;
+    }
+
+    // Otherwise the module's results are mixed in with everyone else's. Only
+    // the module's keys are held, since freeing invalidates the cursor.
+    std::vector<proxy_map> dropped;
+    for(auto c = m_serial_pm_->cursor(); c->valid(); c->next()) {
+        const auto& key = c->key();
+        auto itr        = key.find(module_key);
+        if(itr != key.end() && itr->second == module_uuid)
+            dropped.push_back(key);
+    }
+    for(const auto& key : dropped) m_serial_pm_->free(key);
+    m_serial_pm_->backup();
+    flush();
+}
+
+typename DatabaseFactory::binary_tables DatabaseFactory::export_tables() const {
+    binary_tables rv;
+    for(const auto& [name, pdb] : m_binary_dbs_) {
+        auto& records = rv[name];
+        for(auto c = pdb->cursor(); c->valid(); c->next()) {
+            const auto& k = c->key();
+            records.emplace_back(k, pdb->at(k).get());
+        }
+    }
+    return rv;
+}
+
+void DatabaseFactory::import_tables(const binary_tables& tables) {
+    // With column families, tables of modules which weren't made are fine
+    auto is_module = [this](const std::string& name) {
+        return m_rocks_cache_ && !strip_prefix(name, table_prefix).empty();
+    };
+    for(const auto& [name, _] : tables)
+        if(!m_binary_dbs_.count(name) && !is_module(name))
+            throw std::runtime_error("No long-term storage database named: " +
+                                     name);
+
+    // The saved filters won't know about the restored keys until saved again
+    if(m_filters_) m_filters_->invalidate_saved();
+
+    // The column families opened here are closed when we're done
+    std::vector<std::unique_ptr<binary_db>> opened;
+    auto forget_opened = [&]() {
+        for(const auto& pdb : opened) {
+            for(auto itr = m_binary_dbs_.begin(); itr != m_binary_dbs_.end();
+                ++itr) {
+                if(itr->second != pdb.get()) continue;
+                m_write_behind_dbs_.erase(itr->first);
+                m_binary_dbs_.erase(itr);
+                break;
+            }
+        }
+    };
+    try {
+        for(const auto& [name, records] : tables) {
+            if(!m_binary_dbs_.count(name)) {
+                const auto module = strip_prefix(name, table_prefix);
+                auto open         = column_family_(family_prefix + module);
+                opened.push_back(make_binary_db_(
+                  name, open, m_cache_compression_, m_cache_read_only_));
+            }
+            auto& db = *m_binary_dbs_.at(name);
+            for(const auto& [k, v] : records) db.insert(k, v);
+            db.backup();
+        }
+        flush();
+    } catch(...) {
+        forget_opened();
+        throw;
+    }
+    forget_opened();
+
+    // Results exported by an earlier version are in its format
+    if(m_cache_db_ && tables.count("cache")) upgrade_keys_();
+
+    // The restored keys bypassed the modules' databases, and their filters
+    if(!m_filters_) return;
+    for(const auto& [name, records] : tables) {
+        const auto module = strip_prefix(name, table_prefix);
+        if(name != "cache" && module.empty()) continue;
+
+        // The field names the keys are encoded with are among the records
+        Native<binary_type, binary_type> names;
+        for(const auto& [k, v] : records)
+            if(ProxyMapCodec::is_name(k)) names.insert(k, v);
+        ProxyMapCodec codec(names);
+
+        for(const auto& [k, _] : records) {
+            if(ProxyMapCodec::is_name(k)) continue;
+            auto key = ProxyMapCodec::is_encoded(k) ?
+                         codec.decode(k) :
+                         deserialize_key<proxy_map>(k);
+            if(!module.empty()) {
+                m_filters_->add(module, DBHash<proxy_map>{}(key));
+                continue;
+            }
+            auto [m, h] = module_key_hash(std::move(key));
+            m_filters_->add(m, h);
+        }
+    }
+}
+
+void DatabaseFactory::set_compression_policy(CompressionPolicy policy) {
+    cache::detail_::assert_codecs_available(policy);
+    m_compression_ = std::move(policy);
+}
+
+void DatabaseFactory::flush() {
+    for(auto& [_, pdb] : m_write_behind_dbs_) pdb->flush();
 }
 
 } // namespace pluginplay::cache::database
@@ -15,11 +15,25 @@
  */
 
 #pragma once
+#include "../dedup_table.hpp"
+#include "../intern_table.hpp"
 #include "../proxy_map_maker.hpp"
+#include "codec_hints.hpp"
 #include "database_api.hpp"
+#include "filter_table.hpp"
+#include "rocksdb/rocksdb.hpp"
+#include "tier_state.hpp"
+#include "write_behind.hpp"
+#include <functional>
+#include <map>
 #include <memory>
+#include <optional>
+#include <pluginplay/cache/compression_policy.hpp>
+#include <pluginplay/cache/rocksdb_options.hpp>
+#include <pluginplay/cache/write_behind_policy.hpp>
 #include <pluginplay/fields/fields.hpp>
 #include <pluginplay/types.hpp>
+#include <vector>
 
 namespace pluginplay::cache::database {
 
@@ -46,6 +60,10 @@ namespace pluginplay::cache::database {
  *  Each factory maintains its own copies of these pointers and injects the
  *  copies it holds.
  *
+ *  If the long-term storage is a RocksDB database, the second piece is only
+ *  shared in the sense that every module's results live in the same database.
+ *  Each module gets its own column family, so its keys don't need to name the
+ *  module, and its I/O can be tuned separately (see set_rocksdb_options).
  */
 class DatabaseFactory {
 public:
@@ -94,12 +112,43 @@ public:
     /// Type of a pointer to the DB satisfying any_2_uuid
     using any_2_uuid_pointer = std::shared_ptr<any_2_uuid>;
 
+    /// Type of the DB storing the proxy-to-object relationships
+    using uuid_2_any = DatabaseAPI<uuid_type, any_type>;
+
+    /// Type of a read-only pointer to the DB satisfying uuid_2_any
+    using uuid_2_any_pointer = std::shared_ptr<const uuid_2_any>;
+
     /// Type of a DB that can map proxy maps to result maps
     using pm_2_result_map = DatabaseAPI<proxy_map_type, result_map_type>;
 
     /// Type of a pointer to a pm_2_result_map DB
     using pm_2_result_map_pointer = std::unique_ptr<pm_2_result_map>;
 
+    /// Type of the DBs which actually write to long-term storage
+    using binary_db = DatabaseAPI<binary_type, binary_type>;
+
+    /// Type of the records of a binary_db
+    using binary_records = std::vector<std::pair<binary_type, binary_type>>;
+
+    /// Type of a map from the names of the binary_db instances to their records
+    using binary_tables = std::map<std::string, binary_records>;
+
+    /// Type of the wrapper which writes to a binary_db in the background
+    using write_behind_db = WriteBehind<binary_type, binary_type>;
+
+    /// Type of a module's compression policy, empty means use the default
+    using module_compression = std::optional<CompressionPolicy>;
+
+    /// Type of a pointer to a module's compression policy
+    using module_compression_pointer =
+      std::shared_ptr<const module_compression>;
+
+    /// Type of a pointer to the state of a module's in-memory tier
+    using tier_pointer = std::shared_ptr<TierState>;
+
+    /// Type of the RocksDB databases used for long-term storage
+    using rocks_db = RocksDB<binary_type, binary_type>;
+
     /** @brief Creates a new DatabaseFactory which doesn't have any long-term
      *         storage.
      *
@@ -137,9 +186,50 @@ public:
      *
      *  @param[in] module_uuid This method generates a database backend specific
      *                         to the module with this UUID.
+     *  @param[in] compression If non-null, and if this factory has long-term
+     *                         storage, the module's results are compressed
+     *                         according to the policy @p compression points
+     *                         to (at the time the results are saved), rather
+     *                         than the factory's policy. Default is null.
+     *  @param[in] tiers If non-null, and if this factory has long-term
+     *                   storage, the in-memory results are treated as a tier
+     *                   in front of the long-term storage whose size is
+     *                   limited by, and whose promotions/demotions are
+     *                   counted by, @p tiers. With or without long-term
+     *                   storage, @p tiers also says when in-memory results go
+     *                   cold. Default is null.
+     *
+     */
+    module_db_pointer default_module_db(
+      uuid_type module_uuid,
+      module_compression_pointer compression = nullptr,
+      tier_pointer tiers                     = nullptr);
+
+    /** @brief Makes a Database backend for a module which is never archived.
+     *
+     *  The resulting database shares the object-to-UUID database with the
+     *  databases made by default_module_db, but the results stored in it
+     *  only live in memory, even if this factory has long-term storage. Module
+     *  caches use this database for results which are not worth archiving.
      *
+     *  @param[in] tiers If non-null, the results in the database go cold as
+     *                   @p tiers says (they're never demoted since there's no
+     *                   long-term storage). Default is null.
+     *
+     *  @return A database for a module cache without long-term storage.
      */
-    module_db_pointer default_module_db(uuid_type module_uuid) const;
+    module_db_pointer memory_module_db(tier_pointer tiers = nullptr) const;
+
+    /** @brief Do the databases made by this factory have long-term storage?
+     *
+     *  @return True if default_module_db makes databases which are backed up
+     *          to long-term storage and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool has_long_term_storage() const noexcept {
+        return static_cast<bool>(m_serial_pm_);
+    }
 
     /** @brief Wraps the process of making a DB that can go from proxy maps to
      *         result maps.
@@ -151,7 +241,10 @@ public:
      *
      *
      */
-    pm_2_result_map_pointer pm2result_db(uuid_type module_uuid) const;
+    pm_2_result_map_pointer pm2result_db(
+      uuid_type module_uuid,
+      module_compression_pointer compression = nullptr,
+      tier_pointer tiers                     = nullptr);
 
     /** @brief Allows the user to change where the proxy map to proxy map
      *         database is stored.
@@ -160,8 +253,22 @@ public:
      *       location will not invalidate references being used by already
      *       created databases.
      *
+     *  N.B. The Bloom filters the module databases use to skip lookups of
+     *       missing keys are saved in the directory "<path>_filters" (see
+     *       FilterTable). When the storage is read-only they are instead
+     *       loaded from there and saved to the overlay root (if any).
+     *
+     *  N.B. The storage records the format its keys are saved in. Storage
+     *       saved by an earlier version of PluginPlay (i.e., with keys
+     *       serialized by cereal and, with RocksDB, every module's results in
+     *       the default column family) is upgraded when it's opened.
+     *
      *  @param[in] path Where on the filesystem the database should live.
      *
+     *  @throw std::runtime_error if the storage was saved by an earlier
+     *                            version and is opened read-only, so it can't
+     *                            be upgraded, or if it was saved in a format
+     *                            this version doesn't know.
      */
     void set_serialized_pm_to_pm(const std::string& path);
 
@@ -178,16 +285,312 @@ public:
      *       location will not invalidate references being used by already
      *       created databases.
      *
+     *  N.B. The Bloom filters the module databases use to skip lookups of
+     *       missing keys are saved in the directory "<path>_filters" (see
+     *       FilterTable). When the storage is read-only they are instead
+     *       loaded from there and saved to the overlay root (if any).
+     *
      *  @param[in] path Where on the filesystem the database should live.
      */
     void set_type_eraser_backend(const std::string& path);
 
+    /** @brief Saves the shared databases to long-term storage.
+     *
+     *  The databases made by this factory share the object-to-UUID database
+     *  and (if this factory has long-term storage) the proxy map to proxy map
+     *  database. This method backs up those shared databases. It is a no-op
+     *  for databases without long-term storage.
+     *
+     *  N.B. The module-specific parts of the databases made by this factory
+     *       are backed up by calling backup on those databases.
+     *
+     *  @throw ??? If the backends throw. Same throw guarantee.
+     */
+    void backup();
+
+    /** @brief Copies the contents of the long-term storage.
+     *
+     *  The long-term storage of the databases made by this factory consists
+     *  of several databases which map binary keys to binary values. This
+     *  method returns the records of each of those databases, keyed by the
+     *  database's name ("cache", "uuid", "uuid_index", and, if the long-term
+     *  storage is a RocksDB database, "cache/<module>" for each module whose
+     *  column family has been opened). Only what has been backed up is
+     *  included, i.e., call backup on the module databases and this factory
+     *  first.
+     *
+     *  @return The records of each long-term storage database. The result is
+     *          empty if this factory has no long-term storage.
+     *
+     *  @throw ??? If the backends throw. Strong throw guarantee.
+     */
+    binary_tables export_tables() const;
+
+    /** @brief Adds records to the long-term storage.
+     *
+     *  This is the inverse of export_tables. Records in @p tables overwrite
+     *  records in the long-term storage with the same key. Since the databases
+     *  made by this factory read through to their long-term storage, the
+     *  imported records are visible to already created databases, unless a
+     *  database already has an entry for the same key in memory. Tables of
+     *  modules whose column family has not been opened yet are imported too.
+     *  Results exported by an earlier version of PluginPlay are upgraded as
+     *  they are imported (see set_serialized_pm_to_pm).
+     *
+     *  @param[in] tables The records to add, keyed by the name of the database
+     *                    they belong to.
+     *
+     *  @throw std::runtime_error if this factory has no long-term storage or
+     *                            @p tables contains a database this factory
+     *                            does not have. Strong throw guarantee.
+     *  @throw std::runtime_error if @p tables holds results exported by an
+     *                            earlier version and the long-term storage
+     *                            is read-only. Weak throw guarantee.
+     *  @throw ??? If the backends throw. Weak throw guarantee.
+     */
+    void import_tables(const binary_tables& tables);
+
+    /** @brief Sets how long-term storage opened from now on is written to.
+     *
+     *  If @p policy is enabled, the databases which write to long-term storage
+     *  are wrapped in WriteBehind instances, i.e., writes to long-term storage
+     *  are performed on a background thread. Objects are still serialized by
+     *  the thread which writes to the databases made by this factory, only the
+     *  actual writing is deferred.
+     *
+     *  N.B. Like the rest of the factory's state, @p policy only applies to
+     *       long-term storage set after this call (i.e., by later calls to
+     *       set_serialized_pm_to_pm or set_type_eraser_backend).
+     *
+     *  @param[in] policy How to write to long-term storage.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_write_behind_policy(WriteBehindPolicy policy) noexcept {
+        m_write_behind_ = policy;
+    }
+
+    /** @brief Sets how values written to long-term storage opened from now on
+     *         are compressed.
+     *
+     *  Like set_write_behind_policy, @p policy only applies to long-term
+     *  storage set after this call. Modules can override the policy for their
+     *  results (see default_module_db).
+     *
+     *  @param[in] policy How to compress the values.
+     *
+     *  @throw std::runtime_error if @p policy compresses values and
+     *                            PluginPlay was not built with zlib. Strong
+     *                            throw guarantee.
+     */
+    void set_compression_policy(CompressionPolicy policy);
+
+    /** @brief Sets whether long-term storage opened from now on is opened
+     *         read-only.
+     *
+     *  Most persistent backends only let one process open a database for
+     *  writing. If @p read_only is true, long-term storage set after this call
+     *  is instead opened read-only, which any number of processes can do at
+     *  once, and is layered under a writable overlay (see Overlay). Objects
+     *  already in the read-only storage are found as usual, while everything
+     *  this process saves goes to the overlay.
+     *
+     *  @param[in] read_only Should long-term storage be opened read-only?
+     *  @param[in] overlay_root The directory the overlays are saved in. Each
+     *                          database gets a subdirectory named after it
+     *                          (see export_tables). If empty (the default),
+     *                          the overlays only live in memory. Ignored if
+     *                          @p read_only is false.
+     *
+     *  @throw std::bad_alloc if there is a problem copying @p overlay_root.
+     *                        Strong throw guarantee.
+     */
+    void set_read_only_storage(bool read_only, std::string overlay_root = "") {
+        m_read_only_    = read_only;
+        m_overlay_root_ = std::move(overlay_root);
+    }
+
+    /** @brief Sets how RocksDB stores results in long-term storage opened
+     *         from now on.
+     *
+     *  Like set_compression_policy, @p options only applies to long-term
+     *  storage set after this call. They apply to the column families of
+     *  modules which don't have their own options. This is a no-op if
+     *  PluginPlay was built without RocksDB.
+     *
+     *  @param[in] options The RocksDB options to use.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_rocksdb_options(RocksDBOptions options) noexcept {
+        m_rocksdb_options_ = options;
+    }
+
+    /** @brief Sets how RocksDB stores the results of one module in long-term
+     *         storage opened from now on.
+     *
+     *  @param[in] module_uuid The module whose results @p options apply to.
+     *  @param[in] options The RocksDB options of the module's column family.
+     *
+     *  @throw std::bad_alloc if there is a problem storing @p options. Strong
+     *                        throw guarantee.
+     */
+    void set_rocksdb_options(uuid_type module_uuid, RocksDBOptions options) {
+        m_module_rocksdb_options_[std::move(module_uuid)] = options;
+    }
+
+    /** @brief Deletes a module's results from long-term storage.
+     *
+     *  If the long-term storage is a RocksDB database this drops the module's
+     *  column family, which takes the same time no matter how many results
+     *  the module has. Otherwise the module's results are deleted one at a
+     *  time. Databases already made for the module remain usable, but their
+     *  in-memory results are unaffected (see ModuleCache::clear). This is a
+     *  no-op if this factory has no long-term storage.
+     *
+     *  @param[in] module_uuid The module whose results should be deleted.
+     *
+     *  @throw std::runtime_error if the long-term storage was opened
+     *                            read-only. Strong throw guarantee.
+     *  @throw ??? If the backends throw. Weak throw guarantee.
+     */
+    void drop_module(const uuid_type& module_uuid);
+
+    /** @brief Returns the references to the objects in long-term storage.
+     *
+     *  If this factory has long-term storage, inputs and results are assigned
+     *  UUIDs derived from their serialized forms, so identical objects are
+     *  only stored once, no matter which module (or run) produced them. The
+     *  returned table counts the references the databases made by this
+     *  factory hold to those objects, and how much storage sharing them saved.
+     *
+     *  @return The reference counts of the objects in long-term storage.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const DedupTable& dedup_table() const noexcept { return *m_dedup_; }
+
+    /** @brief Returns the table hash-consing the module inputs.
+     *
+     *  Inputs whose values the databases made by this factory matched to a
+     *  UUID are made to share one instance of each value. The returned table
+     *  records those instances, and how many inputs started sharing them.
+     *
+     *  @return The table of shared input values.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const InternTable& intern_table() const noexcept { return *m_interns_; }
+
+    /** @brief Is long-term storage written to on a background thread?
+     *
+     *  @return True if any of the databases writing to long-term storage do so
+     *          on a background thread and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool write_behind() const noexcept { return !m_write_behind_dbs_.empty(); }
+
+    /** @brief Waits for all writes to long-term storage to be performed.
+     *
+     *  This is a no-op unless write_behind() is true.
+     *
+     *  @throw ??? Rethrows the first exception raised while writing to
+     *             long-term storage on the background thread.
+     */
+    void flush();
+
 private:
+    // Wraps a proxy map to result map DB so it can take input maps as keys
+    module_db_pointer module_db_(pm_2_result_map_pointer pm2result) const;
+
+    // Type of a function returning how to compress the value of a binary key
+    using compression_function =
+      std::function<CompressionPolicy(const binary_type&)>;
+
+    // Type of a function opening a backend, or its overlay if passed true
+    using open_function =
+      std::function<std::unique_ptr<binary_db>(bool overlay)>;
+
+    // Makes the DB which writes to @p path, registering it under @p name
+    std::unique_ptr<binary_db> make_binary_db_(const std::string& name,
+                                               const std::string& path,
+                                               compression_function policy);
+
+    // Makes the DB @p open opens, registering it under @p name
+    std::unique_ptr<binary_db> make_binary_db_(const std::string& name,
+                                               const open_function& open,
+                                               compression_function policy,
+                                               bool read_only);
+
+    // Opens column family @p family of the RocksDB long-term storage
+    open_function column_family_(std::string family) const;
+
+    // Moves results saved by an earlier version to where they're saved now
+    void upgrade_keys_();
+
     // The common proxy map to proxy map database used by each module's cache
     serial_pm_pointer m_serial_pm_;
 
+    // The database m_serial_pm_ wraps. Without column families, the modules'
+    // caches save their results in it directly (see pm2result_db)
+    std::shared_ptr<binary_db> m_cache_db_;
+
     // The common AnyField to UUID database
     any_2_uuid_pointer m_any2uuid_;
+
+    // The inverse of m_any2uuid_, used to restore results saved by other runs
+    uuid_2_any_pointer m_uuid2any_;
+
+    // The databases writing to long-term storage, keyed by name. They are
+    // owned by (the databases wrapped by) m_serial_pm_ and m_any2uuid_
+    std::map<std::string, binary_db*> m_binary_dbs_;
+
+    // How long-term storage set from now on is written to
+    WriteBehindPolicy m_write_behind_;
+
+    // The subset of m_binary_dbs_ which write in the background
+    std::map<std::string, write_behind_db*> m_write_behind_dbs_;
+
+    // How values in long-term storage set from now on are compressed
+    CompressionPolicy m_compression_;
+
+    // How modules with their own compression policy want their results
+    // compressed, keyed by the results' UUIDs
+    std::shared_ptr<CodecHints<uuid_type>> m_codec_hints_;
+
+    // Is long-term storage set from now on opened read-only?
+    bool m_read_only_ = false;
+
+    // Where the overlays of read-only storage are saved, empty means memory
+    std::string m_overlay_root_;
+
+    // Counts references to the content-addressed objects
+    std::shared_ptr<DedupTable> m_dedup_;
+
+    // Hash-conses the inputs. The UUIDs are those of the current type eraser
+    // backend, so each backend gets its own table
+    std::shared_ptr<InternTable> m_interns_ = std::make_shared<InternTable>();
+
+    // The Bloom filters of the modules' saved results
+    std::shared_ptr<FilterTable> m_filters_;
+
+    // The RocksDB database the modules' results are saved in, and its
+    // overlay (if it's read-only). Null unless RocksDB is the backend
+    std::shared_ptr<rocks_db> m_rocks_cache_;
+    std::shared_ptr<rocks_db> m_rocks_overlay_;
+
+    // How values of the proxy map to proxy map storage are compressed
+    compression_function m_cache_compression_;
+
+    // Was the proxy map to proxy map storage opened read-only?
+    bool m_cache_read_only_ = false;
+
+    // The RocksDB options of storage set from now on
+    RocksDBOptions m_rocksdb_options_;
+
+    // The RocksDB options of the modules with their own options
+    std::map<uuid_type, RocksDBOptions> m_module_rocksdb_options_;
 };
 
 } // namespace pluginplay::cache::database
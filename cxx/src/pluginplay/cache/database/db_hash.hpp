@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <utility>
+
+namespace pluginplay::cache::database {
+
+/** @brief Mixes the hash @p value into the running hash @p seed.
+ *
+ *  This is the same mixing function used by boost::hash_combine. It is
+ *  order-dependent, which is what we want for hashing ordered containers.
+ *
+ *  @param[in,out] seed The running hash. On output @p value has been mixed in.
+ *  @param[in] value The hash to mix into @p seed.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline void hash_combine(std::size_t& seed, std::size_t value) noexcept {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+/** @brief Functor used by the hashed database backends to hash keys.
+ *
+ *  The primary template simply defers to std::hash. Key types which std::hash
+ *  does not know about (most notably std::map, which is the type of a proxy
+ *  map) are handled by specializing this class. Specializations must be
+ *  consistent with the key type's operator==, i.e., equal keys must hash to
+ *  the same value.
+ *
+ *  @tparam T The type of the object being hashed.
+ */
+template<typename T>
+struct DBHash {
+    std::size_t operator()(const T& value) const noexcept {
+        return std::hash<T>{}(value);
+    }
+};
+
+/** @brief Hashes an std::map by combining the hashes of its elements.
+ *
+ *  std::map's operator== compares the elements in iteration order, so the
+ *  hash is computed by combining the key and value hashes in iteration order.
+ *
+ *  @tparam KeyType The type of the map's keys.
+ *  @tparam MappedType The type of the map's values.
+ *  @tparam Compare The comparison used to order the map.
+ *  @tparam Allocator The allocator used by the map.
+ */
+template<typename KeyType, typename MappedType, typename Compare,
+         typename Allocator>
+struct DBHash<std::map<KeyType, MappedType, Compare, Allocator>> {
+    using map_type = std::map<KeyType, MappedType, Compare, Allocator>;
+
+    std::size_t operator()(const map_type& map) const noexcept {
+        std::size_t seed = map.size();
+        for(const auto& [k, v] : map) {
+            hash_combine(seed, DBHash<KeyType>{}(k));
+            hash_combine(seed, DBHash<MappedType>{}(v));
+        }
+        return seed;
+    }
+};
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filter_table.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace pluginplay::cache::database {
+namespace {
+
+// Sentinel size of a filter which was never saved
+constexpr auto unsaved = static_cast<std::size_t>(-1);
+
+// Name of the file marking a directory's filters as complete
+constexpr const char* complete_marker = "complete";
+
+// FNV-1a hash, used to turn module names into file names
+std::uint64_t fnv1a(std::string_view data) noexcept {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for(unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Where the filter of @p module lives in @p dir
+std::filesystem::path filter_path(const std::string& dir,
+                                  const std::string& module) {
+    std::stringstream ss;
+    ss << std::hex << fnv1a(module) << ".bloom";
+    return std::filesystem::path(dir) / ss.str();
+}
+
+} // namespace
+
+FilterTable::FilterTable(scan_function scan) noexcept :
+  m_scan_(std::move(scan)), m_complete_(!m_scan_) {}
+
+FilterTable::FilterTable(std::string save_dir, std::string shared_dir,
+                         hash_type check, bool fresh, scan_function scan) :
+  m_save_dir_(std::move(save_dir)),
+  m_shared_dir_(std::move(shared_dir)),
+  m_check_(check),
+  m_scan_(std::move(scan)),
+  m_complete_(fresh || !m_scan_) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto marked = [&ec](const std::string& dir) {
+        return !dir.empty() && fs::exists(fs::path(dir) / complete_marker, ec);
+    };
+    // A save directory without the marker means keys were saved after the
+    // filters (the directory is made before the first key is saved)
+    const bool save_ok   = m_save_dir_.empty() || marked(m_save_dir_) ||
+                         !fs::exists(m_save_dir_, ec);
+    const bool shared_ok = m_shared_dir_.empty() || marked(m_shared_dir_);
+    m_loadable_          = save_ok && shared_ok;
+    if(m_loadable_ && (marked(m_save_dir_) || marked(m_shared_dir_)))
+        m_complete_ = true;
+}
+
+typename FilterTable::filter_pointer FilterTable::get(
+  const std::string& module) {
+    auto itr = m_filters_.find(module);
+    if(itr != m_filters_.end()) return itr->second.first;
+
+    // Filters in m_save_dir_ are only written again once they change
+    filter_pointer rv;
+    if(m_loadable_) rv = load_(m_save_dir_, module);
+    auto saved_size = rv ? rv->size() : unsaved;
+    if(!rv && m_loadable_) rv = load_(m_shared_dir_, module);
+    if(!rv && m_complete_) rv = std::make_shared<BloomFilter>();
+    if(!rv) rv = from_scan_(module);
+    m_filters_.emplace(module, std::make_pair(rv, saved_size));
+    return rv;
+}
+
+void FilterTable::add(const std::string& module, hash_type h) {
+    if(auto pfilter = get(module)) pfilter->insert(h);
+}
+
+void FilterTable::invalidate_saved() {
+    if(m_save_dir_.empty() || m_invalidated_) return;
+    namespace fs = std::filesystem;
+    fs::create_directories(m_save_dir_);
+    fs::remove(fs::path(m_save_dir_) / complete_marker);
+    m_invalidated_ = true;
+}
+
+void FilterTable::save() {
+    if(m_save_dir_.empty()) return;
+    namespace fs = std::filesystem;
+    fs::create_directories(m_save_dir_);
+    for(auto& [module, entry] : m_filters_) {
+        auto& [pfilter, saved_size] = entry;
+        if(!pfilter || pfilter->size() == saved_size) continue;
+
+        // Written to a temporary file first, so a partial filter is never read
+        const auto path = filter_path(m_save_dir_, module);
+        auto tmp_path   = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            detail_::write_u64(file, m_check_);
+            detail_::write_u64(file, module.size());
+            file.write(module.data(), module.size());
+            pfilter->save(file);
+            file.flush();
+            if(!file)
+                throw std::runtime_error("Unable to write filter: " +
+                                         tmp_path.string());
+        }
+        fs::rename(tmp_path, path);
+        saved_size = pfilter->size();
+    }
+    if(!m_complete_) return;
+    std::ofstream(fs::path(m_save_dir_) / complete_marker);
+    m_invalidated_ = false;
+}
+
+typename FilterTable::filter_pointer FilterTable::load_(
+  const std::string& dir, const std::string& module) const {
+    if(dir.empty()) return nullptr;
+    std::ifstream file(filter_path(dir, module), std::ios::binary);
+    if(!file) return nullptr;
+    try {
+        if(detail_::read_u64(file) != m_check_) return nullptr;
+        std::string name(detail_::read_u64(file), '\0');
+        // Guards against hash collisions of module names
+        if(!file.read(name.data(), name.size()) || name != module)
+            return nullptr;
+        return std::make_shared<BloomFilter>(BloomFilter::load(file));
+    } catch(...) { return nullptr; }
+}
+
+typename FilterTable::filter_pointer FilterTable::from_scan_(
+  const std::string& module) {
+    if(m_scanned_) return nullptr; // Scanning failed
+    m_scanned_ = true;
+    std::map<std::string, BloomFilter> filters;
+    try {
+        for(const auto& [m, h] : m_scan_()) filters[m].insert(h);
+    } catch(...) {
+        // Can't list the saved keys (e.g., the backend doesn't support it)
+        return nullptr;
+    }
+    m_complete_ = true;
+
+    // Every module's filter is kept, so they're all saved with the marker
+    for(auto& [m, filter] : filters) {
+        if(m_filters_.count(m)) continue;
+        auto pfilter = std::make_shared<BloomFilter>(std::move(filter));
+        m_filters_.emplace(m, std::make_pair(std::move(pfilter), unsaved));
+    }
+    auto itr = m_filters_.find(module);
+    if(itr != m_filters_.end()) return m_filters_.extract(itr).mapped().first;
+    return std::make_shared<BloomFilter>();
+}
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "bloom_filter.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::database {
+
+/** @brief Creates, loads, and saves the Bloom filters of the module caches.
+ *
+ *  The results of all module caches are saved in one database, but each
+ *  module cache filters the lookups it sends there with its own BloomFilter
+ *  (see Filtered). A filter is only correct if it contains the hashes of all
+ *  of the module's saved keys, including those saved by previous runs. This
+ *  class makes sure that is the case. The filter of a module is:
+ *
+ *  1. loaded from the file it was saved to, if there is one,
+ *  2. otherwise empty if the table knows it has seen every saved key (i.e.,
+ *     the storage was new or the filters were complete when last saved),
+ *  3. otherwise rebuilt by scanning the saved keys (done once for all
+ *     modules), and
+ *  4. otherwise (if the storage can not be scanned) not used at all.
+ *
+ *  Filters are saved in a directory, one file per module, and a marker file
+ *  records that the directory has a filter for every module with saved keys,
+ *  i.e., that the filters match the storage. Filters are only ever added to,
+ *  so a filter which is saved before (or without) the keys it contains merely
+ *  causes extra lookups. A filter which is missing keys would cause those
+ *  results to be recomputed, so the marker is removed (and the directory
+ *  made, if need be) before the first key is saved after the filters were
+ *  last saved (see invalidate_saved). If a job is killed before it saves the
+ *  filters again, the next job thus finds a directory without a marker, and
+ *  ignores the saved filters.
+ */
+class FilterTable {
+public:
+    /// Type of the hashes in the filters
+    using hash_type = typename BloomFilter::hash_type;
+
+    /// Type of a pointer to a filter
+    using filter_pointer = std::shared_ptr<BloomFilter>;
+
+    /// Type of a list of (module, key hash) pairs
+    using saved_keys = std::vector<std::pair<std::string, hash_type>>;
+
+    /// Type of a function listing the saved keys, throws if it can't
+    using scan_function = std::function<saved_keys()>;
+
+    /** @brief Creates a table whose filters are neither saved nor loaded.
+     *
+     *  @param[in] scan Lists the keys which are already saved. If null the
+     *                  storage is assumed to be empty. Default is null.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit FilterTable(scan_function scan = {}) noexcept;
+
+    /** @brief Creates a table which saves its filters to @p save_dir.
+     *
+     *  @param[in] save_dir Where filters are loaded from and saved to. Empty
+     *                      means filters are not saved.
+     *  @param[in] shared_dir Where filters are loaded from if they are not in
+     *                        @p save_dir (used for read-only storage). Empty
+     *                        means nowhere.
+     *  @param[in] check Identifies the function used to hash the keys. Saved
+     *                   filters made with a different value are ignored.
+     *  @param[in] fresh True if the storage was just created, i.e., there are
+     *                   no saved keys.
+     *  @param[in] scan Lists the keys which are already saved.
+     *
+     *  @throw std::bad_alloc if there is a problem copying the paths. Strong
+     *                        throw guarantee.
+     */
+    FilterTable(std::string save_dir, std::string shared_dir, hash_type check,
+                bool fresh, scan_function scan);
+
+    /** @brief Returns the filter of @p module.
+     *
+     *  @param[in] module The module whose filter is wanted.
+     *
+     *  @return The filter of @p module, or a nullptr if the module's keys can
+     *          not be filtered.
+     *
+     *  @throw std::bad_alloc if there is a problem making the filter. Strong
+     *                        throw guarantee.
+     */
+    filter_pointer get(const std::string& module);
+
+    /** @brief Records that a key of @p module with hash @p h was saved by
+     *         means other than the module's database (e.g., a restore).
+     *
+     *  @param[in] module The module the key belongs to.
+     *  @param[in] h The hash of the key.
+     *
+     *  @throw std::bad_alloc if there is a problem making the filter. Strong
+     *                        throw guarantee.
+     */
+    void add(const std::string& module, hash_type h);
+
+    /** @brief Records that keys are about to be saved to the storage.
+     *
+     *  The saved filters do not contain the keys, so they are marked as out
+     *  of date until the next call to save. Only the first call after a save
+     *  touches the disk. This is a no-op if the table has no save directory.
+     *
+     *  @throw std::filesystem::filesystem_error if the save directory can not
+     *         be made or the marker can not be removed. Strong throw
+     *         guarantee.
+     */
+    void invalidate_saved();
+
+    /** @brief Writes the filters which changed since they were last saved.
+     *
+     *  This is a no-op if the table has no save directory. If the table knows
+     *  about every saved key, the saved filters are marked as matching the
+     *  storage.
+     *
+     *  @throw std::runtime_error if a filter can not be written. Weak throw
+     *                            guarantee.
+     */
+    void save();
+
+    /// Does the table know about every saved key?
+    bool complete() const noexcept { return m_complete_; }
+
+private:
+    /// Loads the filter of @p module from @p dir, nullptr if not possible
+    filter_pointer load_(const std::string& dir,
+                         const std::string& module) const;
+
+    /// Makes the filter of @p module from the scan, nullptr if not possible
+    filter_pointer from_scan_(const std::string& module);
+
+    /// Where filters are saved
+    std::string m_save_dir_;
+
+    /// Where filters are loaded from (if not in m_save_dir_)
+    std::string m_shared_dir_;
+
+    /// Identifies the hash function
+    hash_type m_check_ = 0;
+
+    /// Lists the saved keys
+    scan_function m_scan_;
+
+    /// Does the table know about every saved key?
+    bool m_complete_ = false;
+
+    /// Has m_scan_ been called?
+    bool m_scanned_ = false;
+
+    /// Can the saved filters be loaded? Not unless they match the storage
+    bool m_loadable_ = false;
+
+    /// Has the marker been removed since the filters were last saved?
+    bool m_invalidated_ = false;
+
+    /// The filters, and their sizes when they were last saved
+    std::map<std::string, std::pair<filter_pointer, std::size_t>> m_filters_;
+};
+
+} // namespace pluginplay::cache::database
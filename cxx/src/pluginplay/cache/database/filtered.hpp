@@ -0,0 +1,160 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "bloom_filter.hpp"
+#include "database_api.hpp"
+#include "db_hash.hpp"
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+namespace pluginplay::cache::database {
+
+/** @brief Answers lookups of missing keys without consulting the wrapped
+ *         database.
+ *
+ *  Looking up a key in a database on disk usually requires touching the
+ *  disk, even if (as is common for a cold cache) the key is not there. This
+ *  class wraps such a database and records the hash of every key inserted
+ *  through it in a BloomFilter. count() first consults the filter, and only
+ *  asks the wrapped database if the filter says the key may be present. For
+ *  this to be correct, the filter must also contain the hashes of keys which
+ *  were put in the wrapped database by other means (e.g., by previous runs).
+ *  Populating the filter with those is the responsibility of whoever makes
+ *  the filter (see FilterTable).
+ *
+ *  The filter is shared so that it can be saved, and refilled, by its
+ *  creator. A null filter disables filtering. Since saved copies of the filter
+ *  don't know about the keys inserted afterwards, the creator can ask to be
+ *  told before a key is inserted.
+ *
+ *  @tparam KeyType The type of the keys. Must be hashable by DBHash<KeyType>.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+class Filtered : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the database being wrapped
+    using sub_db_type = base_type;
+
+    /// Type of a managed pointer to the database being wrapped
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /// Type of a pointer to the filter
+    using filter_pointer = std::shared_ptr<BloomFilter>;
+
+    /// Type of the functor used to hash the keys
+    using hasher = DBHash<KeyType>;
+
+    /// Type of a function called before a key is inserted
+    using insert_hook = std::function<void()>;
+
+    /// Typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Typedef of const key_type&
+    using typename base_type::const_key_reference;
+
+    /// Typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Typedef of ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /** @brief Wraps @p sub_db, filtering lookups with @p filter.
+     *
+     *  @param[in] sub_db The database being wrapped.
+     *  @param[in] filter Contains (at least) the hashes of the keys in
+     *                    @p sub_db. If null, lookups are not filtered.
+     *  @param[in] on_insert Called before each key is inserted into
+     *                       @p sub_db. Default is an empty function.
+     *
+     *  @throw std::runtime_error if @p sub_db is a nullptr. Strong throw
+     *                            guarantee.
+     */
+    Filtered(sub_db_pointer sub_db, filter_pointer filter,
+             insert_hook on_insert = {});
+
+    /// The filter in use, may be null
+    const filter_pointer& filter() const noexcept { return m_filter_; }
+
+    /// The number of lookups the filter answered
+    std::size_t n_filtered() const noexcept { return m_n_filtered_; }
+
+protected:
+    /// Calls m_db_->cursor()
+    cursor_pointer cursor_() const override { return m_db_->cursor(); }
+
+    /// Calls m_db_->range(first, last)
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override {
+        return m_db_->range(first, last);
+    }
+
+    /// Calls m_db_->prefix(prefix)
+    cursor_pointer prefix_(const_key_reference prefix) const override {
+        return m_db_->prefix(prefix);
+    }
+
+    /// Consults the filter, then m_db_->count(key) if needed
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Calls m_on_insert_, adds the hash of @p key to the filter, then
+    /// inserts into m_db_
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Calls m_db_->free(key), the hash stays in the filter
+    void free_(const_key_reference key) override { m_db_->free(key); }
+
+    /// Calls m_db_->at(key)
+    const_mapped_reference at_(const_key_reference key) const override {
+        return m_db_->at(key);
+    }
+
+    /// Calls m_db_->backup()
+    void backup_() override { m_db_->backup(); }
+
+    /// Calls m_db_->dump()
+    void dump_() override { m_db_->dump(); }
+
+private:
+    /// The database being wrapped
+    sub_db_pointer m_db_;
+
+    /// The filter, may be null
+    filter_pointer m_filter_;
+
+    /// Called before a key is inserted, may be empty
+    insert_hook m_on_insert_;
+
+    /// The number of lookups the filter answered
+    mutable std::size_t m_n_filtered_ = 0;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "filtered.ipp"
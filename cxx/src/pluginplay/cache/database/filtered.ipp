@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from filtered.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define FILTERED Filtered<KeyType, ValueType>
+
+TPARAMS
+FILTERED::Filtered(sub_db_pointer sub_db, filter_pointer filter,
+                   insert_hook on_insert) :
+  m_db_(std::move(sub_db)),
+  m_filter_(std::move(filter)),
+  m_on_insert_(std::move(on_insert)) {
+    if(!m_db_) throw std::runtime_error("Wrapped database can't be nullptr.");
+}
+
+TPARAMS
+bool FILTERED::count_(const_key_reference key) const noexcept {
+    if(m_filter_ && !m_filter_->might_contain(hasher{}(key))) {
+        ++m_n_filtered_;
+        return false;
+    }
+    return m_db_->count(key);
+}
+
+TPARAMS
+void FILTERED::insert_(key_type key, mapped_type value) {
+    // Before the insert, so the filter never misses a key that's stored
+    if(m_on_insert_) m_on_insert_();
+    if(m_filter_) m_filter_->insert(hasher{}(key));
+    m_db_->insert(std::move(key), std::move(value));
+}
+
+#undef FILTERED
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
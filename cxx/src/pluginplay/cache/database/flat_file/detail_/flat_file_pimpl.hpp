@@ -0,0 +1,312 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../flat_file.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace pluginplay::cache::database::detail_ {
+
+/** @brief Implements the FlatFile class.
+ *
+ *  A FlatFile database lives in a directory containing two files:
+ *
+ *  - `data`, an append-only log of records, and
+ *  - `index`, an open-addressing hash table (linear probing) from keys to the
+ *    offset of the newest record for that key in `data`.
+ *
+ *  Both files are memory-mapped. Lookups hash the key, probe the mapped index,
+ *  and compare the key against the record in the mapped data file, so no
+ *  system calls (or intermediate buffers) are involved in a read. Since the
+ *  index lives on disk, reopening an existing database only requires mapping
+ *  the two files; nothing is read until it's needed.
+ *
+ *  Each record in `data` is laid out as:
+ *
+ *  ```
+ *  | key size (8 bytes) | value size (8 bytes) | key bytes | value bytes |
+ *  ```
+ *
+ *  Overwriting or freeing a key appends a new record (freeing appends a
+ *  record whose value size is `tombstone`), the old record is simply no
+ *  longer referenced by the index. Because `data` alone contains the full
+ *  history, the index is rebuilt from it if the index is missing or does not
+ *  match the data file (e.g., because the program died between updating the
+ *  two).
+ *
+ *  The data file grows geometrically, its header records where the valid
+ *  data ends. Integers are stored in native byte order, so database files are
+ *  not portable between architectures with different endianness.
+ */
+class FlatFilePIMPL {
+public:
+    /// Type of the class we're implementing
+    using parent_type = FlatFile<std::string, std::string>;
+
+    /// Type of a read-only reference to a file path
+    using const_path_reference = typename parent_type::const_path_reference;
+
+    /// Type used for database keys
+    using key_type = typename parent_type::key_type;
+
+    /// Type used for read-only references to database keys
+    using const_key_reference = typename parent_type::const_key_reference;
+
+    /// Type of a container holding keys
+    using key_set_type = typename parent_type::key_set_type;
+
+    /// Type used to store the values in the database
+    using mapped_type = typename parent_type::mapped_type;
+
+    /// Type of a read-only reference to a value
+    using const_mapped_reference = typename parent_type::const_mapped_reference;
+
+    /// Type of a read-only, non-owning view of a value
+    using view_type = std::string_view;
+
+    /// Type used for sizes and offsets
+    using size_type = std::uint64_t;
+
+    /** @brief Creates (or opens) the database in directory @p path.
+     *
+     *  A database opened read-only is never modified, so its index can not be
+     *  rebuilt. Opening it read-only thus requires it to have been closed (or
+     *  synced) by the last process which wrote to it.
+     *
+     *  @param[in] path The directory the database lives in. Created if it
+     *                  does not exist and @p read_only is false.
+     *  @param[in] read_only Should the files be opened read-only? Default is
+     *                       false.
+     *
+     *  @throw std::runtime_error if the files can not be created, opened, or
+     *                            mapped, if they are not FlatFile files, or if
+     *                            @p read_only is true and the index is out of
+     *                            date. Strong throw guarantee.
+     */
+    explicit FlatFilePIMPL(const_path_reference path, bool read_only = false);
+
+    /// Were the files opened read-only?
+    bool read_only() const noexcept { return m_data_->read_only(); }
+
+    /// Is @p key in the database?
+    bool count(const_key_reference key) const noexcept;
+
+    /** @brief Adds (or overwrites) a key/value pair.
+     *
+     *  @param[in] key The key for @p value.
+     *  @param[in] value The value to store.
+     *
+     *  @throw std::runtime_error if the files can not be grown. The database
+     *                            is in a valid, but unspecified state.
+     */
+    void insert(const_key_reference key, const mapped_type& value);
+
+    /** @brief Removes @p key (if present).
+     *
+     *  @param[in] key The key to remove.
+     *
+     *  @throw std::runtime_error if the data file can not be grown. The
+     *                            database is in a valid, but unspecified
+     *                            state.
+     */
+    void free(const_key_reference key);
+
+    /** @brief Retrieves the value associated with @p key.
+     *
+     *  @return A ConstDBValue holding a copy of the value, or an empty
+     *          ConstDBValue if @p key is not in the database.
+     *
+     *  @throw std::bad_alloc if the copy can not be allocated. Strong throw
+     *                        guarantee.
+     */
+    const_mapped_reference at(const_key_reference key) const;
+
+    /** @brief Returns a view of the value associated with @p key.
+     *
+     *  The view points directly into the mapped data file, i.e., no copy is
+     *  made. It is invalidated by the next insert or free.
+     *
+     *  @return A view of the value, or an empty view whose data() is nullptr
+     *          if @p key is not in the database.
+     *
+     *  @throw None No throw guarantee.
+     */
+    view_type view(const_key_reference key) const noexcept;
+
+    /// Returns the keys currently in the database (in no particular order)
+    key_set_type keys() const;
+
+    /** @brief Finds the first slot of the index, at or after @p slot, which
+     *         holds a key.
+     *
+     *  Together with slot_key this walks the keys without copying them all.
+     *  Since inserting may rehash the index, slot numbers are only meaningful
+     *  until the next insert.
+     *
+     *  @param[in] slot Where to start looking.
+     *
+     *  @return The slot, or capacity() if no later slot holds a key.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type next_slot(size_type slot) const noexcept;
+
+    /// The key held by slot @p slot, which must hold a key
+    view_type slot_key(size_type slot) const noexcept;
+
+    /// Number of slots in the index
+    size_type capacity() const noexcept;
+
+    /// Number of keys currently in the database
+    size_type size() const noexcept;
+
+    /// Flushes both files to disk
+    void sync() const;
+
+private:
+    /// Value size which marks a record as freeing its key
+    static constexpr size_type tombstone = ~size_type{0};
+
+    /// Offsets in the index meaning the slot is empty or held a freed key
+    ///@{
+    static constexpr size_type empty_slot   = 0;
+    static constexpr size_type deleted_slot = 1;
+    ///@}
+
+    /// Size of a record's header (key size, value size)
+    static constexpr size_type record_header_size = 2 * sizeof(size_type);
+
+    /// Initial number of slots in the index (must be a power of 2)
+    static constexpr size_type initial_capacity = 64;
+
+    /// Initial size of the data file
+    static constexpr size_type initial_data_size = 64 * 1024;
+
+    /// Layout of the header of the data file
+    struct DataHeader {
+        char magic[8];
+        size_type end; // Offset one past the last valid record
+    };
+
+    /// Layout of the header of the index file
+    struct IndexHeader {
+        char magic[8];
+        size_type capacity; // Number of slots
+        size_type size;     // Number of live keys
+        size_type used;     // Number of non-empty slots (live + deleted)
+        size_type data_end; // DataHeader::end this index is consistent with
+    };
+
+    /// Layout of a slot in the index
+    struct Slot {
+        size_type hash;
+        size_type offset; // Offset of the record in the data file
+    };
+
+    /// Hashes the bytes of a key (FNV-1a, stable across runs and platforms)
+    static size_type hash_(view_type key) noexcept;
+
+    /// Opens the data file, initializing it if it's new
+    void open_data_();
+
+    /// Opens the index, rebuilding it if it's new or stale
+    void open_index_();
+
+    /// Recreates the index from the records in the data file
+    void rebuild_index_();
+
+    /// Resizes the index to @p capacity slots and reinserts the live keys
+    void rehash_(size_type capacity);
+
+    /// Appends a record to the data file, returns its offset
+    size_type append_(view_type key, view_type value, size_type value_size);
+
+    /// Returns the slot holding @p key, or the slot it should go in
+    Slot* find_slot_(view_type key, size_type hash) const noexcept;
+
+    /// Points the index entry for @p key at the record at @p offset
+    void index_put_(view_type key, size_type hash, size_type offset);
+
+    /// Removes @p key from the index
+    void index_erase_(view_type key, size_type hash) noexcept;
+
+    /// Reads the key/value stored in the record at @p offset
+    ///@{
+    view_type record_key_(size_type offset) const noexcept;
+    view_type record_value_(size_type offset) const noexcept;
+    ///@}
+
+    /// Reads an integer at @p offset of the data file
+    size_type read_size_(size_type offset) const noexcept;
+
+    /// Throws if the files were opened read-only
+    void assert_writable_() const;
+
+    /// Typed access to the mapped headers and slots
+    ///@{
+    DataHeader& data_header_() const noexcept;
+    IndexHeader& index_header_() const noexcept;
+    Slot* slots_() const noexcept;
+    ///@}
+
+    /// The append-only log of records
+    std::unique_ptr<MappedFile> m_data_;
+
+    /// The hash index
+    std::unique_ptr<MappedFile> m_index_;
+};
+
+/** @brief Walks the keys of a FlatFilePIMPL.
+ *
+ *  Only the current key is copied out of the mapping. The position is kept as
+ *  a slot of the index, so the cursor is invalidated by inserts (which may
+ *  rehash the index).
+ */
+class FlatFileCursor : public Cursor<std::string> {
+public:
+    /// Type of the database being walked
+    using pimpl_type = FlatFilePIMPL;
+
+    /// Positions the cursor on the first key of @p pimpl (if any)
+    explicit FlatFileCursor(const pimpl_type& pimpl);
+
+protected:
+    bool valid_() const override { return m_slot_ < m_pimpl_.capacity(); }
+
+    const_key_reference key_() const override { return m_key_; }
+
+    void next_() override { seek_(m_slot_ + 1); }
+
+private:
+    /// Moves to the first key at or after @p slot
+    void seek_(pimpl_type::size_type slot);
+
+    /// The database being walked
+    const pimpl_type& m_pimpl_;
+
+    /// The slot holding the current key
+    pimpl_type::size_type m_slot_ = 0;
+
+    /// A copy of the current key
+    key_type m_key_;
+};
+
+} // namespace pluginplay::cache::database::detail_
+
+#include "flat_file_pimpl.ipp"
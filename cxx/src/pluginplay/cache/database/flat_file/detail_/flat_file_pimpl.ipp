@@ -0,0 +1,376 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from flat_file_pimpl.hpp
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace pluginplay::cache::database::detail_ {
+
+// Macro which hides inline, but could be used to hide template parameters
+#define TPARAMS inline
+
+// Macro which hides the class name (including template parameters if added)
+#define FLAT_FILE_PIMPL FlatFilePIMPL
+
+namespace flat_file {
+
+/// Identifies the data file
+inline constexpr char data_magic[8] = {'P', 'P', 'F', 'F', 'D', 'A', 'T', '1'};
+
+/// Identifies the index file
+inline constexpr char index_magic[8] = {'P', 'P', 'F', 'F', 'I', 'D', 'X', '1'};
+
+} // namespace flat_file
+
+TPARAMS
+FLAT_FILE_PIMPL::FLAT_FILE_PIMPL(const_path_reference path, bool read_only) {
+    std::filesystem::path root(path);
+    if(!read_only) std::filesystem::create_directories(root);
+    const auto data = (root / "data").string();
+    m_data_         = std::make_unique<MappedFile>(data, read_only);
+    open_data_();
+    const auto index = (root / "index").string();
+    m_index_         = std::make_unique<MappedFile>(index, read_only);
+    open_index_();
+}
+
+TPARAMS
+bool FLAT_FILE_PIMPL::count(const_key_reference key) const noexcept {
+    return find_slot_(key, hash_(key))->offset > deleted_slot;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::insert(const_key_reference key, const mapped_type& value) {
+    assert_writable_();
+    const auto offset = append_(key, value, value.size());
+    index_put_(key, hash_(key), offset);
+    index_header_().data_end = data_header_().end;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::free(const_key_reference key) {
+    assert_writable_();
+    if(!count(key)) return;
+    // The tombstone record makes the deletion survive an index rebuild
+    append_(key, view_type{}, tombstone);
+    index_erase_(key, hash_(key));
+    index_header_().data_end = data_header_().end;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::const_mapped_reference FLAT_FILE_PIMPL::at(
+  const_key_reference key) const {
+    const auto* pslot = find_slot_(key, hash_(key));
+    if(pslot->offset <= deleted_slot) return const_mapped_reference();
+    return const_mapped_reference(mapped_type(record_value_(pslot->offset)));
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::view_type FLAT_FILE_PIMPL::view(
+  const_key_reference key) const noexcept {
+    const auto* pslot = find_slot_(key, hash_(key));
+    if(pslot->offset <= deleted_slot) return view_type{};
+    return record_value_(pslot->offset);
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::key_set_type FLAT_FILE_PIMPL::keys() const {
+    key_set_type rv;
+    rv.reserve(size());
+    for(auto i = next_slot(0); i < capacity(); i = next_slot(i + 1))
+        rv.emplace_back(slot_key(i));
+    return rv;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::next_slot(
+  size_type slot) const noexcept {
+    const auto* pslots = slots_();
+    const auto n       = capacity();
+    while(slot < n && pslots[slot].offset <= deleted_slot) ++slot;
+    return slot;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::view_type FLAT_FILE_PIMPL::slot_key(
+  size_type slot) const noexcept {
+    return record_key_(slots_()[slot].offset);
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::capacity() const noexcept {
+    return index_header_().capacity;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::size() const noexcept {
+    return index_header_().size;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::sync() const {
+    m_data_->sync();
+    m_index_->sync();
+}
+
+// -- Private methods ----------------------------------------------------------
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::hash_(
+  view_type key) noexcept {
+    size_type h = 14695981039346656037ull;
+    for(unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::open_data_() {
+    if(m_data_->size() == 0 && !read_only()) {
+        m_data_->resize(initial_data_size);
+        auto& header = data_header_();
+        std::memcpy(header.magic, flat_file::data_magic, sizeof(header.magic));
+        header.end = sizeof(DataHeader);
+        return;
+    }
+    const bool too_small = m_data_->size() < sizeof(DataHeader);
+    if(too_small || std::memcmp(data_header_().magic, flat_file::data_magic,
+                                sizeof(flat_file::data_magic)) != 0)
+        throw std::runtime_error("Not a FlatFile database");
+
+    // Ignore any partially written record past the end of the file
+    auto& header = data_header_();
+    if(header.end <= m_data_->size()) return;
+    if(read_only()) throw std::runtime_error("FlatFile database is truncated");
+    header.end = m_data_->size();
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::open_index_() {
+    const auto n = m_index_->size();
+    if(n < sizeof(IndexHeader)) {
+        rebuild_index_();
+        return;
+    }
+    const auto& header = index_header_();
+    const bool is_index =
+      std::memcmp(header.magic, flat_file::index_magic,
+                  sizeof(flat_file::index_magic)) == 0;
+    const auto cap       = header.capacity;
+    const bool valid_cap = cap && !(cap & (cap - 1)) &&
+                           n == sizeof(IndexHeader) + cap * sizeof(Slot);
+    if(!is_index || !valid_cap || header.data_end != data_header_().end)
+        rebuild_index_();
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::assert_writable_() const {
+    if(!read_only()) return;
+    throw std::runtime_error("FlatFile database was opened read-only");
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::rebuild_index_() {
+    if(read_only())
+        throw std::runtime_error("FlatFile index is out of date, open the "
+                                 "database for writing once to rebuild it");
+    m_index_->resize(0); // Guarantees the new slots are zeroed
+    m_index_->resize(sizeof(IndexHeader) + initial_capacity * sizeof(Slot));
+    auto& header = index_header_();
+    std::memcpy(header.magic, flat_file::index_magic, sizeof(header.magic));
+    header.capacity = initial_capacity;
+    header.size     = 0;
+    header.used     = 0;
+
+    // Replay the log
+    const auto end = data_header_().end;
+    auto offset    = static_cast<size_type>(sizeof(DataHeader));
+    while(offset + record_header_size <= end) {
+        const auto key_size   = read_size_(offset);
+        const auto value_size = read_size_(offset + sizeof(size_type));
+        const bool is_free    = value_size == tombstone;
+        const auto n = record_header_size + key_size + (is_free ? 0 : value_size);
+        if(key_size > end || (!is_free && value_size > end)) break;
+        if(offset + n > end) break; // Truncated record
+
+        const auto key = record_key_(offset);
+        if(is_free)
+            index_erase_(key, hash_(key));
+        else
+            index_put_(key, hash_(key), offset);
+        offset += n;
+    }
+    data_header_().end       = offset;
+    index_header_().data_end = offset;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::rehash_(size_type capacity) {
+    std::vector<Slot> live;
+    live.reserve(size());
+    for(size_type i = 0; i < index_header_().capacity; ++i)
+        if(slots_()[i].offset > deleted_slot) live.push_back(slots_()[i]);
+
+    m_index_->resize(sizeof(IndexHeader) + capacity * sizeof(Slot));
+    auto* pslots = slots_();
+    std::memset(static_cast<void*>(pslots), 0, capacity * sizeof(Slot));
+    auto& header    = index_header_();
+    header.capacity = capacity;
+    header.size     = live.size();
+    header.used     = live.size();
+
+    // Keys are unique, so each goes in the first empty slot
+    const auto mask = capacity - 1;
+    for(const auto& slot : live) {
+        auto i = slot.hash & mask;
+        while(pslots[i].offset != empty_slot) i = (i + 1) & mask;
+        pslots[i] = slot;
+    }
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::append_(
+  view_type key, view_type value, size_type value_size) {
+    const auto n   = record_header_size + key.size() + value.size();
+    const auto end = data_header_().end;
+    if(end + n > m_data_->size()) {
+        const auto doubled = 2 * static_cast<size_type>(m_data_->size());
+        m_data_->resize(std::max<size_type>(doubled, end + n));
+    }
+    const size_type key_size = key.size();
+    char* p                  = m_data_->data() + end;
+    std::memcpy(p, &key_size, sizeof(size_type));
+    std::memcpy(p + sizeof(size_type), &value_size, sizeof(size_type));
+    if(!key.empty()) std::memcpy(p + record_header_size, key.data(), key.size());
+    if(!value.empty())
+        std::memcpy(p + record_header_size + key.size(), value.data(),
+                    value.size());
+    data_header_().end = end + n;
+    return end;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::Slot* FLAT_FILE_PIMPL::find_slot_(
+  view_type key, size_type hash) const noexcept {
+    // The load factor is kept below 1, so there's always an empty slot
+    auto* pslots       = slots_();
+    const auto mask    = index_header_().capacity - 1;
+    Slot* first_erased = nullptr;
+    for(auto i = hash & mask;; i = (i + 1) & mask) {
+        auto& slot = pslots[i];
+        if(slot.offset == empty_slot) return first_erased ? first_erased : &slot;
+        if(slot.offset == deleted_slot) {
+            if(!first_erased) first_erased = &slot;
+            continue;
+        }
+        if(slot.hash == hash && record_key_(slot.offset) == key) return &slot;
+    }
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::index_put_(view_type key, size_type hash,
+                                 size_type offset) {
+    {
+        // Keep (live + erased) / capacity <= 3/4 and live / capacity <= 1/2
+        // after a rehash
+        const auto& header = index_header_();
+        if(4 * (header.used + 1) > 3 * header.capacity) {
+            auto capacity = header.capacity;
+            while(2 * (header.size + 1) > capacity) capacity *= 2;
+            rehash_(capacity);
+        }
+    }
+
+    auto* pslot   = find_slot_(key, hash);
+    auto& header  = index_header_();
+    const bool is_new = pslot->offset <= deleted_slot;
+    if(pslot->offset == empty_slot) ++header.used;
+    if(is_new) ++header.size;
+    pslot->hash   = hash;
+    pslot->offset = offset;
+}
+
+TPARAMS
+void FLAT_FILE_PIMPL::index_erase_(view_type key, size_type hash) noexcept {
+    auto* pslot = find_slot_(key, hash);
+    if(pslot->offset <= deleted_slot) return;
+    pslot->offset = deleted_slot;
+    --index_header_().size;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::view_type FLAT_FILE_PIMPL::record_key_(
+  size_type offset) const noexcept {
+    const auto key_size = read_size_(offset);
+    const char* p       = m_data_->data() + offset + record_header_size;
+    return view_type(p, key_size);
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::view_type FLAT_FILE_PIMPL::record_value_(
+  size_type offset) const noexcept {
+    const auto key_size   = read_size_(offset);
+    const auto value_size = read_size_(offset + sizeof(size_type));
+    const char* p = m_data_->data() + offset + record_header_size + key_size;
+    return view_type(p, value_size);
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::size_type FLAT_FILE_PIMPL::read_size_(
+  size_type offset) const noexcept {
+    // Records aren't aligned, so we can't just reinterpret_cast
+    size_type rv;
+    std::memcpy(&rv, m_data_->data() + offset, sizeof(size_type));
+    return rv;
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::DataHeader& FLAT_FILE_PIMPL::data_header_()
+  const noexcept {
+    return *reinterpret_cast<DataHeader*>(m_data_->data());
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::IndexHeader& FLAT_FILE_PIMPL::index_header_()
+  const noexcept {
+    return *reinterpret_cast<IndexHeader*>(m_index_->data());
+}
+
+TPARAMS
+typename FLAT_FILE_PIMPL::Slot* FLAT_FILE_PIMPL::slots_() const noexcept {
+    return reinterpret_cast<Slot*>(m_index_->data() + sizeof(IndexHeader));
+}
+
+TPARAMS
+FlatFileCursor::FlatFileCursor(const pimpl_type& pimpl) : m_pimpl_(pimpl) {
+    seek_(0);
+}
+
+TPARAMS
+void FlatFileCursor::seek_(pimpl_type::size_type slot) {
+    m_slot_ = m_pimpl_.next_slot(slot);
+    if(valid_()) m_key_ = key_type(m_pimpl_.slot_key(m_slot_));
+}
+
+#undef FLAT_FILE_PIMPL
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database::detail_
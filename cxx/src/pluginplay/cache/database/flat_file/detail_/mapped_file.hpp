@@ -0,0 +1,191 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pluginplay::cache::database::detail_ {
+
+/** @brief RAII wrapper around a memory-mapped file.
+ *
+ *  This class opens (creating if necessary) a file and maps its entire
+ *  contents into memory with shared (i.e., write-through) semantics. Reading
+ *  and writing the file then amounts to reading and writing memory. The file
+ *  can be grown (or shrunk) with resize, which invalidates all pointers into
+ *  the previous mapping.
+ *
+ *  Since writers update the file in place, the file is locked for as long as
+ *  it is open: exclusively if it was opened for writing and shared if it was
+ *  opened read-only. Hence any number of readers, or a single writer, can
+ *  have the file open at a time (the lock is advisory, i.e., it only keeps
+ *  out other MappedFile instances, whether in this process or another one).
+ *
+ *  N.B. An empty file can not be mapped, so while the file is empty data()
+ *       returns nullptr.
+ */
+class MappedFile {
+public:
+    /// Type used for offsets and sizes
+    using size_type = std::size_t;
+
+    /// Type used for paths
+    using path_type = std::string;
+
+    /** @brief Opens and maps the file at @p path.
+     *
+     *  @param[in] path The file to map. Created if it does not exist and
+     *                  @p read_only is false.
+     *  @param[in] read_only If true the file is opened and mapped read-only,
+     *                       in which case it must already exist.
+     *
+     *  @throw std::runtime_error if the file can not be opened, locked, or
+     *                            mapped. In particular if the file is open
+     *                            for writing elsewhere, or if @p read_only is
+     *                            false and the file is open at all elsewhere.
+     *                            Strong throw guarantee.
+     */
+    explicit MappedFile(const path_type& path, bool read_only = false) :
+      m_path_(path), m_read_only_(read_only) {
+        const int flags = read_only ? O_RDONLY : (O_RDWR | O_CREAT);
+        m_fd_           = ::open(path.c_str(), flags, 0644);
+        if(m_fd_ < 0) error_("open");
+        try {
+            lock_();
+            struct stat s;
+            if(::fstat(m_fd_, &s) != 0) error_("stat");
+            map_(static_cast<size_type>(s.st_size));
+        } catch(...) {
+            ::close(m_fd_);
+            throw;
+        }
+    }
+
+    /// Unmaps and closes the file, changes are flushed by the OS
+    ~MappedFile() noexcept {
+        unmap_();
+        if(m_fd_ >= 0) ::close(m_fd_);
+    }
+
+    /// Mapped files are not copyable or movable
+    ///@{
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ///@}
+
+    /// The number of bytes in the file (and the mapping)
+    size_type size() const noexcept { return m_size_; }
+
+    /// Start of the mapping, nullptr if the file is empty
+    ///@{
+    char* data() noexcept { return m_data_; }
+    const char* data() const noexcept { return m_data_; }
+    ///@}
+
+    /// Was the file opened read-only?
+    bool read_only() const noexcept { return m_read_only_; }
+
+    /** @brief Changes the size of the file and remaps it.
+     *
+     *  New bytes are zero-initialized (by the OS).
+     *
+     *  @param[in] new_size The size the file should have.
+     *
+     *  @throw std::runtime_error if the file can not be resized or remapped.
+     *                            The file is in a valid, but unspecified state.
+     */
+    void resize(size_type new_size) {
+        if(m_read_only_) throw std::runtime_error("File is read-only");
+        unmap_();
+        if(::ftruncate(m_fd_, static_cast<off_t>(new_size)) != 0)
+            error_("resize");
+        map_(new_size);
+    }
+
+    /** @brief Synchronously flushes the mapping to disk.
+     *
+     *  @throw std::runtime_error if the flush fails. Strong throw guarantee.
+     */
+    void sync() const {
+        if(!m_data_ || m_read_only_) return;
+        if(::msync(m_data_, m_size_, MS_SYNC) != 0) error_("sync");
+    }
+
+private:
+    /// Takes the lock appropriate for how the file was opened, without waiting
+    void lock_() const {
+        const int op = (m_read_only_ ? LOCK_SH : LOCK_EX) | LOCK_NB;
+        int rv       = 0;
+        do { rv = ::flock(m_fd_, op); } while(rv != 0 && errno == EINTR);
+        if(rv == 0) return;
+        if(errno != EWOULDBLOCK) error_("lock");
+        const std::string by = m_read_only_ ? "for writing " : "";
+        throw std::runtime_error("Failed to lock " + m_path_ +
+                                 ": it is already open " + by +
+                                 "(by this or another process)");
+    }
+
+    /// Maps the first @p n bytes of the file
+    void map_(size_type n) {
+        m_size_ = n;
+        if(n == 0) return;
+        const int prot = m_read_only_ ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void* p        = ::mmap(nullptr, n, prot, MAP_SHARED, m_fd_, 0);
+        if(p == MAP_FAILED) {
+            m_size_ = 0;
+            error_("map");
+        }
+        m_data_ = static_cast<char*>(p);
+    }
+
+    /// Releases the current mapping (if any)
+    void unmap_() noexcept {
+        if(m_data_) ::munmap(m_data_, m_size_);
+        m_data_ = nullptr;
+        m_size_ = 0;
+    }
+
+    /// Throws std::runtime_error describing errno
+    [[noreturn]] void error_(const char* what) const {
+        throw std::runtime_error("Failed to " + std::string(what) + " " +
+                                 m_path_ + ": " + std::strerror(errno));
+    }
+
+    /// Where the file lives
+    path_type m_path_;
+
+    /// Was the file opened read-only?
+    bool m_read_only_;
+
+    /// File descriptor of the open file
+    int m_fd_ = -1;
+
+    /// Start of the mapping
+    char* m_data_ = nullptr;
+
+    /// Length of the mapping
+    size_type m_size_ = 0;
+};
+
+} // namespace pluginplay::cache::database::detail_
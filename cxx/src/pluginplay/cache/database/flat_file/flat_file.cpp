@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "detail_/flat_file_pimpl.hpp"
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define FLAT_FILE FlatFile<KeyType, ValueType>
+
+TPARAMS
+FLAT_FILE::FlatFile() noexcept = default;
+
+TPARAMS
+FLAT_FILE::FlatFile(const_path_reference path, bool read_only) :
+  m_pimpl_(std::make_unique<pimpl_type>(path, read_only)) {}
+
+TPARAMS
+FLAT_FILE::~FlatFile() noexcept = default;
+
+TPARAMS
+bool FLAT_FILE::read_only() const noexcept {
+    return m_pimpl_ && m_pimpl_->read_only();
+}
+
+TPARAMS
+typename FLAT_FILE::view_type FLAT_FILE::view(const_key_reference key) const {
+    if(!pimpl_().count(key)) throw std::out_of_range("Key not in database");
+    return m_pimpl_->view(key);
+}
+
+TPARAMS
+typename FLAT_FILE::cursor_pointer FLAT_FILE::cursor_() const {
+    if(!m_pimpl_) return std::make_unique<VectorCursor<key_type>>();
+    return std::make_unique<detail_::FlatFileCursor>(*m_pimpl_);
+}
+
+TPARAMS
+bool FLAT_FILE::count_(const_key_reference key) const noexcept {
+    if(!m_pimpl_) return false;
+    return m_pimpl_->count(key);
+}
+
+TPARAMS
+void FLAT_FILE::insert_(key_type key, mapped_type value) {
+    pimpl_().insert(key, value);
+}
+
+TPARAMS
+void FLAT_FILE::free_(const_key_reference key) { pimpl_().free(key); }
+
+TPARAMS
+typename FLAT_FILE::const_mapped_reference FLAT_FILE::at_(
+  const_key_reference key) const {
+    return pimpl_().at(key);
+}
+
+TPARAMS
+void FLAT_FILE::backup_() {
+    if(m_pimpl_) m_pimpl_->sync();
+}
+
+TPARAMS
+void FLAT_FILE::dump_() { backup_(); }
+
+TPARAMS
+void FLAT_FILE::assert_pimpl_() const {
+    if(m_pimpl_) return;
+    throw std::runtime_error("Object has no PIMPL. Was it default constructed "
+                             "or moved from?");
+}
+
+TPARAMS
+typename FLAT_FILE::pimpl_reference FLAT_FILE::pimpl_() {
+    assert_pimpl_();
+    return *m_pimpl_;
+}
+
+TPARAMS
+typename FLAT_FILE::const_pimpl_reference FLAT_FILE::pimpl_() const {
+    assert_pimpl_();
+    return *m_pimpl_;
+}
+
+#undef FLAT_FILE
+#undef TPARAMS
+
+template class FlatFile<std::string, std::string>;
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../database_api.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+class FlatFilePIMPL;
+} // namespace detail_
+
+/** @brief A persistent database built on memory-mapped files.
+ *
+ *  FlatFile is PluginPlay's built-in persistent backend. Unlike RocksDB it has
+ *  no dependencies beyond POSIX, so it's always available. The database lives
+ *  in a directory holding an append-only data file and a hash index, both of
+ *  which are memory-mapped (see detail_::FlatFilePIMPL for the file formats).
+ *  Consequentially:
+ *
+ *  - Opening an existing database only maps the files; nothing is read or
+ *    deserialized until it's asked for.
+ *  - Reads are served straight out of the mapping. `view` returns a view of
+ *    the stored bytes without copying them, `at` copies them once into the
+ *    returned value.
+ *  - Overwritten and freed values are not reclaimed, the data file only
+ *    grows.
+ *
+ *  FlatFile is not thread-safe for concurrent writes. Only one process can
+ *  have a given database open for writing at a time, while any number of
+ *  processes can open a database read-only (as long as no process is writing
+ *  to it), in which case they share the operating system's page cache. This is
+ *  enforced with file locks, opening a database which is in use in a
+ *  conflicting way raises an error.
+ *
+ *  @tparam KeyType Type of the keys in the database, expected to be some type
+ *                  which holds binary data.
+ *  @tparam ValueType Type of the values that the keys map to. Expected to be a
+ *                    type holding binary data.
+ */
+template<typename KeyType, typename ValueType>
+class FlatFile : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type this class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type used for specifying the disk location of the database
+    using path_type = std::string;
+
+    /// Type of a read-only reference to the disk location
+    using const_path_reference = const path_type&;
+
+    /// @copydoc base_type::key_type
+    using key_type = typename base_type::key_type;
+
+    /// @copydoc base_type::key_set_type
+    using key_set_type = typename base_type::key_set_type;
+
+    /// @copydoc base_type::cursor_pointer
+    using cursor_pointer = typename base_type::cursor_pointer;
+
+    /// @copydoc base_type::const_key_reference
+    using const_key_reference = typename base_type::const_key_reference;
+
+    /// @copydoc base_type::mapped_type
+    using mapped_type = typename base_type::mapped_type;
+
+    /// @copydoc base_type::const_mapped_reference
+    using const_mapped_reference = typename base_type::const_mapped_reference;
+
+    /// Type of a non-owning view of a stored value
+    using view_type = std::string_view;
+
+    /** @brief Creates a stub FlatFile instance.
+     *
+     *  The instance resulting from this ctor has no PIMPL and can not be used
+     *  except as a place holder.
+     *
+     *  @throw None No throw guarantee.
+     */
+    FlatFile() noexcept;
+
+    /** @brief Creates a, or opens an existing, FlatFile database.
+     *
+     *  @param[in] path The directory the database lives in. If it already
+     *                  holds a FlatFile database, that database is opened.
+     *                  Otherwise a new database is created (as are any missing
+     *                  directories).
+     *  @param[in] read_only If true, the existing database at @p path is
+     *                       opened read-only and calling insert or free
+     *                       raises an error. Default is false.
+     *
+     *  @throw std::runtime_error if the database can not be created/opened,
+     *                            if it is open for writing elsewhere, if
+     *                            @p read_only is false and it is open at all
+     *                            elsewhere, or if @p read_only is true and
+     *                            @p path does not hold an up-to-date FlatFile
+     *                            database. Strong throw guarantee.
+     */
+    explicit FlatFile(const_path_reference path, bool read_only = false);
+
+    /// Was the database opened read-only?
+    bool read_only() const noexcept;
+
+    /** @brief Default Dtor
+     *
+     *  Changes are written back to disk by the OS after the files are
+     *  unmapped. Call backup to force them to disk.
+     *
+     *  @throw None no throw guarantee.
+     */
+    ~FlatFile() noexcept;
+
+    /** @brief Returns a view of the value stored under @p key without
+     *         copying it.
+     *
+     *  The view points into the memory-mapped data file and is invalidated
+     *  by the next call to insert or free.
+     *
+     *  @param[in] key The key of the value to view.
+     *
+     *  @return A view of the stored value.
+     *
+     *  @throw std::out_of_range if @p key is not in the database. Strong throw
+     *                           guarantee.
+     *  @throw std::runtime_error if this instance has no PIMPL. Strong throw
+     *                            guarantee.
+     */
+    view_type view(const_key_reference key) const;
+
+protected:
+    /// Implements cursor method
+    cursor_pointer cursor_() const override;
+
+    /// Implements count method
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Implements insert method
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Implements free method
+    void free_(const_key_reference key) override;
+
+    /// Implements at and operator[]
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Implements backup by flushing the files to disk
+    void backup_() override;
+
+    /// Implements dump (which, since the data already lives on disk, is backup)
+    void dump_() override;
+
+private:
+    /// Type of the implementation
+    using pimpl_type = detail_::FlatFilePIMPL;
+
+    /// Type of a mutable reference to the PIMPL
+    using pimpl_reference = pimpl_type&;
+
+    /// Type of a read-only reference to the PIMPL
+    using const_pimpl_reference = const pimpl_type&;
+
+    /// Type of a mutable pointer to the PIMPL
+    using pimpl_pointer = std::unique_ptr<pimpl_type>;
+
+    /// Factors out throwing if a PIMPL has not been allocated
+    void assert_pimpl_() const;
+
+    /// Calls assert_pimpl_ then returns a mutable PIMPL
+    pimpl_reference pimpl_();
+
+    /// Calls assert_pimpl_ then returns an immutable PIMPL
+    const_pimpl_reference pimpl_() const;
+
+    /// The actual implementation
+    pimpl_pointer m_pimpl_;
+};
+
+extern template class FlatFile<std::string, std::string>;
+
+} // namespace pluginplay::cache::database
@@ -38,6 +38,10 @@ namespace pluginplay::cache::database {
  *  additional overhead and could prove useful down the line for adding
  *  additional metadata.
  *
+ *  @note Injecting copies the key on every operation. The persistent module
+ *        caches instead use a Serialized instance which adds the module to
+ *        each key as it encodes it.
+ *
  *  @tparam KeyType The types of the keys in this database. Assumed to satisfy
  *                  the concept of an associative map.
  *  @tparam ValueType The types of the values in this database.
@@ -64,6 +68,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Type of this database's values
     using typename base_type::mapped_type;
 
@@ -98,8 +105,8 @@ public:
                 sub_db_pointer sub_db);
 
 protected:
-    /// calls m_db_->keys() and then removes the injected key
-    key_set_type keys_() const override;
+    /// Wraps m_db_->cursor(), removing the injected key from each key
+    cursor_pointer cursor_() const override;
 
     /// injects into key, then calls m_db_->count()
     bool count_(const_key_reference key) const noexcept override;
@@ -33,10 +33,14 @@ KEY_INJECTOR::KeyInjector(key_key_type key_to_inject,
 }
 
 TPARAMS
-typename KEY_INJECTOR::key_set_type KEY_INJECTOR::keys_() const {
-    auto rv = m_db_->keys();
-    for(auto& key : rv) key.erase(m_key_to_inject_);
-    return rv;
+typename KEY_INJECTOR::cursor_pointer KEY_INJECTOR::cursor_() const {
+    auto fxn = [this](const_key_reference key) {
+        auto rv = key;
+        rv.erase(m_key_to_inject_);
+        return rv;
+    };
+    using cursor_type = TransformCursor<key_type, key_type>;
+    return std::make_unique<cursor_type>(m_db_->cursor(), std::move(fxn));
 }
 
 TPARAMS
@@ -43,6 +43,9 @@ public:
     /// Ultimately typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Read-only reference to a key, typedef of const KeyType&
     using typename base_type::const_key_reference;
 
@@ -79,8 +82,8 @@ public:
     KeyProxyMapper(proxy_map_maker_pointer proxy_mapper, sub_db_pointer sub_db);
 
 protected:
-    /// Returns the keys in the wrapped proxy_mapper
-    key_set_type keys_() const override;
+    /// Returns a cursor over the keys in the wrapped proxy_mapper
+    cursor_pointer cursor_() const override;
 
     /// Makes sure key is in proxy_mapper, if so then check sub_db
     bool count_(const_key_reference key) const noexcept override;
@@ -29,8 +29,8 @@ KEY_PROXY_MAPPER::KeyProxyMapper(proxy_map_maker_pointer proxy_mapper,
 }
 
 TPARAMS
-typename KEY_PROXY_MAPPER::key_set_type KEY_PROXY_MAPPER::keys_() const {
-    return m_proxy_mapper_->keys();
+typename KEY_PROXY_MAPPER::cursor_pointer KEY_PROXY_MAPPER::cursor_() const {
+    return m_proxy_mapper_->cursor();
 }
 
 TPARAMS
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_budget.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace pluginplay::cache::database {
+
+typename MemoryBudget::token_type MemoryBudget::attach(
+  const TierState& tiers, reclaim_function reclaim) {
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    const auto token = m_next_token_;
+    m_members_.push_back(member_type{token, &tiers, std::move(reclaim)});
+    ++m_next_token_;
+    return token;
+}
+
+void MemoryBudget::detach(token_type token) noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    auto same = [token](const member_type& m) { return m.token == token; };
+    auto itr  = std::find_if(m_members_.begin(), m_members_.end(), same);
+    if(itr != m_members_.end()) m_members_.erase(itr);
+}
+
+void MemoryBudget::enforce() {
+    const auto max_bytes = limit();
+    if(!max_bytes || used() <= max_bytes) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    // Instances which should lose memory first have smaller keys: over
+    // quota, then lower priority, then more bytes
+    using key_type  = std::tuple<bool, int, size_type>;
+    auto victim_key = [&](const member_type& m) {
+        const auto& t    = *m.tiers;
+        const auto bytes = t.bytes.load(relaxed);
+        return key_type(!t.over_quota(), t.priority.load(relaxed), ~bytes);
+    };
+    std::vector<std::pair<key_type, member_type*>> victims;
+    victims.reserve(m_members_.size());
+    for(auto& m : m_members_) victims.emplace_back(victim_key(m), &m);
+    auto first = [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    };
+    std::sort(victims.begin(), victims.end(), first);
+
+    // Go down to 7/8 of the limit (like NativeHashed's quotas) so the sort is
+    // amortized over several allocations
+    const auto target = max_bytes - max_bytes / 8;
+    for(auto& [_, pm] : victims) {
+        const auto n = used();
+        if(n <= target) return;
+        pm->reclaim(n - target);
+    }
+}
+
+} // namespace pluginplay::cache::database
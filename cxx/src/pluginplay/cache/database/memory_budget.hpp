@@ -0,0 +1,145 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "tier_state.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace pluginplay::cache::database {
+
+/** @brief A limit on the memory used by several NativeHashed instances.
+ *
+ *  The module caches of a ModuleManagerCache share one instance of this
+ *  class. Each NativeHashed instance whose TierState points to the budget
+ *  attaches itself to the budget (with a function which frees some of its
+ *  memory), reports how many bytes it gains and loses, and calls enforce
+ *  after it grows. If the attached instances use more bytes than the limit,
+ *  enforce takes memory from them, in the order: instances whose owner is
+ *  over a quota, instances whose owner has a lower priority, and instances
+ *  whose owner uses more bytes, until they use at most 7/8 of the limit.
+ *
+ *  Attaching, detaching, and enforcing are guarded by a mutex. The byte count
+ *  and limit are atomics. N.B. enforce calls into other instances, which must
+ *  therefore not be in use by other threads (like the rest of the cache,
+ *  NativeHashed instances are not synchronized).
+ */
+class MemoryBudget {
+public:
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /// Type of a function freeing at least the given number of bytes (if it
+    /// can), returns how many bytes it freed
+    using reclaim_function = std::function<size_type(size_type)>;
+
+    /// Type of the handle returned by attach
+    using token_type = std::size_t;
+
+    /** @brief Sets the limit.
+     *
+     *  The limit is enforced the next time an attached instance grows.
+     *
+     *  @param[in] limit The most bytes the attached instances may use, 0
+     *                   means no limit.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_limit(size_type limit) noexcept {
+        m_limit_.store(limit, std::memory_order_relaxed);
+    }
+
+    /// The most bytes the attached instances may use, 0 means no limit
+    size_type limit() const noexcept {
+        return m_limit_.load(std::memory_order_relaxed);
+    }
+
+    /// Approximate number of bytes the attached instances use
+    size_type used() const noexcept {
+        return m_used_.load(std::memory_order_relaxed);
+    }
+
+    /// Records that an attached instance now uses @p n more bytes
+    void grow(size_type n) noexcept {
+        m_used_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// Records that an attached instance now uses @p n fewer bytes
+    void shrink(size_type n) noexcept {
+        m_used_.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    /** @brief Adds an instance to the instances sharing the budget.
+     *
+     *  @param[in] tiers The state of the instance's owner, must outlive the
+     *                   attachment.
+     *  @param[in] reclaim Frees some of the instance's memory.
+     *
+     *  @return The handle to pass to detach.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating memory. Strong
+     *                        throw guarantee.
+     */
+    token_type attach(const TierState& tiers, reclaim_function reclaim);
+
+    /** @brief Removes an instance added by attach.
+     *
+     *  @param[in] token The value attach returned.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void detach(token_type token) noexcept;
+
+    /** @brief Frees memory until the attached instances are within the limit.
+     *
+     *  Once over the limit, memory is freed until the instances use at most
+     *  7/8 of it, so the next few allocations don't need to free memory.
+     *
+     *  N.B. Reclaim functions are called with the budget's mutex locked, so
+     *       they must not call enforce.
+     *
+     *  @throw ??? If a reclaim function throws. Weak throw guarantee.
+     */
+    void enforce();
+
+private:
+    /// An attached instance
+    struct member_type {
+        token_type token;
+        const TierState* tiers;
+        reclaim_function reclaim;
+    };
+
+    /// Guards m_members_ and m_next_token_
+    std::mutex m_mutex_;
+
+    /// The attached instances
+    std::vector<member_type> m_members_;
+
+    /// Value attach returns next
+    token_type m_next_token_ = 0;
+
+    /// The limit
+    std::atomic<size_type> m_limit_{0};
+
+    /// The bytes used by the attached instances
+    std::atomic<size_type> m_used_{0};
+};
+
+} // namespace pluginplay::cache::database
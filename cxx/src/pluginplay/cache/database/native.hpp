@@ -18,6 +18,8 @@
 #include "database_api.hpp"
 #include <map>
 #include <memory>
+#include <set>
+#include <type_traits>
 
 namespace pluginplay::cache::database {
 
@@ -32,6 +34,14 @@ namespace pluginplay::cache::database {
  *
  *  In practice this class just wraps an std::map with our DatabaseAPI API.
  *
+ *  If the instance is created in read-through mode, keys which are not in the
+ *  map are also looked up in the subdatabase, and their values are loaded into
+ *  the map the first time they are retrieved. backup only writes the
+ *  key/value pairs which were added (or overwritten) since the last backup,
+ *  so loaded values are not written back to the subdatabase. Values which
+ *  report that they can't be serialized (i.e., whose `is_serializable()`
+ *  member returns false) are never backed up, they stay in memory.
+ *
  *  @tparam KeyType The type of the keys we are storing.
  *  @tparam ValueType The type of the values that the keys map to.
  */
@@ -51,6 +61,9 @@ public:
     /// Ultimately typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Type of a read-only reference to a key, typedef of const KeyType&
     using typename base_type::const_key_reference;
 
@@ -80,10 +93,15 @@ public:
      *  @param[in] backup The database where the contents of this instance will
      *                    be backed up to. If this is a nullptr then backing up
      *                    the database will be a no-op.
+     *  @param[in] read_through If true, and @p backup is non-null, @p backup
+     *                          is treated as part of this database, i.e.,
+     *                          count, at, keys, and free also consider the
+     *                          contents of @p backup. Defaults to false.
      *
      *  @throw None No throw guarantee
      */
-    explicit Native(map_type map = {}, backup_db_pointer backup = {});
+    explicit Native(map_type map = {}, backup_db_pointer backup = {},
+                    bool read_through = false);
 
     /** @brief Creates an empty Native instance with the provided subdatabase
      *
@@ -93,20 +111,29 @@ public:
      *  @param[in] backup The database where the contents of this instance will
      *                    be backed up to. If this is nullptr then backup will
      *                    be a no-op.
+     *  @param[in] read_through Whether @p backup should be treated as part of
+     *                          this database. Defaults to false.
      *
      *  @throw None No throw guarantee.
      */
-    explicit Native(backup_db_pointer backup);
+    explicit Native(backup_db_pointer backup, bool read_through = false);
 
     auto& map() { return m_map_; }
 
     const auto& map() const { return m_map_; }
 
 protected:
-    /// Puts keys in wrapped map into a key_set_type and returns it
-    key_set_type keys_() const override;
+    /// Visits the keys in the wrapped map, then the backup if reading through
+    cursor_pointer cursor_() const override;
+
+    /// Seeks to @p first in the wrapped map, calls range on the backup
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override;
 
-    /// Calls count on the wrapped map
+    /// Seeks to @p prefix in the wrapped map, calls prefix on the backup
+    cursor_pointer prefix_(const_key_reference prefix) const override;
+
+    /// Calls count on the wrapped map (then the backup if reading through)
     bool count_(const_key_reference key) const noexcept override;
 
     /// Calls operator[] on the wrapped map
@@ -115,21 +142,45 @@ protected:
     /// Calls erase on the wrapped map
     void free_(const_key_reference key) override;
 
-    /// Calls at on the wrapped map
+    /// Calls at on the wrapped map, loading the value first if needed
     const_mapped_reference at_(const_key_reference key) const override;
 
-    /// If a backup database was set, pushes keys to it
+    /// If a backup database was set, pushes keys which changed to it
     void backup_() override;
 
-    /// Calls backup then clear on m_map_
+    /// Calls backup then removes the backed up values from m_map_
     void dump_() override;
 
 private:
-    /// The key/values the user gave to us
-    map_type m_map_;
+    /// Should count/at/keys/free consider the backup?
+    bool reading_through_() const noexcept {
+        return m_read_through_ && m_backup_;
+    }
+
+    /// Can @p value be written to the backup?
+    static bool can_back_up_(const mapped_type& value) noexcept;
+
+    /// Type of a read-only iterator over m_map_
+    using map_iterator = typename map_type::const_iterator;
+
+    /// Visits the keys of m_map_ in [@p begin, @p end)
+    cursor_pointer map_cursor_(map_iterator begin, map_iterator end) const;
+
+    /// Visits @p memory, then (if not null) the keys of @p backup not in m_map_
+    cursor_pointer with_backup_(cursor_pointer memory,
+                                cursor_pointer backup) const;
+
+    /// The key/values the user gave to us (mutable so at_ can load values)
+    mutable map_type m_map_;
+
+    /// Keys whose values changed since they were last backed up
+    std::set<key_type> m_dirty_;
 
     /// The DB to backup m_map_ to
     backup_db_pointer m_backup_;
+
+    /// Is m_backup_ treated as part of this database?
+    bool m_read_through_;
 };
 
 } // namespace pluginplay::cache::database
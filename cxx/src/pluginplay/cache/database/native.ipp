@@ -22,49 +22,154 @@ namespace pluginplay::cache::database {
 #define NATIVE Native<KeyType, ValueType>
 
 TPARAMS
-NATIVE::Native(map_type map, backup_db_pointer backup) :
-  m_map_(std::move(map)), m_backup_(std::move(backup)) {}
+NATIVE::Native(map_type map, backup_db_pointer backup, bool read_through) :
+  m_map_(std::move(map)),
+  m_backup_(std::move(backup)),
+  m_read_through_(read_through) {
+    for(const auto& [k, _] : m_map_) m_dirty_.insert(k);
+}
+
+TPARAMS
+NATIVE::Native(backup_db_pointer backup, bool read_through) :
+  Native(map_type{}, std::move(backup), read_through) {}
 
 TPARAMS
-NATIVE::Native(backup_db_pointer backup) :
-  Native(map_type{}, std::move(backup)) {}
+typename NATIVE::cursor_pointer NATIVE::cursor_() const {
+    auto backup = reading_through_() ? m_backup_->cursor() : nullptr;
+    return with_backup_(map_cursor_(m_map_.cbegin(), m_map_.cend()),
+                        std::move(backup));
+}
 
 TPARAMS
-typename NATIVE::key_set_type NATIVE::keys_() const {
-    key_set_type rv;
-    for(const auto& [k, _] : m_map_) rv.push_back(k);
-    return rv;
+typename NATIVE::cursor_pointer NATIVE::range_(const_key_reference first,
+                                               const_key_reference last) const {
+    auto backup = reading_through_() ? m_backup_->range(first, last) : nullptr;
+    auto begin  = m_map_.lower_bound(first);
+    auto end    = m_map_.key_comp()(first, last) ? m_map_.lower_bound(last) :
+                                                   begin;
+    return with_backup_(map_cursor_(begin, end), std::move(backup));
+}
+
+TPARAMS
+typename NATIVE::cursor_pointer NATIVE::prefix_(
+  const_key_reference prefix) const {
+    if constexpr(is_string_key_v<key_type>) {
+        auto backup = reading_through_() ? m_backup_->prefix(prefix) : nullptr;
+
+        // The keys starting with prefix are contiguous, starting at prefix
+        auto matches = [prefix](const_key_reference key) {
+            return has_prefix(key, prefix);
+        };
+        auto memory = std::make_unique<FilteredCursor<key_type>>(
+          map_cursor_(m_map_.lower_bound(prefix), m_map_.cend()),
+          std::move(matches), true);
+        return with_backup_(std::move(memory), std::move(backup));
+    } else {
+        return base_type::prefix_(prefix);
+    }
 }
 
 TPARAMS
 bool NATIVE::count_(const_key_reference key) const noexcept {
-    return m_map_.count(key);
+    if(m_map_.count(key)) return true;
+    return reading_through_() && m_backup_->count(key);
 }
 
 TPARAMS
 void NATIVE::insert_(key_type key, mapped_type value) {
+    m_dirty_.insert(key);
     m_map_[std::move(key)] = std::move(value);
 }
 
 TPARAMS
-void NATIVE::free_(const_key_reference key) { m_map_.erase(key); }
+void NATIVE::free_(const_key_reference key) {
+    // Otherwise the key would come back on the next lookup
+    if(reading_through_()) m_backup_->free(key);
+    m_dirty_.erase(key);
+    m_map_.erase(key);
+}
 
 TPARAMS
 typename NATIVE::const_mapped_reference NATIVE::at_(
   const_key_reference key) const {
-    return const_mapped_reference(&m_map_.at(key));
+    auto itr = m_map_.find(key);
+    if(itr == m_map_.end() && reading_through_() && m_backup_->count(key)) {
+        // First access, load it
+        mapped_type value(m_backup_->at(key).get());
+        itr = m_map_.emplace(key, std::move(value)).first;
+    }
+    if(itr == m_map_.end()) throw std::out_of_range("Key not in database");
+    return const_mapped_reference(&itr->second);
 }
 
 TPARAMS
 void NATIVE::backup_() {
     if(!m_backup_) return;
-    for(const auto& [k, v] : m_map_) m_backup_->insert(k, v);
+    // Values which can't be backed up stay dirty (and thus in memory)
+    std::set<key_type> kept;
+    for(const auto& k : m_dirty_) {
+        const auto& v = m_map_.at(k);
+        if(can_back_up_(v))
+            m_backup_->insert(k, v);
+        else
+            kept.insert(k);
+    }
+    m_dirty_.swap(kept);
 }
 
 TPARAMS
 void NATIVE::dump_() {
     backup_();
-    m_map_.clear();
+    if(!m_backup_) m_dirty_.clear();
+    for(auto itr = m_map_.begin(); itr != m_map_.end();) {
+        if(m_dirty_.count(itr->first))
+            ++itr;
+        else
+            itr = m_map_.erase(itr);
+    }
+}
+
+namespace detail_ {
+
+/// Primary template, selected when T has no is_serializable member
+template<typename T, typename = void>
+struct reports_serializable : std::false_type {};
+
+/// Selected when T has an is_serializable member
+template<typename T>
+struct reports_serializable<
+  T, std::void_t<decltype(std::declval<const T&>().is_serializable())>>
+  : std::true_type {};
+
+} // namespace detail_
+
+TPARAMS
+bool NATIVE::can_back_up_(const mapped_type& value) noexcept {
+    if constexpr(detail_::reports_serializable<mapped_type>::value) {
+        return value.is_serializable();
+    } else {
+        return true;
+    }
+}
+
+TPARAMS
+typename NATIVE::cursor_pointer NATIVE::map_cursor_(map_iterator begin,
+                                                    map_iterator end) const {
+    auto proj = [](map_iterator itr) { return &itr->first; };
+    return make_iterator_cursor<key_type>(begin, end, proj);
+}
+
+TPARAMS
+typename NATIVE::cursor_pointer NATIVE::with_backup_(
+  cursor_pointer memory, cursor_pointer backup) const {
+    if(!backup) return memory;
+    auto not_loaded = [this](const_key_reference key) {
+        return !m_map_.count(key);
+    };
+    auto filtered = std::make_unique<FilteredCursor<key_type>>(
+      std::move(backup), std::move(not_loaded));
+    return std::make_unique<ChainCursor<key_type>>(std::move(memory),
+                                                   std::move(filtered));
 }
 
 #undef NATIVE
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include "db_hash.hpp"
+#include "memory_budget.hpp"
+#include "tier_state.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::database {
+
+/** @brief An in memory database which stores objects in their native form in
+ *         a hash table.
+ *
+ *  NativeHashed has the same semantics as Native, save for the fact that the
+ *  keys are not ordered. Native is backed by an std::map, which means each
+ *  lookup requires O(log n) comparisons of entire keys. When the keys are
+ *  themselves maps (e.g., the proxy maps used by module caches) those
+ *  comparisons are expensive. NativeHashed instead stores the key/value pairs
+ *  in an open-addressing (linear probing) hash table. The hash of each key is
+ *  computed once, upon insertion, and stored alongside the key. Lookups thus
+ *  require hashing the query key once and then comparing the cached hashes,
+ *  only falling back to comparing keys when the hashes match. The cached
+ *  hashes also mean the table can be grown without rehashing any keys.
+ *
+ *  Key/value pairs are stored in nodes which are not moved when the table is
+ *  reorganized, so references returned by at() remain valid until the
+ *  corresponding key is freed or demoted (or the database is dumped).
+ *
+ *  Like Native, this class supports backing the key/value pairs up to more
+ *  persistent storage by providing a subdatabase. Only key/value pairs which
+ *  were added (or overwritten) since the last backup are written to the
+ *  subdatabase (and finding them does not require scanning the table, so
+ *  frequent backups are cheap). If the instance is created in read-through mode, keys which
+ *  are not in memory are also looked up in the subdatabase, and their values
+ *  are loaded into memory the first time they are retrieved. This allows an
+ *  existing subdatabase to be used without loading it up front.
+ *
+ *  In read-through mode the instance can also be given a TierState, which
+ *  makes the instance behave like the in-memory tier of a cache hierarchy.
+ *  Loading a value from the subdatabase is counted as a promotion and, if
+ *  the TierState limits the number of key/value pairs in memory, the least
+ *  recently used key/value pairs are demoted once the limit is exceeded.
+ *  Demoting a key/value pair backs it up (if it is dirty) and removes it from
+ *  memory, invalidating references to its value. It remains part of the
+ *  database and is loaded again the next time it is retrieved.
+ *
+ *  Given a TierState and a ColdCodec (with or without a subdatabase) the
+ *  instance also compresses values which have not been retrieved for the
+ *  number of accesses (insertions and retrievals), or the amount of time, the
+ *  TierState says makes a value cold. A cold value is kept in memory only in
+ *  compressed form, which invalidates references to it, and is decompressed
+ *  the next time it is retrieved. Values are checked for coldness as the
+ *  instance is used, by sweeps which are spread out so that their cost per
+ *  access is constant. Values which can not be compressed stay as they are.
+ *
+ *  Given a TierState with a time to live and/or a generation counter, pairs
+ *  which are stale (see TierState) are treated as if they were not in the
+ *  database. Stale pairs in memory are removed (from memory and, in
+ *  read-through mode, from the subdatabase) a few slots at a time as the
+ *  instance is used, so memory is reclaimed without ever scanning the whole
+ *  table at once. Stale pairs which were never loaded from the subdatabase
+ *  stay there until they are overwritten. Pairs which leave memory, but not
+ *  the database (i.e., are demoted or dumped), keep their age and generation.
+ *  The age and generation of the other pairs in the subdatabase (e.g., those
+ *  saved by an earlier run) are not known, so they are taken to be those of
+ *  the instance, i.e., such pairs become stale no later than pairs inserted
+ *  when the instance was created.
+ *
+ *  The TierState may also set quotas on the number of pairs, and on the bytes
+ *  of the values (as measured by the size function given to the constructor),
+ *  kept in memory, and point to a MemoryBudget shared with other instances.
+ *  Going over a quota removes the least recently used pairs (backing them up
+ *  first if they are dirty) until the instance is at 7/8 of the quota. In
+ *  read-through mode removing a pair is a demotion, otherwise it is an
+ *  eviction. The most recently used pair is never removed.
+ *
+ *  @tparam KeyType The type of the keys we are storing. Must be equality
+ *                  comparable and hashable by DBHash<KeyType>.
+ *  @tparam ValueType The type of the values that the keys map to.
+ */
+template<typename KeyType, typename ValueType>
+class NativeHashed : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the keys to this database, typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Type of a read-only reference to a key, typedef of const KeyType&
+    using typename base_type::const_key_reference;
+
+    /// Type of the mapped values, typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Type of an object holding a read-only reference to a value, typedef of
+    /// ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /// Type of the functor used to hash the keys
+    using hasher = DBHash<key_type>;
+
+    /// Type used for sizes and hashes
+    using size_type = std::size_t;
+
+    /// Type of DatabaseAPI that can be used for backup
+    using backup_db_type = DatabaseAPI<key_type, mapped_type>;
+
+    /// Type of a pointer to a backup database
+    using backup_db_pointer = std::unique_ptr<backup_db_type>;
+
+    /// Type of a pointer to the state shared with the owner of the tier
+    using tier_pointer = std::shared_ptr<TierState>;
+
+    /// Type of the object compressing cold values
+    using cold_codec_type = ColdCodec<mapped_type>;
+
+    /// Type of a function estimating the memory a value uses
+    using size_function = std::function<size_type(const mapped_type&)>;
+
+    /** @brief Creates an empty NativeHashed instance.
+     *
+     *  @param[in] backup The database where the contents of this instance will
+     *                    be backed up to. If this is a nullptr then backing up
+     *                    the database will be a no-op. Defaults to nullptr.
+     *  @param[in] read_through If true, and @p backup is non-null, @p backup
+     *                          is treated as part of this database, i.e.,
+     *                          count, at, keys, and free also consider the
+     *                          contents of @p backup. Defaults to false.
+     *  @param[in] tiers Where to record promotions/demotions and to read the
+     *                   maximum number of key/value pairs to keep in memory
+     *                   from. The maximum is only used in read-through
+     *                   mode. Also says when values are cold. Defaults to
+     *                   nullptr, which means nothing is recorded, memory
+     *                   usage is not limited, and no value is cold.
+     *  @param[in] cold How cold values are compressed. Defaults to an empty
+     *                  codec, which means cold values are not compressed.
+     *  @param[in] sizer Estimates the bytes a value uses, for @p tiers' byte
+     *                   quota and budget. Defaults to null, which means
+     *                   values are taken to use no memory (the size of cold
+     *                   values is always known).
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit NativeHashed(backup_db_pointer backup = {},
+                          bool read_through        = false,
+                          tier_pointer tiers       = {},
+                          cold_codec_type cold     = {},
+                          size_function sizer      = {}) noexcept;
+
+    /// Detaches from the budget and stops counting this instance's memory
+    ~NativeHashed() noexcept override;
+
+    /** @brief The number of key/value pairs in memory.
+     *
+     *  In read-through mode, key/value pairs which are only in the backup
+     *  database are not counted.
+     *
+     *  @return The number of key/value pairs in memory.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type size() const noexcept { return m_size_; }
+
+    /** @brief The number of slots in the hash table.
+     *
+     *  The capacity is always zero or a power of two.
+     *
+     *  @return The number of slots in the underlying hash table.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type capacity() const noexcept { return m_slots_.size(); }
+
+protected:
+    /// Visits the slots (in no particular order), then the backup if reading
+    /// through
+    cursor_pointer cursor_() const override;
+
+    /// Hashes @p key and probes for it, then checks the backup if reading
+    /// through
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Adds (or overwrites) the key/value pair, growing the table if needed.
+    /// Then demotes key/value pairs if there are too many.
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Removes @p key using backward-shift deletion (no tombstones)
+    void free_(const_key_reference key) override;
+
+    /// Hashes @p key, probes for it, and returns a reference to its value.
+    /// When reading through, loads the value from the backup if needed (and
+    /// then demotes key/value pairs if there are too many).
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// If a backup database was set, pushes new key/value pairs to it
+    void backup_() override;
+
+    /// Calls backup then clears the table
+    void dump_() override;
+
+private:
+    /// Type actually storing a key/value pair
+    using node_type = std::pair<const key_type, mapped_type>;
+
+    /// Type of the clock used for times
+    using clock_type = std::chrono::steady_clock;
+
+    /// Type of the generation counter's value
+    using generation_type = std::uint64_t;
+
+    /// A slot in the table. An empty slot has a null node.
+    struct slot_type {
+        /// The cached hash of node->first
+        size_type hash = 0;
+
+        /// The key/value pair occupying this slot
+        std::unique_ptr<node_type> node;
+
+        /// When node was last inserted or retrieved (see m_clock_)
+        size_type last_used = 0;
+
+        /// The time node was last inserted or retrieved (if m_cold_ is set)
+        clock_type::time_point last_time;
+
+        /// If node's value is cold, its compressed form (otherwise null)
+        std::unique_ptr<std::string> cold;
+
+        /// The time node's value was set
+        clock_type::time_point born;
+
+        /// The generation when node's value was set
+        generation_type generation = 0;
+
+        /// The bytes node's value uses, as counted in m_tiers_
+        size_type bytes = 0;
+    };
+
+    /// When, and during which generation, a pair's value was set
+    struct stamp_type {
+        /// The time the value was set
+        clock_type::time_point born;
+
+        /// The generation when the value was set
+        generation_type generation = 0;
+    };
+
+    /// How many slots reclaim_ visits per call
+    static constexpr size_type reclaim_batch_ = 4;
+
+    /// Memory order used for m_tiers_ (it only holds counters and a knob)
+    static constexpr auto relaxed_ = std::memory_order_relaxed;
+
+    /// Sentinel returned by find_ when a key is not present
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    /// Returns the slot holding @p key (with hash @p h) or npos
+    size_type find_(const_key_reference key, size_type h) const noexcept;
+
+    /// Puts a new key/value pair (with hash @p h) in an empty slot
+    size_type emplace_(key_type key, mapped_type value, size_type h,
+                       bool dirty) const;
+
+    /// Moves the nodes into a table with @p new_capacity slots
+    void rehash_(size_type new_capacity) const;
+
+    /// Empties slot @p i using backward-shift deletion (no tombstones)
+    void erase_(size_type i) const noexcept;
+
+    /// Removes the least recently used pairs if there are more than allowed
+    void demote_() const;
+
+    /// Removes at least @p n least recently used pairs and at least @p bytes
+    /// of values (but never the most recently used), returns the bytes freed
+    size_type shed_(size_type n, size_type bytes) const;
+
+    /// Updates the bytes counted for @p slot
+    void measure_(slot_type& slot) const;
+
+    /// Sets the bytes counted for @p slot to @p bytes
+    void resize_(slot_type& slot, size_type bytes) const noexcept;
+
+    /// Stops counting the memory of every pair
+    void release_() const noexcept;
+
+    /// Asks the budget to free memory (if there's a budget)
+    void enforce_budget_() const;
+
+    /// Records that the pair in @p slot was just inserted or retrieved
+    void touch_(slot_type& slot) const noexcept;
+
+    /// Compresses the values which are cold, if it's time to check
+    void cool_() const;
+
+    /// Replaces the value in @p slot by its compressed form, if possible
+    void compress_(slot_type& slot) const;
+
+    /// Undoes compress_
+    void decompress_(slot_type& slot) const;
+
+    /// The current generation, 0 if there's no generation counter
+    generation_type generation_() const noexcept;
+
+    /// Is a pair set at @p born during @p generation stale?
+    bool expired_(clock_type::time_point born,
+                  generation_type generation) const noexcept;
+
+    /// Removes the stale pair in slot @p i from memory and the backup
+    void expire_(size_type i) const;
+
+    /// Remembers the stamp of the pair in @p slot, which is leaving memory
+    void keep_stamp_(const slot_type& slot) const;
+
+    /// The stamp of the pair with hash @p h, which is only in the backup
+    stamp_type backup_stamp_(size_type h) const noexcept;
+
+    /// Removes the stale pairs in the next few slots
+    void reclaim_() const;
+
+    /// Should count/at/keys/free consider the backup?
+    bool reading_through_() const noexcept {
+        return m_read_through_ && m_backup_;
+    }
+
+    // N.B. The table is mutable so at_ can load values from the backup
+
+    /// The slots of the hash table, size is zero or a power of 2
+    mutable std::vector<slot_type> m_slots_;
+
+    /// The number of occupied slots
+    mutable size_type m_size_ = 0;
+
+    /// The pairs which changed since they were last backed up/loaded
+    mutable std::unordered_set<const node_type*> m_dirty_;
+
+    /// Incremented every time a pair is inserted or retrieved
+    mutable size_type m_clock_ = 0;
+
+    /// The DB to backup the key/value pairs to
+    backup_db_pointer m_backup_;
+
+    /// Is m_backup_ treated as part of this database?
+    bool m_read_through_;
+
+    /// Limit and counters shared with the owner, may be null
+    tier_pointer m_tiers_;
+
+    /// Compresses cold values, may be empty
+    cold_codec_type m_cold_;
+
+    /// m_clock_ at which cool_ next checks for cold values
+    mutable size_type m_next_sweep_ = 0;
+
+    /// When this instance was made (the age of pairs in the backup)
+    clock_type::time_point m_born_;
+
+    /// The generation when this instance was made (that of the backup)
+    generation_type m_generation_;
+
+    /// The stamps of the pairs which left memory for the backup, by hash
+    mutable std::unordered_map<size_type, stamp_type> m_stamps_;
+
+    /// The slot reclaim_ visits next
+    mutable size_type m_next_reclaim_ = 0;
+
+    /// The generation when reclaim_ last started visiting the slots
+    mutable generation_type m_reclaim_generation_;
+
+    /// No pair is from a generation before this one (see reclaim_)
+    mutable generation_type m_clean_generation_;
+
+    /// Estimates the bytes of a value, may be null
+    size_function m_sizer_;
+
+    /// Set once this instance has attached to the budget
+    mutable std::optional<MemoryBudget::token_type> m_budget_token_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "native_hashed.ipp"
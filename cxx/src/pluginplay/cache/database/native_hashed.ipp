@@ -0,0 +1,490 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// File to be included from native_hashed.hpp only
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define NATIVE_HASHED NativeHashed<KeyType, ValueType>
+
+TPARAMS
+NATIVE_HASHED::NativeHashed(backup_db_pointer backup, bool read_through,
+                            tier_pointer tiers, cold_codec_type cold,
+                            size_function sizer) noexcept :
+  m_backup_(std::move(backup)),
+  m_read_through_(read_through),
+  m_tiers_(std::move(tiers)),
+  m_cold_(std::move(cold)),
+  m_born_(clock_type::now()),
+  m_generation_(generation_()),
+  m_reclaim_generation_(m_generation_),
+  m_clean_generation_(m_generation_),
+  m_sizer_(std::move(sizer)) {
+    if(m_tiers_ && m_cold_) m_tiers_->coolable = true;
+}
+
+TPARAMS
+NATIVE_HASHED::~NativeHashed() noexcept {
+    if(m_budget_token_) m_tiers_->budget->detach(*m_budget_token_);
+    release_();
+}
+
+TPARAMS
+typename NATIVE_HASHED::cursor_pointer NATIVE_HASHED::cursor_() const {
+    using slot_iterator = typename std::vector<slot_type>::const_iterator;
+    auto proj = [](slot_iterator itr) -> const key_type* {
+        return itr->node ? &itr->node->first : nullptr;
+    };
+
+    auto memory = make_iterator_cursor<key_type>(m_slots_.cbegin(),
+                                                 m_slots_.cend(), proj);
+    if(!reading_through_()) return memory;
+
+    auto not_loaded = [this](const_key_reference key) {
+        return find_(key, hasher{}(key)) == npos;
+    };
+    auto backup = std::make_unique<FilteredCursor<key_type>>(
+      m_backup_->cursor(), std::move(not_loaded));
+    return std::make_unique<ChainCursor<key_type>>(std::move(memory),
+                                                   std::move(backup));
+}
+
+TPARAMS
+bool NATIVE_HASHED::count_(const_key_reference key) const noexcept {
+    const auto h = hasher{}(key);
+    const auto i = find_(key, h);
+    if(i != npos) return !expired_(m_slots_[i].born, m_slots_[i].generation);
+    if(!reading_through_() || !m_backup_->count(key)) return false;
+    const auto stamp = backup_stamp_(h);
+    if(expired_(stamp.born, stamp.generation)) return false;
+    if(m_tiers_) m_tiers_->backup_finds.fetch_add(1, relaxed_);
+    return true;
+}
+
+TPARAMS
+void NATIVE_HASHED::insert_(key_type key, mapped_type value) {
+    reclaim_();
+    const auto h = hasher{}(key);
+    const auto i = find_(key, h);
+    m_stamps_.erase(h);
+    if(i != npos) {
+        auto& slot        = m_slots_[i];
+        slot.node->second = std::move(value);
+        slot.cold.reset();
+        slot.born       = clock_type::now();
+        slot.generation = generation_();
+        touch_(slot);
+        measure_(slot);
+        m_dirty_.insert(slot.node.get());
+    } else {
+        emplace_(std::move(key), std::move(value), h, true);
+    }
+    demote_();
+    cool_();
+    enforce_budget_();
+}
+
+TPARAMS
+void NATIVE_HASHED::free_(const_key_reference key) {
+    // Otherwise the key would come back on the next lookup
+    if(reading_through_()) m_backup_->free(key);
+
+    const auto h = hasher{}(key);
+    m_stamps_.erase(h);
+    const auto i = find_(key, h);
+    if(i == npos) return;
+    m_dirty_.erase(m_slots_[i].node.get());
+    erase_(i);
+}
+
+TPARAMS
+void NATIVE_HASHED::erase_(size_type i) const noexcept {
+    resize_(m_slots_[i], 0);
+    if(m_tiers_) m_tiers_->entries.fetch_sub(1, relaxed_);
+    m_slots_[i].node.reset();
+    m_slots_[i].cold.reset();
+    --m_size_;
+
+    // Backward-shift deletion: pull later members of the probe sequence into
+    // the hole so that lookups never have to skip over empty slots.
+    const auto mask = capacity() - 1;
+    for(auto j = (i + 1) & mask; m_slots_[j].node; j = (j + 1) & mask) {
+        const auto home = m_slots_[j].hash & mask;
+        // Distance (wrapping) from the slot's home to j and from the hole to j
+        const auto j_from_home = (j - home) & mask;
+        const auto j_from_hole = (j - i) & mask;
+        if(j_from_home < j_from_hole) continue;
+        m_slots_[i] = std::move(m_slots_[j]);
+        i           = j;
+    }
+}
+
+TPARAMS
+typename NATIVE_HASHED::const_mapped_reference NATIVE_HASHED::at_(
+  const_key_reference key) const {
+    reclaim_();
+    const auto h = hasher{}(key);
+    auto i       = find_(key, h);
+    if(i != npos && expired_(m_slots_[i].born, m_slots_[i].generation)) {
+        expire_(i);
+        throw std::out_of_range("Key not in database");
+    }
+    if(i == npos) {
+        if(!reading_through_() || !m_backup_->count(key))
+            throw std::out_of_range("Key not in database");
+        const auto stamp = backup_stamp_(h);
+        if(expired_(stamp.born, stamp.generation)) {
+            m_backup_->free(key);
+            m_stamps_.erase(h);
+            m_tiers_->expirations.fetch_add(1, relaxed_);
+            throw std::out_of_range("Key not in database");
+        }
+        // First access, load it. It's already backed up, so it's clean.
+        mapped_type value(m_backup_->at(key).get());
+        i = emplace_(key, std::move(value), h, false);
+        m_slots_[i].born       = stamp.born;
+        m_slots_[i].generation = stamp.generation;
+        m_stamps_.erase(h);
+        if(m_tiers_) m_tiers_->promotions.fetch_add(1, relaxed_);
+        // The new pair is the most recently used, so it won't be demoted
+        const auto* pnode = m_slots_[i].node.get();
+        demote_();
+        i = find_(pnode->first, h);
+    }
+    auto& slot         = m_slots_[i];
+    const bool inflate = static_cast<bool>(slot.cold);
+    if(inflate) decompress_(slot);
+    touch_(slot);
+    // The pair was just used, so it's neither removed nor compressed below
+    const auto* pvalue = &slot.node->second;
+    if(inflate) demote_();
+    cool_();
+    enforce_budget_();
+    return const_mapped_reference(pvalue);
+}
+
+TPARAMS
+void NATIVE_HASHED::backup_() {
+    if(!m_backup_) return;
+    for(auto pnode : m_dirty_) m_backup_->insert(pnode->first, pnode->second);
+    m_dirty_.clear();
+}
+
+TPARAMS
+void NATIVE_HASHED::dump_() {
+    backup_();
+    if(reading_through_())
+        for(const auto& slot : m_slots_)
+            if(slot.node) keep_stamp_(slot);
+    release_();
+    m_slots_.clear();
+    m_size_ = 0;
+    m_dirty_.clear();
+    m_next_reclaim_ = 0;
+}
+
+TPARAMS
+typename NATIVE_HASHED::size_type NATIVE_HASHED::find_(
+  const_key_reference key, size_type h) const noexcept {
+    if(m_slots_.empty()) return npos;
+    const auto mask = capacity() - 1;
+    for(auto i = h & mask; m_slots_[i].node; i = (i + 1) & mask) {
+        const auto& slot = m_slots_[i];
+        if(slot.hash == h && slot.node->first == key) return i;
+    }
+    return npos;
+}
+
+TPARAMS
+typename NATIVE_HASHED::size_type NATIVE_HASHED::emplace_(key_type key,
+                                                          mapped_type value,
+                                                          size_type h,
+                                                          bool dirty) const {
+    // Keep the load factor at or below 3/4
+    if(4 * (m_size_ + 1) > 3 * capacity())
+        rehash_(capacity() ? 2 * capacity() : 16);
+
+    const auto mask = capacity() - 1;
+    auto j          = h & mask;
+    while(m_slots_[j].node) j = (j + 1) & mask;
+    m_slots_[j].hash = h;
+    m_slots_[j].node =
+      std::make_unique<node_type>(std::move(key), std::move(value));
+    m_slots_[j].born       = clock_type::now();
+    m_slots_[j].generation = generation_();
+    touch_(m_slots_[j]);
+    if(dirty) m_dirty_.insert(m_slots_[j].node.get());
+    ++m_size_;
+    if(m_tiers_) {
+        m_tiers_->entries.fetch_add(1, relaxed_);
+        measure_(m_slots_[j]);
+        if(m_tiers_->budget && !m_budget_token_) {
+            auto reclaim      = [this](size_type n) { return shed_(0, n); };
+            m_budget_token_ = m_tiers_->budget->attach(*m_tiers_, reclaim);
+        }
+    }
+    return j;
+}
+
+TPARAMS
+void NATIVE_HASHED::rehash_(size_type new_capacity) const {
+    std::vector<slot_type> new_slots(new_capacity);
+    const auto mask = new_capacity - 1;
+    for(auto& slot : m_slots_) {
+        if(!slot.node) continue;
+        auto j = slot.hash & mask;
+        while(new_slots[j].node) j = (j + 1) & mask;
+        new_slots[j] = std::move(slot);
+    }
+    m_slots_.swap(new_slots);
+    // The pairs moved, so reclaim_ has to start over
+    m_next_reclaim_ = 0;
+}
+
+TPARAMS
+void NATIVE_HASHED::demote_() const {
+    if(!m_tiers_) return;
+
+    // Go down to 7/8 of a limit so the scan is amortized over several
+    // insertions
+    auto excess = [](size_type used, size_type limit) -> size_type {
+        if(limit == 0 || used <= limit) return 0;
+        return used - (limit - limit / 8);
+    };
+    size_type n = 0;
+    if(reading_through_())
+        n = excess(m_size_, m_tiers_->max_size.load(relaxed_));
+    const auto entries = m_tiers_->entries.load(relaxed_);
+    n = std::max(n, excess(entries, m_tiers_->max_entries.load(relaxed_)));
+    const auto max_b = m_tiers_->max_bytes.load(relaxed_);
+    const auto bytes = excess(m_tiers_->bytes.load(relaxed_), max_b);
+    if(n || bytes) shed_(n, bytes);
+}
+
+TPARAMS
+typename NATIVE_HASHED::size_type NATIVE_HASHED::shed_(size_type n,
+                                                       size_type bytes) const {
+    if(m_size_ < 2) return 0;
+    n = std::min(n, m_size_ - 1);
+
+    std::vector<const slot_type*> lru;
+    lru.reserve(m_size_);
+    for(const auto& slot : m_slots_)
+        if(slot.node) lru.push_back(&slot);
+    auto older = [](const slot_type* lhs, const slot_type* rhs) {
+        return lhs->last_used < rhs->last_used;
+    };
+    // Only the n oldest are needed, unless it's not known how many it takes
+    if(bytes)
+        std::sort(lru.begin(), lru.end(), older);
+    else
+        std::nth_element(lru.begin(), lru.begin() + n, lru.end(), older);
+
+    // Erasing moves slots around, so remember the nodes (which don't move).
+    // The last pair (the most recently used if sorted) is never a victim.
+    std::vector<std::pair<size_type, const node_type*>> victims;
+    size_type freed = 0;
+    for(auto it = lru.begin(); it + 1 != lru.end(); ++it) {
+        if(victims.size() >= n && freed >= bytes) break;
+        victims.emplace_back((*it)->hash, (*it)->node.get());
+        freed += (*it)->bytes;
+    }
+
+    for(const auto& [h, pnode] : victims) {
+        if(m_backup_ && m_dirty_.count(pnode)) {
+            m_backup_->insert(pnode->first, pnode->second);
+            m_dirty_.erase(pnode);
+        }
+        const auto i = find_(pnode->first, h);
+        if(reading_through_()) keep_stamp_(m_slots_[i]);
+        erase_(i);
+    }
+    // Demoted pairs are still part of the database, evicted ones are not
+    auto& counter =
+      reading_through_() ? m_tiers_->demotions : m_tiers_->evictions;
+    counter.fetch_add(victims.size(), relaxed_);
+    return freed;
+}
+
+TPARAMS
+void NATIVE_HASHED::measure_(slot_type& slot) const {
+    if(!m_tiers_) return;
+    if(slot.cold)
+        resize_(slot, slot.cold->size());
+    else
+        resize_(slot, m_sizer_ ? m_sizer_(slot.node->second) : 0);
+}
+
+TPARAMS
+void NATIVE_HASHED::resize_(slot_type& slot, size_type bytes) const noexcept {
+    if(!m_tiers_ || bytes == slot.bytes) return;
+    auto* pbudget = m_tiers_->budget.get();
+    if(bytes > slot.bytes) {
+        m_tiers_->bytes.fetch_add(bytes - slot.bytes, relaxed_);
+        if(pbudget) pbudget->grow(bytes - slot.bytes);
+    } else {
+        m_tiers_->bytes.fetch_sub(slot.bytes - bytes, relaxed_);
+        if(pbudget) pbudget->shrink(slot.bytes - bytes);
+    }
+    slot.bytes = bytes;
+}
+
+TPARAMS
+void NATIVE_HASHED::release_() const noexcept {
+    if(!m_tiers_) return;
+    for(auto& slot : m_slots_)
+        if(slot.node) resize_(slot, 0);
+    m_tiers_->entries.fetch_sub(m_size_, relaxed_);
+}
+
+TPARAMS
+void NATIVE_HASHED::enforce_budget_() const {
+    if(m_tiers_ && m_tiers_->budget) m_tiers_->budget->enforce();
+}
+
+TPARAMS
+void NATIVE_HASHED::touch_(slot_type& slot) const noexcept {
+    slot.last_used = ++m_clock_;
+    if(m_cold_) slot.last_time = std::chrono::steady_clock::now();
+}
+
+TPARAMS
+void NATIVE_HASHED::cool_() const {
+    if(!m_tiers_ || !m_cold_ || m_clock_ < m_next_sweep_) return;
+    const auto n = m_tiers_->cold_after_accesses.load(relaxed_);
+    const std::chrono::nanoseconds dt(m_tiers_->cold_after_ns.load(relaxed_));
+    if(n == 0 && dt.count() <= 0) return;
+
+    // Sweeps visit every slot, so they're spread out enough that the cost per
+    // access is constant
+    m_next_sweep_  = m_clock_ + std::max<size_type>(m_size_ / 4, 16);
+    const auto now = std::chrono::steady_clock::now();
+    for(auto& slot : m_slots_) {
+        if(!slot.node || slot.cold) continue;
+        const bool idle_n  = n && m_clock_ - slot.last_used >= n;
+        const bool idle_dt = dt.count() > 0 && now - slot.last_time >= dt;
+        if(idle_n || idle_dt) compress_(slot);
+    }
+}
+
+TPARAMS
+void NATIVE_HASHED::compress_(slot_type& slot) const {
+    auto* pnode = slot.node.get();
+    std::string compressed;
+    try {
+        compressed = m_cold_.compress(pnode->second);
+    } catch(...) {
+        // E.g., the value can't be serialized. Don't retry for a while.
+        slot.last_used = m_clock_;
+        slot.last_time = std::chrono::steady_clock::now();
+        return;
+    }
+
+    // The value is about to be gone, so back it up now (like a demotion)
+    if(m_backup_ && m_dirty_.count(pnode)) {
+        m_backup_->insert(pnode->first, pnode->second);
+        m_dirty_.erase(pnode);
+    }
+    slot.cold     = std::make_unique<std::string>(std::move(compressed));
+    pnode->second = mapped_type{};
+    measure_(slot);
+    m_tiers_->compressions.fetch_add(1, relaxed_);
+}
+
+TPARAMS
+void NATIVE_HASHED::decompress_(slot_type& slot) const {
+    slot.node->second = m_cold_.decompress(*slot.cold);
+    slot.cold.reset();
+    measure_(slot);
+    m_tiers_->decompressions.fetch_add(1, relaxed_);
+}
+
+TPARAMS
+typename NATIVE_HASHED::generation_type NATIVE_HASHED::generation_()
+  const noexcept {
+    if(!m_tiers_ || !m_tiers_->generation) return 0;
+    return m_tiers_->generation->load(std::memory_order_acquire);
+}
+
+TPARAMS
+bool NATIVE_HASHED::expired_(clock_type::time_point born,
+                             generation_type generation) const noexcept {
+    if(!m_tiers_) return false;
+    if(generation != generation_()) return true;
+    const std::chrono::nanoseconds ttl(m_tiers_->ttl_ns.load(relaxed_));
+    return ttl.count() > 0 && clock_type::now() - born >= ttl;
+}
+
+TPARAMS
+void NATIVE_HASHED::expire_(size_type i) const {
+    auto* pnode = m_slots_[i].node.get();
+    // Otherwise the pair would be loaded again (and look fresh)
+    if(reading_through_()) m_backup_->free(pnode->first);
+    m_dirty_.erase(pnode);
+    erase_(i);
+    m_tiers_->expirations.fetch_add(1, relaxed_);
+}
+
+TPARAMS
+void NATIVE_HASHED::keep_stamp_(const slot_type& slot) const {
+    if(!m_tiers_) return; // Nothing expires
+    // Keys sharing a hash share the older stamp, so neither looks fresher
+    // than it is
+    const stamp_type stamp{slot.born, slot.generation};
+    auto [itr, added] = m_stamps_.emplace(slot.hash, stamp);
+    if(added) return;
+    itr->second.born       = std::min(itr->second.born, stamp.born);
+    itr->second.generation = std::min(itr->second.generation, stamp.generation);
+}
+
+TPARAMS
+typename NATIVE_HASHED::stamp_type NATIVE_HASHED::backup_stamp_(
+  size_type h) const noexcept {
+    auto itr = m_stamps_.find(h);
+    if(itr != m_stamps_.end()) return itr->second;
+    return stamp_type{m_born_, m_generation_};
+}
+
+TPARAMS
+void NATIVE_HASHED::reclaim_() const {
+    if(!m_tiers_ || m_slots_.empty()) return;
+    const auto generation = generation_();
+    const bool has_ttl    = m_tiers_->ttl_ns.load(relaxed_) > 0;
+    if(!has_ttl && generation == m_clean_generation_) return;
+
+    // Visiting a few slots per call spreads the cost of freeing stale pairs
+    // over many calls. Erasing a pair moves another pair into its slot, so the
+    // slot is visited again.
+    for(size_type n = 0; n < reclaim_batch_; ++n) {
+        if(m_next_reclaim_ >= capacity()) {
+            // Every pair older than the pass's generation was removed
+            m_clean_generation_ = m_reclaim_generation_;
+            m_next_reclaim_     = 0;
+        }
+        if(m_next_reclaim_ == 0) m_reclaim_generation_ = generation;
+        const auto& slot = m_slots_[m_next_reclaim_];
+        if(slot.node && expired_(slot.born, slot.generation))
+            expire_(m_next_reclaim_);
+        else
+            ++m_next_reclaim_;
+    }
+}
+
+#undef NATIVE_HASHED
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+namespace pluginplay::cache::database {
+
+/** @brief Layers a writable database on top of a read-only one.
+ *
+ *  Overlay presents the union of two databases: a read-only "base" (e.g., a
+ *  pre-populated cache shared by many processes) and a writable "overlay"
+ *  (e.g., a database private to the current process). Reads check the overlay
+ *  first and fall back to the base. All writes go to the overlay, so the base
+ *  is never modified:
+ *
+ *  - Inserting a key the base already has shadows the base's value.
+ *  - Freeing a key hides it, even if the base has it. Which base keys are
+ *    hidden is only known to this instance, i.e., the base's values reappear
+ *    the next time the databases are layered.
+ *
+ *  @tparam KeyType The type of the keys.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+class Overlay : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the layered databases
+    using sub_db_type = base_type;
+
+    /// Type of a managed pointer to one of the layered databases
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /// Typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Typedef of const key_type&
+    using typename base_type::const_key_reference;
+
+    /// Typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Typedef of ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /** @brief Layers @p overlay on top of @p base.
+     *
+     *  @param[in] base The read-only database. This instance never writes to
+     *                  it (including backing it up).
+     *  @param[in] overlay The database which receives all writes.
+     *
+     *  @throw std::runtime_error if either database is a nullptr. Strong
+     *                            throw guarantee.
+     */
+    Overlay(sub_db_pointer base, sub_db_pointer overlay);
+
+    /// The read-only database
+    const sub_db_type& base() const noexcept { return *m_base_; }
+
+    /// The database receiving the writes
+    const sub_db_type& overlay() const noexcept { return *m_overlay_; }
+
+protected:
+    /// Visits the keys of the overlay, then the keys of the base not hidden
+    cursor_pointer cursor_() const override;
+
+    /// Calls range on the overlay and the base
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override;
+
+    /// Calls prefix on the overlay and the base
+    cursor_pointer prefix_(const_key_reference prefix) const override;
+
+    /// Is @p key in the overlay or (and not hidden) in the base?
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Inserts into the overlay, un-hiding @p key
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Frees @p key from the overlay and hides it in the base
+    void free_(const_key_reference key) override;
+
+    /// Returns the overlay's value, or the base's if the overlay has none
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Backs up the overlay
+    void backup_() override { m_overlay_->backup(); }
+
+    /// Dumps the overlay
+    void dump_() override { m_overlay_->dump(); }
+
+private:
+    /// Is @p key in the base and not hidden?
+    bool in_base_(const_key_reference key) const noexcept;
+
+    /// Visits @p overlay, then the keys of @p base not hidden or overlaid
+    cursor_pointer merge_(cursor_pointer overlay, cursor_pointer base) const;
+
+    /// The read-only database
+    sub_db_pointer m_base_;
+
+    /// The database receiving the writes
+    sub_db_pointer m_overlay_;
+
+    /// Keys of the base which have been freed
+    std::set<key_type> m_hidden_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "overlay.ipp"
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from overlay.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define OVERLAY Overlay<KeyType, ValueType>
+
+TPARAMS
+OVERLAY::Overlay(sub_db_pointer base, sub_db_pointer overlay) :
+  m_base_(std::move(base)), m_overlay_(std::move(overlay)) {
+    if(m_base_ && m_overlay_) return;
+    throw std::runtime_error("Layered databases can't be nullptr.");
+}
+
+TPARAMS
+typename OVERLAY::cursor_pointer OVERLAY::cursor_() const {
+    return merge_(m_overlay_->cursor(), m_base_->cursor());
+}
+
+TPARAMS
+typename OVERLAY::cursor_pointer OVERLAY::range_(
+  const_key_reference first, const_key_reference last) const {
+    return merge_(m_overlay_->range(first, last), m_base_->range(first, last));
+}
+
+TPARAMS
+typename OVERLAY::cursor_pointer OVERLAY::prefix_(
+  const_key_reference prefix) const {
+    return merge_(m_overlay_->prefix(prefix), m_base_->prefix(prefix));
+}
+
+TPARAMS
+bool OVERLAY::count_(const_key_reference key) const noexcept {
+    return m_overlay_->count(key) || in_base_(key);
+}
+
+TPARAMS
+void OVERLAY::insert_(key_type key, mapped_type value) {
+    m_hidden_.erase(key);
+    m_overlay_->insert(std::move(key), std::move(value));
+}
+
+TPARAMS
+void OVERLAY::free_(const_key_reference key) {
+    if(m_base_->count(key)) m_hidden_.insert(key);
+    m_overlay_->free(key);
+}
+
+TPARAMS
+typename OVERLAY::const_mapped_reference OVERLAY::at_(
+  const_key_reference key) const {
+    if(m_overlay_->count(key)) return m_overlay_->at(key);
+    if(in_base_(key)) return m_base_->at(key);
+    throw std::out_of_range("Key not in database");
+}
+
+TPARAMS
+bool OVERLAY::in_base_(const_key_reference key) const noexcept {
+    return !m_hidden_.count(key) && m_base_->count(key);
+}
+
+TPARAMS
+typename OVERLAY::cursor_pointer OVERLAY::merge_(cursor_pointer overlay,
+                                                 cursor_pointer base) const {
+    auto visible = [this](const_key_reference key) {
+        return !m_hidden_.count(key) && !m_overlay_->count(key);
+    };
+    auto filtered = std::make_unique<FilteredCursor<key_type>>(
+      std::move(base), std::move(visible));
+    return std::make_unique<ChainCursor<key_type>>(std::move(overlay),
+                                                   std::move(filtered));
+}
+
+#undef OVERLAY
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "proxy_map_codec.hpp"
+#include <array>
+#include <stdexcept>
+
+namespace pluginplay::cache::database {
+namespace {
+
+// Flags in the byte which starts each field
+constexpr unsigned char name_in_full  = 0x01;
+constexpr unsigned char value_is_uuid = 0x02;
+
+// Number of characters in, and bytes of, a UUID
+constexpr std::size_t uuid_chars = 36;
+constexpr std::size_t uuid_bytes = 16;
+
+// Is position @p i of a UUID's string a hyphen?
+constexpr bool is_hyphen(std::size_t i) noexcept {
+    return i == 8 || i == 13 || i == 18 || i == 23;
+}
+
+constexpr const char* hex_digits = "0123456789abcdef";
+
+// Values of the lower-case hex digits, -1 for every other character
+constexpr auto hex_values = [] {
+    std::array<signed char, 256> rv{};
+    for(auto& x : rv) x = -1;
+    for(int i = 0; i < 16; ++i)
+        rv[static_cast<unsigned char>(hex_digits[i])] = i;
+    return rv;
+}();
+
+// Value of the lower-case hex digit @p c, or -1 if @p c isn't one
+int hex_value(char c) noexcept {
+    return hex_values[static_cast<unsigned char>(c)];
+}
+
+// Appends the bytes of @p value to @p out if it's a canonical UUID
+bool append_uuid(const std::string& value, std::string& out) {
+    if(value.size() != uuid_chars) return false;
+    char bytes[uuid_bytes];
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < uuid_chars; i += 2) {
+        if(is_hyphen(i)) {
+            if(value[i] != '-') return false;
+            ++i;
+        }
+        const auto hi = hex_value(value[i]);
+        const auto lo = hex_value(value[i + 1]);
+        if((hi | lo) < 0) return false;
+        bytes[n++] = static_cast<char>(hi << 4 | lo);
+    }
+    out.append(bytes, uuid_bytes);
+    return true;
+}
+
+// Appends @p n to @p out, seven bits at a time
+void append_size(std::size_t n, std::string& out) {
+    for(; n >= 0x80; n >>= 7)
+        out.push_back(static_cast<char>((n & 0x7F) | 0x80));
+    out.push_back(static_cast<char>(n));
+}
+
+// Appends the size of @p s, then @p s, to @p out
+void append_string(std::string_view s, std::string& out) {
+    append_size(s.size(), out);
+    out.append(s);
+}
+
+// Appends @p id to @p out, most significant byte first
+void append_id(ProxyMapCodec::id_type id, std::string& out) {
+    for(int shift = 24; shift >= 0; shift -= 8)
+        out.push_back(static_cast<char>((id >> shift) & 0xFF));
+}
+
+// The key the name with ID @p id is saved under
+std::string name_key(ProxyMapCodec::id_type id) {
+    std::string rv(1, ProxyMapCodec::name_marker);
+    append_id(id, rv);
+    return rv;
+}
+
+// Reads encoded proxy maps, throwing if they run out early
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) noexcept : m_bytes_(bytes) {}
+
+    /// True if everything has been read
+    bool done() const noexcept { return m_bytes_.empty(); }
+
+    /// Reads one byte
+    unsigned char byte() { return static_cast<unsigned char>(take(1)[0]); }
+
+    /// Reads the next @p n bytes
+    std::string_view take(std::size_t n) {
+        if(n > m_bytes_.size())
+            throw std::runtime_error("Truncated proxy map encoding");
+        auto rv = m_bytes_.substr(0, n);
+        m_bytes_.remove_prefix(n);
+        return rv;
+    }
+
+    /// Reads a size written by append_size
+    std::size_t size() {
+        std::size_t rv = 0;
+        for(unsigned shift = 0;; shift += 7) {
+            if(shift >= 64) throw std::runtime_error("Invalid proxy map size");
+            const auto b = byte();
+            rv |= static_cast<std::size_t>(b & 0x7F) << shift;
+            if(!(b & 0x80)) return rv;
+        }
+    }
+
+    /// Reads a string written by append_string
+    std::string string() { return std::string(take(size())); }
+
+    /// Reads an ID written by append_id
+    ProxyMapCodec::id_type id() {
+        ProxyMapCodec::id_type rv = 0;
+        for(unsigned char b : take(4)) rv = (rv << 8) | b;
+        return rv;
+    }
+
+    /// Reads a UUID written by append_uuid
+    std::string uuid() {
+        char rv[uuid_chars];
+        std::size_t n = 0;
+        for(unsigned char b : take(uuid_bytes)) {
+            if(is_hyphen(n)) rv[n++] = '-';
+            rv[n++] = hex_digits[b >> 4];
+            rv[n++] = hex_digits[b & 0x0F];
+        }
+        return std::string(rv, uuid_chars);
+    }
+
+private:
+    /// The bytes which have not been read yet
+    std::string_view m_bytes_;
+};
+
+} // namespace
+
+bool ProxyMapCodec::encode(const proxy_map_type& pm, binary_type& out,
+                           bool intern, const field_type* injected) {
+    out.push_back(key_marker);
+
+    // The injected field goes where it would be if it were in pm
+    bool pending = injected && !pm.count(injected->first);
+    for(const auto& [name, value] : pm) {
+        if(pending && injected->first < name) {
+            const auto& [iname, ivalue] = *injected;
+            if(!encode_field_(iname, ivalue, out, intern)) return false;
+            pending = false;
+        }
+        if(!encode_field_(name, value, out, intern)) return false;
+    }
+    if(!pending) return true;
+    return encode_field_(injected->first, injected->second, out, intern);
+}
+
+typename ProxyMapCodec::proxy_map_type ProxyMapCodec::decode(
+  std::string_view bytes) const {
+    if(!is_encoded(bytes))
+        throw std::runtime_error("Not an encoded proxy map");
+    Reader r(bytes.substr(1));
+    proxy_map_type rv;
+    while(!r.done()) {
+        const auto flags = r.byte();
+        auto name        = flags & name_in_full ? r.string() : name_(r.id());
+        auto value       = flags & value_is_uuid ? r.uuid() : r.string();
+        rv.emplace_hint(rv.end(), std::move(name), std::move(value));
+    }
+    return rv;
+}
+
+void ProxyMapCodec::clear() noexcept {
+    std::lock_guard lock(m_mutex_);
+    m_names_.clear();
+}
+
+typename ProxyMapCodec::id_type ProxyMapCodec::name_id(
+  std::string_view name) noexcept {
+    // FNV-1a, which is the same on every platform
+    id_type h = 0x811c9dc5u;
+    for(unsigned char c : name) {
+        h ^= c;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+bool ProxyMapCodec::encode_field_(const std::string& name,
+                                 const std::string& value, binary_type& out,
+                                 bool intern) {
+    const auto state = resolve_(name, intern);
+    if(state == name_state::unsaved) return false;
+
+    const auto header = out.size();
+    out.push_back(0);
+    unsigned char flags = 0;
+    if(state == name_state::id) {
+        append_id(name_id(name), out);
+    } else {
+        flags |= name_in_full;
+        append_string(name, out);
+    }
+    if(append_uuid(value, out))
+        flags |= value_is_uuid;
+    else
+        append_string(value, out);
+    out[header] = static_cast<char>(flags);
+    return true;
+}
+
+typename ProxyMapCodec::name_state ProxyMapCodec::resolve_(
+  const std::string& name, bool intern) {
+    const auto id = name_id(name);
+    std::lock_guard lock(m_mutex_);
+    auto itr = m_names_.find(id);
+    if(itr == m_names_.end()) {
+        const auto key = name_key(id);
+        if(m_db_.count(key)) {
+            itr = m_names_.emplace(id, m_db_.at(key).get()).first;
+        } else {
+            if(!intern) return name_state::unsaved;
+            m_db_.insert(key, name);
+            itr = m_names_.emplace(id, name).first;
+        }
+    }
+    return itr->second == name ? name_state::id : name_state::in_full;
+}
+
+std::string ProxyMapCodec::name_(id_type id) const {
+    std::lock_guard lock(m_mutex_);
+    auto itr = m_names_.find(id);
+    if(itr != m_names_.end()) return itr->second;
+    const auto key = name_key(id);
+    if(!m_db_.count(key))
+        throw std::runtime_error("Proxy map uses an unknown field name");
+    return m_names_.emplace(id, m_db_.at(key).get()).first->second;
+}
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace pluginplay::cache::database {
+
+/** @brief Compact, canonical binary encoding of proxy maps.
+ *
+ *  Proxy maps (maps from field names to UUIDs) are the keys of the saved
+ *  results. Serialized generically (i.e., by cereal) every key repeats each
+ *  field name and spells out each UUID as 36 characters, each behind an
+ *  8 byte length. This class instead encodes:
+ *
+ *  - a field name as a 4 byte ID, which is a hash of the name,
+ *  - a UUID (in its canonical, lower-case form) as its 16 bytes, and
+ *  - anything else as a (variable-length) length and its bytes.
+ *
+ *  The fields are written in the map's order, so a proxy map always encodes
+ *  to the same bytes and comparing keys is comparing bytes.
+ *
+ *  The name of an ID is saved (once) in the database holding the keys, under
+ *  a reserved key starting with name_marker. Because IDs are derived from
+ *  the names (and not, e.g., handed out in order), databases can be merged
+ *  and exported/imported without renumbering. The rare name whose ID is
+ *  already taken by another name is written out in full instead.
+ *
+ *  Encoded keys start with key_marker. Keys which start with neither marker
+ *  were written with cereal (i.e., by an earlier version) and are left to
+ *  the caller to decode. Lookups encode keys with this class, so they don't
+ *  find such keys; DatabaseFactory re-encodes them when it opens the storage.
+ */
+class ProxyMapCodec {
+public:
+    /// Type of the maps this class encodes
+    using proxy_map_type = std::map<std::string, std::string>;
+
+    /// Type of the encoded maps
+    using binary_type = std::string;
+
+    /// Type of the database the keys (and the names) are saved in
+    using binary_db = DatabaseAPI<binary_type, binary_type>;
+
+    /// Type of a (field name, value) pair
+    using field_type = std::pair<std::string, std::string>;
+
+    /// Type of the IDs of field names
+    using id_type = std::uint32_t;
+
+    /// First byte of an encoded proxy map
+    static constexpr char key_marker = '\xFD';
+
+    /// First byte of the key a field name is saved under
+    static constexpr char name_marker = '\xFE';
+
+    /** @brief Makes a codec whose field names are saved in @p db.
+     *
+     *  @param[in] db The database the encoded keys go in. Must outlive *this.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit ProxyMapCodec(binary_db& db) noexcept : m_db_(db) {}
+
+    /** @brief Appends the encoding of @p pm to @p out.
+     *
+     *  @param[in] pm The proxy map to encode.
+     *  @param[out] out Where the encoding goes.
+     *  @param[in] intern If true, the names of @p pm which have not been
+     *                    saved yet are saved (use when inserting @p pm). If
+     *                    false, nothing is saved (use when looking @p pm up).
+     *  @param[in] injected If non-null, @p pm is encoded as if this field
+     *                      had been added to it (unless @p pm already has a
+     *                      field with that name). Default is null.
+     *
+     *  @return False if @p intern is false and a name of @p pm has never been
+     *          saved, in which case no saved key can be @p pm. True otherwise.
+     *
+     *  @throw ??? If the database throws while reading or saving a name.
+     */
+    bool encode(const proxy_map_type& pm, binary_type& out, bool intern,
+                const field_type* injected = nullptr);
+
+    /** @brief Decodes a proxy map encoded by encode.
+     *
+     *  @param[in] bytes The encoded proxy map, must satisfy is_encoded.
+     *
+     *  @return The decoded proxy map.
+     *
+     *  @throw std::runtime_error if @p bytes is not a valid encoding or uses
+     *                            a name which was never saved.
+     */
+    proxy_map_type decode(std::string_view bytes) const;
+
+    /// Forgets the names read so far, e.g., because the database was dumped
+    void clear() noexcept;
+
+    /// True if @p bytes were made by encode
+    static bool is_encoded(std::string_view bytes) noexcept {
+        return !bytes.empty() && bytes[0] == key_marker;
+    }
+
+    /// True if @p bytes is the key a field name is saved under
+    static bool is_name(std::string_view bytes) noexcept {
+        return !bytes.empty() && bytes[0] == name_marker;
+    }
+
+    /// The ID of @p name (if it is not taken by another name)
+    static id_type name_id(std::string_view name) noexcept;
+
+private:
+    /// How a name is written
+    enum class name_state { id, in_full, unsaved };
+
+    /// Appends the field (@p name, @p value), see encode for @p intern
+    bool encode_field_(const std::string& name, const std::string& value,
+                       binary_type& out, bool intern);
+
+    /// Works out how @p name is written, saving it if @p intern is true
+    name_state resolve_(const std::string& name, bool intern);
+
+    /// Returns the name with ID @p id, throws if there isn't one
+    std::string name_(id_type id) const;
+
+    /// The database the names are saved in
+    binary_db& m_db_;
+
+    /// The saved names read/written so far, by ID
+    mutable std::unordered_map<id_type, std::string> m_names_;
+
+    /// Guards m_names_
+    mutable std::mutex m_mutex_;
+};
+
+/// Is @p T the type of the proxy maps ProxyMapCodec encodes?
+template<typename T>
+static constexpr bool is_proxy_map_v =
+  std::is_same_v<T, typename ProxyMapCodec::proxy_map_type>;
+
+} // namespace pluginplay::cache::database
@@ -15,7 +15,16 @@
  */
 
 #include "../rocksdb.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <rocksdb/cache.h>
 #include <rocksdb/db.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/iterator.h>
+#include <rocksdb/table.h>
+#include <string>
+#include <vector>
 namespace pluginplay::cache::database::detail_ {
 
 /** @brief Implements the RocksDB class when RocksDB support is enabled.
@@ -31,6 +40,10 @@ namespace pluginplay::cache::database::detail_ {
  *  by splitting the value into smaller chunks. The splitting and reassembling
  *  of values happens automatically and users of this database should act as if
  *  it doesn't happen.
+ *
+ *  Each instance holds one column family of the database. The instances for
+ *  the column families of a database (see column_family) share the database
+ *  and the bookkeeping for its column families.
  */
 class RocksDBPIMPL {
 public:
@@ -54,6 +67,15 @@ public:
 
     using const_mapped_reference = typename parent_type::const_mapped_reference;
 
+    /// Type of a pointer to a cursor over the keys
+    using cursor_pointer = typename parent_type::cursor_pointer;
+
+    /// Type of the names of the column families
+    using name_type = typename parent_type::name_type;
+
+    /// Type of a function returning the options of a column family
+    using options_function = typename parent_type::options_function;
+
     /** @brief Creates (or opens) a RocksDB database with the specified path
      *
      *  This Ctor is used to open an existing database (if @p path already
@@ -63,16 +85,51 @@ public:
      *  if the backend can not create the database. If this call is sucessful
      *  then the database is ready for business.
      *
-     *  At the moment, construction uses the default RocksDB options for the
-     *  database. No tuning has been performed.
+     *  Every column family of the database is opened, each with the options
+     *  @p options returns for it. The resulting instance holds the "default"
+     *  column family.
      *
      *  @param[in] path For new databases this is where the database should
      *                  live, for existing databases this is where it lives.
+     *  @param[in] read_only If true, the existing database at @p path is
+     *                       opened with rocksdb::DB::OpenForReadOnly. Default
+     *                       is false.
+     *  @param[in] options Returns the options of a column family given its
+     *                     name. If null (the default) the default
+     *                     RocksDBOptions are used for every column family.
+     *
+     *  @throw std::runtime_error if RocksDB can not open the database. Strong
+     *                            throw guarantee.
+     */
+    explicit RocksDBPIMPL(const_path_reference path, bool read_only = false,
+                          options_function options = {});
+
+    /** @brief Makes an instance for column family @p name.
+     *
+     *  @param[in] name The column family. Created if it does not exist.
+     *
+     *  @return An instance which shares the database with this instance.
      *
-     *  @throws None No throw guarantee. At the moment, if an error occurs an
-     *               assertion is tripped.
+     *  @throw std::runtime_error if the column family does not exist and can
+     *                            not be created. Strong throw guarantee.
      */
-    explicit RocksDBPIMPL(const_path_reference path);
+    std::unique_ptr<RocksDBPIMPL> column_family(const name_type& name) const;
+
+    /// Does the database have column family @p name?
+    bool has_column_family(const name_type& name) const;
+
+    /// The names of the database's column families
+    std::vector<name_type> column_families() const;
+
+    /** @brief Drops column family @p name and recreates it empty.
+     *
+     *  @param[in] name The column family to empty. No-op if it DNE.
+     *
+     *  @throw std::runtime_error if the database is read-only, if @p name is
+     *                            "default", or if RocksDB fails. Strong throw
+     *                            guarantee unless recreating the family fails.
+     */
+    void drop_column_family(const name_type& name);
 
     /** @brief Returns the number of times a key appears in the database.
      *
@@ -134,12 +191,56 @@ public:
      */
     const_mapped_reference at(const_key_reference key) const;
 
+    /** @brief Returns a cursor over the keys of the column family.
+     *
+     *  The cursor wraps a rocksdb::Iterator, so the keys are read from disk
+     *  as they are visited. The iterator reads from an implicit snapshot,
+     *  meaning writes made after the cursor was created are not seen by it
+     *  and do not invalidate it. Keys are visited in sorted order.
+     *
+     *  N.B. Values split by large_value_insert_ are visited as their pieces.
+     *
+     *  @return A cursor positioned on the first key (if any).
+     *
+     *  @throw std::runtime_error if RocksDB fails. Strong throw guarantee.
+     */
+    cursor_pointer cursor() const;
+
+    /** @brief Returns a cursor over the keys in [@p first, @p last).
+     *
+     *  Seeks to @p first rather than visiting every key before it.
+     *
+     *  @throw std::runtime_error if RocksDB fails. Strong throw guarantee.
+     */
+    cursor_pointer range(const_key_reference first,
+                         const_key_reference last) const;
+
+    /** @brief Returns a cursor over the keys starting with @p prefix.
+     *
+     *  Seeks to @p prefix rather than visiting every key before it.
+     *
+     *  @throw std::runtime_error if RocksDB fails. Strong throw guarantee.
+     */
+    cursor_pointer prefix(const_key_reference prefix) const;
+
 private:
     /// Type RocksDB uses for databases
     using db_type = rocksdb::DB;
 
     /// Type RocksDB uses for database-wide options.
-    using options_type = rocksdb::Options;
+    using options_type = rocksdb::DBOptions;
+
+    /// Type RocksDB uses for the options of a column family
+    using cf_options_type = rocksdb::ColumnFamilyOptions;
+
+    /// Type RocksDB uses to describe the column families to open
+    using descriptor_list = std::vector<rocksdb::ColumnFamilyDescriptor>;
+
+    /// Type RocksDB uses for column families
+    using handle_type = rocksdb::ColumnFamilyHandle;
+
+    /// Type of a pointer to a column family, destroys the handle when done
+    using handle_pointer = std::shared_ptr<handle_type>;
 
     /// Type of a raw pointer to a RocksDB database
     using raw_db_pointer = db_type*;
@@ -153,14 +254,69 @@ private:
         }
     };
 
-    /// Type of the pointer holding a RocksDB database
-    using db_pointer = std::unique_ptr<db_type, Deleter>;
+    /// Type of the pointer holding a RocksDB database (uses Deleter)
+    using db_pointer = std::shared_ptr<db_type>;
+
+    /// A column family, its handle is replaced when the family is dropped
+    struct Family {
+        /// Accessed atomically since drop_column_family replaces it
+        handle_pointer handle;
+    };
+
+    /// Type of a pointer to a column family
+    using family_pointer = std::shared_ptr<Family>;
+
+    /// The state shared by the instances for a database's column families
+    struct SharedState {
+        /// The database
+        db_pointer db;
+
+        /// Was the database opened read-only?
+        bool read_only = false;
+
+        /// Returns the options of the column families
+        options_function options;
+
+        /// Guards families and block_caches
+        std::mutex mutex;
+
+        /// The open column families, keyed by name
+        std::map<name_type, family_pointer> families;
+
+        /// The block caches, keyed by size
+        std::map<std::size_t, std::shared_ptr<rocksdb::Cache>> block_caches;
+    };
+
+    /// Type of a pointer to the shared state
+    using shared_pointer = std::shared_ptr<SharedState>;
+
+    /// Used by column_family to make an instance for an open column family
+    RocksDBPIMPL(shared_pointer shared, family_pointer family) noexcept;
 
     /// Wraps the process of setting the default RocksDB options
     options_type options_();
 
+    /// Converts the options for column family @p name to RocksDB's options
+    cf_options_type cf_options_(const name_type& name) const;
+
+    /// Creates column family @p name
+    handle_pointer create_family_(const name_type& name) const;
+
+    /// Takes ownership of a column family handle
+    handle_pointer make_handle_(handle_type* handle) const;
+
+    /// The handle of the column family this instance holds
+    handle_pointer handle_() const;
+
+    /// Makes a cursor which starts at @p first and stops when @p in_bounds
+    /// returns false
+    template<typename BoundType>
+    cursor_pointer seek_(const_key_reference first, BoundType in_bounds) const;
+
     /// Wraps the process of allocating the RocksDB database
-    raw_db_pointer allocate_(const_path_reference path, options_type opts);
+    raw_db_pointer allocate_(const_path_reference path, options_type opts,
+                             bool read_only, const descriptor_list& families,
+                             std::vector<handle_type*>& handles);
 
     /// Asserts that the RocksDB database has been allocated
     void assert_ptr_() const;
@@ -230,13 +386,82 @@ private:
      */
     const std::size_t m_max_value_size_ = 3E9;
 
-    /// The pointer to the RocksDB database
-    db_pointer m_db_;
+    /// The database and its column families
+    shared_pointer m_shared_;
+
+    /// The column family this instance holds
+    family_pointer m_family_;
 
     /// Maps keys for large values to the keys for the pieces
     std::map<key_type, std::vector<key_type>> m_split_values_;
 };
 
+/** @brief Cursor over a rocksdb::Iterator.
+ *
+ *  The cursor holds the column family's handle (which in turn holds the
+ *  database), so the iterator can not outlive them. The key is copied out of
+ *  the iterator when the cursor moves.
+ *
+ *  @tparam BoundType Type of a functor which returns false for the first key
+ *                    past the keys the cursor visits.
+ */
+template<typename BoundType>
+class RocksDBCursor : public Cursor<std::string> {
+public:
+    /// Type of a pointer to the column family the cursor is iterating over
+    using handle_pointer = std::shared_ptr<rocksdb::ColumnFamilyHandle>;
+
+    /// Type of a pointer to the wrapped iterator
+    using iterator_pointer = std::unique_ptr<rocksdb::Iterator>;
+
+    /// Wraps @p itr, which has already been positioned
+    RocksDBCursor(handle_pointer handle, iterator_pointer itr,
+                  BoundType in_bounds) :
+      m_handle_(std::move(handle)),
+      m_itr_(std::move(itr)),
+      m_in_bounds_(std::move(in_bounds)) {
+        load_();
+    }
+
+protected:
+    bool valid_() const override { return m_valid_; }
+
+    const_key_reference key_() const override { return m_key_; }
+
+    void next_() override {
+        m_itr_->Next();
+        load_();
+    }
+
+private:
+    /// Copies the key out of the iterator and checks the bounds
+    void load_() {
+        m_valid_ = m_itr_->Valid();
+        if(!m_valid_) {
+            auto s = m_itr_->status();
+            if(!s.ok()) throw std::runtime_error(s.ToString());
+            return;
+        }
+        m_key_   = m_itr_->key().ToString();
+        m_valid_ = m_in_bounds_(m_key_);
+    }
+
+    /// Keeps the column family alive, must be destroyed after m_itr_
+    handle_pointer m_handle_;
+
+    /// The wrapped iterator
+    iterator_pointer m_itr_;
+
+    /// Is a key still in the range of keys being visited?
+    BoundType m_in_bounds_;
+
+    /// Is the cursor on a key?
+    bool m_valid_ = false;
+
+    /// A copy of the current key
+    key_type m_key_;
+};
+
 } // namespace pluginplay::cache::database::detail_
 
 #include "rocksdb_pimpl.ipp"
@@ -24,21 +24,108 @@ namespace pluginplay::cache::database::detail_ {
 #define ROCKSDB_PIMPL RocksDBPIMPL
 
 TPARAMS
-ROCKSDB_PIMPL::ROCKSDB_PIMPL(const_path_reference path) :
-  m_db_(allocate_(path, options_())) {}
+ROCKSDB_PIMPL::ROCKSDB_PIMPL(const_path_reference path, bool read_only,
+                             options_function options) :
+  m_shared_(std::make_shared<SharedState>()) {
+    m_shared_->read_only = read_only;
+    m_shared_->options   = std::move(options);
+
+    // An existing database has to be opened with all of its column families
+    std::vector<name_type> names;
+    auto s = db_type::ListColumnFamilies(options_(), path, &names);
+    if(!s.ok() || names.empty()) names = {rocksdb::kDefaultColumnFamilyName};
+
+    descriptor_list families;
+    for(const auto& name : names)
+        families.emplace_back(name, cf_options_(name));
+
+    std::vector<handle_type*> handles;
+    auto pdb = allocate_(path, options_(), read_only, families, handles);
+    m_shared_->db = db_pointer(pdb, Deleter{});
+    for(std::size_t i = 0; i < names.size(); ++i) {
+        auto pfamily    = std::make_shared<Family>();
+        pfamily->handle = make_handle_(handles[i]);
+        m_shared_->families.emplace(names[i], std::move(pfamily));
+    }
+    m_family_ = m_shared_->families.at(rocksdb::kDefaultColumnFamilyName);
+}
+
+TPARAMS
+ROCKSDB_PIMPL::ROCKSDB_PIMPL(shared_pointer shared,
+                             family_pointer family) noexcept :
+  m_shared_(std::move(shared)), m_family_(std::move(family)) {}
+
+TPARAMS
+std::unique_ptr<ROCKSDB_PIMPL> ROCKSDB_PIMPL::column_family(
+  const name_type& name) const {
+    assert_ptr_();
+    std::lock_guard<std::mutex> lock(m_shared_->mutex);
+    auto& families = m_shared_->families;
+    auto itr       = families.find(name);
+    if(itr == families.end()) {
+        if(m_shared_->read_only)
+            throw std::runtime_error("Read-only database has no column "
+                                     "family: " +
+                                     name);
+        auto pfamily    = std::make_shared<Family>();
+        pfamily->handle = create_family_(name);
+        itr             = families.emplace(name, std::move(pfamily)).first;
+    }
+    return std::unique_ptr<RocksDBPIMPL>(
+      new RocksDBPIMPL(m_shared_, itr->second));
+}
+
+TPARAMS
+bool ROCKSDB_PIMPL::has_column_family(const name_type& name) const {
+    assert_ptr_();
+    std::lock_guard<std::mutex> lock(m_shared_->mutex);
+    return m_shared_->families.count(name);
+}
+
+TPARAMS
+std::vector<typename ROCKSDB_PIMPL::name_type> ROCKSDB_PIMPL::column_families()
+  const {
+    assert_ptr_();
+    std::lock_guard<std::mutex> lock(m_shared_->mutex);
+    std::vector<name_type> rv;
+    for(const auto& [name, _] : m_shared_->families) rv.push_back(name);
+    return rv;
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::drop_column_family(const name_type& name) {
+    assert_ptr_();
+    if(m_shared_->read_only)
+        throw std::runtime_error("Can not drop the column families of a "
+                                 "read-only database");
+    if(name == rocksdb::kDefaultColumnFamilyName)
+        throw std::runtime_error("The default column family can not be "
+                                 "dropped");
+    std::lock_guard<std::mutex> lock(m_shared_->mutex);
+    auto itr = m_shared_->families.find(name);
+    if(itr == m_shared_->families.end()) return;
+
+    // Instances holding the family pick up the new handle on their next call
+    auto& family = *itr->second;
+    auto handle  = std::atomic_load(&family.handle);
+    check_status_(m_shared_->db->DropColumnFamily(handle.get()));
+    std::atomic_store(&family.handle, create_family_(name));
+}
 
 TPARAMS
 bool ROCKSDB_PIMPL::count(const_key_reference key) const noexcept {
     assert_ptr_();
     if(m_split_values_.count(key)) return true;
-    auto opts = rocksdb::ReadOptions();
+    auto opts   = rocksdb::ReadOptions();
+    auto handle = handle_();
 
     mapped_type buffer;
 
     // Rule out that it definitely doesn't exist
-    if(!m_db_->KeyMayExist(opts, key, &buffer)) return false;
+    auto& db = *m_shared_->db;
+    if(!db.KeyMayExist(opts, handle.get(), key, &buffer)) return false;
 
-    auto status = m_db_->Get(opts, key, &buffer);
+    auto status = db.Get(opts, handle.get(), key, &buffer);
     return mapped_type{} != buffer;
 }
 
@@ -50,8 +137,7 @@ void ROCKSDB_PIMPL::insert(key_type key, mapped_type value) {
         return;
     }
     auto opts = rocksdb::WriteOptions();
-    check_status_(
-      m_db_->Put(std::move(opts), std::move(key), std::move(value)));
+    check_status_(m_shared_->db->Put(opts, handle_().get(), key, value));
 }
 
 TPARAMS
@@ -62,7 +148,7 @@ void ROCKSDB_PIMPL::free(const_key_reference key) {
         return;
     }
     auto opts = rocksdb::WriteOptions();
-    check_status_(m_db_->Delete(opts, std::move(key)));
+    check_status_(m_shared_->db->Delete(opts, handle_().get(), key));
 }
 
 TPARAMS
@@ -74,12 +160,32 @@ typename ROCKSDB_PIMPL::const_mapped_reference ROCKSDB_PIMPL::at(
 
     auto opts = rocksdb::ReadOptions();
     mapped_type buffer;
-    auto status = m_db_->Get(opts, key, &buffer);
+    auto status = m_shared_->db->Get(opts, handle_().get(), key, &buffer);
 
     if(!status.ok()) throw std::out_of_range(status.ToString());
     return const_mapped_reference(std::move(buffer));
 }
 
+TPARAMS
+typename ROCKSDB_PIMPL::cursor_pointer ROCKSDB_PIMPL::cursor() const {
+    return seek_(key_type{}, [](const_key_reference) { return true; });
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::cursor_pointer ROCKSDB_PIMPL::range(
+  const_key_reference first, const_key_reference last) const {
+    // Keys are sorted bytewise, which is also how std::string compares them
+    return seek_(first, [last](const_key_reference key) { return key < last; });
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::cursor_pointer ROCKSDB_PIMPL::prefix(
+  const_key_reference prefix) const {
+    return seek_(prefix, [prefix](const_key_reference key) {
+        return has_prefix(key, prefix);
+    });
+}
+
 TPARAMS
 typename ROCKSDB_PIMPL::options_type ROCKSDB_PIMPL::options_() {
     options_type options;
@@ -87,17 +193,97 @@ typename ROCKSDB_PIMPL::options_type ROCKSDB_PIMPL::options_() {
     return options;
 }
 
+TPARAMS
+typename ROCKSDB_PIMPL::cf_options_type ROCKSDB_PIMPL::cf_options_(
+  const name_type& name) const {
+    const auto& fxn = m_shared_->options;
+    const auto opts = fxn ? fxn(name) : RocksDBOptions{};
+
+    cf_options_type rv;
+    if(opts.write_buffer_size) rv.write_buffer_size = opts.write_buffer_size;
+    switch(opts.compaction_style) {
+        case CompactionStyle::level:
+            rv.compaction_style = rocksdb::kCompactionStyleLevel;
+            break;
+        case CompactionStyle::universal:
+            rv.compaction_style = rocksdb::kCompactionStyleUniversal;
+            break;
+        case CompactionStyle::fifo:
+            rv.compaction_style = rocksdb::kCompactionStyleFIFO;
+            break;
+    }
+
+    rocksdb::BlockBasedTableOptions table;
+    if(const auto n = opts.block_cache_size) {
+        auto& cache = m_shared_->block_caches[n];
+        if(!cache) cache = rocksdb::NewLRUCache(n);
+        table.block_cache = cache;
+    }
+    if(opts.bloom_bits_per_key > 0.0)
+        table.filter_policy.reset(
+          rocksdb::NewBloomFilterPolicy(opts.bloom_bits_per_key));
+    rv.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table));
+    return rv;
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::handle_pointer ROCKSDB_PIMPL::create_family_(
+  const name_type& name) const {
+    handle_type* handle;
+    auto& db = *m_shared_->db;
+    check_status_(db.CreateColumnFamily(cf_options_(name), name, &handle));
+    return make_handle_(handle);
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::handle_pointer ROCKSDB_PIMPL::make_handle_(
+  handle_type* handle) const {
+    // The deleter keeps the database open until the handle is destroyed
+    auto db = m_shared_->db;
+    return handle_pointer(
+      handle, [db](handle_type* h) { db->DestroyColumnFamilyHandle(h); });
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::handle_pointer ROCKSDB_PIMPL::handle_() const {
+    return std::atomic_load(&m_family_->handle);
+}
+
+template<typename BoundType>
+typename ROCKSDB_PIMPL::cursor_pointer ROCKSDB_PIMPL::seek_(
+  const_key_reference first, BoundType in_bounds) const {
+    assert_ptr_();
+    auto handle = handle_();
+    std::unique_ptr<rocksdb::Iterator> itr(
+      m_shared_->db->NewIterator(rocksdb::ReadOptions(), handle.get()));
+    if(first.empty())
+        itr->SeekToFirst();
+    else
+        itr->Seek(first);
+    using cursor_type = RocksDBCursor<BoundType>;
+    return std::make_unique<cursor_type>(std::move(handle), std::move(itr),
+                                         std::move(in_bounds));
+}
+
 TPARAMS
 typename ROCKSDB_PIMPL::raw_db_pointer ROCKSDB_PIMPL::allocate_(
-  const_path_reference path, options_type opts) {
+  const_path_reference path, options_type opts, bool read_only,
+  const descriptor_list& families, std::vector<handle_type*>& handles) {
     raw_db_pointer db;
-    check_status_(rocksdb::DB::Open(std::move(opts), path, &db));
+    if(read_only) {
+        opts.create_if_missing = false;
+        check_status_(rocksdb::DB::OpenForReadOnly(opts, path, families,
+                                                   &handles, &db));
+    } else {
+        check_status_(
+          rocksdb::DB::Open(std::move(opts), path, families, &handles, &db));
+    }
     return db;
 }
 
 TPARAMS
 void ROCKSDB_PIMPL::assert_ptr_() const {
-    if(m_db_) return;
+    if(m_shared_ && m_shared_->db && m_family_) return;
     throw std::runtime_error("No allocated database. Was this PIMPL moved from"
                              " or default allocated?");
 }
@@ -15,7 +15,10 @@
  */
 
 #include "../rocksdb.hpp"
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace pluginplay::cache::database::detail_ {
 
@@ -52,8 +55,32 @@ public:
     /// Type of
     using const_mapped_reference = typename parent_type::const_mapped_reference;
 
+    /// Type of a pointer to a cursor over the keys
+    using cursor_pointer = typename parent_type::cursor_pointer;
+
+    /// Type of the names of the column families
+    using name_type = typename parent_type::name_type;
+
+    /// Type of a function returning the options of a column family
+    using options_function = typename parent_type::options_function;
+
+    /// Raises runtime_error if called
+    explicit RocksDBPIMPLStub(const_path_reference, bool = false,
+                              options_function = {}) {
+        raise_error_();
+    }
+
     /// Raises runtime_error if called
-    RocksDBPIMPLStub(const_path_reference) { raise_error_(); }
+    std::unique_ptr<RocksDBPIMPLStub> column_family(const name_type&) const;
+
+    /// Raises runtime_error if called
+    bool has_column_family(const name_type&) const;
+
+    /// Raises runtime_error if called
+    std::vector<name_type> column_families() const;
+
+    /// Raises runtime_error if called
+    void drop_column_family(const name_type&) { raise_error_(); }
 
     /// Raises runtime_error if called
     bool count(const_key_reference) const;
@@ -67,6 +94,15 @@ public:
     /// Raises runtime_error if called
     const_mapped_reference at(const_key_reference) const;
 
+    /// Raises runtime_error if called
+    cursor_pointer cursor() const;
+
+    /// Raises runtime_error if called
+    cursor_pointer range(const_key_reference, const_key_reference) const;
+
+    /// Raises runtime_error if called
+    cursor_pointer prefix(const_key_reference) const;
+
 private:
     /// Code factorization for raising the runtime_error
     void raise_error_() const;
@@ -75,6 +111,23 @@ private:
 // -----------------------------------------------------------------------------
 // -- Inline Implementations
 // -----------------------------------------------------------------------------
+inline std::unique_ptr<RocksDBPIMPLStub> RocksDBPIMPLStub::column_family(
+  const name_type&) const {
+    raise_error_();
+    return nullptr;
+}
+
+inline bool RocksDBPIMPLStub::has_column_family(const name_type&) const {
+    raise_error_();
+    return false;
+}
+
+inline std::vector<typename RocksDBPIMPLStub::name_type>
+RocksDBPIMPLStub::column_families() const {
+    raise_error_();
+    return {};
+}
+
 inline bool RocksDBPIMPLStub::count(const_key_reference) const {
     raise_error_();
     return false;
@@ -86,6 +139,24 @@ inline typename RocksDBPIMPLStub::const_mapped_reference RocksDBPIMPLStub::at(
     return const_mapped_reference{mapped_type{}};
 }
 
+inline typename RocksDBPIMPLStub::cursor_pointer RocksDBPIMPLStub::cursor()
+  const {
+    raise_error_();
+    return nullptr;
+}
+
+inline typename RocksDBPIMPLStub::cursor_pointer RocksDBPIMPLStub::range(
+  const_key_reference, const_key_reference) const {
+    raise_error_();
+    return nullptr;
+}
+
+inline typename RocksDBPIMPLStub::cursor_pointer RocksDBPIMPLStub::prefix(
+  const_key_reference) const {
+    raise_error_();
+    return nullptr;
+}
+
 inline void RocksDBPIMPLStub::raise_error_() const {
     throw std::runtime_error("PluginPlay was not compiled with RocksDB "
                              "support. To use RocksDB as a database rebuild "
@@ -36,12 +36,36 @@ TPARAMS
 ROCKS_DB::RocksDB() noexcept = default;
 
 TPARAMS
-ROCKS_DB::RocksDB(const_path_reference path) :
-  m_pimpl_(std::make_unique<pimpl_type>(path)) {}
+ROCKS_DB::RocksDB(const_path_reference path, bool read_only,
+                  options_function options) :
+  m_pimpl_(std::make_unique<pimpl_type>(path, read_only, std::move(options))) {}
+
+TPARAMS
+ROCKS_DB::RocksDB(pimpl_pointer pimpl) noexcept : m_pimpl_(std::move(pimpl)) {}
 
 TPARAMS
 ROCKS_DB::~RocksDB() noexcept = default;
 
+TPARAMS
+std::unique_ptr<ROCKS_DB> ROCKS_DB::column_family(const name_type& name) const {
+    return std::unique_ptr<RocksDB>(new RocksDB(pimpl_().column_family(name)));
+}
+
+TPARAMS
+bool ROCKS_DB::has_column_family(const name_type& name) const {
+    return pimpl_().has_column_family(name);
+}
+
+TPARAMS
+std::vector<typename ROCKS_DB::name_type> ROCKS_DB::column_families() const {
+    return pimpl_().column_families();
+}
+
+TPARAMS
+void ROCKS_DB::drop_column_family(const name_type& name) {
+    pimpl_().drop_column_family(name);
+}
+
 TPARAMS
 bool ROCKS_DB::count_(const_key_reference key) const noexcept {
     if(!m_pimpl_) return false;
@@ -62,6 +86,23 @@ typename ROCKS_DB::const_mapped_reference ROCKS_DB::at_(
     return pimpl_().at(key);
 }
 
+TPARAMS
+typename ROCKS_DB::cursor_pointer ROCKS_DB::cursor_() const {
+    return pimpl_().cursor();
+}
+
+TPARAMS
+typename ROCKS_DB::cursor_pointer ROCKS_DB::range_(
+  const_key_reference first, const_key_reference last) const {
+    return pimpl_().range(first, last);
+}
+
+TPARAMS
+typename ROCKS_DB::cursor_pointer ROCKS_DB::prefix_(
+  const_key_reference prefix) const {
+    return pimpl_().prefix(prefix);
+}
+
 TPARAMS
 void ROCKS_DB::backup_() {}
 
@@ -17,8 +17,11 @@
 #pragma once
 #include "../../../config/config_impl.hpp" // For with_rockdb_v
 #include "../database_api.hpp"
+#include <functional>
 #include <memory>
+#include <pluginplay/cache/rocksdb_options.hpp>
 #include <string>
+#include <vector>
 
 namespace pluginplay::cache::database {
 namespace detail_ {
@@ -34,6 +37,12 @@ class RocksDBPIMPLStub;
  *  RocksDB support. In the case that PluginPlay was built without RocksDB
  *  support attempting to use this class will result in runtime errors.
  *
+ *  A RocksDB database consists of one or more column families, i.e., key/value
+ *  stores which share the database's files, but have their own options. An
+ *  instance of this class holds the "default" column family; instances for the
+ *  other column families are made with column_family and share the database
+ *  with the instance they were made from.
+ *
  *  N.B. API documentation assumes that RocksDB support has been enabled. If it
  *  has not, then attempting to call any method other than the default ctor or
  *  the dtor will result in a runtime error.
@@ -56,12 +65,21 @@ public:
     /// Type of a read-only reference to the disk location
     using const_path_reference = const path_type&;
 
+    /// Type of the names of the column families
+    using name_type = std::string;
+
+    /// Type of a function returning the options of a column family
+    using options_function = std::function<RocksDBOptions(const name_type&)>;
+
     /// @copydoc base_type::key_type
     using key_type = typename base_type::key_type;
 
     /// @copydoc base_type::const_key_reference
     using const_key_reference = typename base_type::const_key_reference;
 
+    /// @copydoc base_type::cursor_pointer
+    using cursor_pointer = typename base_type::cursor_pointer;
+
     /// @copydoc base_type::mapped_type
     using mapped_type = typename base_type::mapped_type;
 
@@ -87,15 +105,29 @@ public:
      *  if the backend can not create the database. If this call is sucessful
      *  then the database is ready for business.
      *
+     *  RocksDB only lets one process open a database for writing. If
+     *  @p read_only is true the database is instead opened with RocksDB's
+     *  read-only mode, which any number of processes can do at once (as long
+     *  as no process has the database open for writing). Calling insert or
+     *  free on a read-only database raises an error.
+     *
      *  @param[in] path Where the RocksDB database lives/will live. If @p path
      *                  is an already existing RocksDB database the resulting
      *                  instance will open it. If @p path is not an existing
      *                  database then a new database will be created and opend.
+     *  @param[in] read_only Should the existing database at @p path be opened
+     *                       read-only? Default is false.
+     *  @param[in] options Called with the name of each column family to get
+     *                     the family's options. If null (the default) every
+     *                     column family uses the default RocksDBOptions.
      *
      *  @throw std::bad_alloc if the PIMPL can not be created. Strong throw
      *                        guarantee.
+     *  @throw std::runtime_error if RocksDB can not open the database. Strong
+     *                            throw guarantee.
      */
-    explicit RocksDB(const_path_reference path);
+    explicit RocksDB(const_path_reference path, bool read_only = false,
+                     options_function options = {});
 
     /** @brief Default Dtor
      *
@@ -103,6 +135,59 @@ public:
      */
     ~RocksDB() noexcept;
 
+    /** @brief Makes an instance for a column family of this database.
+     *
+     *  If the column family does not exist it is created, using the options
+     *  returned by the options function this database was opened with.
+     *
+     *  @param[in] name The name of the column family.
+     *
+     *  @return An instance whose keys and values live in column family
+     *          @p name. It shares the database with this instance.
+     *
+     *  @throw std::runtime_error if this instance has no PIMPL, or if the
+     *                            column family does not exist and can not be
+     *                            created (e.g., because the database is
+     *                            read-only). Strong throw guarantee.
+     */
+    std::unique_ptr<RocksDB> column_family(const name_type& name) const;
+
+    /** @brief Does the database have the column family @p name?
+     *
+     *  @param[in] name The name of the column family.
+     *
+     *  @return True if column family @p name exists and false otherwise.
+     *
+     *  @throw std::runtime_error if this instance has no PIMPL. Strong throw
+     *                            guarantee.
+     */
+    bool has_column_family(const name_type& name) const;
+
+    /** @brief Lists the column families of the database.
+     *
+     *  @return The names of the column families, including "default".
+     *
+     *  @throw std::runtime_error if this instance has no PIMPL. Strong throw
+     *                            guarantee.
+     */
+    std::vector<name_type> column_families() const;
+
+    /** @brief Deletes the contents of a column family.
+     *
+     *  The column family is dropped, which removes its contents without
+     *  having to delete the keys one at a time, and then recreated (with the
+     *  same options). Instances made for the column family remain usable and
+     *  see the new, empty, column family. This is a no-op if the column family
+     *  does not exist.
+     *
+     *  @param[in] name The name of the column family.
+     *
+     *  @throw std::runtime_error if this instance has no PIMPL, if the
+     *                            database is read-only, or if @p name is
+     *                            "default". Strong throw guarantee.
+     */
+    void drop_column_family(const name_type& name);
+
 protected:
     /// Implements count method
     bool count_(const_key_reference key) const noexcept override;
@@ -116,6 +201,16 @@ protected:
     /// Implements at and operator[]
     const_mapped_reference at_(const_key_reference key) const override;
 
+    /// Implements cursor with a rocksdb::Iterator
+    cursor_pointer cursor_() const override;
+
+    /// Implements range by seeking to @p first
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override;
+
+    /// Implements prefix by seeking to @p prefix
+    cursor_pointer prefix_(const_key_reference prefix) const override;
+
     /// Implements backup (which ATM is a no-op)
     void backup_() override;
 
@@ -136,6 +231,9 @@ private:
     /// Type of a mutable pointer to the PIMPL
     using pimpl_pointer = std::unique_ptr<pimpl_type>;
 
+    /// Used by column_family to make an instance from a PIMPL
+    explicit RocksDB(pimpl_pointer pimpl) noexcept;
+
     /// Factors out throwing if a PIMPL has not been allocated
     void assert_pimpl_() const;
 
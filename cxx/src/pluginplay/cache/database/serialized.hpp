@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 
+#include "../detail_/archive_buffers.hpp"
 #include "database_api.hpp"
+#include "proxy_map_codec.hpp"
+#include <optional>
 #include <parallelzone/serialization.hpp>
 
 namespace pluginplay::cache::database {
@@ -35,6 +38,11 @@ namespace pluginplay::cache::database {
  *        occur on the wrapped database (e.g., calling dump will actually call
  *        dump on the wrapped database too)
  *
+ *  Keys which are proxy maps are not serialized with cereal, but encoded by
+ *  ProxyMapCodec, which makes them several times smaller. Keys saved with
+ *  cereal (by earlier versions) can still be visited, but are not found by
+ *  lookups. DatabaseFactory upgrades such keys (see set_serialized_pm_to_pm).
+ *
  *  @tparam KeyType The type of the keys. Must be serializable.
  *  @tparam ValueType The type of the objects that the keys map to. Must be
  *                    serializable.
@@ -53,7 +61,10 @@ public:
     using sub_db_type = DatabaseAPI<binary_type, binary_type>;
 
     /// Type of a managed pointer to an instance of sub_db_type
-    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+    using sub_db_pointer = std::shared_ptr<sub_db_type>;
+
+    /// Type of a field added to every key, see the second ctor
+    using field_type = typename ProxyMapCodec::field_type;
 
     /// Typedef of KeyType
     using typename base_type::key_type;
@@ -61,6 +72,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Typedef of const key_type&
     using typename base_type::const_key_reference;
 
@@ -82,13 +96,36 @@ public:
      *               expected to ensure that @p p is non-null. Using a null @p p
      *               will result in undefined behavior.
      *
-     *  @throw None No throw guarantee.
+     *  @throw std::bad_alloc if there is a problem allocating the codec of
+     *                        proxy map keys. Strong throw guarantee.
+     */
+    Serialized(sub_db_pointer p) : m_db_(std::move(p)) {
+        if constexpr(is_proxy_map_v<key_type>)
+            m_codec_ = std::make_unique<ProxyMapCodec>(*m_db_);
+    }
+
+    /** @brief Creates a Serialized instance which adds @p injected to every
+     *         key.
+     *
+     *  Only available if the keys are proxy maps. The keys of this instance
+     *  are saved as if @p injected had been added to them (see KeyInjector).
+     *  Rather than copying each key to add the field, the field is added as
+     *  the key is encoded, so lookups do not copy (or allocate) any maps.
+     *  Only the saved keys which have @p injected are visited, and they are
+     *  visited without it. This lets instances with different fields share
+     *  @p p, e.g., to keep the results of different modules apart.
+     *
+     *  @param[in] p The database to wrap. Expected to be non-null.
+     *  @param[in] injected The field to add to every key.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the codec.
+     *                        Strong throw guarantee.
      */
-    Serialized(sub_db_pointer p) : m_db_(std::move(p)) {}
+    Serialized(sub_db_pointer p, field_type injected);
 
 protected:
-    /// returns a container with the deserialized keys
-    key_set_type keys_() const override;
+    /// Wraps m_db_->cursor(), deserializing each key when it's visited
+    cursor_pointer cursor_() const override;
 
     /// Checks if wrapped db has serialized @p key
     bool count_(const_key_reference key) const noexcept override;
@@ -106,19 +143,44 @@ protected:
     void backup_() override { m_db_->backup(); }
 
     /// Implements dump by calling dump on the wrapped database
-    void dump_() override { m_db_->dump(); }
+    void dump_() override {
+        m_db_->dump();
+        if(m_codec_) m_codec_->clear();
+    }
 
 private:
+    /// Type of the (thread-local) buffer objects are serialized into
+    using buffer_type = cache::detail_::OutputBuffer;
+
+    /// Serializes @p serialize_me into @p buffer, e.g., to look it up in place
+    template<typename T>
+    void serialize_(T&& serialize_me, buffer_type& buffer) const;
+
     /// Wraps the process of serializing an object of type @p T
     template<typename T>
     binary_type serialize_(T&& serialize_me) const;
 
-    /// Wraps the process of deserializing to an object of type @p T
+    /// Wraps the process of deserializing to an object of type @p T. The
+    /// bytes are read in place.
     template<typename T>
-    T deserialize_(const binary_type& deserialize_me) const;
+    T deserialize_(std::string_view deserialize_me) const;
+
+    /// Serializes @p key into @p buffer, using m_codec_ if it's set. False if
+    /// @p intern is false and @p key can't be in the wrapped database.
+    bool serialize_key_(const_key_reference key, buffer_type& buffer,
+                        bool intern) const;
+
+    /// Undoes serialize_key_ (or serialize_ for keys saved with cereal)
+    key_type deserialize_key_(std::string_view key) const;
 
     /// The binary database we are serializing in to/out of
     sub_db_pointer m_db_;
+
+    /// Encodes the keys if they are proxy maps, otherwise null
+    std::unique_ptr<ProxyMapCodec> m_codec_;
+
+    /// The field added to each key, if there is one
+    std::optional<field_type> m_injected_;
 };
 
 } // namespace pluginplay::cache::database
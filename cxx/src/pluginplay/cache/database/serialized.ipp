@@ -22,60 +22,129 @@ namespace pluginplay::cache::database {
 #define SERIALIZED Serialized<KeyType, ValueType>
 
 TPARAMS
-typename SERIALIZED::key_set_type SERIALIZED::keys_() const {
-    key_set_type rv;
-    for(const auto& k : m_db_->keys()) rv.push_back(deserialize_<key_type>(k));
+SERIALIZED::Serialized(sub_db_pointer p, field_type injected) :
+  m_db_(std::move(p)), m_injected_(std::move(injected)) {
+    static_assert(is_proxy_map_v<key_type>,
+                  "Fields can only be injected into proxy maps");
+    m_codec_ = std::make_unique<ProxyMapCodec>(*m_db_);
+}
+
+TPARAMS
+typename SERIALIZED::cursor_pointer SERIALIZED::cursor_() const {
+    auto psub = m_db_->cursor();
+    if(m_codec_) { // Skip the saved field names
+        auto is_key = [](const binary_type& k) {
+            return !ProxyMapCodec::is_name(k);
+        };
+        using filtered_type = FilteredCursor<binary_type>;
+        psub = std::make_unique<filtered_type>(std::move(psub), is_key);
+    }
+    auto fxn = [this](const binary_type& k) { return deserialize_key_(k); };
+    using cursor_type = TransformCursor<key_type, binary_type>;
+    cursor_pointer rv =
+      std::make_unique<cursor_type>(std::move(psub), std::move(fxn));
+    if constexpr(is_proxy_map_v<key_type>) {
+        if(!m_injected_) return rv;
+
+        // Only our keys are visited, and they're visited without the field
+        auto is_ours = [this](const_key_reference k) {
+            auto itr = k.find(m_injected_->first);
+            return itr != k.end() && itr->second == m_injected_->second;
+        };
+        auto remove = [this](const_key_reference k) {
+            auto rv = k;
+            rv.erase(m_injected_->first);
+            return rv;
+        };
+        using filtered_type = FilteredCursor<key_type>;
+        rv = std::make_unique<filtered_type>(std::move(rv), std::move(is_ours));
+        using strip_type = TransformCursor<key_type, key_type>;
+        rv = std::make_unique<strip_type>(std::move(rv), std::move(remove));
+    }
     return rv;
 }
 
 TPARAMS
 bool SERIALIZED::count_(const_key_reference key) const noexcept {
     try {
-        return m_db_->count(serialize_(key));
+        buffer_type buffer;
+        if(!serialize_key_(key, buffer, false)) return false;
+        return m_db_->count(buffer.bytes());
     } catch(...) { return false; }
 }
 
 TPARAMS
 void SERIALIZED::insert_(key_type key, mapped_type value) {
-    auto skey = serialize_(std::move(key));
+    buffer_type buffer;
+    serialize_key_(key, buffer, true);
     auto sval = serialize_(std::move(value));
-    m_db_->insert(std::move(skey), std::move(sval));
+    m_db_->insert(buffer.bytes(), std::move(sval));
 }
 
 TPARAMS
 void SERIALIZED::free_(const_key_reference key) {
-    m_db_->free(serialize_(key));
+    buffer_type buffer;
+    if(serialize_key_(key, buffer, false)) m_db_->free(buffer.bytes());
 }
 
 TPARAMS
 typename SERIALIZED::const_mapped_reference SERIALIZED::at_(
   const_key_reference key) const {
-    auto serialized_key = serialize_(key);
-    auto serialized_val = m_db_->at(serialized_key);
+    buffer_type buffer;
+    if(!serialize_key_(key, buffer, false))
+        throw std::out_of_range("Key not in database");
+    auto serialized_val = m_db_->at(buffer.bytes());
     auto rv             = deserialize_<mapped_type>(serialized_val.get());
     return const_mapped_reference(std::move(rv));
 }
 
+TPARAMS
+template<typename T>
+void SERIALIZED::serialize_(T&& serialize_me, buffer_type& buffer) const {
+    cereal::BinaryOutputArchive ar(buffer.stream());
+    ar << std::forward<T>(serialize_me);
+}
+
 TPARAMS
 template<typename T>
 typename SERIALIZED::binary_type SERIALIZED::serialize_(
   T&& serialize_me) const {
-    std::stringstream ss;
-    cereal::BinaryOutputArchive ar(ss);
-    ar << std::forward<T>(serialize_me);
-    return ss.str();
+    buffer_type buffer;
+    serialize_(std::forward<T>(serialize_me), buffer);
+    return buffer.bytes();
 }
 
 TPARAMS
 template<typename T>
-T SERIALIZED::deserialize_(const binary_type& deserialize_me) const {
-    std::stringstream ss(deserialize_me);
-    cereal::BinaryInputArchive ar(ss);
+T SERIALIZED::deserialize_(std::string_view deserialize_me) const {
+    cache::detail_::InputBuffer buffer(deserialize_me);
+    cereal::BinaryInputArchive ar(buffer.stream());
     T rv;
     ar >> rv;
     return rv;
 }
 
+TPARAMS
+bool SERIALIZED::serialize_key_(const_key_reference key, buffer_type& buffer,
+                                bool intern) const {
+    if constexpr(is_proxy_map_v<key_type>) {
+        const auto* injected = m_injected_ ? &*m_injected_ : nullptr;
+        return m_codec_->encode(key, buffer.bytes(), intern, injected);
+    } else {
+        serialize_(key, buffer);
+        return true;
+    }
+}
+
+TPARAMS
+typename SERIALIZED::key_type SERIALIZED::deserialize_key_(
+  std::string_view key) const {
+    if constexpr(is_proxy_map_v<key_type>) {
+        if(ProxyMapCodec::is_encoded(key)) return m_codec_->decode(key);
+    }
+    return deserialize_<key_type>(key);
+}
+
 #undef SERIALIZED
 #undef TPARAMS
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace pluginplay::cache::database {
+
+class MemoryBudget;
+
+/** @brief State a NativeHashed instance shares with whoever manages the
+ *         memory it uses.
+ *
+ *  When a NativeHashed instance reads through to a backup database, the
+ *  instance acts as an in-memory tier sitting in front of the backup. This
+ *  class holds the knob which limits how many key/value pairs the instance
+ *  keeps in memory, and counts how often key/value pairs move between the
+ *  instance and its backup. It also holds the knobs which decide when a value
+ *  is cold, i.e., kept in memory only in compressed form (see ColdCodec), and
+ *  when a key/value pair is stale. A pair is stale if it's older than the
+ *  time to live, or if the generation changed since the pair was added.
+ *  Finally, it holds the owner's memory quotas, and priority, and tracks how
+ *  much memory the instance (or instances, the owner may share a TierState
+ *  among several NativeHashed instances) uses.
+ *
+ *  Everything (except which generation counter and budget to use, which must
+ *  be set before the instance is shared) is atomic so the owner can change
+ *  the knobs, and read the counters, without synchronizing with the database.
+ */
+struct TierState {
+    /// Type used for counting
+    using counter_type = std::atomic<std::uint64_t>;
+
+    /// Type of a pointer to a generation counter (possibly shared)
+    using generation_pointer = std::shared_ptr<const counter_type>;
+
+    /// Maximum number of key/value pairs kept in memory, 0 means no limit
+    std::atomic<std::size_t> max_size{0};
+
+    /// Number of key/value pairs loaded from the backup
+    counter_type promotions{0};
+
+    /// Number of lookups which found the key in the backup, but not in memory
+    counter_type backup_finds{0};
+
+    /// Number of key/value pairs removed from memory to respect max_size
+    counter_type demotions{0};
+
+    /// Can values become cold, i.e., does an instance have a ColdCodec?
+    std::atomic<bool> coolable{false};
+
+    /// Values not retrieved in this many accesses become cold, 0 means never
+    std::atomic<std::size_t> cold_after_accesses{0};
+
+    /// Values not retrieved in this many nanoseconds become cold, 0 is never
+    std::atomic<std::int64_t> cold_after_ns{0};
+
+    /// Number of values which were compressed because they became cold
+    counter_type compressions{0};
+
+    /// Number of cold values which were decompressed to be retrieved
+    counter_type decompressions{0};
+
+    /// Pairs older than this many nanoseconds are stale, 0 means never
+    std::atomic<std::int64_t> ttl_ns{0};
+
+    /// Pairs added before this counter last changed are stale, may be null
+    generation_pointer generation;
+
+    /// Number of stale pairs which were removed
+    counter_type expirations{0};
+
+    /// Quota on the pairs kept in memory (demoting or evicting), 0 is none
+    std::atomic<std::size_t> max_entries{0};
+
+    /// Quota on the bytes of the values kept in memory, 0 is none
+    std::atomic<std::size_t> max_bytes{0};
+
+    /// Pairs are taken from lower priorities first to respect the budget
+    std::atomic<int> priority{1};
+
+    /// Number of pairs in memory
+    std::atomic<std::size_t> entries{0};
+
+    /// Approximate number of bytes used by the values in memory
+    std::atomic<std::size_t> bytes{0};
+
+    /// Number of pairs removed from memory (and not backed up) to respect
+    /// the quotas or the budget
+    counter_type evictions{0};
+
+    /// The budget shared with other owners, may be null
+    std::shared_ptr<MemoryBudget> budget;
+
+    /// Is the owner over one of its quotas?
+    bool over_quota() const noexcept {
+        const auto max_n = max_entries.load(std::memory_order_relaxed);
+        const auto max_b = max_bytes.load(std::memory_order_relaxed);
+        return (max_n && entries.load(std::memory_order_relaxed) > max_n) ||
+               (max_b && bytes.load(std::memory_order_relaxed) > max_b);
+    }
+};
+
+/** @brief How a NativeHashed instance compresses its cold values.
+ *
+ *  @tparam ValueType The type of the values being compressed.
+ */
+template<typename ValueType>
+struct ColdCodec {
+    /// Type of a function compressing a value, throws if it can't
+    using compress_function = std::function<std::string(const ValueType&)>;
+
+    /// Type of a function undoing compress_function
+    using decompress_function = std::function<ValueType(const std::string&)>;
+
+    /// Compresses a value
+    compress_function compress;
+
+    /// Decompresses a value
+    decompress_function decompress;
+
+    /// Can values be compressed?
+    explicit operator bool() const noexcept {
+        return compress && decompress;
+    }
+};
+
+} // namespace pluginplay::cache::database
@@ -42,6 +42,13 @@ namespace pluginplay::cache::database {
  *  This class does nothing to prevent this from happening (in case that's the
  *  user's desired behvior).
  *
+ *  Looking up a "key" of a Transposer requires searching the values of the
+ *  wrapped database, which is O(N). If an index database (a database from
+ *  the keys to the values, i.e., the untransposed mapping) is provided it is
+ *  kept in sync with the wrapped database and used for lookups instead. If the
+ *  index is persistent this also allows the Transposer to find key/value
+ *  pairs which were added in a previous run, without loading them.
+ *
  *  @tparam KeyType The type of the keys. Will actually be the values in the
  *                  wrapped database.
  *  @tparam ValueType The types of the values. Will actually be the keys in the
@@ -60,6 +67,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Type of a read-only reference to a key, typedef of const KeyType&
     using typename base_type::const_key_reference;
 
@@ -75,6 +85,12 @@ public:
     /// Type of a smart pointer to a database suitable for wrapping
     using wrapped_db_pointer = std::unique_ptr<wrapped_db_type>;
 
+    /// Type of the (optional) database used to look keys up
+    using index_db_type = DatabaseAPI<key_type, mapped_type>;
+
+    /// Type of a smart pointer to an index database
+    using index_db_pointer = std::unique_ptr<index_db_type>;
+
     /** @brief Creates a new Transposer instance by wrapping the provided
      *         database.
      *
@@ -90,14 +106,30 @@ public:
      *
      *  @param[in] p The database we are wrapping. @p p is expected to have been
      *               allocated by the caller.
+     *  @param[in] index A database mapping keys to values, which will be used
+     *                   to look up keys. Every key/value pair inserted through
+     *                   this instance is also inserted into @p index. If
+     *                   @p index is a nullptr (the default), lookups search
+     *                   the wrapped database.
      *
      *  @throw std::runtime_error if @p p is a nullptr. Strong throw guarantee.
      */
-    explicit Transposer(wrapped_db_pointer p);
+    explicit Transposer(wrapped_db_pointer p, index_db_pointer index = {});
+
+    /** @brief Provides read-only access to the wrapped database.
+     *
+     *  This allows values to be mapped back to keys, e.g., the key for value
+     *  `v` is `transposed_db().at(v)`.
+     *
+     *  @return A read-only reference to the wrapped database.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const wrapped_db_type& transposed_db() const noexcept { return *m_db_; }
 
 protected:
-    /// Returns a copy of m_keys_
-    key_set_type keys_() const override;
+    /// Visits the values of m_db_ (or m_keys_ if there's no index)
+    cursor_pointer cursor_() const override;
 
     /// Loops over m_keys_ looking for a "key" whose value is @p key
     bool count_(const_key_reference key) const noexcept override;
@@ -111,18 +143,29 @@ protected:
     /// Loops over m_keys_ returning the value that maps to @p key
     const_mapped_reference at_(const_key_reference key) const override;
 
-    /// Calls backup on the wrapped databse
-    void backup_() override { m_db_->backup(); }
+    /// Calls backup on the wrapped databse (and the index)
+    void backup_() override;
 
     /// Calls dump on the wrapped database and clear on m_keys_
     void dump_() override;
 
 private:
+    /// The values whose keys have to be found by searching the wrapped DB
+    const std::set<mapped_type>& unindexed_() const noexcept {
+        return m_index_ ? m_unindexed_ : m_keys_;
+    }
+
     /// The values the user has provided, they are keys in the wrapped database
     std::set<mapped_type> m_keys_;
 
+    /// The values whose keys could not be added to m_index_
+    std::set<mapped_type> m_unindexed_;
+
     /// The wrapped database
     wrapped_db_pointer m_db_;
+
+    /// Maps keys to values (may be null)
+    index_db_pointer m_index_;
 };
 
 } // namespace pluginplay::cache::database
@@ -22,20 +22,30 @@ namespace pluginplay::cache::database {
 #define TRANSPOSER Transposer<KeyType, ValueType>
 
 TPARAMS
-TRANSPOSER::Transposer(wrapped_db_pointer p) : m_db_(std::move(p)) {
+TRANSPOSER::Transposer(wrapped_db_pointer p, index_db_pointer index) :
+  m_db_(std::move(p)), m_index_(std::move(index)) {
     if(!m_db_) throw std::runtime_error("Wrapped database can't be nullptr.");
 }
 
 TPARAMS
-typename TRANSPOSER::key_set_type TRANSPOSER::keys_() const {
-    key_set_type rv;
-    for(const auto& val : m_keys_) rv.push_back(m_db_->at(val).get());
-    return rv;
+typename TRANSPOSER::cursor_pointer TRANSPOSER::cursor_() const {
+    using cursor_type = TransformCursor<key_type, mapped_type>;
+    auto fxn = [this](const mapped_type& val) { return m_db_->at(val).get(); };
+
+    // The wrapped DB may have values m_keys_ doesn't
+    if(m_index_) return std::make_unique<cursor_type>(m_db_->cursor(), fxn);
+
+    using itr_type = typename std::set<mapped_type>::const_iterator;
+    auto proj      = [](itr_type itr) { return &*itr; };
+    auto vals      = make_iterator_cursor<mapped_type>(m_keys_.begin(),
+                                                       m_keys_.end(), proj);
+    return std::make_unique<cursor_type>(std::move(vals), std::move(fxn));
 }
 
 TPARAMS
 bool TRANSPOSER::count_(const_key_reference key) const noexcept {
-    for(const auto& val : m_keys_)
+    if(m_index_ && m_index_->count(key)) return true;
+    for(const auto& val : unindexed_())
         if(m_db_->at(val).get() == key) return true;
     return false;
 }
@@ -43,15 +53,31 @@ bool TRANSPOSER::count_(const_key_reference key) const noexcept {
 TPARAMS
 void TRANSPOSER::insert_(key_type key, mapped_type value) {
     m_keys_.insert(value);
+    if(m_index_) {
+        // Not all keys can be indexed (e.g., a persistent index requires the
+        // keys to be serializable), those keys are searched for instead
+        try {
+            m_index_->insert(key, value);
+        } catch(...) { m_unindexed_.insert(value); }
+    }
     m_db_->insert(std::move(value), std::move(key));
 }
 
 TPARAMS
 void TRANSPOSER::free_(const_key_reference key) {
-    for(const auto& val : m_keys_)
+    if(m_index_ && m_index_->count(key)) {
+        const mapped_type val = m_index_->at(key).get();
+        m_index_->free(key);
+        m_db_->free(val);
+        m_keys_.erase(val);
+        return;
+    }
+    for(const auto& val : unindexed_())
         if(m_db_->at(val).get() == key) {
-            m_db_->free(val);
-            m_keys_.erase(val);
+            const mapped_type copy = val; // val is erased below
+            m_db_->free(copy);
+            m_keys_.erase(copy);
+            m_unindexed_.erase(copy);
             return;
         }
 }
@@ -59,15 +85,24 @@ void TRANSPOSER::free_(const_key_reference key) {
 TPARAMS
 typename TRANSPOSER::const_mapped_reference TRANSPOSER::at_(
   const_key_reference key) const {
-    for(const auto& val : m_keys_)
+    if(m_index_ && m_index_->count(key)) return m_index_->at(key);
+    for(const auto& val : unindexed_())
         if(m_db_->at(val).get() == key) return const_mapped_reference{&val};
     throw std::out_of_range("Key not found");
 }
 
+TPARAMS
+void TRANSPOSER::backup_() {
+    m_db_->backup();
+    if(m_index_) m_index_->backup();
+}
+
 TPARAMS
 void TRANSPOSER::dump_() {
     m_db_->dump();
+    if(m_index_) m_index_->backup();
     m_keys_.clear();
+    m_unindexed_.clear();
 }
 
 #undef TRANSPOSER
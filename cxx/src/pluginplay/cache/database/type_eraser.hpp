@@ -76,6 +76,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Type used for type-erasure, typedef of any::AnyField
     using any_type = any::AnyField;
 
@@ -99,8 +102,8 @@ public:
     explicit TypeEraser(wrapped_mapper_pointer db);
 
 public:
-    /// un-type-erases keys from m_db_->keys()
-    key_set_type keys_() const override;
+    /// Wraps m_db_->cursor(), un-type-erasing each key when it's visited
+    cursor_pointer cursor_() const override;
 
     /// type-erases key, then calls m_db_->count
     bool count_(const_key_reference key) const noexcept override;
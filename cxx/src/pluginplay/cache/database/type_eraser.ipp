@@ -28,11 +28,10 @@ TYPE_ERASER::TypeEraser(wrapped_mapper_pointer db) : m_db_(db) {
 }
 
 TPARAMS
-typename TYPE_ERASER::key_set_type TYPE_ERASER::keys_() const {
-    key_set_type rv;
-    for(const auto& key : m_db_->keys())
-        rv.push_back(any::any_cast<key_type>(key));
-    return rv;
+typename TYPE_ERASER::cursor_pointer TYPE_ERASER::cursor_() const {
+    auto fxn = [](const any_type& key) { return any::any_cast<key_type>(key); };
+    using cursor_type = TransformCursor<key_type, any_type>;
+    return std::make_unique<cursor_type>(m_db_->cursor(), std::move(fxn));
 }
 
 TPARAMS
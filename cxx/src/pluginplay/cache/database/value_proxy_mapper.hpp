@@ -53,6 +53,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
     /// Type the ProxyMapMaker used for assigning proxies
     using proxy_map_maker = ProxyMapMaker<mapped_type>;
 
@@ -81,8 +84,19 @@ public:
                      sub_db_pointer sub_db);
 
 protected:
-    /// Just calls keys() on the wrapped db
-    key_set_type keys_() const override { return m_sub_db_->keys(); }
+    /// Calls m_sub_db_->cursor()
+    cursor_pointer cursor_() const override { return m_sub_db_->cursor(); }
+
+    /// Calls m_sub_db_->range(first, last)
+    cursor_pointer range_(const_key_reference first,
+                          const_key_reference last) const override {
+        return m_sub_db_->range(first, last);
+    }
+
+    /// Calls m_sub_db_->prefix(prefix)
+    cursor_pointer prefix_(const_key_reference prefix) const override {
+        return m_sub_db_->prefix(prefix);
+    }
 
     /// Makes sure key is in proxy_mapper, if so then check sub_db
     bool count_(const_key_reference key) const noexcept override;
@@ -90,7 +104,7 @@ protected:
     /// Inserts into proxy_mapper, then into sub_db
     void insert_(key_type key, mapped_type value) override;
 
-    /// Removes key from sub_db only
+    /// Removes key from sub_db, releasing its value's references (if counted)
     void free_(const_key_reference key) override;
 
     /// Uses proxy_mapper to map key, before calling sub_db
@@ -103,6 +117,9 @@ protected:
     void dump_() override;
 
 private:
+    /// Releases the references held by the value of @p key (if any)
+    void release_(const_key_reference key);
+
     /// Used to map keys to proxy maps
     proxy_map_maker_pointer m_proxy_mapper_;
 
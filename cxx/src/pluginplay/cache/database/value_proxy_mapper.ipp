@@ -37,11 +37,13 @@ bool VALUE_PROXY_MAPPER::count_(const_key_reference key) const noexcept {
 TPARAMS
 void VALUE_PROXY_MAPPER::insert_(key_type key, mapped_type value) {
     m_proxy_mapper_->insert(value);
+    release_(key); // Overwriting drops the old value's references
     m_sub_db_->insert(std::move(key), m_proxy_mapper_->at(value));
 }
 
 TPARAMS
 void VALUE_PROXY_MAPPER::free_(const_key_reference key) {
+    release_(key);
     m_sub_db_->free(key);
 }
 
@@ -66,6 +68,13 @@ void VALUE_PROXY_MAPPER::dump_() {
     m_sub_db_->dump();
 }
 
+TPARAMS
+void VALUE_PROXY_MAPPER::release_(const_key_reference key) {
+    if(!m_proxy_mapper_->counts_references()) return;
+    if(!m_sub_db_->count(key)) return;
+    m_proxy_mapper_->release(m_sub_db_->at(key).get());
+}
+
 #undef VALUE_PROXY_MAPPER
 #undef TPARAMS
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace pluginplay::cache::database {
+
+/** @brief Performs the writes to a database on a background thread.
+ *
+ *  Writing to persistent storage can be slow. WriteBehind wraps a database
+ *  and, instead of writing to it, queues the writes (inserts, frees, and
+ *  backups). A background thread performs the queued writes in batches: it
+ *  waits until `batch_size` writes are queued (or until the oldest queued
+ *  write has waited `max_delay`) and then performs up to `batch_size` writes.
+ *  Consecutive backups within a batch are coalesced into a single backup of
+ *  the wrapped database.
+ *
+ *  Reads see the queued writes, i.e., a key which was inserted is found even
+ *  if the insert has not been performed yet. Reads which are not satisfied by
+ *  the queue are forwarded to the wrapped database.
+ *
+ *  The queue is bounded. If `queue_capacity` writes are already queued, the
+ *  calling thread waits for the background thread to make room. flush waits
+ *  for every queued write to be performed, and the destructor flushes before
+ *  stopping the background thread.
+ *
+ *  If a write fails on the background thread, the exception is rethrown by
+ *  the next call to flush (or dump, which flushes). Writes queued after the
+ *  failed write are still attempted.
+ *
+ *  N.B. Access to the wrapped database is serialized (the background thread
+ *       and readers never use it at the same time), but WriteBehind itself is
+ *       only as thread-safe as the other databases, i.e., it expects a single
+ *       thread to be using it.
+ *
+ *  @tparam KeyType The type of the keys in the database. Must be less-than
+ *                  comparable.
+ *  @tparam ValueType The type of the values in the database.
+ */
+template<typename KeyType, typename ValueType>
+class WriteBehind : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the database being wrapped
+    using sub_db_type = base_type;
+
+    /// Type of a pointer to the database being wrapped
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /// Type used for counting writes
+    using size_type = std::size_t;
+
+    /// Type used to specify how long writes can wait
+    using duration_type = std::chrono::milliseconds;
+
+    /// Typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Ultimately a typedef of DatabaseAPI::cursor_pointer
+    using typename base_type::cursor_pointer;
+
+    /// Typedef of const key_type&
+    using typename base_type::const_key_reference;
+
+    /// Typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Typedef of ConstValue<mapped_type>
+    using typename base_type::const_mapped_reference;
+
+    /** @brief Wraps @p sub_db and starts the background thread.
+     *
+     *  @param[in] sub_db The database to write to.
+     *  @param[in] queue_capacity The maximum number of queued writes. Must be
+     *                            at least 1.
+     *  @param[in] batch_size The maximum number of writes per batch. Must be
+     *                        at least 1.
+     *  @param[in] max_delay The longest a queued write waits for its batch to
+     *                       fill up.
+     *
+     *  @throw std::runtime_error if @p sub_db is a nullptr or if
+     *                            @p queue_capacity or @p batch_size is 0.
+     *                            Strong throw guarantee.
+     *  @throw std::system_error if the thread can not be started. Strong
+     *                           throw guarantee.
+     */
+    WriteBehind(sub_db_pointer sub_db, size_type queue_capacity,
+                size_type batch_size, duration_type max_delay);
+
+    /// Flushes the queue, then stops the background thread
+    ~WriteBehind() noexcept override;
+
+    /** @brief Waits until every queued write has been performed.
+     *
+     *  @throw ??? Rethrows the first exception raised by a write on the
+     *             background thread since the last flush. The exception is
+     *             only rethrown once.
+     */
+    void flush();
+
+    /// The number of writes which have not been performed yet
+    size_type pending() const;
+
+protected:
+    /// Flushes, then returns a cursor over the wrapped database
+    cursor_pointer cursor_() const override;
+
+    /// Checks the queue, then the wrapped database
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Queues inserting @p key/@p value into the wrapped database
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Queues freeing @p key from the wrapped database
+    void free_(const_key_reference key) override;
+
+    /// Checks the queue, then the wrapped database
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Queues backing up the wrapped database
+    void backup_() override;
+
+    /// Flushes, then dumps the wrapped database
+    void dump_() override;
+
+private:
+    /// Kinds of writes
+    enum class op_kind { insert, free, backup };
+
+    /// Type of a shared pointer to a queued value
+    using value_pointer = std::shared_ptr<const mapped_type>;
+
+    /// A queued write
+    struct op_type {
+        op_kind kind;
+        key_type key;
+        /// The value to insert (null unless kind is insert)
+        value_pointer value;
+        /// Used to tell if a later write to the same key was queued
+        size_type id = 0;
+    };
+
+    /// The latest queued value of a key, a null value means it was freed
+    struct pending_type {
+        value_pointer value;
+        size_type id;
+    };
+
+    /// Adds @p op to the queue, waiting for room if needed
+    void push_(op_type op);
+
+    /// Waits until the queue is empty and no writes are in flight
+    void wait_() const;
+
+    /// Function run by the background thread
+    void run_();
+
+    /// Performs @p batch on the wrapped database, returns the first error
+    std::exception_ptr write_(const std::deque<op_type>& batch);
+
+    /// The database being written to
+    sub_db_pointer m_db_;
+
+    /// Maximum number of queued writes
+    size_type m_capacity_;
+
+    /// Maximum number of writes per batch
+    size_type m_batch_size_;
+
+    /// Longest a write waits for its batch to fill up
+    duration_type m_max_delay_;
+
+    /// Guards everything below, except m_db_
+    mutable std::mutex m_mutex_;
+
+    /// Guards m_db_
+    mutable std::mutex m_db_mutex_;
+
+    /// Signals the background thread that there's work or it should stop
+    mutable std::condition_variable m_work_cv_;
+
+    /// Signals waiting threads that writes were performed
+    mutable std::condition_variable m_done_cv_;
+
+    /// Writes which have not been started
+    std::deque<op_type> m_queue_;
+
+    /// The latest queued value of keys with queued inserts/frees
+    std::map<key_type, pending_type> m_pending_;
+
+    /// Number of writes the background thread is currently performing
+    size_type m_in_flight_ = 0;
+
+    /// Used to give each write a unique id
+    size_type m_next_id_ = 0;
+
+    /// Number of threads waiting for the queue to empty
+    mutable size_type m_waiting_ = 0;
+
+    /// Set to true to stop the background thread
+    bool m_stop_ = false;
+
+    /// The first exception raised by the background thread since last flush
+    std::exception_ptr m_error_;
+
+    /// The background thread (started last, so everything else is ready)
+    std::thread m_thread_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "write_behind.ipp"
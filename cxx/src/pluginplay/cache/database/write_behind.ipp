@@ -0,0 +1,219 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is meant only for inclusion from write_behind.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define WRITE_BEHIND WriteBehind<KeyType, ValueType>
+
+TPARAMS
+WRITE_BEHIND::WriteBehind(sub_db_pointer sub_db, size_type queue_capacity,
+                          size_type batch_size, duration_type max_delay) :
+  m_db_(std::move(sub_db)),
+  m_capacity_(queue_capacity),
+  m_batch_size_(batch_size),
+  m_max_delay_(max_delay) {
+    if(!m_db_) throw std::runtime_error("Wrapped database can't be nullptr.");
+    if(!m_capacity_ || !m_batch_size_)
+        throw std::runtime_error("Queue capacity and batch size must be > 0");
+    m_thread_ = std::thread([this]() { run_(); });
+}
+
+TPARAMS
+WRITE_BEHIND::~WriteBehind() noexcept {
+    try {
+        flush();
+    } catch(...) {}
+    {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_stop_ = true;
+    }
+    m_work_cv_.notify_all();
+    m_thread_.join();
+}
+
+TPARAMS
+void WRITE_BEHIND::flush() {
+    wait_();
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    if(!m_error_) return;
+    auto error = m_error_;
+    m_error_   = nullptr;
+    std::rethrow_exception(error);
+}
+
+TPARAMS
+typename WRITE_BEHIND::size_type WRITE_BEHIND::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex_);
+    return m_queue_.size() + m_in_flight_;
+}
+
+TPARAMS
+typename WRITE_BEHIND::cursor_pointer WRITE_BEHIND::cursor_() const {
+    wait_();
+    std::lock_guard<std::mutex> lock(m_db_mutex_);
+    return std::make_unique<LockedCursor<key_type>>(m_db_->cursor(),
+                                                    m_db_mutex_);
+}
+
+TPARAMS
+bool WRITE_BEHIND::count_(const_key_reference key) const noexcept {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        auto itr = m_pending_.find(key);
+        if(itr != m_pending_.end()) return static_cast<bool>(itr->second.value);
+    }
+    std::lock_guard<std::mutex> lock(m_db_mutex_);
+    return m_db_->count(key);
+}
+
+TPARAMS
+void WRITE_BEHIND::insert_(key_type key, mapped_type value) {
+    auto pvalue = std::make_shared<const mapped_type>(std::move(value));
+    push_(op_type{op_kind::insert, std::move(key), std::move(pvalue)});
+}
+
+TPARAMS
+void WRITE_BEHIND::free_(const_key_reference key) {
+    push_(op_type{op_kind::free, key, nullptr});
+}
+
+TPARAMS
+typename WRITE_BEHIND::const_mapped_reference WRITE_BEHIND::at_(
+  const_key_reference key) const {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        auto itr = m_pending_.find(key);
+        if(itr != m_pending_.end()) {
+            const auto& pvalue = itr->second.value;
+            if(!pvalue) throw std::out_of_range("Key not in database");
+            return const_mapped_reference(mapped_type(*pvalue));
+        }
+    }
+    // Copy, since the background thread may write to m_db_ once we unlock
+    std::lock_guard<std::mutex> lock(m_db_mutex_);
+    return const_mapped_reference(mapped_type(m_db_->at(key).get()));
+}
+
+TPARAMS
+void WRITE_BEHIND::backup_() {
+    {
+        // Consecutive backups are redundant
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        if(!m_queue_.empty() && m_queue_.back().kind == op_kind::backup)
+            return;
+    }
+    push_(op_type{op_kind::backup, key_type{}, nullptr});
+}
+
+TPARAMS
+void WRITE_BEHIND::dump_() {
+    flush();
+    std::lock_guard<std::mutex> lock(m_db_mutex_);
+    m_db_->dump();
+}
+
+TPARAMS
+void WRITE_BEHIND::push_(op_type op) {
+    std::unique_lock<std::mutex> lock(m_mutex_);
+    m_done_cv_.wait(lock, [this]() { return m_queue_.size() < m_capacity_; });
+    op.id = m_next_id_++;
+    if(op.kind != op_kind::backup)
+        m_pending_.insert_or_assign(op.key, pending_type{op.value, op.id});
+    m_queue_.push_back(std::move(op));
+    if(m_queue_.size() >= m_batch_size_) m_work_cv_.notify_one();
+}
+
+TPARAMS
+void WRITE_BEHIND::wait_() const {
+    std::unique_lock<std::mutex> lock(m_mutex_);
+    ++m_waiting_;
+    m_work_cv_.notify_one(); // Don't wait for the batch to fill up
+    m_done_cv_.wait(lock,
+                    [this]() { return m_queue_.empty() && !m_in_flight_; });
+    --m_waiting_;
+}
+
+TPARAMS
+void WRITE_BEHIND::run_() {
+    std::unique_lock<std::mutex> lock(m_mutex_);
+    while(true) {
+        m_work_cv_.wait_for(lock, m_max_delay_, [this]() {
+            const bool flushing = m_waiting_ && !m_queue_.empty();
+            return m_stop_ || flushing || m_queue_.size() >= m_batch_size_;
+        });
+        if(m_queue_.empty()) {
+            if(m_stop_) return;
+            continue;
+        }
+
+        std::deque<op_type> batch;
+        while(!m_queue_.empty() && batch.size() < m_batch_size_) {
+            batch.push_back(std::move(m_queue_.front()));
+            m_queue_.pop_front();
+        }
+        m_in_flight_ = batch.size();
+        m_done_cv_.notify_all(); // There's room in the queue now
+
+        lock.unlock();
+        auto error = write_(batch);
+        lock.lock();
+
+        if(error && !m_error_) m_error_ = error;
+        // Reads of keys which were written can now go to m_db_
+        for(const auto& op : batch) {
+            if(op.kind == op_kind::backup) continue;
+            auto itr = m_pending_.find(op.key);
+            if(itr != m_pending_.end() && itr->second.id == op.id)
+                m_pending_.erase(itr);
+        }
+        m_in_flight_ = 0;
+        m_done_cv_.notify_all();
+    }
+}
+
+TPARAMS
+std::exception_ptr WRITE_BEHIND::write_(const std::deque<op_type>& batch) {
+    std::exception_ptr rv;
+    bool backup = false;
+    std::lock_guard<std::mutex> lock(m_db_mutex_);
+    for(const auto& op : batch) {
+        try {
+            if(op.kind == op_kind::insert)
+                m_db_->insert(op.key, *op.value);
+            else if(op.kind == op_kind::free)
+                m_db_->free(op.key);
+            else
+                backup = true; // Done once, after the rest of the batch
+        } catch(...) {
+            if(!rv) rv = std::current_exception();
+        }
+    }
+    if(!backup) return rv;
+    try {
+        m_db_->backup();
+    } catch(...) {
+        if(!rv) rv = std::current_exception();
+    }
+    return rv;
+}
+
+#undef WRITE_BEHIND
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <map>
+#include <pluginplay/utility/uuid.hpp>
+
+namespace pluginplay::cache {
+
+/** @brief Counts the references to the objects in a content-addressed store.
+ *
+ *  When results are content-addressed, identical results share a single UUID
+ *  and are thus only stored once. DedupTable counts how many times each of
+ *  those objects is referenced (i.e., how many cached result maps contain
+ *  it), so that an object can be freed once nothing references it, and keeps
+ *  track of how much storage deduplication saved. The size of each object is
+ *  recorded with its first reference, so later references don't need to
+ *  recompute it.
+ *
+ *  References can only be counted for objects this process stored. Objects
+ *  which already existed (e.g., because a previous run stored them) may be
+ *  referenced by records this process does not know about, so they are never
+ *  reported as freeable.
+ */
+class DedupTable {
+public:
+    /// Type of the object identifiers
+    using id_type = utility::uuid_type;
+
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /** @brief Records a new reference to the object with UUID @p id.
+     *
+     *  @param[in] id The UUID of the referenced object.
+     *  @param[in] bytes The size of the object in bytes.
+     *  @param[in] created True if the object was stored because of this
+     *                     reference and false if it was already stored.
+     *  @param[in] report Should reusing an already stored object count
+     *                    towards n_deduplicated and bytes_saved? Default is
+     *                    true.
+     *
+     *  @throw std::bad_alloc if there is a problem recording the reference.
+     *                        Strong throw guarantee.
+     */
+    void add(const id_type& id, size_type bytes, bool created,
+             bool report = true) {
+        auto& entry = m_refs_[id];
+        if(!entry.count) entry.bytes = bytes;
+        if(created) {
+            entry.owned = true;
+        } else if(report) {
+            record_reuse_(entry.bytes);
+        }
+        ++entry.count;
+    }
+
+    /** @brief Records another reference to an already referenced object.
+     *
+     *  Unlike add, this does not need the size of the object, the size
+     *  recorded with its first reference is used.
+     *
+     *  @param[in] id The UUID of the referenced object.
+     *  @param[in] report Should the reuse count towards n_deduplicated and
+     *                    bytes_saved? Default is true.
+     *
+     *  @return True if the reference was recorded and false if the object has
+     *          no known references (in which case add must be called).
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool add_reference(const id_type& id, bool report = true) noexcept {
+        auto itr = m_refs_.find(id);
+        if(itr == m_refs_.end()) return false;
+        if(report) record_reuse_(itr->second.bytes);
+        ++itr->second.count;
+        return true;
+    }
+
+    /** @brief Removes a reference to the object with UUID @p id.
+     *
+     *  @param[in] id The UUID of the object which is no longer referenced.
+     *
+     *  @return True if that was the last reference to an object stored by
+     *          this process (i.e., the object can be freed) and false
+     *          otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool release(const id_type& id) noexcept {
+        auto itr = m_refs_.find(id);
+        if(itr == m_refs_.end()) return false;
+        if(--itr->second.count) return false;
+        const bool owned = itr->second.owned;
+        m_refs_.erase(itr);
+        return owned;
+    }
+
+    /// The number of known references to the object with UUID @p id
+    size_type count(const id_type& id) const noexcept {
+        auto itr = m_refs_.find(id);
+        return itr == m_refs_.end() ? 0 : itr->second.count;
+    }
+
+    /// The number of references which reused an already stored object
+    size_type n_deduplicated() const noexcept { return m_n_deduplicated_; }
+
+    /// The number of bytes which did not need to be stored thanks to reuse
+    size_type bytes_saved() const noexcept { return m_bytes_saved_; }
+
+private:
+    /// Records that an object of @p bytes bytes was reused
+    void record_reuse_(size_type bytes) noexcept {
+        ++m_n_deduplicated_;
+        m_bytes_saved_ += bytes;
+    }
+
+    /// What we know about an object
+    struct entry_type {
+        /// The number of references
+        size_type count = 0;
+
+        /// The size of the object in bytes
+        size_type bytes = 0;
+
+        /// Was the object stored by this process?
+        bool owned = false;
+    };
+
+    /// The objects with known references
+    std::map<id_type, entry_type> m_refs_;
+
+    /// Number of references which reused an object
+    size_type m_n_deduplicated_ = 0;
+
+    /// Bytes saved by reusing objects
+    size_type m_bytes_saved_ = 0;
+};
+
+} // namespace pluginplay::cache
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pluginplay::cache::detail_ {
+
+/// Stream buffer which appends everything written to it to a std::string
+class StringSink : public std::streambuf {
+public:
+    /// Appends to @p bytes, which must outlive *this
+    explicit StringSink(std::string& bytes) noexcept : m_bytes_(bytes) {}
+
+protected:
+    int_type overflow(int_type c) override {
+        if(traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        m_bytes_.push_back(traits_type::to_char_type(c));
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        m_bytes_.append(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+private:
+    /// Where the bytes go
+    std::string& m_bytes_;
+};
+
+/// Stream buffer which reads bytes in place, i.e., without copying them
+class SpanSource : public std::streambuf {
+public:
+    /// Makes @p bytes (which must outlive the reads) the bytes to read
+    void reset(std::string_view bytes) noexcept {
+        // The get area is never written through, so casting away const is ok
+        auto* p = const_cast<char*>(bytes.data());
+        setg(p, p, p + bytes.size());
+    }
+};
+
+/** @brief The calling thread's instances of @p SlotType.
+ *
+ *  Instances are leased in stack order, i.e., the most recently acquired
+ *  instance is the first released. They are kept for reuse when released.
+ *
+ *  @tparam SlotType The type being pooled. Must be default constructible.
+ */
+template<typename SlotType>
+class ThreadLocalPool {
+public:
+    /// Leases the next instance, making it if needed
+    static SlotType& acquire() {
+        auto& pool = local_();
+        if(pool.depth == pool.slots.size())
+            pool.slots.push_back(std::make_unique<SlotType>());
+        return *pool.slots[pool.depth++];
+    }
+
+    /// Ends the lease of the most recently acquired instance
+    static void release() noexcept { --local_().depth; }
+
+private:
+    /// The instances, the first depth of which are leased
+    struct Pool {
+        std::vector<std::unique_ptr<SlotType>> slots;
+        std::size_t depth = 0;
+    };
+
+    /// The calling thread's instances
+    static Pool& local_() {
+        thread_local Pool pool;
+        return pool;
+    }
+};
+
+/** @brief Lends the calling thread a reusable stream to serialize into.
+ *
+ *  Serializing with a std::stringstream allocates the stream (and its locale)
+ *  plus a buffer which grows as the object is written, and then copies the
+ *  bytes out. Each thread instead keeps its streams around, writing into a
+ *  std::string whose capacity is reused from one object to the next. The
+ *  bytes can be used in place (e.g., as a key to look up), or copied out once
+ *  at their final size.
+ *
+ *  Instances are leases on the thread's streams, which are handed out in
+ *  stack order so that serializing can nest (e.g., a database layer which
+ *  serializes a key and looks it up in another such layer). Buffers which
+ *  grew past max_retained are released when their lease ends, so one large
+ *  object does not pin memory for the life of the thread.
+ */
+class OutputBuffer {
+public:
+    /// Buffers larger than this (in bytes) are released after use
+    static constexpr std::size_t max_retained = std::size_t{1} << 20;
+
+    /// Leases the calling thread's next stream, which starts empty
+    OutputBuffer() : m_slot_(pool_type::acquire()) {
+        m_slot_.bytes.clear();
+        m_slot_.stream.clear();
+    }
+
+    /// Returns the stream to the calling thread
+    ~OutputBuffer() noexcept {
+        if(m_slot_.bytes.capacity() > max_retained)
+            std::string().swap(m_slot_.bytes);
+        pool_type::release();
+    }
+
+    /// Leases are tied to the scope they were made in
+    ///@{
+    OutputBuffer(const OutputBuffer&)            = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    ///@}
+
+    /// The stream to serialize into
+    std::ostream& stream() noexcept { return m_slot_.stream; }
+
+    /// The bytes written so far, invalidated when the lease ends
+    const std::string& bytes() const noexcept { return m_slot_.bytes; }
+
+    /// The bytes, for encoders which append to them directly
+    std::string& bytes() noexcept { return m_slot_.bytes; }
+
+private:
+    /// A thread's stream and the string it writes to
+    struct Slot {
+        std::string bytes;
+        StringSink sink{bytes};
+        std::ostream stream{&sink};
+    };
+
+    /// The calling thread's streams
+    using pool_type = ThreadLocalPool<Slot>;
+
+    /// The leased stream
+    Slot& m_slot_;
+};
+
+/** @brief Lends the calling thread a reusable stream which reads bytes in
+ *         place.
+ *
+ *  The counterpart of OutputBuffer for deserializing. Deserializing from a
+ *  std::stringstream copies the bytes into the stream first; the stream lent
+ *  by this class reads them where they are (e.g., out of the value a backend
+ *  returned). Leases nest like those of OutputBuffer.
+ */
+class InputBuffer {
+public:
+    /// Leases the calling thread's next stream, set to read @p bytes
+    explicit InputBuffer(std::string_view bytes) :
+      m_slot_(pool_type::acquire()) {
+        m_slot_.source.reset(bytes);
+        m_slot_.stream.clear();
+    }
+
+    /// Returns the stream to the calling thread
+    ~InputBuffer() noexcept {
+        m_slot_.source.reset({});
+        pool_type::release();
+    }
+
+    /// Leases are tied to the scope they were made in
+    ///@{
+    InputBuffer(const InputBuffer&)            = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+    ///@}
+
+    /// The stream to deserialize from
+    std::istream& stream() noexcept { return m_slot_.stream; }
+
+private:
+    /// A thread's stream and the bytes it reads
+    struct Slot {
+        SpanSource source;
+        std::istream stream{&source};
+    };
+
+    /// The calling thread's streams
+    using pool_type = ThreadLocalPool<Slot>;
+
+    /// The leased stream
+    Slot& m_slot_;
+};
+
+} // namespace pluginplay::cache::detail_
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "checkpoint_bundle.hpp"
+#include "zlib.hpp"
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace pluginplay::cache::detail_ {
+namespace {
+
+constexpr std::string_view magic = "PPCKPT01";
+
+constexpr std::uint32_t format_version = 1;
+
+constexpr std::uint32_t compressed_flag = 1;
+
+/// Size of the header in bytes
+constexpr std::size_t header_size = 8 + 4 + 4 + 8 + 8 + 8;
+
+std::uint64_t fnv1a(std::string_view data) noexcept {
+    std::uint64_t h = 14695981039346656037ull;
+    for(unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/// Appends @p n little-endian bytes of @p value to @p buffer
+void put_uint(std::string& buffer, std::uint64_t value, std::size_t n = 8) {
+    for(std::size_t i = 0; i < n; ++i)
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void put_string(std::string& buffer, std::string_view value) {
+    put_uint(buffer, value.size());
+    buffer.append(value);
+}
+
+/// Reads values out of a buffer, throwing if the buffer is too short
+class Reader {
+public:
+    explicit Reader(std::string_view buffer) noexcept : m_buffer_(buffer) {}
+
+    std::uint64_t get_uint(std::size_t n = 8) {
+        auto bytes       = take(n);
+        std::uint64_t rv = 0;
+        for(std::size_t i = 0; i < n; ++i) {
+            const auto byte = static_cast<unsigned char>(bytes[i]);
+            rv |= std::uint64_t(byte) << (8 * i);
+        }
+        return rv;
+    }
+
+    std::string get_string() {
+        const auto n = get_uint();
+        return std::string(take(n));
+    }
+
+    std::string_view take(std::uint64_t n) {
+        if(n > m_buffer_.size())
+            throw std::runtime_error("Checkpoint bundle is truncated");
+        auto rv   = m_buffer_.substr(0, n);
+        m_buffer_ = m_buffer_.substr(n);
+        return rv;
+    }
+
+    bool empty() const noexcept { return m_buffer_.empty(); }
+
+private:
+    std::string_view m_buffer_;
+};
+
+} // namespace
+
+void CheckpointBundle::save(const std::string& path, bool compress) const {
+    std::string payload;
+    put_uint(payload, modules.size());
+    for(const auto& module : modules) put_string(payload, module);
+    put_uint(payload, tables.size());
+    for(const auto& [name, records] : tables) {
+        put_string(payload, name);
+        put_uint(payload, records.size());
+        for(const auto& [k, v] : records) {
+            put_string(payload, k);
+            put_string(payload, v);
+        }
+    }
+
+    const std::string stored =
+      compress ? zlib_compress(payload) : std::string{};
+    const std::string_view body = compress ? stored : payload;
+
+    std::string header(magic);
+    put_uint(header, format_version, 4);
+    put_uint(header, compress ? compressed_flag : 0, 4);
+    put_uint(header, payload.size());
+    put_uint(header, body.size());
+    put_uint(header, fnv1a(payload));
+
+    // Write to a temporary file, then rename it, so a partial bundle is never
+    // mistaken for a complete one
+    const std::string tmp_path = path + ".tmp";
+    bool good;
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(header.data(), header.size());
+        file.write(body.data(), body.size());
+        file.flush();
+        good = static_cast<bool>(file);
+    }
+    if(!good) {
+        std::error_code ec; // Don't care if the temporary file isn't there
+        std::filesystem::remove(tmp_path, ec);
+        throw std::runtime_error("Unable to write checkpoint: " + path);
+    }
+    std::filesystem::rename(tmp_path, path);
+}
+
+CheckpointBundle CheckpointBundle::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file) throw std::runtime_error("Unable to open checkpoint: " + path);
+
+    std::array<char, header_size> header_buffer;
+    file.read(header_buffer.data(), header_size);
+    if(file.gcount() != std::streamsize(header_size) ||
+       std::string_view(header_buffer.data(), magic.size()) != magic)
+        throw std::runtime_error(path + " is not a checkpoint bundle");
+
+    Reader header(std::string_view(header_buffer.data(), header_size));
+    header.take(magic.size());
+    const auto version     = header.get_uint(4);
+    const auto flags       = header.get_uint(4);
+    const auto raw_size    = header.get_uint();
+    const auto stored_size = header.get_uint();
+    const auto checksum    = header.get_uint();
+    if(version != format_version)
+        throw std::runtime_error("Unsupported checkpoint version: " +
+                                 std::to_string(version));
+
+    const auto file_size = std::filesystem::file_size(path);
+    if(stored_size > file_size - header_size)
+        throw std::runtime_error("Checkpoint bundle is truncated");
+
+    std::string body(stored_size, '\0');
+    file.read(body.data(), stored_size);
+    if(file.gcount() != std::streamsize(stored_size))
+        throw std::runtime_error("Checkpoint bundle is truncated");
+
+    std::string payload = (flags & compressed_flag) ?
+                            zlib_decompress(body, raw_size) :
+                            std::move(body);
+    if(payload.size() != raw_size || fnv1a(payload) != checksum)
+        throw std::runtime_error("Checkpoint bundle is corrupt");
+
+    CheckpointBundle rv;
+    Reader reader(payload);
+    const auto n_modules = reader.get_uint();
+    for(std::uint64_t i = 0; i < n_modules; ++i)
+        rv.modules.push_back(reader.get_string());
+    const auto n_tables = reader.get_uint();
+    for(std::uint64_t i = 0; i < n_tables; ++i) {
+        auto& records        = rv.tables[reader.get_string()];
+        const auto n_records = reader.get_uint();
+        for(std::uint64_t j = 0; j < n_records; ++j) {
+            auto key = reader.get_string();
+            records.emplace_back(std::move(key), reader.get_string());
+        }
+    }
+    if(!reader.empty())
+        throw std::runtime_error("Checkpoint bundle is corrupt");
+    return rv;
+}
+
+} // namespace pluginplay::cache::detail_
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::detail_ {
+
+/** @brief The contents of a cache checkpoint.
+ *
+ *  A checkpoint is a snapshot of the long-term storage of a
+ *  ModuleManagerCache. The long-term storage consists of several databases
+ *  (the proxy maps of each module, the serialized inputs/results, etc.) all
+ *  of which map binary keys to binary values. A CheckpointBundle holds the
+ *  records of each of those databases, keyed by the database's name, along
+ *  with the identities of the modules whose caches were checkpointed.
+ *
+ *  Bundles are saved as a single file with the layout:
+ *
+ *  | Field        | Size (bytes) | Description                              |
+ *  |--------------|--------------|------------------------------------------|
+ *  | magic        | 8            | "PPCKPT01"                               |
+ *  | version      | 4            | Format version, currently 1              |
+ *  | flags        | 4            | Bit 0 set if the payload is compressed   |
+ *  | raw size     | 8            | Size of the uncompressed payload         |
+ *  | stored size  | 8            | Size of the payload as stored            |
+ *  | checksum     | 8            | FNV-1a hash of the uncompressed payload  |
+ *  | payload      | stored size  | See below                                |
+ *
+ *  The payload is the number of modules, followed by each module's identity,
+ *  followed by the number of databases, followed by each database. A database
+ *  is its name, the number of records, and then the key and value of each
+ *  record. Strings (names, keys, and values) are stored as their length
+ *  followed by their bytes. All integers are unsigned, 64-bit (unless noted
+ *  otherwise), and little-endian, so bundles can be moved between machines.
+ *
+ *  Bundles are written to a temporary file which is then renamed, so a job
+ *  which is killed while checkpointing never leaves a partial bundle behind.
+ */
+struct CheckpointBundle {
+    /// Type of the keys and values in the databases
+    using binary_type = std::string;
+
+    /// Type of a key/value pair
+    using record_type = std::pair<binary_type, binary_type>;
+
+    /// Type of the records of a database
+    using table_type = std::vector<record_type>;
+
+    /// Type of a map from database names to their records
+    using table_map_type = std::map<std::string, table_type>;
+
+    /// The identities of the checkpointed modules
+    std::vector<std::string> modules;
+
+    /// The contents of the databases
+    table_map_type tables;
+
+    /** @brief Writes the bundle to disk.
+     *
+     *  @param[in] path Where to write the bundle. If a file already exists at
+     *                  @p path it is replaced.
+     *  @param[in] compress Should the payload be compressed (with zlib)?
+     *                      Default is false.
+     *
+     *  @throw std::runtime_error if @p compress is true and PluginPlay was
+     *                            not built with zlib, or if there is a
+     *                            problem writing the file. Strong throw
+     *                            guarantee.
+     */
+    void save(const std::string& path, bool compress = false) const;
+
+    /** @brief Reads a bundle which was written by save.
+     *
+     *  @param[in] path The bundle to read.
+     *
+     *  @return The bundle stored at @p path.
+     *
+     *  @throw std::runtime_error if @p path can not be read, is not a bundle,
+     *                            is corrupt, or is compressed and PluginPlay
+     *                            was not built with zlib. Strong throw
+     *                            guarantee.
+     */
+    static CheckpointBundle load(const std::string& path);
+};
+
+} // namespace pluginplay::cache::detail_
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec.hpp"
+#include "zlib.hpp"
+#include <pluginplay/config/config.hpp>
+#include <stdexcept>
+
+namespace pluginplay::cache::detail_ {
+namespace {
+
+// Codec::fast and Codec::best differ only in the level passed to zlib
+class ZlibCodec : public CodecImpl {
+public:
+    explicit ZlibCodec(int level) noexcept : m_level_(level) {}
+
+    std::string compress(std::string_view data) const override {
+        return zlib_compress(data, m_level_);
+    }
+
+    std::string decompress(std::string_view data,
+                           std::size_t size) const override {
+        return zlib_decompress(data, size);
+    }
+
+private:
+    int m_level_;
+};
+
+} // namespace
+
+const CodecImpl* codec_impl(Codec codec) {
+    static const ZlibCodec fast(1);
+    static const ZlibCodec best(9);
+    switch(codec) {
+        case Codec::none: return nullptr;
+        case Codec::fast: return &fast;
+        case Codec::best: return &best;
+    }
+    throw std::runtime_error("Unknown compression codec");
+}
+
+void assert_codecs_available(const CompressionPolicy& policy) {
+    if(!policy.enabled() || with_zlib()) return;
+    throw std::runtime_error("Compression requires zlib. Please rebuild "
+                             "PluginPlay with the CMake option BUILD_ZLIB "
+                             "enabled.");
+}
+
+} // namespace pluginplay::cache::detail_
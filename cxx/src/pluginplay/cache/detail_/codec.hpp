@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <pluginplay/cache/compression_policy.hpp>
+#include <string>
+#include <string_view>
+
+namespace pluginplay::cache::detail_ {
+
+/** @brief The interface of the algorithms behind the Codec enumeration.
+ *
+ *  Adding a new codec amounts to adding a value to the Codec enumeration,
+ *  deriving a class from CodecImpl, and returning an instance of that class
+ *  from codec_impl. The value of the enumeration is saved with the
+ *  compressed data, so existing values must never be renumbered.
+ */
+class CodecImpl {
+public:
+    /// Polymorphic base, so virtual dtor
+    virtual ~CodecImpl() noexcept = default;
+
+    /** @brief Compresses @p data.
+     *
+     *  @param[in] data The bytes to compress.
+     *
+     *  @return The compressed bytes.
+     *
+     *  @throw std::runtime_error if the data can not be compressed. Strong
+     *                            throw guarantee.
+     */
+    virtual std::string compress(std::string_view data) const = 0;
+
+    /** @brief Decompresses @p data.
+     *
+     *  @param[in] data Bytes compressed by this codec.
+     *  @param[in] size The number of bytes @p data decompresses to.
+     *
+     *  @return The decompressed bytes.
+     *
+     *  @throw std::runtime_error if @p data is corrupt. Strong throw
+     *                            guarantee.
+     */
+    virtual std::string decompress(std::string_view data,
+                                   std::size_t size) const = 0;
+};
+
+/** @brief Returns the implementation of @p codec.
+ *
+ *  @param[in] codec The codec whose implementation is wanted.
+ *
+ *  @return The implementation of @p codec, or nullptr if @p codec is
+ *          Codec::none.
+ *
+ *  @throw std::runtime_error if @p codec is not a known codec. Strong throw
+ *                            guarantee.
+ */
+const CodecImpl* codec_impl(Codec codec);
+
+/** @brief Ensures the codecs @p policy uses are available.
+ *
+ *  Codecs may depend on optional dependencies. This function is meant to be
+ *  called when a policy is set, so that the user learns about a missing
+ *  dependency then, and not when the first value is compressed.
+ *
+ *  @param[in] policy The policy to check.
+ *
+ *  @throw std::runtime_error if @p policy compresses values and PluginPlay
+ *                            was not built with the dependencies needed to
+ *                            do so. Strong throw guarantee.
+ */
+void assert_codecs_available(const CompressionPolicy& policy);
+
+} // namespace pluginplay::cache::detail_
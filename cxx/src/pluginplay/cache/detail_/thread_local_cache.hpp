@@ -0,0 +1,177 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::detail_ {
+
+/** @brief A small cache of recently used key/value pairs kept by each thread.
+ *
+ *  Each thread which uses a ThreadLocalCache instance gets its own list of
+ *  the key/value pairs it most recently inserted into the instance. Since the
+ *  lists are thread-local, looking up and inserting pairs never synchronizes
+ *  with other threads (it is lock-free). The lists are kept in most recently
+ *  used order and searched linearly, so capacities are expected to be small.
+ *
+ *  Calling invalidate() (from any thread) empties every thread's list. This
+ *  is done lazily: each instance has an atomic epoch which invalidate()
+ *  increments, and a thread which sees that the epoch changed since it last
+ *  used the instance empties its list before using it. Lists of instances
+ *  which have been destroyed are released the next time their thread starts
+ *  using a new instance.
+ *
+ *  @tparam KeyType The type of the keys. Must be equality comparable.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+class ThreadLocalCache {
+public:
+    /// Type of the keys
+    using key_type = KeyType;
+
+    /// Type of the values
+    using mapped_type = ValueType;
+
+    /// Type used for capacities
+    using size_type = std::size_t;
+
+    /** @brief Sets how many key/value pairs each thread keeps.
+     *
+     *  Changing the capacity invalidates every thread's list.
+     *
+     *  @param[in] capacity The maximum number of pairs per thread. 0 disables
+     *                      the cache, i.e., find always returns nullptr and
+     *                      insert is a no-op.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_capacity(size_type capacity) noexcept {
+        m_capacity_.store(capacity, std::memory_order_relaxed);
+        invalidate();
+    }
+
+    /// The maximum number of pairs each thread keeps
+    size_type capacity() const noexcept {
+        return m_capacity_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Looks up @p key in the calling thread's list.
+     *
+     *  A found pair becomes the most recently used pair.
+     *
+     *  @param[in] key The key to look for.
+     *
+     *  @return A pointer to the value @p key maps to, or nullptr if the
+     *          calling thread's list does not contain @p key. The pointer is
+     *          invalidated by the calling thread's next call to find or
+     *          insert.
+     *
+     *  @throw std::bad_alloc if the calling thread has no list yet and
+     *                        allocating one fails. Strong throw guarantee.
+     */
+    const mapped_type* find(const key_type& key) const {
+        if(!capacity()) return nullptr;
+        auto& pairs = local_();
+        auto same   = [&](const auto& p) { return p.first == key; };
+        auto itr    = std::find_if(pairs.begin(), pairs.end(), same);
+        if(itr == pairs.end()) return nullptr;
+        std::rotate(pairs.begin(), itr, itr + 1);
+        return &pairs.front().second;
+    }
+
+    /** @brief Makes @p key/@p value the calling thread's most recently used
+     *         pair.
+     *
+     *  If the calling thread's list is full the least recently used pair is
+     *  removed.
+     *
+     *  @param[in] key The key to insert. Should not already be in the list.
+     *  @param[in] value The value @p key maps to.
+     *
+     *  @throw std::bad_alloc if there is not enough memory. Weak throw
+     *                        guarantee.
+     */
+    void insert(key_type key, mapped_type value) const {
+        const auto max_size = capacity();
+        if(!max_size) return;
+        auto& pairs = local_();
+        if(pairs.size() >= max_size) pairs.resize(max_size - 1);
+        pairs.emplace(pairs.begin(), std::move(key), std::move(value));
+    }
+
+    /** @brief Empties every thread's list.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void invalidate() noexcept {
+        m_epoch_->fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    /// Type of the epoch counter
+    using epoch_type = std::atomic<std::uint64_t>;
+
+    /// Type of a thread's list
+    using list_type = std::vector<std::pair<key_type, mapped_type>>;
+
+    /// What a thread keeps per instance
+    struct local_type {
+        /// Used to tell if the instance still exists
+        std::weak_ptr<const epoch_type> owner;
+
+        /// Value of the instance's epoch when the list was last valid
+        std::uint64_t epoch = 0;
+
+        /// The pairs, most recently used first
+        list_type pairs;
+    };
+
+    /// Returns the calling thread's (valid) list for this instance
+    list_type& local_() const {
+        thread_local std::unordered_map<const void*, local_type> lists;
+        auto itr = lists.find(m_epoch_.get());
+        if(itr == lists.end() || itr->second.owner.expired()) {
+            // Release the lists of instances which no longer exist
+            for(auto i = lists.begin(); i != lists.end();)
+                i = i->second.owner.expired() ? lists.erase(i) : std::next(i);
+            itr = lists.emplace(m_epoch_.get(), local_type{m_epoch_}).first;
+        }
+        auto& local      = itr->second;
+        const auto epoch = m_epoch_->load(std::memory_order_acquire);
+        if(local.epoch != epoch) {
+            local.pairs.clear();
+            local.epoch = epoch;
+        }
+        return local.pairs;
+    }
+
+    /// Incremented to invalidate the lists, shared so threads can tell when
+    /// the instance has been destroyed
+    std::shared_ptr<epoch_type> m_epoch_ = std::make_shared<epoch_type>(1);
+
+    /// Maximum number of pairs per thread
+    std::atomic<size_type> m_capacity_{0};
+};
+
+} // namespace pluginplay::cache::detail_
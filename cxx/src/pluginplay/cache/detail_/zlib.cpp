@@ -0,0 +1,66 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "zlib.hpp"
+#include <stdexcept>
+#ifdef BUILD_ZLIB
+#include <zlib.h>
+#endif
+
+namespace pluginplay::cache::detail_ {
+
+#ifdef BUILD_ZLIB
+
+std::string zlib_compress(std::string_view data, int level) {
+    auto n = compressBound(data.size());
+    std::string rv(n, '\0');
+    auto pout = reinterpret_cast<Bytef*>(rv.data());
+    auto pin  = reinterpret_cast<const Bytef*>(data.data());
+    if(compress2(pout, &n, pin, data.size(), level) != Z_OK)
+        throw std::runtime_error("zlib failed to compress the data");
+    rv.resize(n);
+    return rv;
+}
+
+std::string zlib_decompress(std::string_view data, std::size_t size) {
+    std::string rv(size, '\0');
+    uLongf n  = size;
+    auto pout = reinterpret_cast<Bytef*>(rv.data());
+    auto pin  = reinterpret_cast<const Bytef*>(data.data());
+    if(uncompress(pout, &n, pin, data.size()) != Z_OK || n != size)
+        throw std::runtime_error("Compressed data is corrupt");
+    return rv;
+}
+
+#else
+
+namespace {
+
+[[noreturn]] void no_zlib() {
+    throw std::runtime_error("Compression requires zlib. Please rebuild "
+                             "PluginPlay with the CMake option BUILD_ZLIB "
+                             "enabled.");
+}
+
+} // namespace
+
+std::string zlib_compress(std::string_view, int) { no_zlib(); }
+
+std::string zlib_decompress(std::string_view, std::size_t) { no_zlib(); }
+
+#endif
+
+} // namespace pluginplay::cache::detail_
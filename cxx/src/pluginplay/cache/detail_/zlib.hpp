@@ -0,0 +1,52 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace pluginplay::cache::detail_ {
+
+/** @brief Compresses @p data with zlib.
+ *
+ *  @param[in] data The bytes to compress.
+ *  @param[in] level The zlib compression level, 1 is the fastest and 9 gives
+ *                   the best compression. Default is 6, zlib's default.
+ *
+ *  @return The compressed bytes.
+ *
+ *  @throw std::runtime_error if PluginPlay was not built with zlib support or
+ *                            if zlib fails. Strong throw guarantee.
+ */
+std::string zlib_compress(std::string_view data, int level = 6);
+
+/** @brief Decompresses data compressed with zlib_compress.
+ *
+ *  @param[in] data The compressed bytes.
+ *  @param[in] size The number of bytes @p data decompresses to. The caller is
+ *                  responsible for remembering this.
+ *
+ *  @return The decompressed bytes.
+ *
+ *  @throw std::runtime_error if PluginPlay was not built with zlib support,
+ *                            if @p data is corrupt, or if @p data does not
+ *                            decompress to @p size bytes. Strong throw
+ *                            guarantee.
+ */
+std::string zlib_decompress(std::string_view data, std::size_t size);
+
+} // namespace pluginplay::cache::detail_
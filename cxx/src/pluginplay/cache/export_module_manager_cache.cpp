@@ -20,10 +20,143 @@
 namespace pluginplay::cache {
 
 void export_module_manager_cache(py_module_reference m) {
+    py_class_type<cache::CacheStats>(m, "CacheStats")
+      .def(py::init<>())
+      .def_readonly("hits", &cache::CacheStats::hits)
+      .def_readonly("misses", &cache::CacheStats::misses)
+      .def_readonly("l1_hits", &cache::CacheStats::l1_hits)
+      .def_readonly("l2_hits", &cache::CacheStats::l2_hits)
+      .def_readonly("l3_hits", &cache::CacheStats::l3_hits)
+      .def_readonly("promotions", &cache::CacheStats::promotions)
+      .def_readonly("demotions", &cache::CacheStats::demotions)
+      .def_readonly("compressions", &cache::CacheStats::compressions)
+      .def_readonly("decompressions", &cache::CacheStats::decompressions)
+      .def_readonly("cooling", &cache::CacheStats::cooling)
+      .def_readonly("expirations", &cache::CacheStats::expirations)
+      .def_readonly("resident_entries", &cache::CacheStats::resident_entries)
+      .def_readonly("resident_bytes", &cache::CacheStats::resident_bytes)
+      .def_readonly("insertions", &cache::CacheStats::insertions)
+      .def_readonly("evictions", &cache::CacheStats::evictions)
+      .def_readonly("entries", &cache::CacheStats::entries)
+      .def_readonly("rejections", &cache::CacheStats::rejections)
+      .def_readonly("bytes_in_memory", &cache::CacheStats::bytes_in_memory)
+      .def_readonly("bytes_on_disk", &cache::CacheStats::bytes_on_disk)
+      .def_readonly("deduplicated", &cache::CacheStats::deduplicated)
+      .def_readonly("bytes_deduplicated",
+                    &cache::CacheStats::bytes_deduplicated)
+      .def_readonly("interned", &cache::CacheStats::interned)
+      .def_readonly("bytes_interned", &cache::CacheStats::bytes_interned)
+      .def_readonly("key_time_ns", &cache::CacheStats::key_time_ns)
+      .def_readonly("deserialize_time_ns",
+                    &cache::CacheStats::deserialize_time_ns)
+      .def("hit_rate", &cache::CacheStats::hit_rate)
+      .def("tier_hit_rate", &cache::CacheStats::tier_hit_rate);
+
+    using tier_type = cache::TierPolicy;
+    py_class_type<tier_type>(m, "TierPolicy")
+      .def(py::init<>())
+      .def_readwrite("l1_capacity", &tier_type::l1_capacity)
+      .def_readwrite("l2_capacity", &tier_type::l2_capacity)
+      .def_readwrite("cold_after_accesses", &tier_type::cold_after_accesses)
+      .def_property(
+        "cold_after_ms",
+        [](const tier_type& p) { return p.cold_after.count(); },
+        [](tier_type& p, long ms) {
+            p.cold_after = std::chrono::milliseconds(ms);
+        });
+
+    py::enum_<cache::CachePriority>(m, "CachePriority")
+      .value("low", cache::CachePriority::low)
+      .value("normal", cache::CachePriority::normal)
+      .value("high", cache::CachePriority::high);
+
+    using quota_type = cache::QuotaPolicy;
+    py_class_type<quota_type>(m, "QuotaPolicy")
+      .def(py::init<>())
+      .def_readwrite("max_entries", &quota_type::max_entries)
+      .def_readwrite("max_bytes", &quota_type::max_bytes)
+      .def_readwrite("priority", &quota_type::priority);
+
+    py::enum_<cache::CompactionStyle>(m, "CompactionStyle")
+      .value("level", cache::CompactionStyle::level)
+      .value("universal", cache::CompactionStyle::universal)
+      .value("fifo", cache::CompactionStyle::fifo);
+
+    using rocksdb_type = cache::RocksDBOptions;
+    py_class_type<rocksdb_type>(m, "RocksDBOptions")
+      .def(py::init<>())
+      .def_readwrite("block_cache_size", &rocksdb_type::block_cache_size)
+      .def_readwrite("bloom_bits_per_key", &rocksdb_type::bloom_bits_per_key)
+      .def_readwrite("compaction_style", &rocksdb_type::compaction_style)
+      .def_readwrite("write_buffer_size", &rocksdb_type::write_buffer_size);
+
+    py::enum_<cache::Codec>(m, "Codec")
+      .value("none", cache::Codec::none)
+      .value("fast", cache::Codec::fast)
+      .value("best", cache::Codec::best);
+
+    using compression_type = cache::CompressionPolicy;
+    py_class_type<compression_type>(m, "CompressionPolicy")
+      .def(py::init<>())
+      .def_readwrite("codec", &compression_type::codec)
+      .def_readwrite("min_size", &compression_type::min_size)
+      .def_readwrite("large_codec", &compression_type::large_codec)
+      .def_readwrite("large_size", &compression_type::large_size)
+      .def("enabled", &compression_type::enabled);
+
+    using policy_type = cache::WriteBehindPolicy;
+    py_class_type<policy_type>(m, "WriteBehindPolicy")
+      .def(py::init<>())
+      .def_readwrite("queue_capacity", &policy_type::queue_capacity)
+      .def_readwrite("batch_size", &policy_type::batch_size)
+      .def_property(
+        "max_delay_ms",
+        [](const policy_type& p) { return p.max_delay.count(); },
+        [](policy_type& p, long ms) {
+            p.max_delay = std::chrono::milliseconds(ms);
+        })
+      .def("enabled", &policy_type::enabled);
+
+    using mmc_type            = cache::ModuleManagerCache;
+    using default_options_fxn = void (mmc_type::*)(cache::RocksDBOptions);
+    using module_options_fxn =
+      void (mmc_type::*)(mmc_type::module_cache_key, cache::RocksDBOptions);
     py_class_type<cache::ModuleManagerCache,
                   std::shared_ptr<cache::ModuleManagerCache>>(
       m, "ModuleManagerCache")
-      .def(py::init<>());
+      .def(py::init<>())
+      .def("backup", &cache::ModuleManagerCache::backup)
+      .def("flush", &cache::ModuleManagerCache::flush)
+      .def("set_tier_policy", &cache::ModuleManagerCache::set_tier_policy)
+      .def(
+        "set_time_to_live",
+        [](mmc_type& c, mmc_type::module_cache_key key, long ms) {
+            c.set_time_to_live(std::move(key), std::chrono::milliseconds(ms));
+        },
+        py::arg("key"), py::arg("ms"))
+      .def("set_quota_policy", &cache::ModuleManagerCache::set_quota_policy)
+      .def("set_memory_budget", &cache::ModuleManagerCache::set_memory_budget)
+      .def("memory_budget", &cache::ModuleManagerCache::memory_budget)
+      .def("generation", &cache::ModuleManagerCache::generation)
+      .def("bump_generation", &cache::ModuleManagerCache::bump_generation)
+      .def("set_rocksdb_options",
+           static_cast<default_options_fxn>(
+             &cache::ModuleManagerCache::set_rocksdb_options))
+      .def("set_rocksdb_options",
+           static_cast<module_options_fxn>(
+             &cache::ModuleManagerCache::set_rocksdb_options))
+      .def("drop_module_cache", &cache::ModuleManagerCache::drop_module_cache)
+      .def("set_write_behind_policy",
+           &cache::ModuleManagerCache::set_write_behind_policy)
+      .def("set_compression_policy",
+           &cache::ModuleManagerCache::set_compression_policy)
+      .def("checkpoint", &cache::ModuleManagerCache::checkpoint,
+           py::arg("path"), py::arg("compress") = false)
+      .def("restore", &cache::ModuleManagerCache::restore)
+      .def("open_read_only", &cache::ModuleManagerCache::open_read_only,
+           py::arg("shared_location"), py::arg("overlay_location") = "")
+      .def("stats", &cache::ModuleManagerCache::stats)
+      .def("module_stats", &cache::ModuleManagerCache::module_stats);
 }
 
 } // namespace pluginplay::cache
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "interner.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <pluginplay/fields/module_input.hpp>
+#include <pluginplay/utility/uuid.hpp>
+#include <unordered_map>
+
+namespace pluginplay::cache {
+
+/** @brief Hash-conses the values of ModuleInput instances.
+ *
+ *  Calls often pass equal (and large) inputs as separate copies. Once the
+ *  cache has matched an input's value to a UUID, the InternTable remembers the
+ *  instance holding that value. Later inputs whose values are matched to the
+ *  same UUID are made to share that instance (see ModuleInput::intern), which
+ *  frees their own copies, and copies of inputs sharing an instance share it
+ *  too. Inputs sharing an instance are mapped back to their UUID by the
+ *  instance's address, i.e., without looking at their values. Inputs holding
+ *  their own copy of a value are found by the hash they keep with the value
+ *  (see ModuleInput::content_hash), so only the instances with that hash have
+ *  to be compared to them.
+ *
+ *  The table only holds weak references to the instances, so it does not keep
+ *  any value alive. Instances which died are removed every so often. Values
+ *  which alias an object owned by the user (i.e., inputs bound by const
+ *  reference) are never shared with other inputs.
+ */
+class InternTable : public Interner<ModuleInput, utility::uuid_type> {
+public:
+    /// Type of the object identifiers
+    using id_type = utility::uuid_type;
+
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Type of a shared instance of a value
+    using shared_any = typename ModuleInput::shared_any;
+
+    /// Returns the UUID of the instance @p key holds (or of an equal one)
+    const id_type* find(const ModuleInput& key) const noexcept override {
+        if(!key.has_value()) return nullptr;
+        auto itr = m_instances_.find(address_(key));
+        // If the instance died, its address may have been reused
+        if(itr != m_instances_.end() && !itr->second.value.expired())
+            return &itr->second.id;
+        return find_equal_(key);
+    }
+
+    /// Makes @p key share the instance matched to @p uuid (or records it)
+    void intern(const ModuleInput& key, const id_type& uuid) override {
+        if(!key.has_value()) return;
+        auto itr = m_ids_.find(uuid);
+        if(itr != m_ids_.end()) {
+            auto canonical = m_instances_.at(itr->second).value.lock();
+            if(canonical) {
+                if(canonical.get() == address_(key)) return;
+                const auto bytes = key.memory_footprint();
+                key.intern(std::move(canonical));
+                ++m_n_interned_;
+                m_bytes_saved_ += bytes;
+                return;
+            }
+        }
+        if(!key.value<const type::any&>().owns_value()) return;
+        sweep_();
+        record_(key.value<shared_any>(), key.content_hash(), uuid);
+    }
+
+    /// Forgets the instance matched to @p uuid (if any)
+    void forget(const id_type& uuid) noexcept override {
+        auto itr = m_ids_.find(uuid);
+        if(itr == m_ids_.end()) return;
+        auto instance = m_instances_.find(itr->second);
+        if(instance != m_instances_.end() && instance->second.id == uuid) {
+            unhash_(instance->first, instance->second);
+            m_instances_.erase(instance);
+        }
+        m_ids_.erase(itr);
+    }
+
+    /// Forgets every instance
+    void clear() noexcept override {
+        m_instances_.clear();
+        m_ids_.clear();
+        m_hashes_.clear();
+    }
+
+    /// The number of instances being tracked (some may have died)
+    size_type size() const noexcept { return m_instances_.size(); }
+
+    /// The number of inputs which dropped their copy for a shared instance
+    size_type n_interned() const noexcept { return m_n_interned_; }
+
+    /// The approximate number of bytes freed by sharing instances
+    size_type bytes_saved() const noexcept { return m_bytes_saved_; }
+
+private:
+    /// Type of a pointer to an instance, used to look instances up
+    using address_type = const type::any*;
+
+    /// Type of the hash of an instance's value
+    using content_hash_type = typename ModuleInput::content_hash_type;
+
+    /// What we know about an instance
+    struct entry_type {
+        /// The instance, used to tell if it's still alive
+        std::weak_ptr<const type::any> value;
+
+        /// The hash of the instance's value (if it has one)
+        content_hash_type hash;
+
+        /// The UUID it was matched to
+        id_type id;
+    };
+
+    /// Fewest instances to track before removing dead ones
+    static constexpr size_type min_sweep_ = 64;
+
+    /// The address of the instance @p key holds (@p key must have a value)
+    static address_type address_(const ModuleInput& key) {
+        return &key.value<const type::any&>();
+    }
+
+    /// Looks for an instance whose value equals @p key's, by its hash
+    const id_type* find_equal_(const ModuleInput& key) const noexcept {
+        const auto hash = key.content_hash();
+        if(!hash) return nullptr;
+        const auto& value = key.value<const type::any&>();
+        auto [begin, end] = m_hashes_.equal_range(*hash);
+        for(; begin != end; ++begin) {
+            auto itr = m_instances_.find(begin->second);
+            if(itr == m_instances_.end()) continue;
+            auto canonical = itr->second.value.lock();
+            if(canonical && *canonical == value) return &itr->second.id;
+        }
+        return nullptr;
+    }
+
+    /// Removes the instance at @p address from m_hashes_
+    void unhash_(address_type address, const entry_type& entry) noexcept {
+        if(!entry.hash) return;
+        auto [begin, end] = m_hashes_.equal_range(*entry.hash);
+        for(; begin != end; ++begin)
+            if(begin->second == address) {
+                m_hashes_.erase(begin);
+                return;
+            }
+    }
+
+    /// Makes @p value, whose hash is @p hash, the instance matched to @p uuid
+    void record_(shared_any value, content_hash_type hash,
+                 const id_type& uuid) {
+        forget(uuid);
+        auto& entry = m_instances_[value.get()];
+        // The instance may still be recorded under a UUID which was forgotten
+        // and then matched to a new one
+        auto old = m_ids_.find(entry.id);
+        if(old != m_ids_.end() && old->second == value.get()) m_ids_.erase(old);
+        unhash_(value.get(), entry);
+        if(hash) m_hashes_.emplace(*hash, value.get());
+        m_ids_[uuid] = value.get();
+        entry        = entry_type{value, hash, uuid};
+    }
+
+    /// Removes dead instances, if enough instances are being tracked
+    void sweep_() {
+        if(m_instances_.size() < m_next_sweep_) return;
+        for(auto itr = m_instances_.begin(); itr != m_instances_.end();) {
+            if(!itr->second.value.expired()) {
+                ++itr;
+                continue;
+            }
+            auto id = m_ids_.find(itr->second.id);
+            if(id != m_ids_.end() && id->second == itr->first) m_ids_.erase(id);
+            unhash_(itr->first, itr->second);
+            itr = m_instances_.erase(itr);
+        }
+        m_next_sweep_ = std::max(min_sweep_, 2 * m_instances_.size());
+    }
+
+    /// The instances, keyed by their addresses
+    std::unordered_map<address_type, entry_type> m_instances_;
+
+    /// Maps UUIDs to the address of the instance they were matched to
+    std::unordered_map<id_type, address_type> m_ids_;
+
+    /// Maps the hashes of the instances' values to the instances' addresses
+    std::unordered_multimap<std::size_t, address_type> m_hashes_;
+
+    /// When to next remove dead instances
+    size_type m_next_sweep_ = min_sweep_;
+
+    /// Number of inputs which started sharing an instance
+    size_type m_n_interned_ = 0;
+
+    /// Bytes freed by sharing instances
+    size_type m_bytes_saved_ = 0;
+};
+
+} // namespace pluginplay::cache
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+namespace pluginplay::cache {
+
+/** @brief Interface for hash-consing the keys of a UUIDMapper.
+ *
+ *  A UUIDMapper assigns each distinct key a UUID. An Interner remembers which
+ *  instance a key's value was matched to a UUID with, so that later keys
+ *  holding an equal value can share that instance (saving memory), and so
+ *  that keys which share it can be mapped to their UUID without looking at
+ *  their value.
+ *
+ *  @tparam KeyType The type of the keys being interned.
+ *  @tparam MappedType The type of the UUIDs.
+ */
+template<typename KeyType, typename MappedType>
+class Interner {
+public:
+    /// Type of the keys being interned
+    using key_type = KeyType;
+
+    /// Type of the UUIDs
+    using mapped_type = MappedType;
+
+    /// Standard polymorphic dtor
+    virtual ~Interner() noexcept = default;
+
+    /** @brief Returns the UUID of @p key if its value is interned.
+     *
+     *  Keys sharing an interned instance are always found. Implementations may
+     *  also find keys which hold their own copy of an interned value (e.g., by
+     *  comparing the hashes of the values); such keys should then be interned
+     *  so that they share the instance.
+     *
+     *  @param[in] key The key to look up.
+     *
+     *  @return A pointer to the UUID of the instance @p key holds (or of an
+     *          instance holding an equal value), or nullptr if no such
+     *          instance is interned. The pointer is invalidated by any
+     *          non-const call to this interner.
+     *
+     *  @throw None No throw guarantee.
+     */
+    virtual const mapped_type* find(const key_type& key) const noexcept = 0;
+
+    /** @brief Records that @p key's value was matched to @p uuid.
+     *
+     *  If an instance holding an equal value was already matched to @p uuid,
+     *  @p key shares that instance from now on. Otherwise the instance @p key
+     *  holds becomes the instance later keys share.
+     *
+     *  @param[in] key A key whose value is known to map to @p uuid.
+     *  @param[in] uuid The UUID of @p key.
+     *
+     *  @throw std::bad_alloc if there is a problem recording the match.
+     *                        Strong throw guarantee.
+     */
+    virtual void intern(const key_type& key, const mapped_type& uuid) = 0;
+
+    /** @brief Forgets the instance matched to @p uuid.
+     *
+     *  Used when @p uuid no longer maps to a key, e.g., because the key was
+     *  freed. Keys sharing the instance keep sharing it, but are looked up by
+     *  value again.
+     *
+     *  @param[in] uuid The UUID to forget.
+     *
+     *  @throw None No throw guarantee.
+     */
+    virtual void forget(const mapped_type& uuid) noexcept = 0;
+
+    /** @brief Forgets every instance.
+     *
+     *  @throw None No throw guarantee.
+     */
+    virtual void clear() noexcept = 0;
+};
+
+} // namespace pluginplay::cache
@@ -15,9 +15,28 @@
  */
 
 #include "database/database_api.hpp"
+#include "detail_/codec.hpp"
 #include "module_cache_pimpl.hpp"
+#include <algorithm>
 
 namespace pluginplay::cache {
+namespace {
+
+// Can every input and result be saved and loaded back? Saved results whose
+// inputs can't be saved can't be found again, and results which can't be
+// saved can't be read again (e.g., after a restart or restore).
+template<typename MapType>
+bool round_trips(const MapType& fields) noexcept {
+    using shared_any = typename MapType::mapped_type::shared_any;
+    try {
+        for(const auto& [_, field] : fields)
+            if(!field.template value<shared_any>()->is_serializable())
+                return false;
+        return true;
+    } catch(...) { return false; }
+}
+
+} // namespace
 
 ModuleCache::ModuleCache() noexcept = default;
 
@@ -30,22 +49,199 @@ ModuleCache::~ModuleCache() noexcept = default;
 
 bool ModuleCache::count(const_key_reference key) const {
     if(!m_pimpl_) return false;
-    return m_pimpl_->m_db->count(key);
+    auto& counters   = m_pimpl_->m_counters;
+    const auto start = detail_::CacheCounters::clock_type::now();
+    m_pimpl_->check_generation();
+    const bool in_l1 = m_pimpl_->m_l1.find(key) != nullptr;
+    bool found = in_l1, on_disk = false;
+    if(!found) {
+        auto lock = m_pimpl_->lock();
+        found     = m_pimpl_->find(key, &on_disk) != nullptr;
+    }
+    counters.add_time(counters.key_time_ns, start);
+    counters.add(found ? counters.hits : counters.misses);
+    if(in_l1)
+        counters.add(counters.l1_hits);
+    else if(found)
+        counters.add(on_disk ? counters.l3_hits : counters.l2_hits);
+    return found;
 }
 
 void ModuleCache::cache(key_type key, mapped_type value) {
-    pimpl_().m_db->insert(std::move(key), std::move(value));
+    cache(std::move(key), std::move(value), Admission::persistent);
+}
+
+void ModuleCache::cache(key_type key, mapped_type value, Admission admission) {
+    auto& pimpl = pimpl_();
+    if(admission == Admission::skip) return;
+    if(admission == Admission::persistent && pimpl.m_memory_db &&
+       !(round_trips(key) && round_trips(value)))
+        admission = Admission::memory_only;
+    {
+        auto lock = pimpl.lock();
+        auto& db  = pimpl.db_for(admission);
+        // A result cached with a different admission is stale now, and find
+        // could pick it over the new one
+        auto* pother = &db != pimpl.m_db.get() ? pimpl.m_db.get() :
+                       pimpl.m_memory_db_used  ? pimpl.m_memory_db.get() :
+                                                 nullptr;
+        if(pother && pother->count(key)) pother->free(key);
+        db.insert(std::move(key), std::move(value));
+        // Only queues the writes, the actual I/O happens in the background
+        if(pimpl.m_write_behind && admission == Admission::persistent)
+            pimpl.m_db->backup();
+    }
+    // Other threads may have the previous value in their L1
+    pimpl.m_l1.invalidate();
+    pimpl.m_counters.add(pimpl.m_counters.insertions);
 }
 
 typename ModuleCache::mapped_type ModuleCache::uncache(
   const_key_reference key) {
-    if(!count(key)) throw std::out_of_range("No cached results");
-    return m_pimpl_->m_db->at(key).get();
+    // N.B. Not calling count so this doesn't show up as a hit/miss
+    if(!m_pimpl_) throw std::out_of_range("No cached results");
+    m_pimpl_->check_generation();
+    if(auto pl1 = m_pimpl_->m_l1.find(key)) return *pl1;
+    auto& counters   = m_pimpl_->m_counters;
+    const auto start = detail_::CacheCounters::clock_type::now();
+    mapped_type rv;
+    {
+        // The copy is made under the lock, other threads may change the value
+        auto lock = m_pimpl_->lock();
+        auto pdb  = m_pimpl_->find(key);
+        if(!pdb) throw std::out_of_range("No cached results");
+        rv = pdb->at(key).get();
+    }
+    counters.add_time(counters.deserialize_time_ns, start);
+    if(m_pimpl_->l1_allowed()) m_pimpl_->m_l1.insert(key, rv);
+    return rv;
 }
 
 void ModuleCache::clear() {
     if(!m_pimpl_) return;
+    auto lock = m_pimpl_->lock();
+    // Whatever was in memory is about to be evicted
+    const auto n = m_pimpl_->m_tiers->entries.load(std::memory_order_relaxed);
     m_pimpl_->m_db->dump();
+    if(m_pimpl_->m_memory_db) m_pimpl_->m_memory_db->dump();
+    m_pimpl_->m_memory_db_used = false;
+    m_pimpl_->m_l1.invalidate();
+    m_pimpl_->m_counters.evict_all(n);
+}
+
+void ModuleCache::backup() {
+    if(!m_pimpl_) return;
+    auto lock = m_pimpl_->lock();
+    m_pimpl_->m_db->backup();
+}
+
+void ModuleCache::set_admission_policy(AdmissionPolicy policy) {
+    pimpl_().m_policy = std::move(policy);
+}
+
+void ModuleCache::set_compression_policy(CompressionPolicy policy) {
+    detail_::assert_codecs_available(policy);
+    *pimpl_().m_compression = std::move(policy);
+}
+
+void ModuleCache::set_tier_policy(TierPolicy policy) {
+    auto& pimpl = pimpl_();
+    pimpl.m_l1.set_capacity(policy.l1_capacity);
+    auto& tiers = *pimpl.m_tiers;
+    tiers.max_size.store(policy.l2_capacity);
+    tiers.cold_after_accesses.store(policy.cold_after_accesses);
+    using std::chrono::nanoseconds;
+    const auto dt = std::chrono::duration_cast<nanoseconds>(policy.cold_after);
+    tiers.cold_after_ns.store(dt.count());
+}
+
+TierPolicy ModuleCache::tier_policy() const {
+    const auto& pimpl = pimpl_();
+    TierPolicy rv;
+    rv.l1_capacity = pimpl.m_l1.capacity();
+    const auto& tiers      = *pimpl.m_tiers;
+    rv.l2_capacity         = tiers.max_size.load();
+    rv.cold_after_accesses = tiers.cold_after_accesses.load();
+    using std::chrono::milliseconds;
+    const std::chrono::nanoseconds dt(tiers.cold_after_ns.load());
+    rv.cold_after = std::chrono::duration_cast<milliseconds>(dt);
+    return rv;
+}
+
+void ModuleCache::set_time_to_live(std::chrono::milliseconds ttl) {
+    auto& pimpl = pimpl_();
+    using std::chrono::nanoseconds;
+    const auto dt = std::chrono::duration_cast<nanoseconds>(ttl);
+    pimpl.m_tiers->ttl_ns.store(std::max<std::int64_t>(dt.count(), 0));
+    // Results already in L1 don't know their age
+    pimpl.m_l1.invalidate();
+}
+
+std::chrono::milliseconds ModuleCache::time_to_live() const {
+    using std::chrono::milliseconds;
+    const std::chrono::nanoseconds dt(pimpl_().m_tiers->ttl_ns.load());
+    return std::chrono::duration_cast<milliseconds>(dt);
+}
+
+void ModuleCache::set_quota_policy(QuotaPolicy policy) {
+    auto& tiers = *pimpl_().m_tiers;
+    tiers.max_entries.store(policy.max_entries);
+    tiers.max_bytes.store(policy.max_bytes);
+    tiers.priority.store(static_cast<int>(policy.priority));
+}
+
+QuotaPolicy ModuleCache::quota_policy() const {
+    const auto& tiers = *pimpl_().m_tiers;
+    QuotaPolicy rv;
+    rv.max_entries = tiers.max_entries.load();
+    rv.max_bytes   = tiers.max_bytes.load();
+    rv.priority    = static_cast<CachePriority>(tiers.priority.load());
+    return rv;
+}
+
+AdmissionPolicy ModuleCache::admission_policy() const {
+    return pimpl_().m_policy;
+}
+
+Admission ModuleCache::admit(const mapped_type& value,
+                             double compute_time) const noexcept {
+    if(!m_pimpl_) return Admission::skip;
+    const auto& policy = m_pimpl_->m_policy;
+    if(policy.admits_everything()) return Admission::persistent;
+
+    const auto bytes     = pluginplay::memory_footprint(value);
+    const auto admission = policy(compute_time, bytes);
+    if(admission == Admission::skip)
+        m_pimpl_->m_counters.add(m_pimpl_->m_counters.rejections);
+    return admission;
+}
+
+CacheStats ModuleCache::stats() const noexcept {
+    if(!m_pimpl_) return CacheStats{};
+    constexpr auto relaxed = std::memory_order_relaxed;
+    auto rv                = m_pimpl_->m_counters.snapshot();
+    const auto& tier       = *m_pimpl_->m_tiers;
+    rv.promotions          = tier.promotions.load(relaxed);
+    rv.demotions           = tier.demotions.load(relaxed);
+    rv.compressions        = tier.compressions.load(relaxed);
+    rv.decompressions      = tier.decompressions.load(relaxed);
+    rv.expirations         = tier.expirations.load(relaxed);
+    rv.evictions += tier.evictions.load(relaxed);
+    rv.resident_entries = tier.entries.load(relaxed);
+    rv.resident_bytes   = tier.bytes.load(relaxed);
+    rv.entries          = rv.resident_entries;
+    rv.bytes_in_memory  = rv.resident_bytes;
+
+    // Results go cold if the policy asks for it and they can be compressed
+    const bool cold = tier.cold_after_accesses.load(relaxed) ||
+                      tier.cold_after_ns.load(relaxed);
+    rv.cooling = cold && tier.coolable.load(relaxed);
+    return rv;
+}
+
+std::size_t ModuleCache::memory_footprint() const noexcept {
+    if(!m_pimpl_) return 0;
+    return m_pimpl_->m_tiers->bytes.load(std::memory_order_relaxed);
 }
 
 void ModuleCache::assert_pimpl_() const {
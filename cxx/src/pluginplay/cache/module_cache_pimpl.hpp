@@ -15,14 +15,94 @@
  */
 
 #pragma once
+#include "database/tier_state.hpp"
+#include "detail_/thread_local_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <pluginplay/cache/admission_policy.hpp>
+#include <pluginplay/cache/cache_stats.hpp>
+#include <pluginplay/cache/compression_policy.hpp>
 #include <pluginplay/cache/module_cache.hpp>
+#include <pluginplay/cache/tier_policy.hpp>
 
 namespace pluginplay::cache::detail_ {
 
+/** @brief The counters backing a CacheStats instance.
+ *
+ *  The counters are atomics which are only ever updated with relaxed memory
+ *  ordering. Updating a counter is thus lock-free and cheap enough to do on
+ *  every cache operation. The price is that a snapshot taken while other
+ *  threads are updating the counters need not be self-consistent (e.g., the
+ *  hits may reflect an operation that the timers do not yet reflect).
+ */
+struct CacheCounters {
+    // Type of the value held by each counter
+    using value_type = typename CacheStats::counter_type;
+
+    // Type of the counters
+    using counter_type = std::atomic<value_type>;
+
+    // Type of the clock used for timing
+    using clock_type = std::chrono::steady_clock;
+
+    // Adds @p n to @p counter
+    static void add(counter_type& counter, value_type n = 1) noexcept {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Adds the nanoseconds elapsed since @p start to @p counter
+    static void add_time(counter_type& counter,
+                         clock_type::time_point start) noexcept {
+        using std::chrono::duration_cast;
+        using std::chrono::nanoseconds;
+        const auto dt = duration_cast<nanoseconds>(clock_type::now() - start);
+        add(counter, static_cast<value_type>(dt.count()));
+    }
+
+    // Records that the @p n entries which were in memory were removed
+    void evict_all(value_type n) noexcept { add(evictions, n); }
+
+    // Copies the current values of the counters into a CacheStats object
+    CacheStats snapshot() const noexcept {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        CacheStats rv;
+        rv.hits                = hits.load(relaxed);
+        rv.misses              = misses.load(relaxed);
+        rv.l1_hits             = l1_hits.load(relaxed);
+        rv.l2_hits             = l2_hits.load(relaxed);
+        rv.l3_hits             = l3_hits.load(relaxed);
+        rv.insertions          = insertions.load(relaxed);
+        rv.evictions           = evictions.load(relaxed);
+        rv.rejections          = rejections.load(relaxed);
+        rv.key_time_ns         = key_time_ns.load(relaxed);
+        rv.deserialize_time_ns = deserialize_time_ns.load(relaxed);
+        return rv;
+    }
+
+    counter_type hits{0};
+    counter_type misses{0};
+    counter_type l1_hits{0};
+    counter_type l2_hits{0};
+    counter_type l3_hits{0};
+    counter_type insertions{0};
+    counter_type evictions{0};
+    counter_type rejections{0};
+    counter_type key_time_ns{0};
+    counter_type deserialize_time_ns{0};
+};
+
 /** @brief The class containing a ModuleCache instance's state.
  *
  *  This is just a thin-wrapper around a database. The PIMPL nature keeps the
  *  details of the database out of the public API.
+ *
+ *  Even reads modify the databases (e.g., they update the recency of the
+ *  result, or promote it from disk), so every access of m_db or m_memory_db
+ *  must hold m_mutex. Only L1 and the counters can be used without it.
  */
 struct ModuleCachePIMPL {
     // Type of the class this PIMPL implements
@@ -40,8 +120,92 @@ struct ModuleCachePIMPL {
     // Pointer to the DB
     using db_pointer_type = std::unique_ptr<db_type>;
 
+    // Type of the mutex guarding the databases. Recursive so that the owner
+    // of the module caches can hold it while calling into them.
+    using mutex_type = std::recursive_mutex;
+
+    // Type of a lock on the mutex
+    using lock_type = std::lock_guard<mutex_type>;
+
+    // Locks the databases
+    lock_type lock() const { return lock_type(*m_mutex); }
+
+    // Returns the database holding @p key, or nullptr if no database has it.
+    // If @p on_disk is non-null it's set to whether key was only found on
+    // disk (i.e., retrieving it means loading it). Requires holding m_mutex.
+    db_type* find(const key_type& key, bool* on_disk = nullptr) const {
+        const auto& finds = m_tiers->backup_finds;
+        const auto before = finds.load(std::memory_order_relaxed);
+        if(m_db->count(key)) {
+            if(on_disk)
+                *on_disk = finds.load(std::memory_order_relaxed) != before;
+            return m_db.get();
+        }
+        if(on_disk) *on_disk = false;
+        if(m_memory_db_used && m_memory_db->count(key))
+            return m_memory_db.get();
+        return nullptr;
+    }
+
+    // Returns the database results admitted with @p admission belong in
+    db_type& db_for(Admission admission) {
+        if(admission != Admission::memory_only || !m_memory_db) return *m_db;
+        m_memory_db_used = true;
+        return *m_memory_db;
+    }
+
     // The database actually powering the ModuleCache
     db_pointer_type m_db;
+
+    // Database for memory-only results, null if m_db is memory-only already
+    db_pointer_type m_memory_db;
+
+    // Has anything been put in m_memory_db? (avoids a lookup if not)
+    bool m_memory_db_used = false;
+
+    // Decides where new results go
+    AdmissionPolicy m_policy;
+
+    // Should persistent results be handed to long-term storage right away?
+    // Only makes sense if long-term storage is written in the background.
+    bool m_write_behind = false;
+
+    // How this module's results are compressed, empty means the default way.
+    // Shared with the database, which reads it when results are saved.
+    std::shared_ptr<std::optional<CompressionPolicy>> m_compression =
+      std::make_shared<std::optional<CompressionPolicy>>();
+
+    // Each thread's most recently retrieved results (L1)
+    ThreadLocalCache<key_type, mapped_type> m_l1;
+
+    // Limit and counters of m_db's in-memory tier (L2), shared with m_db
+    std::shared_ptr<database::TierState> m_tiers =
+      std::make_shared<database::TierState>();
+
+    // The generation m_l1 was last emptied for
+    std::atomic<std::uint64_t> m_l1_generation{0};
+
+    // Empties every thread's L1 if the generation changed since the last call.
+    // Results in L1 aren't stamped, so this keeps stale ones from being used.
+    void check_generation() noexcept {
+        if(!m_tiers->generation) return;
+        const auto g = m_tiers->generation->load(std::memory_order_acquire);
+        if(m_l1_generation.load(std::memory_order_relaxed) == g) return;
+        m_l1_generation.store(g, std::memory_order_relaxed);
+        m_l1.invalidate();
+    }
+
+    // Can L1 hold results? Not if they expire, as L1 doesn't know their age
+    bool l1_allowed() const noexcept {
+        return m_tiers->ttl_ns.load(std::memory_order_relaxed) == 0;
+    }
+
+    // Usage statistics for the ModuleCache
+    CacheCounters m_counters;
+
+    // Guards the databases (L2 and L3). Module caches sharing storage (or a
+    // memory budget, which reclaims memory from all of them) share the mutex.
+    std::shared_ptr<mutex_type> m_mutex = std::make_shared<mutex_type>();
 };
 
 } // namespace pluginplay::cache::detail_
@@ -15,8 +15,11 @@
  */
 
 #include "database/database_factory.hpp"
+#include "database/memory_budget.hpp"
+#include "detail_/checkpoint_bundle.hpp"
 #include "module_cache_pimpl.hpp"
 #include <filesystem>
+#include <fstream>
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/cache/user_cache.hpp>
@@ -42,17 +45,87 @@ struct ModuleManagerCachePIMPL {
     std::map<module_cache_key, module_cache_pointer> m_module_caches;
 
     std::map<module_cache_key, user_cache_pointer> m_user_caches;
+
+    // Where the cache is saved to, empty if it's memory only
+    path_type m_save_location;
+
+    // Where the overlay of a read-only cache is saved to (if anywhere)
+    path_type m_overlay_location;
+
+    // Where the generation is saved to, empty if it isn't saved
+    path_type m_generation_location;
+
+    // Results cached before this last changed are stale, shared with the
+    // TierState of every module cache
+    std::shared_ptr<database::TierState::counter_type> m_generation =
+      std::make_shared<database::TierState::counter_type>(0);
+
+    // Caps the bytes used by the results in memory, shared with the
+    // TierState of every module cache
+    std::shared_ptr<database::MemoryBudget> m_budget =
+      std::make_shared<database::MemoryBudget>();
+
+    // The module caches share storage and m_budget, so they share a mutex too
+    using mutex_type = ModuleCachePIMPL::mutex_type;
+    std::shared_ptr<mutex_type> m_mutex = std::make_shared<mutex_type>();
+
+    // Locks the databases of every module cache (and the maps above)
+    ModuleCachePIMPL::lock_type lock() const {
+        return ModuleCachePIMPL::lock_type(*m_mutex);
+    }
 };
 
 } // namespace detail_
 
+namespace {
+
+// Name of the file, next to the cache, the generation is saved in
+constexpr const char* generation_file = "generation";
+
+// Reads the generation saved in @p dir, 0 if there isn't one
+std::uint64_t load_generation(const std::filesystem::path& dir) {
+    std::ifstream in(dir / generation_file);
+    std::uint64_t rv = 0;
+    if(!(in >> rv)) return 0;
+    return rv;
+}
+
+// Saves @p generation in @p dir
+void save_generation(const std::filesystem::path& dir,
+                     std::uint64_t generation) {
+    std::ofstream out(dir / generation_file, std::ios::trunc);
+    out << generation;
+    if(!out) throw std::runtime_error("Failed to save the generation");
+}
+
+// Advances @p counter to @p generation, if it's behind
+void advance_generation(database::TierState::counter_type& counter,
+                        std::uint64_t generation) noexcept {
+    auto current = counter.load(std::memory_order_acquire);
+    while(current < generation &&
+          !counter.compare_exchange_weak(current, generation,
+                                         std::memory_order_acq_rel)) {}
+}
+
+} // namespace
+
 ModuleManagerCache::ModuleManagerCache() noexcept = default;
 
 ModuleManagerCache::ModuleManagerCache(path_type disk_location) {
     change_save_location(std::move(disk_location));
 }
 
-ModuleManagerCache::~ModuleManagerCache() noexcept = default;
+ModuleManagerCache::ModuleManagerCache(path_type disk_location,
+                                       WriteBehindPolicy policy) {
+    set_write_behind_policy(policy);
+    change_save_location(std::move(disk_location));
+}
+
+ModuleManagerCache::~ModuleManagerCache() noexcept {
+    try {
+        backup();
+    } catch(...) {}
+}
 
 void ModuleManagerCache::change_save_location(path_type disk_location) {
     std::filesystem::path root_dir(disk_location);
@@ -66,13 +139,200 @@ void ModuleManagerCache::change_save_location(path_type disk_location) {
     auto p = root_dir / cache_dir;
     auto q = root_dir / uuid_dir;
 
-    pimpl_().m_db_factory.set_serialized_pm_to_pm(p.string());
+    auto lock = pimpl_().lock();
+    m_pimpl_->m_db_factory.set_serialized_pm_to_pm(p.string());
     m_pimpl_->m_db_factory.set_type_eraser_backend(q.string());
+    m_pimpl_->m_save_location = root_dir.string();
+    m_pimpl_->m_overlay_location.clear();
+    m_pimpl_->m_generation_location = root_dir.string();
+    advance_generation(*m_pimpl_->m_generation, load_generation(root_dir));
+}
+
+void ModuleManagerCache::open_read_only(path_type shared_location,
+                                        path_type overlay_location) {
+    std::filesystem::path root_dir(shared_location);
+    if(!std::filesystem::is_directory(root_dir))
+        throw std::runtime_error("No saved cache at: " + shared_location);
+    if(!overlay_location.empty())
+        std::filesystem::create_directories(overlay_location);
+
+    auto lock     = pimpl_().lock();
+    auto& factory = m_pimpl_->m_db_factory;
+    factory.set_read_only_storage(true, overlay_location);
+    factory.set_serialized_pm_to_pm((root_dir / "cache").string());
+    factory.set_type_eraser_backend((root_dir / "uuid").string());
+    factory.set_read_only_storage(false);
+    auto& generation = *m_pimpl_->m_generation;
+    advance_generation(generation, load_generation(root_dir));
+    if(!overlay_location.empty())
+        advance_generation(generation, load_generation(overlay_location));
+    m_pimpl_->m_save_location       = root_dir.string();
+    m_pimpl_->m_generation_location = overlay_location;
+    m_pimpl_->m_overlay_location    = std::move(overlay_location);
+}
+
+void ModuleManagerCache::backup() {
+    if(!m_pimpl_) return;
+    auto lock = m_pimpl_->lock();
+    for(auto& [_, pcache] : m_pimpl_->m_module_caches) pcache->backup();
+    for(auto& [_, pcache] : m_pimpl_->m_user_caches) pcache->backup();
+    m_pimpl_->m_db_factory.backup();
+    m_pimpl_->m_db_factory.flush();
+    const auto& dir = m_pimpl_->m_generation_location;
+    if(!dir.empty()) save_generation(dir, m_pimpl_->m_generation->load());
+}
+
+void ModuleManagerCache::set_write_behind_policy(WriteBehindPolicy policy) {
+    pimpl_().m_db_factory.set_write_behind_policy(policy);
+}
+
+void ModuleManagerCache::set_compression_policy(CompressionPolicy policy) {
+    pimpl_().m_db_factory.set_compression_policy(std::move(policy));
+}
+
+void ModuleManagerCache::set_rocksdb_options(RocksDBOptions options) {
+    pimpl_().m_db_factory.set_rocksdb_options(options);
+}
+
+void ModuleManagerCache::set_rocksdb_options(module_cache_key key,
+                                             RocksDBOptions options) {
+    pimpl_().m_db_factory.set_rocksdb_options(std::move(key), options);
+}
+
+void ModuleManagerCache::drop_module_cache(module_cache_key key) {
+    if(!m_pimpl_) return;
+    auto lock = m_pimpl_->lock();
+    auto itr  = m_pimpl_->m_module_caches.find(key);
+    if(itr != m_pimpl_->m_module_caches.end()) itr->second->clear();
+    m_pimpl_->m_db_factory.drop_module(key);
+}
+
+void ModuleManagerCache::set_tier_policy(module_cache_key key,
+                                         TierPolicy policy) {
+    get_or_make_module_cache(std::move(key))->set_tier_policy(policy);
+}
+
+void ModuleManagerCache::set_time_to_live(module_cache_key key,
+                                          std::chrono::milliseconds ttl) {
+    get_or_make_module_cache(std::move(key))->set_time_to_live(ttl);
+}
+
+void ModuleManagerCache::set_quota_policy(module_cache_key key,
+                                          QuotaPolicy policy) {
+    get_or_make_module_cache(std::move(key))->set_quota_policy(policy);
+}
+
+void ModuleManagerCache::set_memory_budget(std::size_t bytes) {
+    auto lock    = pimpl_().lock();
+    auto& budget = *m_pimpl_->m_budget;
+    budget.set_limit(bytes);
+    budget.enforce();
+}
+
+std::size_t ModuleManagerCache::memory_budget() const noexcept {
+    if(!m_pimpl_) return 0;
+    return m_pimpl_->m_budget->limit();
+}
+
+std::uint64_t ModuleManagerCache::generation() const noexcept {
+    if(!m_pimpl_) return 0;
+    return m_pimpl_->m_generation->load(std::memory_order_acquire);
+}
+
+std::uint64_t ModuleManagerCache::bump_generation() {
+    return pimpl_().m_generation->fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+void ModuleManagerCache::flush() {
+    if(m_pimpl_) m_pimpl_->m_db_factory.flush();
+}
+
+namespace {
+
+// Code factorization for checkpoint and checkpoint_async
+detail_::CheckpointBundle make_bundle(detail_::ModuleManagerCachePIMPL& pimpl) {
+    if(!pimpl.m_db_factory.has_long_term_storage())
+        throw std::runtime_error("Only caches which save to disk can be "
+                                 "checkpointed");
+    auto lock = pimpl.lock();
+    detail_::CheckpointBundle rv;
+    for(const auto& [key, _] : pimpl.m_module_caches) rv.modules.push_back(key);
+    for(const auto& [key, _] : pimpl.m_user_caches) rv.modules.push_back(key);
+    rv.tables = pimpl.m_db_factory.export_tables();
+    return rv;
+}
+
+} // namespace
+
+void ModuleManagerCache::checkpoint(path_type path, bool compress) {
+    backup();
+    make_bundle(pimpl_()).save(path, compress);
+}
+
+std::future<void> ModuleManagerCache::checkpoint_async(path_type path,
+                                                       bool compress) {
+    backup();
+    auto bundle = make_bundle(pimpl_());
+    auto l      = [b = std::move(bundle), p = std::move(path), compress]() {
+        b.save(p, compress);
+    };
+    return std::async(std::launch::async, std::move(l));
+}
+
+std::vector<ModuleManagerCache::module_cache_key> ModuleManagerCache::restore(
+  path_type path) {
+    auto& factory = pimpl_().m_db_factory;
+    if(!factory.has_long_term_storage())
+        throw std::runtime_error("Checkpoints can only be restored to caches "
+                                 "which save to disk");
+    auto bundle = detail_::CheckpointBundle::load(path);
+    auto lock   = m_pimpl_->lock();
+    factory.import_tables(bundle.tables);
+    return std::move(bundle.modules);
+}
+
+CacheStats ModuleManagerCache::stats() const {
+    CacheStats rv;
+    if(!m_pimpl_) return rv;
+
+    for(const auto& [_, pcache] : m_pimpl_->m_module_caches)
+        rv += pcache->stats();
+
+    const auto& dedup     = m_pimpl_->m_db_factory.dedup_table();
+    rv.deduplicated       = dedup.n_deduplicated();
+    rv.bytes_deduplicated = dedup.bytes_saved();
+
+    const auto& interns = m_pimpl_->m_db_factory.intern_table();
+    rv.interned         = interns.n_interned();
+    rv.bytes_interned   = interns.bytes_saved();
+
+    namespace fs = std::filesystem;
+    for(const auto& root :
+        {m_pimpl_->m_save_location, m_pimpl_->m_overlay_location}) {
+        if(root.empty() || !fs::exists(root)) continue;
+        for(const auto& entry : fs::recursive_directory_iterator(root)) {
+            std::error_code ec;
+            if(!entry.is_regular_file(ec)) continue;
+            const auto n = entry.file_size(ec);
+            if(!ec) rv.bytes_on_disk += n;
+        }
+    }
+    return rv;
+}
+
+std::map<ModuleManagerCache::module_cache_key, CacheStats>
+ModuleManagerCache::module_stats() const {
+    std::map<module_cache_key, CacheStats> rv;
+    if(!m_pimpl_) return rv;
+    for(const auto& [key, pcache] : m_pimpl_->m_module_caches)
+        rv.emplace(key, pcache->stats());
+    return rv;
 }
 
 typename ModuleManagerCache::module_cache_pointer
 ModuleManagerCache::get_or_make_module_cache(module_cache_key key) {
-    if(!pimpl_().m_module_caches.count(key)) {
+    auto lock = pimpl_().lock();
+    if(!m_pimpl_->m_module_caches.count(key)) {
         auto p = std::make_shared<module_cache_type>(make_module_cache_(key));
         m_pimpl_->m_module_caches.emplace(key, p);
     }
@@ -82,7 +342,8 @@ ModuleManagerCache::get_or_make_module_cache(module_cache_key key) {
 typename ModuleManagerCache::user_cache_pointer
 ModuleManagerCache::get_or_make_user_cache(module_cache_key key) {
     module_cache_key mangled_key = "__PP__ " + key + "-USER __PP__";
-    if(!pimpl_().m_user_caches.count(mangled_key)) {
+    auto lock                    = pimpl_().lock();
+    if(!m_pimpl_->m_user_caches.count(mangled_key)) {
         auto mcache = make_module_cache_(mangled_key);
         auto p      = std::make_shared<user_cache_type>(std::move(mcache));
         m_pimpl_->m_user_caches.emplace(mangled_key, p);
@@ -92,8 +353,18 @@ ModuleManagerCache::get_or_make_user_cache(module_cache_key key) {
 
 typename ModuleManagerCache::module_cache_type
 ModuleManagerCache::make_module_cache_(module_cache_key key) {
-    auto p  = std::make_unique<detail_::ModuleCachePIMPL>();
-    p->m_db = pimpl_().m_db_factory.default_module_db(std::move(key));
+    auto p          = std::make_unique<detail_::ModuleCachePIMPL>();
+    auto& fac       = pimpl_().m_db_factory;
+    const auto& cmp = p->m_compression;
+    // Must be set before the databases share the TierState
+    p->m_tiers->generation = m_pimpl_->m_generation;
+    p->m_tiers->budget     = m_pimpl_->m_budget;
+    p->m_l1_generation     = m_pimpl_->m_generation->load();
+    p->m_mutex             = m_pimpl_->m_mutex;
+    p->m_db         = fac.default_module_db(std::move(key), cmp, p->m_tiers);
+    if(fac.has_long_term_storage())
+        p->m_memory_db = fac.memory_module_db(p->m_tiers);
+    p->m_write_behind = fac.write_behind();
     return module_cache_type(std::move(p));
 }
 
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "uuid_mapper.hpp"
+#include <functional>
 #include <map>
 namespace pluginplay::cache {
 
@@ -60,6 +61,9 @@ public:
     /// Ultimately a typedef of DatabaseAPI<key_value_type, ...>::key_set_type
     using key_set_type = std::vector<key_type>;
 
+    /// Type of a pointer to a cursor over the proxied objects
+    using cursor_pointer = std::unique_ptr<database::Cursor<key_type>>;
+
     /// Read-only reference to a key, typedef of const KeyType&
     using const_key_reference = const key_type&;
 
@@ -72,6 +76,9 @@ public:
     /// Type of a pointer to a UUIDMapper
     using proxy_mapper_pointer = std::unique_ptr<proxy_mapper>;
 
+    /// Type of a function which can map a UUID back to the value it proxies
+    using un_proxy_function = std::function<key_value_type(const uuid_type&)>;
+
     /** @brief Creates a new ProxyMapMaker which relies on @p db for making
      *         proxy objects.
      *
@@ -82,11 +89,17 @@ public:
      *  other ProxyMapMaker instances agree on the UUIDs of values they've seen.
      *
      *  @param[in] db The UUIDMapper this instance will use for mapping.
+     *  @param[in] fxn A function which maps a UUID back to the value it
+     *                 proxies. It is used by un_proxy for proxy maps this
+     *                 instance did not make (e.g., proxy maps which were
+     *                 saved in a previous run). Default is an empty function,
+     *                 meaning only proxy maps made by this instance can be
+     *                 un-proxied.
      *
      *  @throw std::runtime_error if @p db is a null pointer. Strong throw
      *                            guarantee.
      */
-    explicit ProxyMapMaker(proxy_mapper_pointer db);
+    explicit ProxyMapMaker(proxy_mapper_pointer db, un_proxy_function fxn = {});
 
     /** @brief Returns the set of objects which have been proxied.
      *
@@ -97,6 +110,15 @@ public:
      */
     key_set_type keys() const;
 
+    /** @brief Returns a cursor over the objects which have been proxied.
+     *
+     *  Visits the same objects as keys, without copying them. The cursor is
+     *  invalidated by insert and clear.
+     *
+     *  @return A cursor over the objects which have been proxied.
+     */
+    cursor_pointer cursor() const;
+
     /** @brief Determines if all the values in @p key are in the wrapped
      *         database.
      *
@@ -142,6 +164,28 @@ public:
      */
     void free(const_key_reference key);
 
+    /** @brief Removes the references a proxy map holds to its objects.
+     *
+     *  If the wrapped UUIDMapper counts references, each insert records a
+     *  reference to each value in the map. This function undoes that for the
+     *  map @p value is a proxy for, which frees the values nothing else
+     *  references. It is a no-op if references are not being counted, or if
+     *  none of the objects @p value refers to have references we know of (in
+     *  which case @p value is not un-proxied).
+     *
+     *  @param[in] value The proxy map whose objects are no longer referenced
+     *                   by it.
+     *
+     *  @throw ??? If un-proxying @p value or the backend throws. Weak throw
+     *             guarantee.
+     */
+    void release(const_mapped_reference value);
+
+    /// Does the wrapped UUIDMapper count references to the objects?
+    bool counts_references() const noexcept {
+        return m_db_->counts_references();
+    }
+
     /** @brief Returns a map of key-to-proxy objects.
      *
      *  This method will loop over the key/value pairs in @p key and generate a
@@ -157,6 +201,17 @@ public:
      */
     mapped_type at(const_key_reference key) const;
 
+    /** @brief Maps a proxy map back to the map it was made from.
+     *
+     *  @param[in] value The proxy map to un-proxy.
+     *
+     *  @return The map which @p value is a proxy for.
+     *
+     *  @throw std::out_of_range if @p value was not made by this instance and
+     *                           no un-proxy function was provided. Strong
+     *                           throw guarantee.
+     *  @throw ??? If the un-proxy function throws. Strong throw guarantee.
+     */
     key_type un_proxy(const_mapped_reference value) const;
 
     /** @brief Saves the contents of the UUIDMapper.
@@ -187,6 +242,9 @@ private:
     /// TODO: This is a hack so we can reverse the mapping
     std::map<mapped_type, key_type> m_buffer_;
 
+    /// Used to un-proxy values not in m_buffer_
+    un_proxy_function m_un_proxy_;
+
     /// The instance preserving the UUID mapping
     proxy_mapper_pointer m_db_;
 };
@@ -22,7 +22,8 @@ namespace pluginplay::cache {
 #define PROXY_MAP_MAKER ProxyMapMaker<KeyType>
 
 TPARAMS
-PROXY_MAP_MAKER::ProxyMapMaker(proxy_mapper_pointer db) : m_db_(std::move(db)) {
+PROXY_MAP_MAKER::ProxyMapMaker(proxy_mapper_pointer db, un_proxy_function fxn) :
+  m_un_proxy_(std::move(fxn)), m_db_(std::move(db)) {
     if(m_db_) return;
     throw std::runtime_error("Expected a non-null DB to use");
 }
@@ -34,6 +35,13 @@ typename PROXY_MAP_MAKER::key_set_type PROXY_MAP_MAKER::keys() const {
     return rv;
 }
 
+TPARAMS
+typename PROXY_MAP_MAKER::cursor_pointer PROXY_MAP_MAKER::cursor() const {
+    auto proj = [](auto itr) { return &itr->second; };
+    return database::make_iterator_cursor<key_type>(m_buffer_.begin(),
+                                                    m_buffer_.end(), proj);
+}
+
 TPARAMS bool PROXY_MAP_MAKER::count(const_key_reference key) const {
     for(const auto& [_, v] : key) {
         if(!m_db_->count(v)) return false;
@@ -52,6 +60,15 @@ void PROXY_MAP_MAKER::free(const_key_reference key) {
     for(const auto& [_, v] : key) { m_db_->free(v); }
 }
 
+TPARAMS
+void PROXY_MAP_MAKER::release(const_mapped_reference value) {
+    // Un-proxying may mean deserializing, so only do it if we have to
+    bool tracked = false;
+    for(const auto& [_, v] : value) tracked |= m_db_->is_referenced(v);
+    if(!tracked) return;
+    for(const auto& [_, v] : un_proxy(value)) m_db_->release(v);
+}
+
 TPARAMS
 typename PROXY_MAP_MAKER::mapped_type PROXY_MAP_MAKER::at(
   const_key_reference key) const {
@@ -63,7 +80,12 @@ typename PROXY_MAP_MAKER::mapped_type PROXY_MAP_MAKER::at(
 TPARAMS
 typename PROXY_MAP_MAKER::key_type PROXY_MAP_MAKER::un_proxy(
   const_mapped_reference value) const {
-    return m_buffer_.at(value);
+    auto itr = m_buffer_.find(value);
+    if(itr != m_buffer_.end()) return itr->second;
+    if(!m_un_proxy_) throw std::out_of_range("Proxy map was not found");
+    key_type rv;
+    for(const auto& [k, v] : value) rv.emplace(k, m_un_proxy_(v));
+    return rv;
 }
 
 #undef PROXY_MAP_MAKER
@@ -16,7 +16,12 @@
 
 #pragma once
 #include "database/database_api.hpp"
+#include "dedup_table.hpp"
+#include "interner.hpp"
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <utility>
 #include <pluginplay/utility/uuid.hpp>
 
 namespace pluginplay::cache {
@@ -54,15 +59,54 @@ public:
     /// Type of a container holding keys
     using key_set_type = typename db_type::key_set_type;
 
+    /// Type of an object's content-derived UUID and its size in bytes
+    using content_id_type = std::pair<mapped_type, std::size_t>;
+
+    /// Type of a function which derives an object's UUID from its contents
+    using id_function = std::function<content_id_type(const_key_reference)>;
+
+    /// Type of a pointer to the table counting references to objects
+    using dedup_pointer = std::shared_ptr<DedupTable>;
+
+    /// Type of a pointer to the object hash-consing the objects
+    using interner_pointer = std::shared_ptr<Interner<key_type, mapped_type>>;
+
     /** @brief Creates a new UUID instance which stores the UUID mapping in the
      *         provided db
      *
+     *  By default objects are assigned random UUIDs. If @p id is provided,
+     *  objects are instead assigned UUIDs derived from their contents, so that
+     *  identical objects get the same UUID, even if they were inserted by
+     *  different runs or processes (i.e., the objects are content-addressed).
+     *
+     *  If @p dedup is provided, every call to insert is recorded as a
+     *  reference to the object, which can be undone by calling release. If
+     *  @p report_reuse is also true, references which reuse an already stored
+     *  object count towards @p dedup's statistics.
+     *
      *  @param[in] db The database that UUID will store object-to-UUID mappings
      *                in.
+     *  @param[in] id A function returning the UUID of an object, derived from
+     *                its contents, and the size of those contents. Default is
+     *                an empty function, meaning UUIDs are random.
+     *  @param[in] dedup The table used to count references to the objects in
+     *                   @p db. Should be shared by all UUIDMapper instances
+     *                   wrapping the same objects. Default is null, meaning
+     *                   references are not counted.
+     *  @param[in] interner Used to hash-cons the objects, i.e., objects are
+     *                      told to share the instance an equal object was
+     *                      mapped with, and objects sharing an instance are
+     *                      mapped to their UUID without comparing values.
+     *                      Should be shared by all UUIDMapper instances
+     *                      wrapping the same objects. Default is null,
+     *                      meaning objects are not hash-consed.
+     *  @param[in] report_reuse Should the references recorded in @p dedup
+     *                          count as deduplications? Default is true.
      *
      *  @throw std::runtime_error if @p db is a nullptr. Strong throw guarantee.
      */
-    UUIDMapper(db_pointer db);
+    UUIDMapper(db_pointer db, id_function id = {}, dedup_pointer dedup = {},
+               interner_pointer interner = {}, bool report_reuse = true);
 
     /** @brief Overloads insert so that the user doesn't need to provide a UUID.
      *
@@ -88,6 +132,29 @@ public:
      */
     void insert(key_type key);
 
+    /** @brief Removes a reference to @p key.
+     *
+     *  This undoes one call to insert. If that was the last reference to
+     *  @p key, and this process added @p key to the database, @p key is
+     *  freed. This is a no-op if references are not being counted.
+     *
+     *  @param[in] key The object which is no longer referenced.
+     *
+     *  @throw ??? If the wrapped database's free method throws. Same throw
+     *         guarantee.
+     */
+    void release(const_key_reference key);
+
+    /// Are references to the objects being counted?
+    bool counts_references() const noexcept {
+        return static_cast<bool>(m_dedup_);
+    }
+
+    /// Is the object with UUID @p uuid referenced by anything we know of?
+    bool is_referenced(const mapped_type& uuid) const noexcept {
+        return m_dedup_ && m_dedup_->count(uuid);
+    }
+
     /** @brief Returns the set of objects which have been proxied.
      *
      *  N.B. this operation should only be used for debugging as it will copy
@@ -100,33 +167,46 @@ public:
      */
     key_set_type keys() const { return m_db_->keys(); }
 
-    /// Just calls m_db_->count(key)
+    /// Asks the interner, then m_db_->count(key)
     bool count(const_key_reference key) const noexcept;
 
-    /// Just calls m_db_->free(key)
+    /// Forgets key's UUID in the interner, then calls m_db_->free(key)
     void free(const_key_reference key);
 
-    /// Just calls m_db_->at(key)
+    /// Asks the interner, then m_db_->at(key) (and interns key)
     const_mapped_reference at(const_key_reference key) const;
 
     /// Just calls m_db_->backup()
     void backup();
 
-    /// Just calls m_db_->dump()
+    /// Clears the interner, then calls m_db_->dump()
     void dump();
 
 private:
     /** @brief Wraps the process of generating a UUID
      *
-     *  At the moment this just wraps a call to Boost's random UUID generator.
+     *  If an id function was provided this calls it, otherwise it wraps a call
+     *  to Boost's random UUID generator (in which case the size is 0).
      *
      *  @throw boost::uuids::entropy_error if the backend can't generate enough
      *         entropy. Strong throw guarantee.
      */
-    mapped_type uuid_() const;
+    content_id_type uuid_(const_key_reference key) const;
 
     /// The object-to-UUID relationships we know about
     db_pointer m_db_;
+
+    /// Derives UUIDs from the objects' contents (if set)
+    id_function m_id_;
+
+    /// Counts references to the objects (if set)
+    dedup_pointer m_dedup_;
+
+    /// Hash-conses the objects (if set)
+    interner_pointer m_interner_;
+
+    /// Do references count towards m_dedup_'s statistics?
+    bool m_report_reuse_;
 };
 
 } // namespace pluginplay::cache
@@ -22,39 +22,88 @@ namespace pluginplay::cache {
 #define UUID_MAPPER UUIDMapper<KeyType>
 
 TPARAMS
-UUID_MAPPER::UUIDMapper(db_pointer db) : m_db_(std::move(db)) {
+UUID_MAPPER::UUIDMapper(db_pointer db, id_function id, dedup_pointer dedup,
+                        interner_pointer interner, bool report_reuse) :
+  m_db_(std::move(db)),
+  m_id_(std::move(id)),
+  m_dedup_(std::move(dedup)),
+  m_interner_(std::move(interner)),
+  m_report_reuse_(report_reuse) {
     if(!m_db_) throw std::runtime_error("Database can not be a nullptr");
 }
 
 TPARAMS
 bool UUID_MAPPER::count(const_key_reference key) const noexcept {
+    if(m_interner_ && m_interner_->find(key)) return true;
     return m_db_->count(key);
 }
 
 TPARAMS
 void UUID_MAPPER::insert(key_type key) {
-    if(count(key)) return; // Don't regenerate the UUID
-    m_db_->insert(std::move(key), uuid_());
+    const bool known = count(key);
+    if(known && !m_dedup_) return; // Don't regenerate the UUID
+    if(known) {
+        // Keep the UUID it already has, the reference is what's new. Only the
+        // first reference needs the size (which requires serializing key)
+        mapped_type uuid = at(key).get();
+        if(m_dedup_->add_reference(uuid, m_report_reuse_)) return;
+        m_dedup_->add(uuid, uuid_(key).second, false, m_report_reuse_);
+        return;
+    }
+    auto [uuid, bytes] = uuid_(key);
+    if(m_dedup_) m_dedup_->add(uuid, bytes, true, m_report_reuse_);
+    m_db_->insert(std::move(key), std::move(uuid));
 }
 
 TPARAMS
-void UUID_MAPPER::free(const_key_reference key) { m_db_->free(key); }
+void UUID_MAPPER::release(const_key_reference key) {
+    if(!m_dedup_ || !count(key)) return;
+    if(m_dedup_->release(at(key).get())) free(key);
+}
+
+TPARAMS
+void UUID_MAPPER::free(const_key_reference key) {
+    if(m_interner_) {
+        // Copied since forgetting the UUID invalidates the pointer
+        const auto* puuid = m_interner_->find(key);
+        if(puuid)
+            m_interner_->forget(mapped_type(*puuid));
+        else if(m_db_->count(key))
+            m_interner_->forget(m_db_->at(key).get());
+    }
+    m_db_->free(key);
+}
 
 TPARAMS
 typename UUID_MAPPER::const_mapped_reference UUID_MAPPER::at(
   const_key_reference key) const {
-    return m_db_->at(key);
+    if(!m_interner_) return m_db_->at(key);
+    if(const auto* puuid = m_interner_->find(key)) {
+        // key may hold its own copy of the interned value, if so it's made to
+        // share it. The UUID is copied since interning may invalidate puuid
+        m_interner_->intern(key, mapped_type(*puuid));
+        puuid = m_interner_->find(key);
+        if(puuid) return const_mapped_reference{puuid};
+    }
+    auto rv = m_db_->at(key);
+    m_interner_->intern(key, rv.get());
+    return rv;
 }
 
 TPARAMS
 void UUID_MAPPER::backup() { m_db_->backup(); }
 
 TPARAMS
-void UUID_MAPPER::dump() { m_db_->dump(); }
+void UUID_MAPPER::dump() {
+    if(m_interner_) m_interner_->clear();
+    m_db_->dump();
+}
 
 TPARAMS
-typename UUID_MAPPER::mapped_type UUID_MAPPER::uuid_() const {
-    return utility::generate_uuid();
+typename UUID_MAPPER::content_id_type UUID_MAPPER::uuid_(
+  const_key_reference key) const {
+    if(m_id_) return m_id_(key);
+    return content_id_type(utility::generate_uuid(), 0);
 }
 
 #undef UUID_MAPPER
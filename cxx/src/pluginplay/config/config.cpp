@@ -21,6 +21,8 @@ namespace pluginplay {
 
 bool with_rocksdb() { return with_rocksdb_v; }
 
+bool with_zlib() { return with_zlib_v; }
+
 bool with_pybind11() { return with_pybind11_v; }
 
 } // namespace pluginplay
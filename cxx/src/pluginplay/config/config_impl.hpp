@@ -25,6 +25,13 @@ static constexpr bool with_rocksdb_v = true;
 static constexpr bool with_rocksdb_v = false;
 #endif
 
+/// Used throughout PluginPlay to enable/disable zlib support at compiletime
+#ifdef BUILD_ZLIB
+static constexpr bool with_zlib_v = true;
+#else
+static constexpr bool with_zlib_v = false;
+#endif
+
 /// Used throughout PluginPlay to enable/disable pybind11 support at compiletime
 #ifdef BUILD_PYBIND11
 static constexpr bool with_pybind11_v = true;
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <functional>
+#include <memory>
 #include <optional>
 #include <pluginplay/any/any.hpp>
 #include <pluginplay/types.hpp>
@@ -31,6 +32,16 @@ namespace pluginplay::detail_ {
  *  to use a ModuleInput. The fact that it lives in the detail_ namespace means
  *  that you shouldn't be directly using this class.
  *
+ *  The value is held by a shared_ptr so that inputs holding equal values can
+ *  share one instance of it (see intern). Once a value is shared it is never
+ *  modified: copies of this PIMPL share it too, and asking for a read/write
+ *  reference to it first makes a private copy (i.e., copy-on-write). Values
+ *  which are not shared are deep copied, as usual.
+ *
+ *  The hash of the value is computed once and then kept with the value (and
+ *  copied along with it), so that the cache does not need to re-examine the
+ *  value every time the input is used. Small values are hashed when they are
+ *  set, larger ones the first time their hash is needed.
  */
 class ModuleInputPIMPL {
 public:
@@ -43,6 +54,15 @@ public:
     /// The type used to return the descriptions of the bounds checks
     using check_description_type = std::set<type::description>;
 
+    /// The type of a shared, read-only, type-erased value
+    using shared_any = std::shared_ptr<const type::any>;
+
+    /// The type of the hash of the value
+    using content_hash_type = typename type::any::content_hash_type;
+
+    /// Values at most this many bytes are hashed as soon as they are set
+    static constexpr std::size_t eager_hash_limit = 1024;
+
     /** @brief Constructs the PIMPL for a null input.
      *
      *  The resulting input has no type, value, or description. It is by default
@@ -54,6 +74,21 @@ public:
      */
     ModuleInputPIMPL() noexcept = default;
 
+    /** @brief Makes a copy of @p other.
+     *
+     *  If @p other's value is shared the copy shares it too, otherwise the
+     *  value is deep copied.
+     *
+     *  @param[in] other The instance being copied.
+     *
+     *  @throw std::bad_alloc if there is insufficient memory to copy the
+     *                        instance. Strong throw guarantee.
+     */
+    ModuleInputPIMPL(const ModuleInputPIMPL& other);
+
+    /// Deleted since it is not needed (copy assignment goes through clone)
+    ModuleInputPIMPL& operator=(const ModuleInputPIMPL&) = delete;
+
     /** @brief Makes a copy of the PIMPL on the heap.
      *
      *  This function is used to make a deep copy of the PIMPL, which is
@@ -91,7 +126,9 @@ public:
      *
      *  @throw none No throw guarantee.
      */
-    bool has_value() const noexcept { return m_value_.has_value(); }
+    bool has_value() const noexcept {
+        return m_value_ && m_value_->has_value();
+    }
 
     /** @brief Does this input have a description?
      *
@@ -220,6 +257,22 @@ public:
      */
     void set_description(type::description desc) noexcept;
 
+    /** @brief Makes this input share @p value.
+     *
+     *  This function is used to hash-cons inputs: once the cache has matched
+     *  the value of this input to an instance it already knows about, this
+     *  input drops its own copy and uses that instance instead. The value is
+     *  not validated (it is assumed to equal the current value, so it has
+     *  already passed the bounds checks).
+     *
+     *  @param[in] value The instance to share. Must be equal to the current
+     *                   value.
+     *
+     *  @throw std::runtime_error if no value is bound to this input field.
+     *                            Strong throw guarantee.
+     */
+    void intern(shared_any value);
+
     /** @brief Adds a bounds check to the input.
      *
      *  In order to avoid module developers having to perform bounds checks on
@@ -305,6 +358,61 @@ public:
      */
     const type::any& value() const;
 
+    /** @brief Returns a read/write reference to the bound value.
+     *
+     *  If the value is shared, a private copy is made first, so the other
+     *  inputs sharing the value are not affected by changes made through the
+     *  returned reference. Since the value may be changed, its hash is thrown
+     *  away and recomputed the next time it is needed.
+     *
+     *  @return A read/write reference to the bound value.
+     *
+     *  @throw std::runtime_error if no value is bound to this input field.
+     *                            Strong throw guarantee.
+     *  @throw std::bad_alloc if there is a problem copying a shared value.
+     *                        Strong throw guarantee.
+     */
+    type::any& mutable_value();
+
+    /** @brief Returns the bound value so that it can be shared.
+     *
+     *  The value is flagged as shared, i.e., from now on copies of this
+     *  instance share it and it is copied before it is modified.
+     *
+     *  @return A shared_ptr to the bound value.
+     *
+     *  @throw std::runtime_error if no value is bound to this input field.
+     *                            Strong throw guarantee.
+     */
+    shared_any share_value();
+
+    /** @brief Returns the hash of the bound value.
+     *
+     *  The hash is computed the first time it's needed (or when the value is
+     *  set, if the value is small) and is then reused until the value is
+     *  changed. Copies of this instance copy the hash too.
+     *
+     *  @return The hash of the bound value. If no value is bound, or the value
+     *          can't be hashed (see AnyField::content_hash), std::nullopt is
+     *          returned.
+     *
+     *  @throw None No throw guarantee.
+     */
+    content_hash_type content_hash() const noexcept;
+
+    /** @brief Do this instance and @p rhs share their value?
+     *
+     *  @param[in] rhs The instance to compare to.
+     *
+     *  @return True if both instances have a value and it is the same
+     *          instance, false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool shares_value(const ModuleInputPIMPL& rhs) const noexcept {
+        return has_value() && m_value_ == rhs.m_value_;
+    }
+
     /** @brief Used to retrieve the description of what this option is used for.
      *
      *  @return The human-readable description of what the module will use this
@@ -336,8 +444,17 @@ private:
     /// Code factorization for ensuring the value has been set
     void assert_value_set_() const;
 
-    /// The value bound to this input
-    type::any m_value_;
+    /// The value bound to this input (null if none)
+    shared_any m_value_;
+
+    /// Is m_value_ (possibly) shared with other instances?
+    bool m_shared_ = false;
+
+    /// The hash of m_value_, only meaningful if m_hashed_ is true
+    mutable content_hash_type m_hash_;
+
+    /// Has m_value_ been hashed yet?
+    mutable bool m_hashed_ = false;
 
     /// A human-readable description of this input
     std::optional<type::description> m_desc_;
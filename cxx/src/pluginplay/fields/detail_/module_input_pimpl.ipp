@@ -21,6 +21,20 @@ namespace pluginplay::detail_ {
 
 //-----------------------------Implementations----------------------------------
 
+inline ModuleInputPIMPL::ModuleInputPIMPL(const ModuleInputPIMPL& other) :
+  m_value_(other.m_value_),
+  m_shared_(other.m_shared_),
+  m_hash_(other.m_hash_),
+  m_hashed_(other.m_hashed_),
+  m_desc_(other.m_desc_),
+  m_optional_(other.m_optional_),
+  m_transparent_(other.m_transparent_),
+  m_checks_(other.m_checks_),
+  m_type_(other.m_type_) {
+    if(m_value_ && !m_shared_)
+        m_value_ = std::make_shared<type::any>(*other.m_value_);
+}
+
 inline bool ModuleInputPIMPL::is_valid(const type::any& new_value) const {
     assert_type_set_();
     for(const auto& [k, v] : m_checks_)
@@ -48,7 +62,10 @@ inline void ModuleInputPIMPL::set_value(type::any any) {
         }
         throw std::invalid_argument(msg);
     }
-    m_value_.swap(any);
+    m_value_  = std::make_shared<type::any>(std::move(any));
+    m_shared_ = false;
+    m_hashed_ = false;
+    if(m_value_->memory_footprint() <= eager_hash_limit) content_hash();
 }
 
 inline void ModuleInputPIMPL::set_description(type::description desc) noexcept {
@@ -58,7 +75,7 @@ inline void ModuleInputPIMPL::set_description(type::description desc) noexcept {
 inline void ModuleInputPIMPL::add_check(any_check check,
                                         type::description desc) {
     if(has_value())
-        if(!check(m_value_)) {
+        if(!check(*m_value_)) {
             const auto msg = std::string("Value failed provided bounds "
                                          "check: ") +
                              desc;
@@ -72,11 +89,46 @@ inline typename ModuleInputPIMPL::rtti_type ModuleInputPIMPL::type() const {
     return m_type_.value();
 }
 
+inline void ModuleInputPIMPL::intern(shared_any value) {
+    assert_value_set_();
+    if(!value) throw std::runtime_error("Can not intern a null value");
+    m_value_  = std::move(value);
+    m_shared_ = true;
+}
+
 inline const type::any& ModuleInputPIMPL::value() const {
     assert_value_set_();
+    return *m_value_;
+}
+
+inline type::any& ModuleInputPIMPL::mutable_value() {
+    assert_value_set_();
+    if(m_shared_) {
+        m_value_  = std::make_shared<type::any>(*m_value_);
+        m_shared_ = false;
+    }
+    // The caller may change the value, so it needs to be hashed again
+    m_hashed_ = false;
+    // Unshared values are always allocated as non-const by this class
+    return const_cast<type::any&>(*m_value_);
+}
+
+inline typename ModuleInputPIMPL::shared_any ModuleInputPIMPL::share_value() {
+    assert_value_set_();
+    m_shared_ = true;
     return m_value_;
 }
 
+inline typename ModuleInputPIMPL::content_hash_type
+ModuleInputPIMPL::content_hash() const noexcept {
+    if(!has_value()) return std::nullopt;
+    if(!m_hashed_) {
+        m_hash_   = m_value_->content_hash();
+        m_hashed_ = true;
+    }
+    return m_hash_;
+}
+
 inline void ModuleInputPIMPL::assert_type_set_() const {
     if(!has_type()) throw std::runtime_error("Must set type first");
 }
@@ -102,7 +154,14 @@ inline bool operator==(const ModuleInputPIMPL& lhs,
     if(lhs.has_description() != rhs.has_description()) return false;
 
     if(lhs.has_type() && (lhs.type() != rhs.type())) return false;
-    if(lhs.has_value() && (lhs.value() != rhs.value())) return false;
+    // Inputs sharing their value are equal without looking at it, and values
+    // with different (cached) hashes differ without looking at them either
+    if(lhs.has_value() && !lhs.shares_value(rhs)) {
+        const auto lhash = lhs.content_hash();
+        const auto rhash = rhs.content_hash();
+        if(lhash && rhash && *lhash != *rhash) return false;
+        if(lhs.value() != rhs.value()) return false;
+    }
     if(lhs.has_description() && (lhs.description() != rhs.description()))
         return false;
 
@@ -39,6 +39,16 @@ bool ModuleInput::has_type() const noexcept { return m_pimpl_->has_type(); }
 
 bool ModuleInput::has_value() const noexcept { return m_pimpl_->has_value(); }
 
+std::size_t ModuleInput::memory_footprint() const noexcept {
+    if(!has_value()) return 0;
+    return get_().memory_footprint();
+}
+
+typename ModuleInput::content_hash_type ModuleInput::content_hash()
+  const noexcept {
+    return m_pimpl_->content_hash();
+}
+
 bool ModuleInput::has_description() const noexcept {
     return m_pimpl_->has_description();
 }
@@ -87,8 +97,22 @@ typename ModuleInput::bounds_check_desc_t ModuleInput::check_descriptions()
     return m_pimpl_->check_descriptions();
 }
 
+void ModuleInput::intern(shared_any value) const {
+    m_pimpl_->intern(std::move(value));
+}
+
+bool ModuleInput::shares_value(const ModuleInput& rhs) const noexcept {
+    return m_pimpl_->shares_value(*rhs.m_pimpl_);
+}
+
+type::any& ModuleInput::get_() { return m_pimpl_->mutable_value(); }
+
 const type::any& ModuleInput::get_() const { return m_pimpl_->value(); }
 
+typename ModuleInput::shared_any ModuleInput::share_() const {
+    return m_pimpl_->share_value();
+}
+
 void ModuleInput::change_(type::any new_value) {
     m_pimpl_->set_value(std::move(new_value));
 }
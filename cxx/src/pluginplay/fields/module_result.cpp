@@ -44,11 +44,28 @@ bool ModuleResult::has_description() const noexcept {
     return m_pimpl_->has_description();
 }
 
+std::size_t ModuleResult::memory_footprint() const noexcept {
+    if(!has_value()) return 0;
+    return at_()->memory_footprint();
+}
+
 ModuleResult& ModuleResult::set_description(type::description desc) noexcept {
     m_pimpl_->set_description(std::move(desc));
     return *this;
 }
 
+ModuleResult& ModuleResult::set_type_and_change(shared_any new_value) {
+    if(!new_value) throw std::runtime_error("Value can not be a nullptr");
+    if(!has_type()) {
+        const type::rtti rtti = new_value->type();
+        auto l = [rtti](const type::any& v) { return v.type() == rtti; };
+        pimpl_().set_type_check(std::move(l));
+        pimpl_().set_type(rtti);
+    }
+    m_pimpl_->set_value(std::move(new_value));
+    return *this;
+}
+
 type::rtti ModuleResult::type() const { return m_pimpl_->type(); }
 
 const type::description& ModuleResult::description() const {
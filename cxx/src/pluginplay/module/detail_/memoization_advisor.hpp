@@ -0,0 +1,222 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace pluginplay::detail_ {
+
+/** @brief Decides whether memoizing a module's calls is worth it.
+ *
+ *  Memoization is not free. Before a module is run its inputs must be turned
+ *  into a key and looked up in the cache, and after it runs the results must
+ *  be inserted into the cache. For modules which run quickly, or which are
+ *  rarely called with the same inputs, this overhead can exceed the time
+ *  memoization saves. This class keeps exponential moving averages of:
+ *
+ *  - the time it takes to run the module,
+ *  - the time it takes to look up a result (including retrieving it on a hit),
+ *  - the time it takes to insert a result, and
+ *  - the hit rate.
+ *
+ *  From these it estimates the expected time saved per call,
+ *  `hit_rate * compute_time`, and the expected overhead per call,
+ *  `lookup_time + (1 - hit_rate) * insert_time`. If the overhead exceeds the
+ *  savings the advisor recommends bypassing the cache. Since a bypassed cache
+ *  produces no new lookup statistics, the advisor periodically recommends
+ *  using the cache anyway (a "probe") so that its statistics can catch up with
+ *  changes in how the module is being used.
+ *
+ *  The advisor always recommends using the cache until it has seen enough
+ *  lookups to make an informed decision.
+ */
+class MemoizationAdvisor {
+public:
+    /// Type used to measure times
+    using duration_type = std::chrono::duration<double>;
+
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /** @brief Creates a new advisor with no statistics.
+     *
+     *  @param[in] alpha The weight given to the newest sample when updating
+     *                   the moving averages. Should be in (0, 1]. Default is
+     *                   0.2.
+     *  @param[in] warm_up The number of lookups to observe before the advisor
+     *                     will recommend bypassing the cache. Default is 8.
+     *  @param[in] probe_interval While bypassing, every @p probe_interval-th
+     *                            call will use the cache anyway. Default is
+     *                            64.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit MemoizationAdvisor(double alpha = 0.2, size_type warm_up = 8,
+                                size_type probe_interval = 64) noexcept :
+      m_alpha_(alpha), m_warm_up_(warm_up), m_probe_interval_(probe_interval) {}
+
+    /** @brief Should the next call use the cache?
+     *
+     *  This function should be called exactly once per call to the module as
+     *  it also keeps track of when to probe.
+     *
+     *  @return True if the next call should use the cache and false if it
+     *          should bypass it.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool use_cache() noexcept {
+        if(m_n_lookups_ < m_warm_up_) return true;
+        m_bypass_ = overhead() > savings();
+        if(!m_bypass_) {
+            m_since_probe_ = 0;
+            return true;
+        }
+        if(++m_since_probe_ < m_probe_interval_) return false;
+        m_since_probe_ = 0;
+        ++m_n_probes_;
+        return true;
+    }
+
+    /** @brief Records the result of a cache lookup.
+     *
+     *  @param[in] hit Was the result found in the cache?
+     *  @param[in] dt How long the lookup took (including retrieving the result
+     *                if @p hit is true).
+     *
+     *  @throw None No throw guarantee.
+     */
+    void record_lookup(bool hit, duration_type dt) noexcept {
+        update_(m_hit_rate_, hit ? 1.0 : 0.0, m_n_lookups_);
+        update_(m_lookup_time_, dt.count(), m_n_lookups_);
+        ++m_n_lookups_;
+    }
+
+    /** @brief Records how long it took to put a result in the cache.
+     *
+     *  @param[in] dt How long it took to insert the result.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void record_insert(duration_type dt) noexcept {
+        update_(m_insert_time_, dt.count(), m_n_inserts_);
+        ++m_n_inserts_;
+    }
+
+    /** @brief Records how long it took to actually run the module.
+     *
+     *  @param[in] dt How long the module took to run.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void record_compute(duration_type dt) noexcept {
+        update_(m_compute_time_, dt.count(), m_n_computes_);
+        ++m_n_computes_;
+    }
+
+    /// Is the advisor currently recommending bypassing the cache?
+    bool bypassing() const noexcept { return m_bypass_; }
+
+    /// Moving average of the hit rate
+    double hit_rate() const noexcept { return m_hit_rate_; }
+
+    /// Moving average of the time (in seconds) it takes to run the module
+    double compute_time() const noexcept { return m_compute_time_; }
+
+    /// Moving average of the time (in seconds) it takes to look up a result
+    double lookup_time() const noexcept { return m_lookup_time_; }
+
+    /// Moving average of the time (in seconds) it takes to insert a result
+    double insert_time() const noexcept { return m_insert_time_; }
+
+    /// Expected time saved per call by memoizing (in seconds)
+    double savings() const noexcept { return m_hit_rate_ * m_compute_time_; }
+
+    /// Expected overhead per call of memoizing (in seconds)
+    double overhead() const noexcept {
+        return m_lookup_time_ + (1.0 - m_hit_rate_) * m_insert_time_;
+    }
+
+    /// Number of times the advisor used the cache despite bypassing it
+    size_type n_probes() const noexcept { return m_n_probes_; }
+
+    /** @brief Summarizes the advisor's current decision.
+     *
+     *  @return A one-line, human-readable description of whether the cache is
+     *          being used and why.
+     *
+     *  @throw std::bad_alloc if there is insufficient memory to make the
+     *                        string. Strong throw guarantee.
+     */
+    std::string decision() const {
+        std::stringstream ss;
+        ss << "Adaptive memoization: ";
+        if(m_n_lookups_ < m_warm_up_) {
+            ss << "warming up (" << m_n_lookups_ << "/" << m_warm_up_
+               << " lookups)";
+            return ss.str();
+        }
+        ss << (m_bypass_ ? "bypassing cache" : "using cache");
+        ss << " (hit rate " << m_hit_rate_ << ", saves " << savings()
+           << " s/call, costs " << overhead() << " s/call, " << m_n_probes_
+           << " probes)";
+        return ss.str();
+    }
+
+private:
+    /// Updates moving average @p avg with @p x, @p n is the number of samples
+    void update_(double& avg, double x, size_type n) const noexcept {
+        avg = n ? avg + m_alpha_ * (x - avg) : x;
+    }
+
+    /// Weight of the newest sample
+    double m_alpha_;
+
+    /// Number of lookups to observe before deciding
+    size_type m_warm_up_;
+
+    /// How often to probe while bypassing
+    size_type m_probe_interval_;
+
+    /// Moving averages
+    ///@{
+    double m_hit_rate_     = 0.0;
+    double m_compute_time_ = 0.0;
+    double m_lookup_time_  = 0.0;
+    double m_insert_time_  = 0.0;
+    ///@}
+
+    /// Number of samples of each kind
+    ///@{
+    size_type m_n_lookups_  = 0;
+    size_type m_n_inserts_  = 0;
+    size_type m_n_computes_ = 0;
+    ///@}
+
+    /// Calls since the last probe (while bypassing)
+    size_type m_since_probe_ = 0;
+
+    /// Total number of probes
+    size_type m_n_probes_ = 0;
+
+    /// The last decision
+    bool m_bypass_ = false;
+};
+
+} // namespace pluginplay::detail_
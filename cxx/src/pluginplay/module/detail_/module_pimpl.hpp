@@ -15,11 +15,13 @@
  */
 
 #pragma once
+#include "memoization_advisor.hpp"
 #include <chrono>
 #include <iomanip> // for put_time
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/module/module_base.hpp>
 #include <pluginplay/types.hpp>
+#include <pluginplay/utility/pluginplay_hash.hpp>
 #include <utilities/timer.hpp>
 
 namespace pluginplay::detail_ {
@@ -61,6 +63,12 @@ inline auto time_stamp() {
  *  class itself. This is because this is best done in templated functions,
  *  which would prohibit us from using a PIMPL.
  *
+ *  To make comparisons cheap, each module keeps a Merkle-style fingerprint of
+ *  its configuration (see fingerprint()). The part stemming from the module
+ *  itself is cached until write access to its state is requested, and the
+ *  whole fingerprint (as well as the submodule UUIDs) is cached while the
+ *  module, and therefore its submodules, are locked. Modules bound to values
+ *  which can't be hashed have no (known) fingerprint and are always compared.
  */
 class ModulePIMPL {
 public:
@@ -85,6 +93,9 @@ public:
     /// Type of the submodule key to UUID map
     using submod_uuid_map = std::map<std::string, uuid_type>;
 
+    /// Type of a fingerprint of the module's configuration
+    using fingerprint_type = std::size_t;
+
     /** @brief Makes a module with no implementation.
      *
      *  The ModulePIMPL instance resulting from this ctor wraps no algorithm,
@@ -296,11 +307,12 @@ public:
      *
      *  This will not unlock the submodules because we can not do that safely.
      *  This function is only used internally within the Module class. Users are
-     *  not allowed to unlock modules.
+     *  not allowed to unlock modules. Since the module may now change, the
+     *  state cached while it was locked is thrown away.
      *
      *  @throw none No throw guarantee.
      */
-    void unlock() noexcept { m_locked_ = false; }
+    void unlock() noexcept;
 
     /** @brief Returns the set of results computed by this module.
      *
@@ -537,6 +549,42 @@ public:
      */
     void turn_on_memoization();
 
+    /** @brief Is memoization for this module adaptive?
+     *
+     *  @return True if adaptive memoization is on and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_memoization_adaptive() const noexcept { return m_adaptive_; }
+
+    /** @brief Lets the module decide for itself whether to memoize calls
+     *
+     *  With adaptive memoization on, the module keeps track of how long it
+     *  takes to run versus how long it takes to look results up in, and add
+     *  results to, the cache (as well as how often lookups succeed). When
+     *  memoizing is estimated to cost more time than it saves, the cache is
+     *  bypassed. The cache is still periodically consulted so the module can
+     *  notice if memoization becomes worthwhile again. The current decision is
+     *  reported by profile_info.
+     *
+     *  N.B. Adaptive memoization only matters if the module is memoizable and
+     *       has a cache.
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_on_adaptive_memoization();
+
+    /** @brief Makes memoization non-adaptive (the default).
+     *
+     *  The statistics collected while adaptive memoization was on are
+     *  discarded.
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_off_adaptive_memoization();
+
     /** @brief Actually runs the module
      *
      *  This is the function with all of the pluginplay magic. Ultimately it
@@ -618,8 +666,44 @@ public:
      */
     uuid_type uuid() const;
 
+    /** @brief Returns the UUIDs of the submodules, scoped by submodule key.
+     *
+     *  The UUIDs of the submodules' submodules are included too, under the
+     *  key `<submodule key>:<their key>`. While the module is locked the map
+     *  is built once and then reused.
+     *
+     *  @return A map from (scoped) submodule keys to UUIDs.
+     *
+     *  @throw std::bad_alloc if there is insufficient memory to build the map.
+     *                        Strong throw guarantee.
+     */
     submod_uuid_map submod_uuids() const;
 
+    /** @brief Returns a fingerprint of the module's configuration.
+     *
+     *  The fingerprint combines the type of the implementation, the hashes of
+     *  the bound inputs (see ModuleInput::content_hash), the property types,
+     *  and the fingerprints of the submodules. It is consistent with
+     *  operator==, i.e., equal modules have equal fingerprints, so modules
+     *  with different fingerprints can be told apart without comparing them.
+     *  Lockedness is not part of the fingerprint. The fingerprint is unknown
+     *  if a bound input can't be hashed, or a submodule's fingerprint is
+     *  unknown.
+     *
+     *  The part stemming from this module is recomputed only after write
+     *  access to the inputs or property types is requested (and inputs only
+     *  rehash changed values). While the module is locked the whole
+     *  fingerprint is computed once and then reused. Unknown fingerprints are
+     *  not cached.
+     *
+     *  @return The fingerprint of this module, or std::nullopt if it is
+     *          unknown. Modules without an implementation all have the same
+     *          fingerprint.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::optional<fingerprint_type> fingerprint() const noexcept;
+
 private:
     /** @brief Code factorization for merging two sets of inputs.
      *
@@ -645,12 +729,22 @@ private:
     /// Code factorization for asserting that we have a module pointer
     void assert_mod_() const;
 
+    /// Computes the part of the fingerprint stemming from this module, if
+    /// it's known
+    std::optional<fingerprint_type> local_fingerprint_() const noexcept;
+
     /// Is the current module locked or not?
     bool m_locked_ = false;
 
     /// Is the current module memoizable?
     bool m_memoizable_ = true;
 
+    /// Should the module decide when to memoize?
+    bool m_adaptive_ = false;
+
+    /// Decides when to memoize if m_adaptive_ is true
+    MemoizationAdvisor m_advisor_;
+
     /// The object actually implementing the algorithm
     base_ptr m_base_;
 
@@ -671,6 +765,16 @@ private:
 
     /// Timer used to time runs of this module
     utilities::Timer m_timer_;
+
+    /// Part of the fingerprint from the implementation, inputs, and PTs (if
+    /// it's been computed and is known)
+    mutable std::optional<fingerprint_type> m_local_fingerprint_;
+
+    /// The whole fingerprint, only cached while locked (and if it's known)
+    mutable std::optional<fingerprint_type> m_fingerprint_;
+
+    /// The submodules' UUIDs (as an input), only cached while locked
+    mutable std::optional<ModuleInput> m_submod_uuids_;
 }; // class ModulePIMPL
 
 } // namespace pluginplay::detail_
@@ -62,6 +62,8 @@ inline const auto& ModulePIMPL::results() const {
 
 inline auto& ModulePIMPL::inputs() {
     assert_mod_();
+    // The caller may change the inputs
+    m_local_fingerprint_.reset();
     return m_inputs_;
 }
 
@@ -82,6 +84,7 @@ inline auto& ModulePIMPL::submods() const {
 
 inline auto& ModulePIMPL::property_types() {
     assert_mod_();
+    m_local_fingerprint_.reset();
     return m_property_types_;
 }
 
@@ -92,6 +95,7 @@ inline auto& ModulePIMPL::property_types() const {
 
 inline auto& ModulePIMPL::python_property_types() {
     assert_mod_();
+    m_local_fingerprint_.reset();
     return m_python_property_types_;
 }
 
@@ -145,9 +149,21 @@ inline void ModulePIMPL::turn_on_memoization() {
     m_memoizable_ = true;
 }
 
+inline void ModulePIMPL::turn_on_adaptive_memoization() {
+    assert_mod_();
+    m_adaptive_ = true;
+}
+
+inline void ModulePIMPL::turn_off_adaptive_memoization() {
+    assert_mod_();
+    m_adaptive_ = false;
+    m_advisor_  = MemoizationAdvisor{};
+}
+
 inline std::string ModulePIMPL::profile_info() const {
     std::stringstream ss;
     ss << m_timer_;
+    if(m_adaptive_) ss << m_advisor_.decision() << std::endl;
     std::string tab("  ");
     for(auto [key, submod] : m_submods_) {
         ss << tab << key << std::endl;
@@ -180,23 +196,42 @@ inline auto ModulePIMPL::run(type::input_map ps) {
 
     ps = merge_inputs_(ps);
 
-    if(is_memoizable() && m_cache_ && m_cache_->count(ps)) {
-        m_timer_.record(time_now);
-        return m_cache_->uncache(ps);
+    using clock_type = std::chrono::steady_clock;
+    bool use_cache   = m_cache_ && is_memoizable();
+    if(use_cache && m_adaptive_) use_cache = m_advisor_.use_cache();
+
+    if(use_cache) {
+        const auto t0 = clock_type::now();
+        if(m_cache_->count(ps)) {
+            auto rv = m_cache_->uncache(ps);
+            if(m_adaptive_)
+                m_advisor_.record_lookup(true, clock_type::now() - t0);
+            m_timer_.record(time_now);
+            return rv;
+        }
+        if(m_adaptive_) m_advisor_.record_lookup(false, clock_type::now() - t0);
     }
 
     // not there so run
-    auto rv = m_base_->run(ps, m_submods_);
-
-    if(!m_cache_ || !is_memoizable()) {
+    const auto t1 = clock_type::now();
+    auto rv       = m_base_->run(ps, m_submods_);
+    const std::chrono::duration<double> dt = clock_type::now() - t1;
+    if(m_adaptive_) m_advisor_.record_compute(dt);
+
+    const auto admission =
+      use_cache ? m_cache_->admit(rv, dt.count()) : cache::Admission::skip;
+    if(admission == cache::Admission::skip) {
         m_timer_.record(time_now);
         return rv;
     }
 
     // cache result
-    m_cache_->cache(ps, std::move(rv));
+    const auto t2 = clock_type::now();
+    m_cache_->cache(ps, std::move(rv), admission);
+    auto cached_rv = m_cache_->uncache(ps);
+    if(m_adaptive_) m_advisor_.record_insert(clock_type::now() - t2);
     m_timer_.record(time_now);
-    return m_cache_->uncache(ps);
+    return cached_rv;
 }
 
 inline bool ModulePIMPL::operator==(const ModulePIMPL& rhs) const {
@@ -204,6 +239,11 @@ inline bool ModulePIMPL::operator==(const ModulePIMPL& rhs) const {
     if(locked() != rhs.locked()) return false;
     if(!has_module()) return true;
 
+    // Equal modules have equal fingerprints, so this is usually the answer.
+    // Modules with unknown fingerprints have to be compared.
+    const auto lhs_fp = fingerprint();
+    const auto rhs_fp = rhs.fingerprint();
+    if(lhs_fp && rhs_fp && *lhs_fp != *rhs_fp) return false;
     if(std::tie(inputs(), submods(), property_types(), python_property_types()) !=
        std::tie(rhs.inputs(), rhs.submods(), rhs.property_types(),
                 rhs.python_property_types()))
@@ -222,6 +262,10 @@ inline typename ModulePIMPL::uuid_type ModulePIMPL::uuid() const {
 }
 
 inline typename ModulePIMPL::submod_uuid_map ModulePIMPL::submod_uuids() const {
+    if(m_submod_uuids_) {
+        const auto& cached = *m_submod_uuids_;
+        return cached.value<const submod_uuid_map&>();
+    }
     submod_uuid_map rv;
     for(const auto& [k, v] : submods()) {
         // Prepend the submodule key to each of its submodules' keys
@@ -231,20 +275,72 @@ inline typename ModulePIMPL::submod_uuid_map ModulePIMPL::submod_uuids() const {
         }
         rv.emplace(k, v.uuid());
     }
+
+    // While locked the submodules can't change, so the map (and its hash) is
+    // built once and its value is shared with the inputs of each call
+    if(m_locked_) {
+        ModuleInput temp;
+        temp.set_type<submod_uuid_map>();
+        temp.change(rv);
+        m_submod_uuids_    = std::move(temp);
+        const auto& cached = *m_submod_uuids_;
+        cached.value<ModuleInput::shared_any>();
+    }
+    return rv;
+}
+
+inline std::optional<typename ModulePIMPL::fingerprint_type>
+ModulePIMPL::fingerprint() const noexcept {
+    if(m_fingerprint_) return m_fingerprint_;
+    if(!has_module()) return fingerprint_type{};
+
+    // Unknown fingerprints aren't cached, the inputs cache their hashes so
+    // recomputing them is cheap
+    if(!m_local_fingerprint_) m_local_fingerprint_ = local_fingerprint_();
+    if(!m_local_fingerprint_) return std::nullopt;
+    auto rv = *m_local_fingerprint_;
+    // Submodules are hashed by their own fingerprints, which they cache while
+    // they're locked
+    for(const auto& [k, v] : m_submods_) {
+        combine_hash(rv, std::hash<std::string>{}(k));
+        if(!v.has_module()) {
+            combine_hash(rv, 0);
+            continue;
+        }
+        const auto sub_fp = v.value().fingerprint();
+        if(!sub_fp) return std::nullopt;
+        combine_hash(rv, *sub_fp);
+    }
+
+    // Locking a module locks its submodules, so the whole tree is frozen
+    if(m_locked_) m_fingerprint_ = rv;
     return rv;
 }
 
 inline type::input_map ModulePIMPL::merge_inputs_(
   type::input_map in_inputs) const {
-    for(const auto& [k, v] : m_inputs_)
-        if(!in_inputs.count(k)) in_inputs[k] = v;
+    for(const auto& [k, v] : m_inputs_) {
+        if(in_inputs.count(k)) continue;
+        // Bound values are shared with (rather than copied into) the merged
+        // inputs, and are hashed once, so they cost nothing per call
+        if(v.has_value()) {
+            v.value<ModuleInput::shared_any>();
+            if(m_cache_) v.content_hash();
+        }
+        in_inputs[k] = v;
+    }
 
     // TODO: It probably makes sense to create an Input class which tracks this
     //       and allows using submods as inputs
     std::string submod_key = "__PLUGIN_PLAY__ SUBMOD KEYS __PLUGIN_PLAY__";
+    auto uuids             = submod_uuids();
+    if(m_submod_uuids_) {
+        in_inputs.emplace(submod_key, *m_submod_uuids_);
+        return in_inputs;
+    }
     ModuleInput temp;
     temp.set_type<submod_uuid_map>();
-    temp.change(submod_uuids());
+    temp.change(std::move(uuids));
     in_inputs.emplace(submod_key, temp);
     return in_inputs;
 }
@@ -254,6 +350,12 @@ inline void ModulePIMPL::lock() {
     m_locked_ = true;
 }
 
+inline void ModulePIMPL::unlock() noexcept {
+    m_locked_ = false;
+    m_fingerprint_.reset();
+    m_submod_uuids_.reset();
+}
+
 template<typename T>
 std::set<type::key> ModulePIMPL::not_set_guts_(T&& map) const {
     std::set<type::key> probs;
@@ -267,4 +369,27 @@ inline void ModulePIMPL::assert_mod_() const {
     throw std::runtime_error("Module does not contain an implementation");
 }
 
+inline std::optional<typename ModulePIMPL::fingerprint_type>
+ModulePIMPL::local_fingerprint_() const noexcept {
+    fingerprint_type rv = std::hash<rtti_type>{}(m_base_->type());
+    // Inputs cache their hashes, so only changed values are rehashed. Equal
+    // values which can't be hashed could get different placeholders, so the
+    // fingerprint is unknown if any bound value can't be hashed.
+    for(const auto& [k, v] : m_inputs_) {
+        combine_hash(rv, std::hash<std::string>{}(k));
+        if(!v.has_value()) {
+            combine_hash(rv, 0);
+            continue;
+        }
+        const auto h = v.content_hash();
+        if(!h) return std::nullopt;
+        combine_hash(rv, *h);
+    }
+    for(const auto& x : m_property_types_)
+        combine_hash(rv, std::hash<type::rtti>{}(x));
+    for(const auto& x : m_python_property_types_)
+        combine_hash(rv, std::hash<std::string>{}(x));
+    return rv;
+}
+
 } // namespace pluginplay::detail_
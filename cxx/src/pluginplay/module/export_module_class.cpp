@@ -71,6 +71,11 @@ void export_module_class(py_module_reference m) {
       .def("is_memoizable", &Module::is_memoizable)
       .def("turn_off_memoization", &Module::turn_off_memoization)
       .def("turn_on_memoization", &Module::turn_on_memoization)
+      .def("is_memoization_adaptive", &Module::is_memoization_adaptive)
+      .def("turn_on_adaptive_memoization",
+           &Module::turn_on_adaptive_memoization)
+      .def("turn_off_adaptive_memoization",
+           &Module::turn_off_adaptive_memoization)
       .def("lock", &Module::lock)
       .def("results", &Module::results)
       .def("inputs", &Module::inputs)
@@ -121,6 +126,8 @@ void export_module_class(py_module_reference m) {
       .def("profile_info", &Module::profile_info)
       .def("submod_uuids", &Module::submod_uuids)
       .def("uuid", &Module::uuid)
+      // Returns None if the fingerprint is unknown (needs pybind11/stl.h)
+      .def("fingerprint", &Module::fingerprint)
       .def(pybind11::self == pybind11::self)
       .def(pybind11::self != pybind11::self);
 
@@ -69,12 +69,24 @@ void Module::reset_internal_cache() { m_pimpl_->reset_internal_cache(); }
 
 bool Module::is_memoizable() const { return m_pimpl_->is_memoizable(); }
 
+bool Module::is_memoization_adaptive() const noexcept {
+    return m_pimpl_->is_memoization_adaptive();
+}
+
 //--------------------Setters--------------------------------------------------
 
 void Module::turn_on_memoization() { m_pimpl_->turn_on_memoization(); }
 
 void Module::turn_off_memoization() { m_pimpl_->turn_off_memoization(); }
 
+void Module::turn_on_adaptive_memoization() {
+    m_pimpl_->turn_on_adaptive_memoization();
+}
+
+void Module::turn_off_adaptive_memoization() {
+    m_pimpl_->turn_off_adaptive_memoization();
+}
+
 void Module::lock() { m_pimpl_->lock(); }
 
 void Module::change_submod(type::key key, std::shared_ptr<Module> new_module) {
@@ -134,6 +146,12 @@ typename Module::submod_uuid_map Module::submod_uuids() const {
     return m_pimpl_->submod_uuids();
 }
 
+std::optional<typename Module::fingerprint_type> Module::fingerprint()
+  const noexcept {
+    if(!m_pimpl_) return fingerprint_type{};
+    return m_pimpl_->fingerprint();
+}
+
 //--------------------------- Private Members --------------------------------/
 
 void Module::unlock_() noexcept { m_pimpl_->unlock(); }
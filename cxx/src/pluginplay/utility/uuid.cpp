@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <boost/uuid/name_generator_sha1.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -25,4 +26,11 @@ uuid_type generate_uuid() {
     return boost::uuids::to_string(boost::uuids::random_generator()());
 }
 
+uuid_type content_uuid(std::string_view data) {
+    // Changing the namespace would change the UUID of every cached object
+    static const boost::uuids::name_generator_sha1 gen(
+      boost::uuids::ns::oid());
+    return boost::uuids::to_string(gen(data.data(), data.size()));
+}
+
 } // namespace pluginplay::utility
@@ -17,6 +17,7 @@
 #include "pluginplay/any/any.hpp"
 #include "test_any.hpp"
 #include <map>
+#include <parallelzone/serialization.hpp>
 #include <sstream>
 
 using namespace pluginplay::any;
@@ -293,6 +294,49 @@ TEMPLATE_LIST_TEST_CASE("AnyField", "", testing::types2test) {
         REQUIRE(by_cval.owns_value());
         REQUIRE_FALSE(by_cref.owns_value());
     }
+
+    SECTION("memory_footprint") {
+        REQUIRE(defaulted.memory_footprint() == 0);
+        REQUIRE(by_value.memory_footprint() >= sizeof(type));
+        // How the value is held doesn't matter
+        REQUIRE(by_cval.memory_footprint() == by_value.memory_footprint());
+        REQUIRE(by_cref.memory_footprint() == by_value.memory_footprint());
+    }
+
+    SECTION("content_hash") {
+        REQUIRE_FALSE(defaulted.content_hash().has_value());
+        REQUIRE(by_value.content_hash() == pluginplay::content_hash(value));
+        // Consistent with operator==, so how the value is held doesn't matter
+        REQUIRE(by_cval.content_hash() == by_value.content_hash());
+        REQUIRE(by_cref.content_hash() == by_value.content_hash());
+    }
+
+    SECTION("serialization") {
+        auto round_trip = [](const AnyField& da_any) {
+            std::stringstream ss;
+            {
+                cereal::BinaryOutputArchive ar(ss);
+                ar(da_any);
+            }
+            AnyField rv = make_any_field<map_type>(map_type{});
+            {
+                cereal::BinaryInputArchive ar(ss);
+                ar(rv);
+            }
+            return rv;
+        };
+
+        REQUIRE(defaulted.is_serializable());
+        REQUIRE_FALSE(round_trip(defaulted).has_value());
+        for(const auto* pany : {&by_value, &by_cval, &by_cref}) {
+            REQUIRE(pany->is_serializable());
+            auto copy = round_trip(*pany);
+            REQUIRE(copy == by_value);
+            REQUIRE(copy.owns_value());
+        }
+        // The value round trips, not just the type
+        REQUIRE_FALSE(round_trip(default_val) == by_value);
+    }
 }
 
 namespace {
@@ -397,4 +441,14 @@ TEST_CASE("AnyField with polymorphic classes") {
         REQUIRE(&any_cast<wrapped_type>(d1_copy) != pderived1.get());
         REQUIRE(any_cast<wrapped_type>(d1_copy) == *pderived1);
     }
+
+    SECTION("Can't be serialized") {
+        // Neither class is serializable (or default constructible)
+        auto te_base = make_any_field<ABaseClass>(*pbase);
+        REQUIRE_FALSE(te_base.is_serializable());
+
+        std::stringstream ss;
+        cereal::BinaryOutputArchive ar(ss);
+        REQUIRE_THROWS_AS(ar(te_base), std::runtime_error);
+    }
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/cache/admission_policy.hpp>
+
+using namespace pluginplay::cache;
+
+TEST_CASE("AdmissionPolicy") {
+    AdmissionPolicy defaulted;
+
+    AdmissionPolicy policy;
+    policy.memory_threshold     = 1.0;
+    policy.persistent_threshold = 2.0;
+
+    SECTION("admits_everything") {
+        REQUIRE(defaulted.admits_everything());
+        REQUIRE_FALSE(policy.admits_everything());
+    }
+
+    SECTION("Default admits everything to persistent storage") {
+        REQUIRE(defaulted(0.0, 0) == Admission::persistent);
+        REQUIRE(defaulted(0.0, 1000) == Admission::persistent);
+        REQUIRE(defaulted(1.0, 1) == Admission::persistent);
+    }
+
+    SECTION("Decides by value density") {
+        REQUIRE(policy(20.0, 10) == Admission::persistent);
+        REQUIRE(policy(15.0, 10) == Admission::memory_only);
+        REQUIRE(policy(10.0, 10) == Admission::memory_only);
+        REQUIRE(policy(5.0, 10) == Admission::skip);
+    }
+
+    SECTION("Empty results are always admitted") {
+        REQUIRE(policy(0.0, 0) == Admission::persistent);
+    }
+}
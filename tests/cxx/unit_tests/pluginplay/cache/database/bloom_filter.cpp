@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/bloom_filter.hpp>
+#include <sstream>
+
+using namespace pluginplay::cache::database;
+
+TEST_CASE("BloomFilter") {
+    BloomFilter filter(64);
+
+    SECTION("Ctor") {
+        using except_t = std::invalid_argument;
+        REQUIRE_THROWS_AS(BloomFilter(0), except_t);
+        REQUIRE_THROWS_AS(BloomFilter(64, 0.0), except_t);
+        REQUIRE_THROWS_AS(BloomFilter(64, 1.0), except_t);
+        REQUIRE(filter.size() == 0);
+        REQUIRE(filter.memory_footprint() == 0);
+        REQUIRE_FALSE(filter.might_contain(1));
+    }
+
+    SECTION("No false negatives") {
+        // Enough hashes to need several layers
+        for(std::uint64_t i = 0; i < 1000; ++i) filter.insert(i);
+        REQUIRE(filter.size() <= 1000);
+        REQUIRE(filter.size() > 950); // False positives aren't inserted
+        for(std::uint64_t i = 0; i < 1000; ++i)
+            REQUIRE(filter.might_contain(i));
+
+        // Reinserting doesn't use up capacity
+        const auto n = filter.size();
+        filter.insert(0);
+        REQUIRE(filter.size() == n);
+    }
+
+    SECTION("Few false positives") {
+        for(std::uint64_t i = 0; i < 1000; ++i) filter.insert(i);
+        std::size_t n_false = 0;
+        for(std::uint64_t i = 1000; i < 11000; ++i)
+            n_false += filter.might_contain(i);
+        // Overall rate is bounded by twice the rate of the first layer
+        REQUIRE(n_false < 250);
+    }
+
+    SECTION("save/load") {
+        for(std::uint64_t i = 0; i < 100; ++i) filter.insert(i);
+        std::stringstream ss;
+        filter.save(ss);
+        auto loaded = BloomFilter::load(ss);
+        REQUIRE(loaded.size() == filter.size());
+        REQUIRE(loaded.memory_footprint() == filter.memory_footprint());
+        for(std::uint64_t i = 0; i < 100; ++i)
+            REQUIRE(loaded.might_contain(i));
+
+        std::stringstream garbage("not a filter");
+        REQUIRE_THROWS_AS(BloomFilter::load(garbage), std::runtime_error);
+
+        auto truncated = ss.str();
+        truncated.resize(truncated.size() / 2);
+        std::stringstream ss2(truncated);
+        REQUIRE_THROWS_AS(BloomFilter::load(ss2), std::runtime_error);
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/codec_recorder.hpp>
+#include <pluginplay/cache/database/native.hpp>
+
+using namespace pluginplay::cache;
+using namespace pluginplay::cache::database;
+
+using native_type = Native<std::string, std::string>;
+using db_type     = CodecRecorder<std::string, std::string>;
+using hints_type  = typename db_type::hints_type;
+using policy_type = typename db_type::policy_type;
+
+TEST_CASE("CodecRecorder") {
+    auto native = std::make_shared<native_type>();
+    auto hints  = std::make_shared<hints_type>();
+    auto policy = std::make_shared<policy_type>();
+    db_type db(native, hints, policy);
+
+    CompressionPolicy fast;
+    fast.codec = Codec::fast;
+
+    SECTION("Ctor") {
+        using except_t = std::runtime_error;
+        REQUIRE_THROWS_AS(db_type(nullptr, hints, policy), except_t);
+        REQUIRE_THROWS_AS(db_type(native, nullptr, policy), except_t);
+        REQUIRE_THROWS_AS(db_type(native, hints, nullptr), except_t);
+    }
+
+    SECTION("Forwards") {
+        db.insert("Hello", "World");
+        REQUIRE(native->at("Hello").get() == "World");
+        REQUIRE(db.count("Hello"));
+        REQUIRE(db.keys().size() == 1);
+        REQUIRE(db.at("Hello").get() == "World");
+        db.free("Hello");
+        REQUIRE_FALSE(native->count("Hello"));
+    }
+
+    SECTION("No policy, no hints") {
+        db.insert("Hello", "World");
+        REQUIRE(hints->empty());
+    }
+
+    SECTION("Records the current policy") {
+        *policy = fast;
+        db.insert("Hello", "World");
+        REQUIRE_FALSE(hints->empty());
+        REQUIRE(hints->get("World", CompressionPolicy{}).codec == Codec::fast);
+        REQUIRE(hints->get("Hello", CompressionPolicy{}).codec == Codec::none);
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/compressed.hpp>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/config/config.hpp>
+
+using namespace pluginplay::cache;
+using namespace pluginplay::cache::database;
+
+using native_type = Native<std::string, std::string>;
+using db_type     = Compressed<std::string, std::string>;
+
+TEST_CASE("Compressed") {
+    auto pnative = std::make_unique<native_type>();
+    auto native  = pnative.get();
+
+    const std::string small("Hello World");
+    const std::string large(4096, 'a');
+
+    SECTION("Ctors") {
+        using except_t = std::runtime_error;
+        using fxn_type = typename db_type::policy_function;
+        REQUIRE_THROWS_AS(db_type(nullptr, CompressionPolicy{}), except_t);
+        REQUIRE_THROWS_AS(db_type(std::move(pnative), fxn_type{}), except_t);
+
+        if(!pluginplay::with_zlib()) {
+            CompressionPolicy fast;
+            fast.codec = Codec::fast;
+            pnative    = std::make_unique<native_type>();
+            REQUIRE_THROWS_AS(db_type(std::move(pnative), fast), except_t);
+        }
+    }
+
+    SECTION("No compression") {
+        db_type db(std::move(pnative), CompressionPolicy{});
+        db.insert("small", small);
+        db.insert("large", large);
+
+        // Stored as is
+        REQUIRE(native->at("small").get() == small);
+        REQUIRE(native->at("large").get() == large);
+
+        REQUIRE(db.count("small"));
+        REQUIRE(db.keys().size() == 2);
+        REQUIRE(db.at("small").get() == small);
+        REQUIRE(db.at("large").get() == large);
+
+        db.free("small");
+        REQUIRE_FALSE(db.count("small"));
+    }
+
+    SECTION("Values which look compressed") {
+        db_type db(std::move(pnative), CompressionPolicy{});
+        const std::string tricky("\x7fPPZ not really compressed");
+        db.insert("tricky", tricky);
+        REQUIRE(native->at("tricky").get() != tricky);
+        REQUIRE(db.at("tricky").get() == tricky);
+    }
+
+    SECTION("Reads values written without compression") {
+        native->insert("legacy", large);
+        db_type db(std::move(pnative), CompressionPolicy{});
+        REQUIRE(db.at("legacy").get() == large);
+    }
+
+    if(!pluginplay::with_zlib()) return;
+
+    CompressionPolicy policy;
+    policy.codec    = Codec::fast;
+    policy.min_size = 100;
+
+    SECTION("Picks codec by size") {
+        db_type db(std::move(pnative), policy);
+        db.insert("small", small);
+        db.insert("large", large);
+
+        REQUIRE(native->at("small").get() == small);
+        REQUIRE(native->at("large").get().size() < large.size());
+
+        REQUIRE(db.at("small").get() == small);
+        REQUIRE(db.at("large").get() == large);
+    }
+
+    SECTION("large_codec") {
+        auto pfast = std::make_unique<native_type>();
+        auto fast  = pfast.get();
+        db_type fast_db(std::move(pfast), policy);
+
+        policy.large_size = 1000;
+        db_type best_db(std::move(pnative), policy);
+
+        std::string data;
+        for(std::size_t i = 0; i < 10000; ++i) data += std::to_string(i % 97);
+        fast_db.insert("data", data);
+        best_db.insert("data", data);
+
+        const auto nfast = fast->at("data").get().size();
+        const auto nbest = native->at("data").get().size();
+        REQUIRE(nbest <= nfast);
+        REQUIRE(best_db.at("data").get() == data);
+    }
+
+    SECTION("Incompressible values are stored as is") {
+        db_type db(std::move(pnative), policy);
+        std::string noise;
+        unsigned int x = 12345;
+        for(std::size_t i = 0; i < 200; ++i) {
+            x = x * 1103515245u + 12345u;
+            noise.push_back(static_cast<char>(x >> 24));
+        }
+        noise[0] = 'a'; // Can't start with the magic bytes
+        db.insert("noise", noise);
+        REQUIRE(native->at("noise").get() == noise);
+        REQUIRE(db.at("noise").get() == noise);
+    }
+
+    SECTION("Policy per key") {
+        auto fxn = [policy](const std::string& key) {
+            return key == "raw" ? CompressionPolicy{} : policy;
+        };
+        db_type db(std::move(pnative), fxn);
+        db.insert("raw", large);
+        db.insert("compressed", large);
+        REQUIRE(native->at("raw").get() == large);
+        REQUIRE(native->at("compressed").get().size() < large.size());
+        REQUIRE(db.at("raw").get() == large);
+        REQUIRE(db.at("compressed").get() == large);
+    }
+
+    SECTION("Corrupt values") {
+        native->insert("corrupt", std::string("\x7fPPZ\x01", 5));
+        db_type db(std::move(pnative), policy);
+        REQUIRE_THROWS_AS(db.at("corrupt"), std::runtime_error);
+    }
+}
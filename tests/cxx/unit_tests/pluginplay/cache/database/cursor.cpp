@@ -0,0 +1,130 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <pluginplay/cache/database/cursor.hpp>
+
+using namespace pluginplay::cache::database;
+
+namespace {
+
+using key_set_type   = std::vector<std::string>;
+using cursor_pointer = std::unique_ptr<Cursor<std::string>>;
+
+key_set_type drain(cursor_pointer c) {
+    key_set_type rv;
+    for(; c->valid(); c->next()) rv.push_back(c->key());
+    return rv;
+}
+
+cursor_pointer make_cursor(key_set_type keys) {
+    return std::make_unique<VectorCursor<std::string>>(std::move(keys));
+}
+
+} // namespace
+
+TEST_CASE("Cursor") {
+    key_set_type keys{"a1", "a2", "b1", "c1"};
+
+    SECTION("traits") {
+        using pointer_map = std::map<std::string, Cursor<int>*>;
+        STATIC_REQUIRE(is_ordered_key_v<int>);
+        STATIC_REQUIRE(is_ordered_key_v<std::string>);
+        STATIC_REQUIRE(is_ordered_key_v<std::map<std::string, std::string>>);
+        STATIC_REQUIRE_FALSE(is_ordered_key_v<pointer_map>);
+        STATIC_REQUIRE(is_string_key_v<std::string>);
+        STATIC_REQUIRE_FALSE(is_string_key_v<int>);
+        REQUIRE(has_prefix<std::string>("a1", "a"));
+        REQUIRE_FALSE(has_prefix<std::string>("a1", "b"));
+        REQUIRE_FALSE(has_prefix<std::string>("a", "a1"));
+    }
+
+    SECTION("VectorCursor") {
+        REQUIRE(drain(make_cursor({})).empty());
+        REQUIRE(drain(make_cursor(keys)) == keys);
+    }
+
+    SECTION("IteratorCursor") {
+        std::map<std::string, int> m{{"a", 0}, {"b", 1}, {"c", 2}};
+        using itr_type = typename std::map<std::string, int>::const_iterator;
+        auto skip_odd  = [](itr_type itr) -> const std::string* {
+            return itr->second % 2 ? nullptr : &itr->first;
+        };
+        auto c = make_iterator_cursor<std::string>(m.cbegin(), m.cend(),
+                                                   skip_odd);
+        REQUIRE(drain(std::move(c)) == key_set_type{"a", "c"});
+
+        auto empty = make_iterator_cursor<std::string>(m.cend(), m.cend(),
+                                                       skip_odd);
+        REQUIRE_FALSE(empty->valid());
+    }
+
+    SECTION("FilteredCursor") {
+        auto is_1 = [](const std::string& k) { return k[1] == '1'; };
+        using cursor_type = FilteredCursor<std::string>;
+        auto c = std::make_unique<cursor_type>(make_cursor(keys), is_1);
+        REQUIRE(drain(std::move(c)) == key_set_type{"a1", "b1", "c1"});
+
+        // Bounded cursors stop at the first key which fails
+        auto b = std::make_unique<cursor_type>(make_cursor(keys), is_1, true);
+        REQUIRE(drain(std::move(b)) == key_set_type{"a1"});
+    }
+
+    SECTION("TransformCursor") {
+        std::size_t n_calls = 0;
+        auto upper          = [&n_calls](const std::string& k) {
+            ++n_calls;
+            return std::string(1, std::toupper(k[0])) + k.substr(1);
+        };
+        using cursor_type = TransformCursor<std::string, std::string>;
+        auto c = std::make_unique<cursor_type>(make_cursor(keys), upper);
+
+        // Keys are converted once, and only when asked for
+        REQUIRE(n_calls == 0);
+        REQUIRE(c->key() == "A1");
+        REQUIRE(c->key() == "A1");
+        REQUIRE(n_calls == 1);
+        c->next();
+        c->next();
+        REQUIRE(c->key() == "B1");
+        REQUIRE(n_calls == 2);
+        REQUIRE(drain(std::move(c)) == key_set_type{"B1", "C1"});
+    }
+
+    SECTION("ChainCursor") {
+        using cursor_type = ChainCursor<std::string>;
+        auto c = std::make_unique<cursor_type>(make_cursor({"x"}),
+                                               make_cursor(keys));
+        key_set_type corr{"x", "a1", "a2", "b1", "c1"};
+        REQUIRE(drain(std::move(c)) == corr);
+
+        auto empty = std::make_unique<cursor_type>(make_cursor({}),
+                                                   make_cursor({}));
+        REQUIRE_FALSE(empty->valid());
+    }
+
+    SECTION("LockedCursor") {
+        std::mutex mutex;
+        using cursor_type = LockedCursor<std::string>;
+        auto c = std::make_unique<cursor_type>(make_cursor(keys), mutex);
+        REQUIRE(drain(std::move(c)) == keys);
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+}
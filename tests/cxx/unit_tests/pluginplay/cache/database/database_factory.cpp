@@ -15,8 +15,16 @@
  */
 
 #include "../../catch.hpp"
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/string.hpp>
 #include <filesystem>
 #include <pluginplay/cache/database/database_factory.hpp>
+#include <pluginplay/cache/database/flat_file/flat_file.hpp>
+#include <pluginplay/cache/database/proxy_map_codec.hpp>
+#include <pluginplay/cache/database/rocksdb/rocksdb.hpp>
+#include <pluginplay/config/config.hpp>
+#include <sstream>
 
 using namespace pluginplay;
 using namespace pluginplay::cache::database;
@@ -77,4 +85,139 @@ TEST_CASE("DatabaseFactory : No long-term storage") {
 
     REQUIRE(pdb->count(inputs));
     REQUIRE(pdb->at(inputs).get() == results);
+
+    REQUIRE_FALSE(factory.has_long_term_storage());
+
+    auto pmem = factory.memory_module_db();
+    REQUIRE_FALSE(pmem->count(inputs));
+    pmem->insert(inputs, results);
+    REQUIRE(pmem->at(inputs).get() == results);
+}
+
+TEST_CASE("DatabaseFactory : Upgrading saved keys") {
+    using proxy_map_type = typename DatabaseFactory::proxy_map_type;
+    using binary_type    = typename DatabaseFactory::binary_type;
+    using backend_type =
+      std::conditional_t<with_rocksdb_v, RocksDB<binary_type, binary_type>,
+                         FlatFile<binary_type, binary_type>>;
+
+    namespace fs    = std::filesystem;
+    const auto root = fs::temp_directory_path() / "factory_upgrade";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const auto path      = (root / "cache").string();
+    const auto uuid_path = (root / "uuid").string();
+
+    auto serialize = [](const proxy_map_type& pm) {
+        std::stringstream ss;
+        {
+            cereal::BinaryOutputArchive ar(ss);
+            ar << pm;
+        }
+        return ss.str();
+    };
+
+    // Earlier versions serialized keys with cereal, injecting the module, and
+    // (with RocksDB) saved them in the default column family
+    proxy_map_type key{{"x", "bar"}};
+    proxy_map_type legacy_key(key);
+    legacy_key.emplace("__CACHE__ MODULE NAME __CACHE__", "foo");
+    proxy_map_type value{{"r", "baz"}};
+    {
+        backend_type db(path);
+        db.insert(serialize(legacy_key), serialize(value));
+        db.backup();
+    }
+
+    // Counts the saved results, and those whose keys are serialized by cereal
+    auto count_keys = [](const DatabaseFactory& factory) {
+        std::pair<std::size_t, std::size_t> rv{0, 0};
+        for(const auto& [name, records] : factory.export_tables()) {
+            if(name != "cache" && name.rfind("cache/", 0) != 0) continue;
+            for(const auto& [k, _] : records) {
+                if(ProxyMapCodec::is_name(k)) continue;
+                ++rv.first;
+                if(!ProxyMapCodec::is_encoded(k)) ++rv.second;
+            }
+        }
+        return rv;
+    };
+
+    SECTION("Read-only storage can't be upgraded") {
+        DatabaseFactory factory;
+        factory.set_read_only_storage(true);
+        REQUIRE_THROWS_AS(factory.set_serialized_pm_to_pm(path),
+                          std::runtime_error);
+    }
+
+    SECTION("Upgraded when opened") {
+        {
+            DatabaseFactory factory(path, uuid_path);
+            auto pdb = factory.pm2result_db("foo");
+            REQUIRE(pdb->count(key));
+            using count_type = std::pair<std::size_t, std::size_t>;
+            REQUIRE(count_keys(factory) == count_type{1, 0});
+        }
+
+        // Once upgraded, it can be opened read-only
+        DatabaseFactory factory;
+        factory.set_read_only_storage(true);
+        REQUIRE_NOTHROW(factory.set_serialized_pm_to_pm(path));
+        auto pdb = factory.pm2result_db("foo");
+        REQUIRE(pdb->count(key));
+    }
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("DatabaseFactory : Distinct objects get distinct UUIDs") {
+    using input_map_type     = typename DatabaseFactory::input_map_type;
+    using module_input_type  = typename DatabaseFactory::module_input_type;
+    using result_map_type    = typename DatabaseFactory::result_map_type;
+    using module_result_type = typename DatabaseFactory::module_result_type;
+
+    namespace fs    = std::filesystem;
+    const auto root = fs::temp_directory_path() / "factory_uuids";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const auto path      = (root / "cache").string();
+    const auto uuid_path = (root / "uuid").string();
+
+    module_input_type i0, i1;
+    i0.set_type<int>();
+    i0.change(1);
+    i1.set_type<int>();
+    i1.change(2);
+    module_result_type r0, r1;
+    r0.set_type<int>();
+    r0.change(3);
+    r1.set_type<int>();
+    r1.change(4);
+
+    input_map_type inputs0, inputs1;
+    inputs0.emplace("x", i0);
+    inputs1.emplace("x", i1);
+    result_map_type results0, results1;
+    results0.emplace("y", r0);
+    results1.emplace("y", r1);
+
+    {
+        DatabaseFactory factory(path, uuid_path);
+        auto pdb = factory.default_module_db("foo");
+        pdb->insert(inputs0, results0);
+        pdb->insert(inputs1, results1);
+        REQUIRE(pdb->at(inputs0).get() == results0);
+        REQUIRE(pdb->at(inputs1).get() == results1);
+        factory.backup();
+
+        // Two inputs and two results, each with its own UUID
+        REQUIRE(factory.export_tables().at("uuid").size() == 4);
+    }
+
+    DatabaseFactory factory(path, uuid_path);
+    auto pdb = factory.default_module_db("foo");
+    REQUIRE(pdb->at(inputs0).get() == results0);
+    REQUIRE(pdb->at(inputs1).get() == results1);
+
+    fs::remove_all(root);
 }
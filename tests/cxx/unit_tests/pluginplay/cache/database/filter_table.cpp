@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <filesystem>
+#include <pluginplay/cache/database/filter_table.hpp>
+
+using namespace pluginplay::cache::database;
+
+using saved_keys = typename FilterTable::saved_keys;
+
+TEST_CASE("FilterTable") {
+    namespace fs = std::filesystem;
+    const auto root = fs::temp_directory_path() / "filter_table_test";
+    fs::remove_all(root);
+    const auto dir = (root / "filters").string();
+
+    std::size_t n_scans = 0;
+    auto scan           = [&]() {
+        ++n_scans;
+        return saved_keys{{"mod", 1}, {"mod", 2}, {"other", 3}};
+    };
+    auto bad_scan = []() -> saved_keys { throw std::runtime_error("NYI"); };
+
+    SECTION("Memory only") {
+        FilterTable table;
+        REQUIRE(table.complete());
+        auto pfilter = table.get("mod");
+        REQUIRE(pfilter);
+        REQUIRE(pfilter->size() == 0);
+        REQUIRE(table.get("mod") == pfilter);
+        table.save(); // No-op
+    }
+
+    SECTION("Fresh storage") {
+        FilterTable table(dir, "", 42, true, scan);
+        REQUIRE(table.get("mod")->size() == 0);
+        REQUIRE(n_scans == 0);
+    }
+
+    SECTION("Rebuilt by scanning") {
+        FilterTable table(dir, "", 42, false, scan);
+        REQUIRE_FALSE(table.complete());
+        auto pfilter = table.get("mod");
+        REQUIRE(n_scans == 1);
+        REQUIRE(table.complete());
+        REQUIRE(pfilter->might_contain(1));
+        REQUIRE(pfilter->might_contain(2));
+        REQUIRE(table.get("other")->might_contain(3));
+        REQUIRE(table.get("new")->size() == 0);
+        REQUIRE(n_scans == 1);
+    }
+
+    SECTION("Can't scan") {
+        FilterTable table(dir, "", 42, false, bad_scan);
+        REQUIRE(table.get("mod") == nullptr);
+        REQUIRE_FALSE(table.complete());
+        table.add("mod", 1); // No-op
+        table.save();
+        REQUIRE_FALSE(fs::exists(fs::path(dir) / "complete"));
+    }
+
+    SECTION("save/load") {
+        {
+            FilterTable table(dir, "", 42, false, scan);
+            table.add("mod", 5);
+            table.save();
+        }
+        REQUIRE(fs::exists(fs::path(dir) / "complete"));
+
+        // Loaded, and "other" was saved too even though it wasn't used
+        FilterTable table(dir, "", 42, false, bad_scan);
+        REQUIRE(table.complete());
+        REQUIRE(table.get("mod")->might_contain(5));
+        REQUIRE(table.get("other")->might_contain(3));
+
+        // Different hash function, so the saved filters are useless
+        FilterTable other_hash(dir, "", 43, false, bad_scan);
+        REQUIRE(other_hash.get("mod")->size() == 0);
+    }
+
+    SECTION("Saved filters go out of date") {
+        const auto marker = fs::path(dir) / "complete";
+        {
+            FilterTable table(dir, "", 42, false, scan);
+            table.get("mod");
+            table.save();
+            REQUIRE(fs::exists(marker));
+
+            // Keys saved after the filters (e.g., the job is then killed)
+            table.invalidate_saved();
+            REQUIRE_FALSE(fs::exists(marker));
+        }
+        {
+            FilterTable table(dir, "", 42, false, scan);
+            REQUIRE_FALSE(table.complete());
+            REQUIRE(table.get("mod")->might_contain(1));
+            REQUIRE(n_scans == 2);
+            table.save();
+            REQUIRE(fs::exists(marker));
+        }
+
+        // Keys saved before the filters ever were
+        fs::remove_all(dir);
+        {
+            FilterTable table(dir, "", 42, true, scan);
+            table.invalidate_saved();
+            REQUIRE(fs::exists(dir));
+        }
+        FilterTable table(dir, "", 42, false, bad_scan);
+        REQUIRE_FALSE(table.complete());
+        REQUIRE(table.get("mod") == nullptr);
+    }
+
+    SECTION("Shared directory") {
+        {
+            FilterTable table(dir, "", 42, false, scan);
+            table.get("mod");
+            table.save();
+        }
+        const auto overlay = (root / "overlay").string();
+        FilterTable table(overlay, dir, 42, false, bad_scan);
+        table.add("mod", 5);
+        table.save();
+        REQUIRE(fs::exists(fs::path(overlay) / "complete"));
+
+        FilterTable reopened(overlay, dir, 42, false, bad_scan);
+        REQUIRE(reopened.get("mod")->might_contain(5));
+        REQUIRE(reopened.get("other")->might_contain(3));
+        FilterTable shared_only(dir, "", 42, false, bad_scan);
+        REQUIRE_FALSE(shared_only.get("mod")->might_contain(5));
+    }
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/filtered.hpp>
+#include <pluginplay/cache/database/native.hpp>
+
+using namespace pluginplay::cache::database;
+
+using native_type = Native<int, int>;
+using db_type     = Filtered<int, int>;
+
+TEST_CASE("Filtered") {
+    auto pnative = std::make_unique<native_type>();
+    auto native  = pnative.get();
+    auto pfilter = std::make_shared<BloomFilter>();
+
+    SECTION("Ctor") {
+        REQUIRE_THROWS_AS(db_type(nullptr, pfilter), std::runtime_error);
+        db_type db(std::move(pnative), pfilter);
+        REQUIRE(db.filter() == pfilter);
+        REQUIRE(db.n_filtered() == 0);
+    }
+
+    SECTION("Filters missing keys") {
+        db_type db(std::move(pnative), pfilter);
+        db.insert(1, 2);
+        REQUIRE(pfilter->might_contain(DBHash<int>{}(1)));
+        REQUIRE(db.count(1));
+        REQUIRE(db.at(1).get() == 2);
+        REQUIRE(db.keys() == std::vector<int>{1});
+
+        // Filter doesn't know about keys put in the wrapped DB directly
+        native->insert(3, 4);
+        REQUIRE_FALSE(db.count(3));
+        REQUIRE(db.n_filtered() == 1);
+
+        // Freed keys are still in the filter, so they go to the wrapped DB
+        db.free(1);
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE(db.n_filtered() == 1);
+    }
+
+    SECTION("No filter") {
+        db_type db(std::move(pnative), nullptr);
+        native->insert(3, 4);
+        REQUIRE(db.count(3));
+        db.insert(1, 2);
+        REQUIRE(db.count(1));
+        REQUIRE(db.n_filtered() == 0);
+    }
+
+    SECTION("Insert hook") {
+        std::size_t n_calls = 0;
+        auto hook           = [&]() {
+            // Called before the key reaches the wrapped DB
+            REQUIRE_FALSE(native->count(1));
+            ++n_calls;
+        };
+        db_type db(std::move(pnative), pfilter, hook);
+        db.insert(1, 2);
+        REQUIRE(n_calls == 1);
+        REQUIRE(native->count(1));
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../../../catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <pluginplay/cache/database/flat_file/detail_/flat_file_pimpl.hpp>
+using namespace pluginplay::cache::database::detail_;
+
+TEST_CASE("FlatFilePIMPL") {
+    std::filesystem::path file("flat_file_pimpl_test.db");
+    auto p = std::filesystem::temp_directory_path() / file;
+    std::filesystem::remove_all(p);
+
+    SECTION("CTor") {
+        FlatFilePIMPL db(p.string());
+        REQUIRE(std::filesystem::exists(p / "data"));
+        REQUIRE(std::filesystem::exists(p / "index"));
+        REQUIRE(db.size() == 0);
+    }
+
+    SECTION("Not a FlatFile") {
+        std::filesystem::create_directories(p);
+        std::ofstream(p / "data") << "Not a FlatFile data file";
+        REQUIRE_THROWS_AS(FlatFilePIMPL(p.string()), std::runtime_error);
+    }
+
+    SECTION("insert/at/free") {
+        FlatFilePIMPL db(p.string());
+        db.insert("Hello", "World");
+        db.insert("", ""); // Empty keys/values are fine
+        REQUIRE(db.size() == 2);
+        REQUIRE(db.at("Hello").get() == "World");
+        REQUIRE(db.at("").get() == "");
+        REQUIRE(db.view("Hello") == "World");
+
+        // Returns an empty object if key DNE
+        REQUIRE_FALSE(db.at("Not a key").has_value());
+        REQUIRE(db.view("Not a key").data() == nullptr);
+
+        db.insert("Hello", "Universe");
+        REQUIRE(db.size() == 2);
+        REQUIRE(db.at("Hello").get() == "Universe");
+
+        db.free("Hello");
+        REQUIRE(db.size() == 1);
+        REQUIRE_FALSE(db.count("Hello"));
+
+        // Can reinsert freed keys
+        db.insert("Hello", "World");
+        REQUIRE(db.at("Hello").get() == "World");
+    }
+
+    // Enough keys to force the index and data file to grow several times
+    const std::size_t n = 5000;
+    const std::string big(100, 'x');
+    auto fill = [&](FlatFilePIMPL& db) {
+        for(std::size_t i = 0; i < n; ++i)
+            db.insert(std::to_string(i), big + std::to_string(i));
+        for(std::size_t i = 0; i < n; i += 2) db.free(std::to_string(i));
+    };
+    auto check = [&](const FlatFilePIMPL& db) {
+        REQUIRE(db.size() == n / 2);
+        REQUIRE(db.keys().size() == n / 2);
+        for(std::size_t i = 0; i < n; ++i) {
+            const auto key = std::to_string(i);
+            if(i % 2) {
+                REQUIRE(db.at(key).get() == big + key);
+            } else {
+                REQUIRE_FALSE(db.count(key));
+            }
+        }
+    };
+
+    SECTION("Growth") {
+        FlatFilePIMPL db(p.string());
+        fill(db);
+        check(db);
+    }
+
+    SECTION("Reopen") {
+        {
+            FlatFilePIMPL db(p.string());
+            fill(db);
+        }
+        FlatFilePIMPL db(p.string());
+        check(db);
+    }
+
+    SECTION("Rebuilds missing index") {
+        {
+            FlatFilePIMPL db(p.string());
+            fill(db);
+            db.sync();
+        }
+        std::filesystem::remove(p / "index");
+        FlatFilePIMPL db(p.string());
+        check(db);
+    }
+
+    SECTION("Rebuilds stale index") {
+        std::filesystem::create_directories(p);
+        {
+            FlatFilePIMPL db(p.string());
+            db.insert("Hello", "World");
+        }
+        std::filesystem::copy_file(p / "index", p / "old_index");
+        {
+            FlatFilePIMPL db(p.string());
+            db.insert("Hello", "Universe");
+            db.insert("Foo", "Bar");
+        }
+        std::filesystem::remove(p / "index");
+        std::filesystem::rename(p / "old_index", p / "index");
+
+        FlatFilePIMPL db(p.string());
+        REQUIRE(db.size() == 2);
+        REQUIRE(db.at("Hello").get() == "Universe");
+        REQUIRE(db.at("Foo").get() == "Bar");
+    }
+
+    SECTION("Read-only") {
+        // Must already exist
+        REQUIRE_THROWS_AS(FlatFilePIMPL(p.string(), true), std::runtime_error);
+        {
+            FlatFilePIMPL db(p.string());
+            fill(db);
+        }
+        {
+            FlatFilePIMPL db(p.string(), true);
+            REQUIRE(db.read_only());
+            check(db);
+            REQUIRE_THROWS_AS(db.insert("Hello", "World"), std::runtime_error);
+            REQUIRE_THROWS_AS(db.free("1"), std::runtime_error);
+            REQUIRE_NOTHROW(db.sync());
+        }
+
+        // Can't rebuild the index
+        std::filesystem::resize_file(p / "index", 0);
+        REQUIRE_THROWS_AS(FlatFilePIMPL(p.string(), true), std::runtime_error);
+    }
+
+    std::filesystem::remove_all(p);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../../catch.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <pluginplay/cache/database/flat_file/flat_file.hpp>
+using namespace pluginplay::cache::database;
+
+/* Testing notes:
+ *
+ * The database is removed at the start of each section, so sections do not
+ * depend on one another. See flat_file_pimpl.cpp for tests of the file
+ * formats (reopening, rebuilding the index, etc.).
+ */
+
+TEST_CASE("FlatFile") {
+    std::filesystem::path file("flat_file_test.db");
+    auto p = std::filesystem::temp_directory_path() / file;
+    std::filesystem::remove_all(p);
+
+    using FlatFileSS = FlatFile<std::string, std::string>;
+    FlatFileSS defaulted;
+    FlatFileSS db(p.string());
+    db.insert("Hello", "World");
+
+    SECTION("CTor") { REQUIRE(std::filesystem::exists(p)); }
+
+    SECTION("keys") {
+        REQUIRE(defaulted.keys().empty());
+        REQUIRE(db.keys() == std::vector<std::string>{"Hello"});
+    }
+
+    SECTION("cursor/range/prefix") {
+        using key_set_type = std::vector<std::string>;
+        auto drain         = [](auto c) {
+            key_set_type rv;
+            for(; c->valid(); c->next()) rv.push_back(c->key());
+            return rv;
+        };
+        REQUIRE_FALSE(defaulted.cursor()->valid());
+
+        // Enough keys that the index is rehashed, in no particular order
+        key_set_type corr{"Hello"};
+        for(std::size_t i = 0; i < 100; ++i) {
+            corr.push_back("key" + std::to_string(i));
+            db.insert(corr.back(), "value");
+        }
+        db.free("key42");
+        corr.erase(corr.begin() + 43);
+
+        auto keys = drain(db.cursor());
+        std::sort(keys.begin(), keys.end());
+        std::sort(corr.begin(), corr.end());
+        REQUIRE(keys == corr);
+
+        auto hellos = drain(db.prefix("Hell"));
+        REQUIRE(hellos == key_set_type{"Hello"});
+        REQUIRE(drain(db.range("key10", "key11")) == key_set_type{"key10"});
+    }
+
+    SECTION("count") {
+        REQUIRE_FALSE(defaulted.count("not a key"));
+        REQUIRE_FALSE(db.count("not a key"));
+        REQUIRE(db.count("Hello"));
+    }
+
+    SECTION("insert/operator[]") {
+        REQUIRE(db.at("Hello").get() == "World");
+
+        // Repeated inserts do nothing
+        db.insert("Hello", "World");
+        REQUIRE(db["Hello"].get() == "World");
+
+        // Can be used to override a value
+        db.insert("Hello", "Universe");
+        REQUIRE(db["Hello"].get() == "Universe");
+
+        REQUIRE_THROWS_AS(db.at("Not a key"), std::out_of_range);
+        REQUIRE_THROWS_AS(defaulted.insert("", ""), std::runtime_error);
+        REQUIRE_THROWS_AS(defaulted[""], std::runtime_error);
+    }
+
+    SECTION("view") {
+        REQUIRE(db.view("Hello") == "World");
+        REQUIRE_THROWS_AS(db.view("Not a key"), std::out_of_range);
+        REQUIRE_THROWS_AS(defaulted.view("Hello"), std::runtime_error);
+    }
+
+    SECTION("free") {
+        db.free("Hello");
+        REQUIRE_FALSE(db.count("Hello"));
+
+        // Can delete a non-existing key
+        db.free("Hello");
+        REQUIRE_FALSE(db.count("Hello"));
+
+        REQUIRE_THROWS_AS(defaulted.free(""), std::runtime_error);
+    }
+
+    SECTION("backup/dump") {
+        // Data stays available either way
+        db.backup();
+        REQUIRE(db.at("Hello").get() == "World");
+        db.dump();
+        REQUIRE(db.at("Hello").get() == "World");
+        REQUIRE_NOTHROW(defaulted.backup());
+    }
+
+    SECTION("read-only") {
+        REQUIRE_FALSE(defaulted.read_only());
+        REQUIRE_FALSE(db.read_only());
+
+        // Can't be read while it's open for writing
+        REQUIRE_THROWS_AS(FlatFileSS(p.string(), true), std::runtime_error);
+        REQUIRE_THROWS_AS(FlatFileSS(p.string()), std::runtime_error);
+
+        // Other processes see the database through their own mappings
+        const auto path = p.string() + "_4";
+        {
+            FlatFileSS writer(path);
+            writer.insert("Hello", "World");
+        }
+        {
+            FlatFileSS reader(path, true);
+            REQUIRE(reader.read_only());
+            REQUIRE(reader.at("Hello").get() == "World");
+            REQUIRE_THROWS_AS(reader.insert("Foo", "Bar"), std::runtime_error);
+            REQUIRE_THROWS_AS(reader.free("Hello"), std::runtime_error);
+
+            // Any number of readers, but no writers
+            FlatFileSS reader2(path, true);
+            REQUIRE(reader2.at("Hello").get() == "World");
+            REQUIRE_THROWS_AS(FlatFileSS(path), std::runtime_error);
+        }
+        std::filesystem::remove_all(path);
+
+        REQUIRE_THROWS_AS(FlatFileSS(p.string() + "_3", true),
+                          std::runtime_error);
+    }
+
+    SECTION("Persists") {
+        {
+            FlatFileSS other(p.string() + "_2");
+            other.insert("Hello", "World");
+        }
+        FlatFileSS reopened(p.string() + "_2");
+        REQUIRE(reopened.at("Hello").get() == "World");
+        std::filesystem::remove_all(p.string() + "_2");
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <algorithm>
+#include <pluginplay/cache/database/memory_budget.hpp>
+#include <string>
+#include <vector>
+
+using namespace pluginplay::cache::database;
+
+TEST_CASE("MemoryBudget") {
+    using size_type = MemoryBudget::size_type;
+    MemoryBudget budget;
+    TierState low, normal, over;
+    low.priority     = 0;
+    over.max_bytes   = 1;
+    over.bytes       = 2;
+    normal.bytes     = 8;
+    low.bytes        = 4;
+    std::vector<std::string> calls;
+
+    // Frees everything it's asked to
+    auto reclaimer = [&](std::string name, TierState& tiers) {
+        return [&, name](size_type n) {
+            calls.push_back(name);
+            const auto freed = std::min<size_type>(n, tiers.bytes);
+            tiers.bytes -= freed;
+            budget.shrink(freed);
+            return freed;
+        };
+    };
+
+    REQUIRE(budget.limit() == 0);
+    const auto t_normal = budget.attach(normal, reclaimer("normal", normal));
+    budget.attach(low, reclaimer("low", low));
+    budget.attach(over, reclaimer("over", over));
+    budget.grow(14);
+    REQUIRE(budget.used() == 14);
+
+    SECTION("No limit") {
+        budget.enforce();
+        REQUIRE(calls.empty());
+    }
+
+    SECTION("Within the limit") {
+        budget.set_limit(14);
+        budget.enforce();
+        REQUIRE(calls.empty());
+    }
+
+    SECTION("Over quota, then low priority, then the rest") {
+        budget.set_limit(7);
+        budget.enforce();
+        REQUIRE(calls == std::vector<std::string>{"over", "low", "normal"});
+        REQUIRE(budget.used() == 7);
+        REQUIRE(normal.bytes == 7);
+    }
+
+    SECTION("Stops once within the limit") {
+        budget.set_limit(13);
+        budget.enforce();
+        REQUIRE(calls == std::vector<std::string>{"over"});
+        REQUIRE(budget.used() == 12);
+    }
+
+    SECTION("Goes down to 7/8 of the limit") {
+        budget.set_limit(12);
+        budget.enforce();
+        REQUIRE(calls == std::vector<std::string>{"over", "low"});
+        REQUIRE(budget.used() == 11);
+        REQUIRE(low.bytes == 3);
+    }
+
+    SECTION("Detach") {
+        budget.detach(t_normal);
+        budget.set_limit(1);
+        budget.enforce();
+        REQUIRE(calls == std::vector<std::string>{"over", "low"});
+        REQUIRE(budget.used() == 8);
+    }
+}
@@ -95,4 +95,78 @@ TEMPLATE_LIST_TEST_CASE("Map", "", test_types) {
         REQUIRE(pbackup->count(default_key));
         REQUIRE(pbackup->at(default_key).get() == default_value);
     }
+
+    SECTION("read through") {
+        auto pdisk = std::make_unique<map_type>(val);
+        auto disk  = pdisk.get();
+        map_type lazy(std::move(pdisk), true);
+
+        // Nothing is loaded until it's needed
+        REQUIRE(lazy.map() == default_map);
+        REQUIRE(lazy.count(default_key));
+        REQUIRE(lazy.keys() == key_set_type{default_key});
+        REQUIRE(lazy.map() == default_map);
+
+        REQUIRE(lazy.at(default_key).get() == default_value);
+        REQUIRE(lazy.map() == val);
+
+        // Loaded values aren't written back
+        disk->free(default_key);
+        lazy.backup();
+        REQUIRE_FALSE(disk->count(default_key));
+
+        // Freeing also frees in the backup
+        lazy.insert(default_key, default_value);
+        lazy.backup();
+        REQUIRE(disk->count(default_key));
+        lazy.free(default_key);
+        REQUIRE_FALSE(lazy.count(default_key));
+        REQUIRE_FALSE(disk->count(default_key));
+        REQUIRE_THROWS_AS(lazy.at(default_key), std::out_of_range);
+    }
+}
+
+TEST_CASE("Native : cursors") {
+    using db_type      = Native<std::string, int>;
+    using key_set_type = typename db_type::key_set_type;
+
+    auto drain = [](auto c) {
+        key_set_type rv;
+        for(; c->valid(); c->next()) rv.push_back(c->key());
+        return rv;
+    };
+
+    auto pdisk = std::make_unique<db_type>();
+    pdisk->insert("a1", 0);
+    pdisk->insert("b2", 1);
+    db_type db(std::move(pdisk), true);
+    db.insert("a2", 2);
+    db.insert("b1", 3);
+    db.at("b2"); // Loaded, so not repeated by the backup's cursor
+
+    SECTION("cursor") {
+        REQUIRE(drain(db.cursor()) == key_set_type{"a2", "b1", "b2", "a1"});
+        REQUIRE(drain(db.cursor()) == db.keys());
+        REQUIRE_FALSE(db_type{}.cursor()->valid());
+    }
+
+    SECTION("range") {
+        REQUIRE(drain(db.range("a2", "b2")) == key_set_type{"a2", "b1"});
+        REQUIRE(drain(db.range("b", "z")) == key_set_type{"b1", "b2"});
+        REQUIRE(drain(db.range("a", "b")) == key_set_type{"a2", "a1"});
+        REQUIRE(drain(db.range("z", "a")).empty());
+    }
+
+    SECTION("prefix") {
+        REQUIRE(drain(db.prefix("a")) == key_set_type{"a2", "a1"});
+        REQUIRE(drain(db.prefix("b1")) == key_set_type{"b1"});
+        REQUIRE(drain(db.prefix("c")).empty());
+        REQUIRE(drain(db.prefix("")) == db.keys());
+    }
+
+    SECTION("Keys which aren't strings") {
+        Native<int, int> ints(Native<int, int>::map_type{{1, 1}, {2, 2}});
+        REQUIRE(ints.range(2, 3)->key() == 2);
+        REQUIRE_THROWS_AS(ints.prefix(1), std::runtime_error);
+    }
 }
@@ -0,0 +1,603 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cstdint>
+#include <map>
+#include <pluginplay/cache/database/memory_budget.hpp>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/native_hashed.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace pluginplay::cache::database;
+
+using id_pair    = std::pair<int, double>;
+using si_pair    = std::pair<std::string, int>;
+using test_types = std::tuple<id_pair, si_pair>;
+
+TEMPLATE_LIST_TEST_CASE("NativeHashed", "", test_types) {
+    using value_type  = TestType;
+    using key_type    = std::tuple_element_t<0, value_type>;
+    using mapped_type = std::tuple_element_t<1, value_type>;
+
+    using db_type      = NativeHashed<key_type, mapped_type>;
+    using key_set_type = typename db_type::key_set_type;
+
+    key_type default_key{};
+    mapped_type default_value{};
+
+    auto backup  = std::make_unique<db_type>();
+    auto pbackup = backup.get();
+
+    db_type defaulted;
+    db_type has_val;
+    has_val.insert(default_key, default_value);
+    db_type has_backup(std::move(backup));
+    has_backup.insert(default_key, default_value);
+
+    SECTION("Ctors") {
+        REQUIRE(defaulted.size() == 0);
+        REQUIRE(defaulted.capacity() == 0);
+        REQUIRE(has_val.size() == 1);
+        REQUIRE(has_backup.size() == 1);
+    }
+
+    SECTION("keys") {
+        REQUIRE(defaulted.keys() == key_set_type{});
+        REQUIRE(has_val.keys() == key_set_type{default_key});
+        REQUIRE(has_backup.keys() == key_set_type{default_key});
+    }
+
+    SECTION("Count") {
+        REQUIRE_FALSE(defaulted.count(default_key));
+        REQUIRE(has_val.count(default_key));
+        REQUIRE(has_backup.count(default_key));
+    }
+
+    SECTION("insert") {
+        defaulted.insert(default_key, default_value);
+        REQUIRE(defaulted.size() == 1);
+        REQUIRE(defaulted.at(default_key).get() == default_value);
+
+        // Overwrites
+        mapped_type other_value{1};
+        defaulted.insert(default_key, other_value);
+        REQUIRE(defaulted.size() == 1);
+        REQUIRE(defaulted.at(default_key).get() == other_value);
+    }
+
+    SECTION("free") {
+        has_val.free(default_key);
+        REQUIRE_FALSE(has_val.count(default_key));
+        REQUIRE(has_val.size() == 0);
+
+        has_backup.free(default_key);
+        REQUIRE_FALSE(has_backup.count(default_key));
+
+        // Freeing a non-existent key is a no-op
+        defaulted.free(default_key);
+        REQUIRE(defaulted.size() == 0);
+    }
+
+    SECTION("at") {
+        REQUIRE(has_val.at(default_key).get() == default_value);
+        REQUIRE(has_backup.at(default_key).get() == default_value);
+        REQUIRE_THROWS_AS(defaulted.at(default_key), std::out_of_range);
+    }
+
+    SECTION("backup") {
+        has_backup.backup();
+        REQUIRE(has_backup.count(default_key));
+        REQUIRE(pbackup->count(default_key));
+        REQUIRE(pbackup->at(default_key).get() == default_value);
+    }
+
+    SECTION("dump") {
+        has_val.dump();
+        REQUIRE_FALSE(has_val.count(default_key));
+
+        has_backup.dump();
+        REQUIRE_FALSE(has_backup.count(default_key));
+        REQUIRE(pbackup->count(default_key));
+        REQUIRE(pbackup->at(default_key).get() == default_value);
+    }
+
+    SECTION("read through") {
+        auto pdisk = std::make_unique<db_type>();
+        auto disk  = pdisk.get();
+        disk->insert(default_key, default_value);
+        db_type lazy(std::move(pdisk), true);
+
+        // Nothing is loaded until it's needed
+        REQUIRE(lazy.size() == 0);
+        REQUIRE(lazy.count(default_key));
+        REQUIRE(lazy.keys() == key_set_type{default_key});
+        REQUIRE(lazy.size() == 0);
+
+        REQUIRE(lazy.at(default_key).get() == default_value);
+        REQUIRE(lazy.size() == 1);
+
+        // Only dirty values are written back
+        disk->free(default_key);
+        lazy.backup();
+        REQUIRE_FALSE(disk->count(default_key));
+        lazy.insert(default_key, default_value);
+        lazy.backup();
+        REQUIRE(disk->count(default_key));
+
+        // Freeing also frees in the backup
+        lazy.free(default_key);
+        REQUIRE_FALSE(lazy.count(default_key));
+        REQUIRE_FALSE(disk->count(default_key));
+        REQUIRE_THROWS_AS(lazy.at(default_key), std::out_of_range);
+    }
+}
+
+TEST_CASE("NativeHashed : many keys") {
+    NativeHashed<int, int> db;
+    const int n = 1000;
+    for(int i = 0; i < n; ++i) db.insert(i, 2 * i);
+
+    REQUIRE(db.size() == n);
+    REQUIRE(db.capacity() >= n);
+    for(int i = 0; i < n; ++i) REQUIRE(db.at(i).get() == 2 * i);
+
+    auto keys = db.keys();
+    std::sort(keys.begin(), keys.end());
+    for(int i = 0; i < n; ++i) REQUIRE(keys[i] == i);
+
+    // Free every other key, the remaining keys must still be reachable
+    for(int i = 0; i < n; i += 2) db.free(i);
+    REQUIRE(db.size() == n / 2);
+    for(int i = 0; i < n; ++i) {
+        if(i % 2) {
+            REQUIRE(db.at(i).get() == 2 * i);
+        } else {
+            REQUIRE_FALSE(db.count(i));
+        }
+    }
+}
+
+TEST_CASE("NativeHashed : tiers") {
+    using db_type = NativeHashed<int, int>;
+    auto pdisk    = std::make_unique<db_type>();
+    auto disk     = pdisk.get();
+    auto tiers    = std::make_shared<TierState>();
+    db_type db(std::move(pdisk), true, tiers);
+
+    SECTION("No limit") {
+        for(int i = 0; i < 10; ++i) db.insert(i, i);
+        REQUIRE(db.size() == 10);
+        REQUIRE(tiers->demotions == 0);
+    }
+
+    SECTION("Promotion") {
+        disk->insert(1, 2);
+        REQUIRE(db.count(1));
+        REQUIRE(tiers->promotions == 0);
+        REQUIRE(db.at(1).get() == 2);
+        REQUIRE(db.at(1).get() == 2);
+        REQUIRE(tiers->promotions == 1);
+    }
+
+    SECTION("Demotion") {
+        tiers->max_size = 2;
+        db.insert(0, 0);
+        db.insert(1, 1);
+        REQUIRE(db.at(0).get() == 0); // 1 is now the least recently used
+        db.insert(2, 2);
+        REQUIRE(db.size() == 2);
+        REQUIRE(tiers->demotions == 1);
+
+        // Demoted pair was backed up and is still part of the database
+        REQUIRE(disk->count(1));
+        REQUIRE_FALSE(disk->count(0));
+        REQUIRE(db.count(1));
+        REQUIRE(db.at(1).get() == 1);
+        REQUIRE(tiers->promotions == 1);
+        REQUIRE(db.size() == 2);
+        REQUIRE(tiers->demotions == 2);
+        REQUIRE(disk->count(0));
+        for(int i = 0; i < 3; ++i) REQUIRE(db.at(i).get() == i);
+    }
+
+    SECTION("Not reading through") {
+        db_type memory_only({}, false, tiers);
+        tiers->max_size = 1;
+        memory_only.insert(0, 0);
+        memory_only.insert(1, 1);
+        REQUIRE(memory_only.size() == 2);
+        REQUIRE(tiers->demotions == 0);
+    }
+}
+
+TEST_CASE("NativeHashed : cold values") {
+    using db_type    = NativeHashed<int, std::string>;
+    using codec_type = typename db_type::cold_codec_type;
+    auto tiers       = std::make_shared<TierState>();
+
+    // Stands in for serializing and compressing, "!" can't be compressed
+    codec_type cold;
+    cold.compress = [](const std::string& value) {
+        if(value == "!") throw std::runtime_error("Not serializable");
+        return "z" + value;
+    };
+    cold.decompress = [](const std::string& z) { return z.substr(1); };
+
+    // Sweeps are spread out, so use enough accesses to trigger several
+    auto use = [](db_type& db, int key, int n) {
+        for(int i = 0; i < n; ++i) db.at(key);
+    };
+
+    SECTION("Off by default") {
+        db_type db({}, false, tiers, cold);
+        for(int i = 0; i < 4; ++i) db.insert(i, std::to_string(i));
+        use(db, 0, 64);
+        REQUIRE(tiers->compressions == 0);
+    }
+
+    SECTION("Idle for N accesses") {
+        tiers->cold_after_accesses = 8;
+        db_type db({}, false, tiers, cold);
+        for(int i = 0; i < 4; ++i) db.insert(i, std::to_string(i));
+        use(db, 0, 64);
+        REQUIRE(tiers->compressions == 3);
+        REQUIRE(db.size() == 4);
+        REQUIRE(db.count(1));
+
+        REQUIRE(db.at(1).get() == "1");
+        REQUIRE(tiers->decompressions == 1);
+        REQUIRE(db.at(1).get() == "1");
+        REQUIRE(tiers->decompressions == 1);
+        REQUIRE(db.at(0).get() == "0");
+    }
+
+    SECTION("Idle for some time") {
+        tiers->cold_after_ns = 1;
+        db_type db({}, false, tiers, cold);
+        db.insert(1, "1");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for(int i = 0; i < 32; ++i) db.insert(2, "2");
+        REQUIRE(tiers->compressions >= 1);
+        REQUIRE(db.at(1).get() == "1");
+    }
+
+    SECTION("Can't compress") {
+        tiers->cold_after_accesses = 8;
+        db_type db({}, false, tiers, cold);
+        db.insert(1, "!");
+        db.insert(2, "2");
+        use(db, 2, 64);
+        REQUIRE(tiers->compressions == 0);
+        REQUIRE(db.at(1).get() == "!");
+    }
+
+    SECTION("Overwriting a cold value") {
+        tiers->cold_after_accesses = 8;
+        db_type db({}, false, tiers, cold);
+        db.insert(1, "1");
+        db.insert(2, "2");
+        use(db, 2, 64);
+        REQUIRE(tiers->compressions == 1);
+        db.insert(1, "one");
+        REQUIRE(db.at(1).get() == "one");
+        REQUIRE(tiers->decompressions == 0);
+    }
+
+    SECTION("Backs up before compressing") {
+        tiers->cold_after_accesses = 8;
+        auto pdisk = std::make_unique<db_type>();
+        auto disk  = pdisk.get();
+        db_type db(std::move(pdisk), true, tiers, cold);
+        db.insert(1, "1");
+        db.insert(2, "2");
+        use(db, 2, 64);
+        REQUIRE(tiers->compressions == 1);
+        REQUIRE(disk->count(1));
+        REQUIRE(disk->at(1).get() == "1");
+        REQUIRE_FALSE(disk->count(2));
+
+        db.dump();
+        REQUIRE(disk->at(2).get() == "2");
+        REQUIRE(db.at(1).get() == "1");
+    }
+
+    SECTION("Free") {
+        tiers->cold_after_accesses = 8;
+        db_type db({}, false, tiers, cold);
+        db.insert(1, "1");
+        db.insert(2, "2");
+        use(db, 2, 64);
+        db.free(1);
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE(db.size() == 1);
+    }
+}
+
+TEST_CASE("NativeHashed : expiration") {
+    using db_type     = NativeHashed<int, int>;
+    auto tiers        = std::make_shared<TierState>();
+    auto generation   = std::make_shared<TierState::counter_type>(0);
+    tiers->generation = generation;
+
+    SECTION("Time to live") {
+        db_type db({}, false, tiers);
+        db.insert(1, 1);
+        tiers->ttl_ns = std::int64_t{3600} * 1000000000;
+        REQUIRE(db.count(1));
+
+        tiers->ttl_ns = 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE_THROWS_AS(db.at(1), std::out_of_range);
+
+        // Overwriting makes the pair fresh
+        db.insert(1, 2);
+        tiers->ttl_ns = std::int64_t{3600} * 1000000000;
+        REQUIRE(db.at(1).get() == 2);
+    }
+
+    SECTION("Generation") {
+        db_type db({}, false, tiers);
+        db.insert(1, 1);
+        db.insert(2, 2);
+        ++*generation;
+        REQUIRE_FALSE(db.count(1));
+        db.insert(1, 3);
+        REQUIRE(db.count(1));
+        REQUIRE(db.at(1).get() == 3);
+        REQUIRE_FALSE(db.count(2));
+    }
+
+    SECTION("Reclaims stale pairs") {
+        db_type db({}, false, tiers);
+        for(int i = 0; i < 10; ++i) db.insert(i, i);
+        ++*generation;
+        db.insert(10, 10);
+        for(int i = 0; i < 64; ++i) db.at(10);
+        REQUIRE(db.size() == 1);
+        REQUIRE(tiers->expirations == 10);
+        REQUIRE(db.at(10).get() == 10);
+    }
+
+    SECTION("Reading through") {
+        auto pdisk = std::make_unique<db_type>();
+        auto disk  = pdisk.get();
+        disk->insert(1, 1);
+        db_type db(std::move(pdisk), true, tiers);
+        db.insert(2, 2);
+        db.backup();
+        REQUIRE(db.count(1));
+
+        ++*generation;
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE_FALSE(db.count(2));
+        REQUIRE_THROWS_AS(db.at(1), std::out_of_range);
+        REQUIRE_THROWS_AS(db.at(2), std::out_of_range);
+
+        // Reclaiming the pair in memory also frees the backed up copy
+        db.insert(3, 3);
+        for(int i = 0; i < 64; ++i) db.at(3);
+        REQUIRE(tiers->expirations == 1);
+        REQUIRE_FALSE(disk->count(2));
+        REQUIRE_FALSE(db.count(2));
+    }
+
+    SECTION("Demoted pairs keep their stamps") {
+        db_type db(std::make_unique<db_type>(), true, tiers);
+        tiers->max_size = 1;
+
+        // Inserted after the instance was made, so they're newer than it
+        ++*generation;
+        db.insert(1, 1);
+        db.insert(2, 2);
+        REQUIRE(tiers->demotions == 1);
+        REQUIRE(db.count(1));
+        REQUIRE(db.at(1).get() == 1);
+        REQUIRE(tiers->promotions == 1);
+
+        // 2 was demoted when 1 was loaded, it still knows its generation
+        REQUIRE(tiers->demotions == 2);
+        REQUIRE(db.count(2));
+        ++*generation;
+        REQUIRE_FALSE(db.count(2));
+        REQUIRE_THROWS_AS(db.at(2), std::out_of_range);
+    }
+}
+
+TEST_CASE("NativeHashed : quotas") {
+    using db_type = NativeHashed<int, std::string>;
+    auto tiers    = std::make_shared<TierState>();
+    auto sizer    = [](const std::string& value) { return value.size(); };
+
+    SECTION("Counts usage") {
+        db_type db({}, false, tiers, {}, sizer);
+        db.insert(1, "a");
+        db.insert(2, "bb");
+        REQUIRE(tiers->entries == 2);
+        REQUIRE(tiers->bytes == 3);
+        db.insert(2, "bbbb");
+        REQUIRE(tiers->bytes == 5);
+        db.free(1);
+        REQUIRE(tiers->entries == 1);
+        REQUIRE(tiers->bytes == 4);
+        db.dump();
+        REQUIRE(tiers->entries == 0);
+        REQUIRE(tiers->bytes == 0);
+    }
+
+    SECTION("Entries") {
+        tiers->max_entries = 2;
+        db_type db({}, false, tiers, {}, sizer);
+        db.insert(0, "0");
+        db.insert(1, "1");
+        REQUIRE(db.at(0).get() == "0"); // 1 is now the least recently used
+        db.insert(2, "2");
+        REQUIRE(db.size() == 2);
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE(tiers->evictions == 1);
+        REQUIRE(tiers->demotions == 0);
+    }
+
+    SECTION("Bytes") {
+        tiers->max_bytes = 8;
+        db_type db({}, false, tiers, {}, sizer);
+        db.insert(0, "0000");
+        db.insert(1, "1111");
+        db.insert(2, "22");
+        REQUIRE(db.size() == 2);
+        REQUIRE_FALSE(db.count(0));
+        REQUIRE(tiers->bytes == 6);
+
+        // The most recently used pair is kept, even if it's too big
+        db.insert(3, std::string(16, '3'));
+        REQUIRE(db.size() == 1);
+        REQUIRE(db.count(3));
+    }
+
+    SECTION("Demotes in read-through mode") {
+        tiers->max_entries = 1;
+        auto pdisk         = std::make_unique<db_type>();
+        auto disk          = pdisk.get();
+        db_type db(std::move(pdisk), true, tiers, {}, sizer);
+        db.insert(0, "0");
+        db.insert(1, "1");
+        REQUIRE(db.size() == 1);
+        REQUIRE(tiers->demotions == 1);
+        REQUIRE(tiers->evictions == 0);
+        REQUIRE(disk->count(0));
+        REQUIRE(db.at(0).get() == "0");
+    }
+
+    SECTION("Budget") {
+        auto budget   = std::make_shared<MemoryBudget>();
+        auto low      = std::make_shared<TierState>();
+        low->budget   = budget;
+        low->priority = 0;
+        tiers->budget = budget;
+        db_type db({}, false, tiers, {}, sizer);
+        db_type low_db({}, false, low, {}, sizer);
+        budget->set_limit(8);
+
+        low_db.insert(0, "0000");
+        low_db.insert(1, "1111");
+        db.insert(0, "0000");
+        REQUIRE(budget->used() <= 8);
+        REQUIRE(low_db.size() == 1);
+        REQUIRE(db.size() == 1);
+        REQUIRE(low->evictions == 1);
+    }
+}
+
+TEST_CASE("NativeHashed : map keys") {
+    using key_type = std::map<std::string, std::string>;
+    NativeHashed<key_type, int> db;
+
+    key_type k0{{"a", "1"}, {"b", "2"}};
+    key_type k1{{"a", "2"}, {"b", "1"}};
+    db.insert(k0, 0);
+    db.insert(k1, 1);
+
+    REQUIRE(DBHash<key_type>{}(k0) == DBHash<key_type>{}(key_type(k0)));
+    REQUIRE(db.at(k0).get() == 0);
+    REQUIRE(db.at(k1).get() == 1);
+    REQUIRE_FALSE(db.count(key_type{{"a", "1"}}));
+}
+
+TEST_CASE("NativeHashed : cursors") {
+    using db_type      = NativeHashed<std::string, int>;
+    using key_set_type = typename db_type::key_set_type;
+
+    auto drain = [](auto c) {
+        key_set_type rv;
+        for(; c->valid(); c->next()) rv.push_back(c->key());
+        std::sort(rv.begin(), rv.end());
+        return rv;
+    };
+
+    auto pdisk = std::make_unique<Native<std::string, int>>();
+    pdisk->insert("a1", 0);
+    pdisk->insert("b2", 1);
+    db_type db(std::move(pdisk), true);
+    db.insert("a2", 2);
+    db.insert("b1", 3);
+    db.at("b2");
+
+    // Hashed keys aren't sorted, so range and prefix filter the cursor
+    REQUIRE(drain(db.cursor()) == key_set_type{"a1", "a2", "b1", "b2"});
+    REQUIRE(drain(db.range("a2", "b2")) == key_set_type{"a2", "b1"});
+    REQUIRE(drain(db.prefix("b")) == key_set_type{"b1", "b2"});
+
+    NativeHashed<std::map<std::string, int*>, int> unordered;
+    REQUIRE_THROWS_AS(unordered.range({}, {}), std::runtime_error);
+    REQUIRE_THROWS_AS(unordered.prefix({}), std::runtime_error);
+}
+
+// Compares lookups in Native and NativeHashed when the keys are proxy maps
+// Run with: unit_test_pluginplay "[benchmark]"
+TEST_CASE("NativeHashed vs. Native", "[.][benchmark]") {
+    using key_type = std::map<std::string, std::string>;
+
+    // Mimics proxy maps: a handful of fields mapped to 36 character UUIDs
+    auto make_key = [](std::size_t i) {
+        key_type rv;
+        for(std::size_t j = 0; j < 6; ++j) {
+            auto field = "field " + std::to_string(j);
+            auto id    = std::to_string(i * 6 + j);
+            rv.emplace(field, std::string(36 - id.size(), '0') + id);
+        }
+        return rv;
+    };
+
+    const std::size_t n = 5000;
+    std::vector<key_type> keys;
+    for(std::size_t i = 0; i < n; ++i) keys.push_back(make_key(i));
+
+    Native<key_type, std::size_t> native;
+    NativeHashed<key_type, std::size_t> hashed;
+    for(std::size_t i = 0; i < n; ++i) {
+        native.insert(keys[i], i);
+        hashed.insert(keys[i], i);
+    }
+
+    BENCHMARK("Native::at") {
+        std::size_t sum = 0;
+        for(const auto& k : keys) sum += native.at(k).get();
+        return sum;
+    };
+
+    BENCHMARK("NativeHashed::at") {
+        std::size_t sum = 0;
+        for(const auto& k : keys) sum += hashed.at(k).get();
+        return sum;
+    };
+
+    BENCHMARK("Native::insert") {
+        Native<key_type, std::size_t> db;
+        for(std::size_t i = 0; i < n; ++i) db.insert(keys[i], i);
+        return db.count(keys[0]);
+    };
+
+    BENCHMARK("NativeHashed::insert") {
+        NativeHashed<key_type, std::size_t> db;
+        for(std::size_t i = 0; i < n; ++i) db.insert(keys[i], i);
+        return db.count(keys[0]);
+    };
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <algorithm>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/overlay.hpp>
+
+using namespace pluginplay::cache::database;
+
+TEST_CASE("Overlay") {
+    using db_type      = Native<std::string, std::string>;
+    using overlay_type = Overlay<std::string, std::string>;
+    using key_set_type = typename overlay_type::key_set_type;
+
+    auto pbase = std::make_unique<db_type>();
+    pbase->insert("shared", "base");
+    pbase->insert("shadowed", "base");
+    auto pbase_raw = pbase.get();
+    auto ptop      = std::make_unique<db_type>();
+    auto ptop_raw  = ptop.get();
+    overlay_type db(std::move(pbase), std::move(ptop));
+    db.insert("shadowed", "overlay");
+    db.insert("new", "overlay");
+
+    SECTION("CTor") {
+        REQUIRE_THROWS_AS(overlay_type(nullptr, std::make_unique<db_type>()),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(overlay_type(std::make_unique<db_type>(), nullptr),
+                          std::runtime_error);
+        REQUIRE(&db.base() == pbase_raw);
+        REQUIRE(&db.overlay() == ptop_raw);
+    }
+
+    SECTION("keys") {
+        auto keys = db.keys();
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys == key_set_type{"new", "shadowed", "shared"});
+    }
+
+    SECTION("cursor/range/prefix") {
+        auto drain = [](auto c) {
+            key_set_type rv;
+            for(; c->valid(); c->next()) rv.push_back(c->key());
+            return rv;
+        };
+        db.free("shared");
+        REQUIRE(drain(db.cursor()) == key_set_type{"new", "shadowed"});
+        REQUIRE(drain(db.cursor()) == db.keys());
+        REQUIRE(drain(db.range("s", "t")) == key_set_type{"shadowed"});
+        REQUIRE(drain(db.prefix("sh")) == key_set_type{"shadowed"});
+        db.insert("shared", "overlay");
+        REQUIRE(drain(db.prefix("sh")) == key_set_type{"shadowed", "shared"});
+    }
+
+    SECTION("count/at") {
+        REQUIRE(db.count("shared"));
+        REQUIRE(db.at("shared").get() == "base");
+        REQUIRE(db.at("shadowed").get() == "overlay");
+        REQUIRE(db.at("new").get() == "overlay");
+        REQUIRE_FALSE(db.count("not a key"));
+        REQUIRE_THROWS_AS(db.at("not a key"), std::out_of_range);
+    }
+
+    SECTION("insert") {
+        // Writes never reach the base
+        REQUIRE(pbase_raw->at("shadowed").get() == "base");
+        REQUIRE_FALSE(pbase_raw->count("new"));
+        REQUIRE(ptop_raw->at("shadowed").get() == "overlay");
+    }
+
+    SECTION("free") {
+        db.free("shared");
+        REQUIRE_FALSE(db.count("shared"));
+        REQUIRE(pbase_raw->count("shared"));
+        REQUIRE(db.keys().size() == 2);
+
+        db.free("shadowed");
+        REQUIRE_FALSE(db.count("shadowed"));
+
+        // Re-inserting un-hides the key
+        db.insert("shared", "again");
+        REQUIRE(db.at("shared").get() == "again");
+    }
+
+    SECTION("backup/dump") {
+        db.backup();
+        REQUIRE(db.at("new").get() == "overlay");
+
+        // Only the overlay is dumped
+        db.dump();
+        REQUIRE_FALSE(ptop_raw->count("new"));
+        REQUIRE(db.at("shared").get() == "base");
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/proxy_map_codec.hpp>
+
+using namespace pluginplay::cache::database;
+
+TEST_CASE("ProxyMapCodec") {
+    using codec_type     = ProxyMapCodec;
+    using proxy_map_type = typename codec_type::proxy_map_type;
+    using binary_type    = typename codec_type::binary_type;
+    using db_type        = Native<binary_type, binary_type>;
+
+    const std::string uuid0 = "0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0";
+    const std::string uuid1 = "00000000-0000-0000-0000-000000000001";
+    proxy_map_type pm{{"Module", uuid0}, {"Option", uuid1}, {"x", "not"}};
+
+    db_type db;
+    codec_type codec(db);
+
+    SECTION("Round trip") {
+        binary_type bytes;
+        REQUIRE(codec.encode(pm, bytes, true));
+        REQUIRE(codec_type::is_encoded(bytes));
+        REQUIRE(codec.decode(bytes) == pm);
+
+        // A fresh codec reads the names back out of the database
+        codec_type codec2(db);
+        REQUIRE(codec2.decode(bytes) == pm);
+    }
+
+    SECTION("Empty map") {
+        binary_type bytes;
+        REQUIRE(codec.encode(proxy_map_type{}, bytes, true));
+        REQUIRE(codec.decode(bytes) == proxy_map_type{});
+    }
+
+    SECTION("Compact") {
+        // Marker, 3 * (flags + ID), 2 UUIDs, then the size of "not" and it
+        binary_type bytes;
+        codec.encode(pm, bytes, true);
+        REQUIRE(bytes.size() == 1 + 3 * 5 + 2 * 16 + 1 + 3);
+    }
+
+    SECTION("Canonical") {
+        binary_type bytes0, bytes1;
+        codec.encode(pm, bytes0, true);
+        codec_type codec2(db);
+        codec2.encode(pm, bytes1, true);
+        REQUIRE(bytes0 == bytes1);
+
+        // Names are saved once
+        REQUIRE(db.keys().size() == 3);
+    }
+
+    SECTION("Names are saved") {
+        binary_type bytes;
+        codec.encode(pm, bytes, true);
+        for(const auto& [name, _] : pm) {
+            binary_type key(1, codec_type::name_marker);
+            for(int shift = 24; shift >= 0; shift -= 8)
+                key.push_back((codec_type::name_id(name) >> shift) & 0xFF);
+            REQUIRE(codec_type::is_name(key));
+            REQUIRE(db.at(key).get() == name);
+        }
+    }
+
+    SECTION("Lookups don't save names") {
+        binary_type bytes;
+        REQUIRE_FALSE(codec.encode(pm, bytes, false));
+        REQUIRE(db.keys().empty());
+
+        codec.encode(pm, bytes, true);
+        binary_type bytes2;
+        REQUIRE(codec.encode(pm, bytes2, false));
+        REQUIRE(bytes2 == bytes.substr(bytes.size() - bytes2.size()));
+    }
+
+    SECTION("Injected fields") {
+        using field_type = typename codec_type::field_type;
+        for(const auto* name : {"A", "N", "Z", "x"}) {
+            const field_type injected(name, uuid1);
+            auto full = pm;
+            full.emplace(injected);
+
+            binary_type bytes, expected;
+            REQUIRE(codec.encode(pm, bytes, true, &injected));
+            REQUIRE(codec.encode(full, expected, true));
+            REQUIRE(bytes == expected);
+            REQUIRE(codec.decode(bytes) == full);
+        }
+    }
+
+    SECTION("Values which aren't canonical UUIDs are kept as is") {
+        proxy_map_type pm2{{"a", "0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0"},
+                           {"b", "0f1e2d3c+4b5a-6978-8796-a5b4c3d2e1f0"},
+                           {"c", ""},
+                           {"d", std::string(300, 'x')}};
+        binary_type bytes;
+        codec.encode(pm2, bytes, true);
+        REQUIRE(codec.decode(bytes) == pm2);
+    }
+
+    SECTION("Names whose IDs are taken are written in full") {
+        binary_type key(1, codec_type::name_marker);
+        for(int shift = 24; shift >= 0; shift -= 8)
+            key.push_back((codec_type::name_id("Module") >> shift) & 0xFF);
+        db.insert(key, "Not Module");
+
+        binary_type bytes;
+        REQUIRE(codec.encode(pm, bytes, true));
+        REQUIRE(codec.decode(bytes) == pm);
+        REQUIRE(db.at(key).get() == "Not Module");
+    }
+
+    SECTION("clear") {
+        binary_type bytes;
+        codec.encode(pm, bytes, true);
+        db.dump();
+        codec.clear();
+        REQUIRE_THROWS_AS(codec.decode(bytes), std::runtime_error);
+    }
+
+    SECTION("Invalid encodings") {
+        REQUIRE_THROWS_AS(codec.decode(""), std::runtime_error);
+        REQUIRE_THROWS_AS(codec.decode("abc"), std::runtime_error);
+
+        binary_type bytes;
+        codec.encode(pm, bytes, true);
+        bytes.pop_back();
+        REQUIRE_THROWS_AS(codec.decode(bytes), std::runtime_error);
+    }
+}
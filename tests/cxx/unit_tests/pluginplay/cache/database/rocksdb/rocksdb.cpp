@@ -77,6 +77,83 @@ TEST_CASE("RocksDB") {
         REQUIRE_THROWS_AS(defaulted.free(""), std::runtime_error);
     }
 
+    SECTION("column families") {
+        auto pfamily = db.column_family("family");
+        REQUIRE(db.has_column_family("family"));
+        REQUIRE(db.column_families().size() >= 2);
+
+        // Keys don't leak between column families
+        REQUIRE_FALSE(pfamily->count("Hello"));
+        pfamily->insert("Hello", "Family");
+        REQUIRE(pfamily->at("Hello").get() == "Family");
+        REQUIRE(db.at("Hello").get() == "World");
+
+        // Dropping empties the family, but instances remain usable
+        db.drop_column_family("family");
+        REQUIRE(db.has_column_family("family"));
+        REQUIRE_FALSE(pfamily->count("Hello"));
+        pfamily->insert("Hello", "Again");
+        REQUIRE(pfamily->at("Hello").get() == "Again");
+        db.drop_column_family("family");
+
+        REQUIRE_THROWS_AS(db.drop_column_family("default"),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(defaulted.column_family("family"),
+                          std::runtime_error);
+    }
+
+    SECTION("options") {
+        auto p2 = std::filesystem::temp_directory_path() / "test_options.db";
+        std::filesystem::remove_all(p2);
+
+        pluginplay::cache::RocksDBOptions opts;
+        opts.block_cache_size   = 1 << 20;
+        opts.bloom_bits_per_key = 10.0;
+        opts.compaction_style   = pluginplay::cache::CompactionStyle::universal;
+        opts.write_buffer_size  = 1 << 20;
+        auto fxn = [opts](const std::string&) { return opts; };
+
+        {
+            RocksDBSS tuned(p2.string(), false, fxn);
+            auto pfamily = tuned.column_family("family");
+            pfamily->insert("Hello", "World");
+            REQUIRE(pfamily->at("Hello").get() == "World");
+        }
+
+        // Reopening opens the existing column families
+        RocksDBSS tuned(p2.string(), true, fxn);
+        REQUIRE(tuned.has_column_family("family"));
+        REQUIRE(tuned.column_family("family")->at("Hello").get() == "World");
+        REQUIRE_THROWS_AS(tuned.column_family("new"), std::runtime_error);
+        std::filesystem::remove_all(p2);
+    }
+
+    SECTION("cursors") {
+        using key_set_type = std::vector<std::string>;
+        auto drain         = [](auto c) {
+            key_set_type rv;
+            for(; c->valid(); c->next()) rv.push_back(c->key());
+            return rv;
+        };
+        db.drop_column_family("cursors");
+        auto pfamily = db.column_family("cursors");
+        for(const auto* k : {"b1", "a1", "a2", "c"}) pfamily->insert(k, "v");
+
+        // Keys come back sorted, and range/prefix seek to the first match
+        key_set_type corr{"a1", "a2", "b1", "c"};
+        REQUIRE(drain(pfamily->cursor()) == corr);
+        REQUIRE(drain(pfamily->cursor()) == pfamily->keys());
+        REQUIRE(drain(pfamily->range("a2", "c")) == key_set_type{"a2", "b1"});
+        REQUIRE(drain(pfamily->prefix("a")) == key_set_type{"a1", "a2"});
+        REQUIRE(drain(pfamily->prefix("d")).empty());
+
+        // Cursors read from a snapshot
+        auto c = pfamily->cursor();
+        pfamily->insert("0", "v");
+        REQUIRE(drain(std::move(c)) == corr);
+        db.drop_column_family("cursors");
+    }
+
     SECTION("backup") {}
 
     SECTION("dump") {}
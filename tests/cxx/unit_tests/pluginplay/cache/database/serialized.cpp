@@ -16,8 +16,11 @@
 
 #include "../../catch.hpp"
 #include "../lexical_cast.hpp"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <map>
 #include <pluginplay/cache/database/native.hpp>
 #include <pluginplay/cache/database/serialized.hpp>
+#include <set>
 #include <sstream>
 
 /* Testing Strategy:
@@ -102,3 +105,262 @@ TEMPLATE_LIST_TEST_CASE("Serialized", "", test_types) {
         REQUIRE_FALSE(smap.count(key0));
     }
 }
+
+TEST_CASE("Serialized : format") {
+    using serialized_type = Serialized<std::string, std::string>;
+    using binary_type     = typename serialized_type::binary_type;
+    using sub_db_type     = Native<binary_type, binary_type>;
+
+    // What the keys/values looked like when serialized via std::stringstream
+    auto old_format = [](const std::string& x) {
+        std::stringstream ss;
+        cereal::BinaryOutputArchive ar(ss);
+        ar << x;
+        return ss.str();
+    };
+
+    auto pdb  = std::make_unique<sub_db_type>();
+    auto* sub = pdb.get();
+    serialized_type smap(std::move(pdb));
+
+    SECTION("Writes the same bytes") {
+        smap.insert("key", "value");
+        REQUIRE(sub->count(old_format("key")));
+        REQUIRE(sub->at(old_format("key")).get() == old_format("value"));
+    }
+
+    SECTION("Reads the same bytes") {
+        sub->insert(old_format("key"), old_format("value"));
+        REQUIRE(smap.count("key"));
+        REQUIRE(smap.at("key").get() == "value");
+    }
+
+    SECTION("Large values") {
+        std::string value(std::size_t{3} << 20, 'x');
+        smap.insert("key", value);
+        REQUIRE(smap.at("key").get() == value);
+        REQUIRE(smap.at("key").get() == value);
+    }
+}
+
+TEST_CASE("Serialized : proxy map keys") {
+    using proxy_map       = std::map<std::string, std::string>;
+    using serialized_type = Serialized<proxy_map, std::string>;
+    using binary_type     = typename serialized_type::binary_type;
+    using sub_db_type     = Native<binary_type, binary_type>;
+
+    // The order keys are visited in depends on the wrapped database
+    auto key_set = [](const auto& db) {
+        auto keys = db.keys();
+        return std::set<proxy_map>(keys.begin(), keys.end());
+    };
+
+    proxy_map key0{{"Module", "0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0"}};
+    proxy_map key1{{"Module", "00000000-0000-0000-0000-000000000001"},
+                   {"Option", "00000000-0000-0000-0000-000000000002"}};
+
+    auto pdb  = std::make_unique<sub_db_type>();
+    auto* sub = pdb.get();
+    serialized_type smap(std::move(pdb));
+    smap.insert(key0, "zero");
+
+    SECTION("Keys are encoded compactly") {
+        std::stringstream ss;
+        cereal::BinaryOutputArchive ar(ss);
+        ar << key0;
+        for(const auto& k : sub->keys()) {
+            if(ProxyMapCodec::is_name(k)) continue;
+            REQUIRE(ProxyMapCodec::is_encoded(k));
+            REQUIRE(k.size() < ss.str().size());
+        }
+    }
+
+    SECTION("count/at/free") {
+        REQUIRE(smap.count(key0));
+        REQUIRE(smap.at(key0).get() == "zero");
+        REQUIRE_FALSE(smap.count(key1));
+        REQUIRE_THROWS_AS(smap.at(key1), std::out_of_range);
+        smap.free(key1);
+        REQUIRE(sub->keys().size() == 2);
+
+        smap.insert(key1, "one");
+        REQUIRE(smap.at(key1).get() == "one");
+        smap.free(key0);
+        REQUIRE_FALSE(smap.count(key0));
+        REQUIRE(smap.count(key1));
+    }
+
+    SECTION("Field names aren't keys") {
+        smap.insert(key1, "one");
+        REQUIRE(key_set(smap) == std::set<proxy_map>{key0, key1});
+    }
+
+    SECTION("Keys saved by earlier versions are visited") {
+        std::stringstream ss;
+        cereal::BinaryOutputArchive ar(ss);
+        ar << key1;
+        sub->insert(ss.str(), "legacy");
+        REQUIRE(key_set(smap) == std::set<proxy_map>{key0, key1});
+    }
+
+    SECTION("A new instance reads the saved keys") {
+        smap.insert(key1, "one");
+        auto pdb2 = std::make_unique<sub_db_type>();
+        for(const auto& k : sub->keys()) pdb2->insert(k, sub->at(k).get());
+        serialized_type smap2(std::move(pdb2));
+        REQUIRE(key_set(smap2) == std::set<proxy_map>{key0, key1});
+        REQUIRE(smap2.at(key1).get() == "one");
+    }
+
+    SECTION("dump") {
+        smap.dump();
+        REQUIRE_FALSE(smap.count(key0));
+        smap.insert(key0, "zero");
+        REQUIRE(smap.at(key0).get() == "zero");
+    }
+}
+
+TEST_CASE("Serialized : injected field") {
+    using proxy_map       = std::map<std::string, std::string>;
+    using serialized_type = Serialized<proxy_map, std::string>;
+    using binary_type     = typename serialized_type::binary_type;
+    using field_type      = typename serialized_type::field_type;
+    using sub_db_type     = Native<binary_type, binary_type>;
+    using key_set_type    = typename serialized_type::key_set_type;
+
+    const std::string m0 = "00000000-0000-0000-0000-00000000000a";
+    const std::string m1 = "00000000-0000-0000-0000-00000000000b";
+    proxy_map key0{{"a", "00000000-0000-0000-0000-000000000001"}};
+    proxy_map key1{{"z", "00000000-0000-0000-0000-000000000002"}};
+
+    auto psub = std::make_shared<sub_db_type>();
+    serialized_type all(psub);
+    serialized_type smap0(psub, field_type("module", m0));
+    serialized_type smap1(psub, field_type("module", m1));
+
+    smap0.insert(key0, "zero");
+    smap1.insert(key1, "one");
+
+    SECTION("Same bytes as adding the field to the key") {
+        auto full0 = key0;
+        full0.emplace("module", m0);
+        REQUIRE(all.at(full0).get() == "zero");
+        auto full1 = key1;
+        full1.emplace("module", m1);
+        REQUIRE(all.at(full1).get() == "one");
+    }
+
+    SECTION("count/at") {
+        REQUIRE(smap0.count(key0));
+        REQUIRE(smap0.at(key0).get() == "zero");
+        REQUIRE_FALSE(smap0.count(key1));
+        REQUIRE_FALSE(smap1.count(key0));
+        REQUIRE(smap1.at(key1).get() == "one");
+    }
+
+    SECTION("Only our keys are visited") {
+        REQUIRE(smap0.keys() == key_set_type{key0});
+        REQUIRE(smap1.keys() == key_set_type{key1});
+        REQUIRE(all.keys().size() == 2);
+    }
+
+    SECTION("free") {
+        smap0.free(key0);
+        REQUIRE_FALSE(smap0.count(key0));
+        REQUIRE(smap1.count(key1));
+    }
+
+    SECTION("Keys which already have the field keep their value") {
+        auto key2 = key0;
+        key2.emplace("module", m1);
+        smap0.insert(key2, "two");
+        REQUIRE(smap1.at(key0).get() == "two");
+    }
+}
+
+TEST_CASE("Serialized : nested") {
+    // A Serialized instance wrapping another uses the thread's buffers while
+    // the outer instance is still using its own
+    using binary_type = std::string;
+    using inner_type  = Serialized<binary_type, binary_type>;
+    using outer_type  = Serialized<int, std::string>;
+
+    auto pinner = std::make_unique<inner_type>(
+      std::make_unique<Native<binary_type, binary_type>>());
+    outer_type smap(std::move(pinner));
+
+    smap.insert(1, "one");
+    smap.insert(2, "two");
+    REQUIRE(smap.count(1));
+    REQUIRE_FALSE(smap.count(3));
+    REQUIRE(smap.at(1).get() == "one");
+    REQUIRE(smap.at(2).get() == "two");
+    smap.free(1);
+    REQUIRE_FALSE(smap.count(1));
+}
+
+// Compares (de)serializing with std::stringstream to Serialized, whose keys
+// (being proxy maps) are encoded by ProxyMapCodec
+// Run with: unit_test_pluginplay "[benchmark]"
+TEST_CASE("Serialized : throughput", "[.][benchmark]") {
+    using key_type        = std::map<std::string, std::string>;
+    using serialized_type = Serialized<key_type, std::string>;
+    using binary_type     = typename serialized_type::binary_type;
+
+    // Mimics proxy maps: a handful of fields mapped to UUIDs
+    auto make_key = [](std::size_t i) {
+        key_type rv;
+        for(std::size_t j = 0; j < 6; ++j) {
+            auto field = "field " + std::to_string(j);
+            auto id    = std::to_string(i * 6 + j);
+            auto uuid  = "00000000-0000-0000-0000-" + std::string(12, '0');
+            uuid.replace(uuid.size() - id.size(), id.size(), id);
+            rv.emplace(field, std::move(uuid));
+        }
+        return rv;
+    };
+
+    const std::size_t n = 5000;
+    std::vector<key_type> keys;
+    for(std::size_t i = 0; i < n; ++i) keys.push_back(make_key(i));
+
+    using sub_db_type = Native<binary_type, binary_type>;
+
+    serialized_type smap(std::make_unique<sub_db_type>());
+    for(std::size_t i = 0; i < n; ++i) smap.insert(keys[i], "value");
+
+    BENCHMARK("std::stringstream round trip") {
+        std::size_t size = 0;
+        for(const auto& k : keys) {
+            std::stringstream ss;
+            cereal::BinaryOutputArchive oar(ss);
+            oar << k;
+            std::stringstream ss2(ss.str());
+            cereal::BinaryInputArchive iar(ss2);
+            key_type rv;
+            iar >> rv;
+            size += rv.size();
+        }
+        return size;
+    };
+
+    BENCHMARK("Serialized::count") {
+        std::size_t found = 0;
+        for(const auto& k : keys) found += smap.count(k);
+        return found;
+    };
+
+    BENCHMARK("Serialized::at") {
+        std::size_t size = 0;
+        for(const auto& k : keys) size += smap.at(k).get().size();
+        return size;
+    };
+
+    BENCHMARK("Serialized::keys") { return smap.keys().size(); };
+
+    BENCHMARK("Serialized::insert") {
+        serialized_type db(std::make_unique<sub_db_type>());
+        for(std::size_t i = 0; i < n; ++i) db.insert(keys[i], "value");
+        return db.count(keys[0]);
+    };
+}
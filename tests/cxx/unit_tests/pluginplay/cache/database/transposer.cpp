@@ -94,4 +94,35 @@ TEMPLATE_LIST_TEST_CASE("Transposer", "", test_types) {
         REQUIRE(pbackup->count(val0));
         REQUIRE(pbackup->at(val0).get() == key0);
     }
+
+    SECTION("index") {
+        using index_type = Native<key_type, mapped_type>;
+        auto pindex      = std::make_unique<index_type>();
+        auto index       = pindex.get();
+        auto pwrapped    = std::make_unique<wrapped_db_type>();
+        db_type indexed(std::move(pwrapped), std::move(pindex));
+
+        indexed.insert(key0, val0);
+        REQUIRE(index->at(key0).get() == val0);
+        REQUIRE(indexed.count(key0));
+        REQUIRE(indexed.at(key0).get() == val0);
+        REQUIRE(indexed.keys() == key_set_type{key0});
+        REQUIRE(indexed.transposed_db().at(val0).get() == key0);
+
+        indexed.free(key0);
+        REQUIRE_FALSE(indexed.count(key0));
+        REQUIRE_FALSE(index->count(key0));
+    }
+
+    SECTION("index from a previous run") {
+        auto pindex = std::make_unique<Native<key_type, mapped_type>>();
+        pindex->insert(key1, val1);
+        auto pwrapped = std::make_unique<wrapped_db_type>();
+        pwrapped->insert(val1, key1);
+        db_type reopened(std::move(pwrapped), std::move(pindex));
+
+        REQUIRE(reopened.count(key1));
+        REQUIRE(reopened.at(key1).get() == val1);
+        REQUIRE(reopened.keys() == key_set_type{key1});
+    }
 }
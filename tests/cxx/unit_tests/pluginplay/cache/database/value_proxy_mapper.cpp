@@ -110,6 +110,33 @@ TEMPLATE_LIST_TEST_CASE("ValueProxyMapper", "", testing::test_types) {
         REQUIRE_FALSE(psub_db->count(key0));
     }
 
+    SECTION("reference counting") {
+        using uuid_mapper_type = typename map_maker_type::proxy_mapper;
+        using uuid_type        = typename uuid_mapper_type::mapped_type;
+        using id_function      = typename uuid_mapper_type::id_function;
+        auto puuid_db          = std::make_unique<Native<double, uuid_type>>();
+        auto pdedup            = std::make_shared<DedupTable>();
+        auto puuids            = std::make_unique<uuid_mapper_type>(
+          std::move(puuid_db), id_function{}, pdedup);
+        auto pcounting = std::make_unique<map_maker_type>(std::move(puuids));
+        auto pcounter  = pcounting.get();
+        auto pinner    = std::make_unique<Native<sub_db_key, sub_db_value>>();
+        mapper_type counted(std::move(pcounting), std::move(pinner));
+
+        // Both keys share the object in value0
+        counted.insert(key0, value0);
+        counted.insert(key1, value0);
+        REQUIRE(pdedup->n_deduplicated() == 1);
+
+        counted.free(key0);
+        REQUIRE(pcounter->count(value0));
+
+        // Overwriting drops the last reference
+        counted.insert(key1, value1);
+        REQUIRE_FALSE(pcounter->count(value0));
+        REQUIRE(counted.at(key1).get() == value1);
+    }
+
     SECTION("backup") {
         db.backup();
         // Still in outermost database
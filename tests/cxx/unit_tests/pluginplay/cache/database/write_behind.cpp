@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/write_behind.hpp>
+#include <string>
+
+using namespace pluginplay::cache::database;
+
+using native_type   = Native<std::string, std::string>;
+using db_type       = WriteBehind<std::string, std::string>;
+using duration_type = typename db_type::duration_type;
+using key_set_type  = typename db_type::key_set_type;
+
+namespace {
+
+// Forwards to a database which outlives the WriteBehind instance
+struct Forwarder : DatabaseAPI<std::string, std::string> {
+    explicit Forwarder(native_type& db) : m_db(db) {}
+    key_set_type keys_() const override { return m_db.keys(); }
+    bool count_(const std::string& k) const noexcept override {
+        return m_db.count(k);
+    }
+    void insert_(std::string k, std::string v) override { m_db.insert(k, v); }
+    void free_(const std::string& k) override { m_db.free(k); }
+    const_mapped_reference at_(const std::string& k) const override {
+        return m_db.at(k);
+    }
+    void backup_() override { m_db.backup(); }
+    void dump_() override { m_db.dump(); }
+    native_type& m_db;
+};
+
+} // namespace
+
+TEST_CASE("WriteBehind") {
+    // Batches never fill up, so writes wait (up to a minute) for a flush
+    const duration_type forever(60000);
+
+    auto pbackup = std::make_unique<native_type>();
+    auto backup  = pbackup.get();
+    auto pnative = std::make_unique<native_type>(std::move(pbackup));
+    auto native  = pnative.get();
+    db_type db(std::move(pnative), 100, 100, forever);
+
+    SECTION("Ctor") {
+        REQUIRE(db.pending() == 0);
+
+        using except_t = std::runtime_error;
+        auto pdb       = std::make_unique<native_type>();
+        REQUIRE_THROWS_AS(db_type(nullptr, 1, 1, forever), except_t);
+        REQUIRE_THROWS_AS(db_type(std::move(pdb), 0, 1, forever), except_t);
+        pdb = std::make_unique<native_type>();
+        REQUIRE_THROWS_AS(db_type(std::move(pdb), 1, 0, forever), except_t);
+    }
+
+    SECTION("insert") {
+        db.insert("Hello", "World");
+        REQUIRE(db.pending() == 1);
+        REQUIRE(db.count("Hello"));
+        REQUIRE(db.at("Hello").get() == "World");
+        REQUIRE_FALSE(native->count("Hello"));
+
+        db.flush();
+        REQUIRE(db.pending() == 0);
+        REQUIRE(native->at("Hello").get() == "World");
+        REQUIRE(db.at("Hello").get() == "World");
+    }
+
+    SECTION("overwrite") {
+        db.insert("Hello", "World");
+        db.insert("Hello", "Universe");
+        REQUIRE(db.at("Hello").get() == "Universe");
+        db.flush();
+        REQUIRE(native->at("Hello").get() == "Universe");
+    }
+
+    SECTION("free") {
+        db.insert("Hello", "World");
+        db.free("Hello");
+        REQUIRE_FALSE(db.count("Hello"));
+        REQUIRE_THROWS_AS(db.at("Hello"), std::out_of_range);
+        db.flush();
+        REQUIRE_FALSE(native->count("Hello"));
+    }
+
+    SECTION("keys") {
+        db.insert("Hello", "World");
+        REQUIRE(db.keys() == key_set_type{"Hello"});
+        REQUIRE(db.pending() == 0);
+    }
+
+    SECTION("cursor") {
+        db.insert("Hello", "World");
+        auto c = db.cursor();
+        REQUIRE(db.pending() == 0);
+        REQUIRE(c->key() == "Hello");
+        REQUIRE(db.at("Hello").get() == "World"); // Lock isn't held between
+        c->next();
+        REQUIRE_FALSE(c->valid());
+    }
+
+    SECTION("backup") {
+        db.insert("Hello", "World");
+        db.backup();
+        db.backup(); // Coalesced with the first backup
+        REQUIRE(db.pending() == 2);
+        REQUIRE_FALSE(backup->count("Hello"));
+        db.flush();
+        REQUIRE(backup->at("Hello").get() == "World");
+    }
+
+    SECTION("dump") {
+        db.insert("Hello", "World");
+        db.dump();
+        REQUIRE(db.pending() == 0);
+        REQUIRE_FALSE(native->count("Hello"));
+        REQUIRE(backup->at("Hello").get() == "World");
+    }
+
+    SECTION("Full queue") {
+        auto psmall = std::make_unique<native_type>();
+        auto small  = psmall.get();
+        db_type tiny(std::move(psmall), 1, 1, forever);
+        for(std::size_t i = 0; i < 10; ++i)
+            tiny.insert(std::to_string(i), std::to_string(i));
+        tiny.flush();
+        REQUIRE(small->keys().size() == 10);
+    }
+
+    SECTION("max_delay") {
+        auto psmall = std::make_unique<native_type>();
+        auto small  = psmall.get();
+        db_type quick(std::move(psmall), 100, 100, duration_type(1));
+        quick.insert("Hello", "World");
+        while(quick.pending()) std::this_thread::yield();
+        REQUIRE(small->count("Hello"));
+    }
+
+    SECTION("Destructor flushes") {
+        native_type outlives;
+        {
+            db_type temp(std::make_unique<Forwarder>(outlives), 100, 100,
+                         forever);
+            temp.insert("Hello", "World");
+        }
+        REQUIRE(outlives.at("Hello").get() == "World");
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/cache/dedup_table.hpp>
+
+using namespace pluginplay::cache;
+
+TEST_CASE("DedupTable") {
+    DedupTable table;
+
+    SECTION("Defaults") {
+        REQUIRE(table.count("a") == 0);
+        REQUIRE(table.n_deduplicated() == 0);
+        REQUIRE(table.bytes_saved() == 0);
+    }
+
+    SECTION("add") {
+        table.add("a", 10, true);
+        REQUIRE(table.count("a") == 1);
+        REQUIRE(table.n_deduplicated() == 0);
+
+        // Reusing the object is a deduplication
+        table.add("a", 10, false);
+        REQUIRE(table.count("a") == 2);
+        REQUIRE(table.n_deduplicated() == 1);
+        REQUIRE(table.bytes_saved() == 10);
+
+        // Reuse need not be reported
+        table.add("a", 10, false, false);
+        REQUIRE(table.count("a") == 3);
+        REQUIRE(table.n_deduplicated() == 1);
+    }
+
+    SECTION("add_reference") {
+        // Unknown objects need their size
+        REQUIRE_FALSE(table.add_reference("a"));
+        REQUIRE(table.count("a") == 0);
+
+        // Uses the size recorded with the first reference
+        table.add("a", 10, true);
+        REQUIRE(table.add_reference("a"));
+        REQUIRE(table.count("a") == 2);
+        REQUIRE(table.n_deduplicated() == 1);
+        REQUIRE(table.bytes_saved() == 10);
+
+        REQUIRE(table.add_reference("a", false));
+        REQUIRE(table.count("a") == 3);
+        REQUIRE(table.n_deduplicated() == 1);
+    }
+
+    SECTION("release") {
+        // Unknown objects are never freeable
+        REQUIRE_FALSE(table.release("a"));
+
+        table.add("a", 10, true);
+        table.add("a", 10, false);
+        REQUIRE_FALSE(table.release("a"));
+        REQUIRE(table.count("a") == 1);
+        REQUIRE(table.release("a"));
+        REQUIRE(table.count("a") == 0);
+
+        // Objects stored by someone else aren't freeable either
+        table.add("b", 10, false);
+        REQUIRE_FALSE(table.release("b"));
+        REQUIRE(table.count("b") == 0);
+
+        // Statistics are cumulative
+        REQUIRE(table.n_deduplicated() == 2);
+        REQUIRE(table.bytes_saved() == 20);
+    }
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/detail_/archive_buffers.hpp>
+#include <string>
+#include <thread>
+
+using namespace pluginplay::cache::detail_;
+
+TEST_CASE("OutputBuffer") {
+    SECTION("Starts empty") {
+        OutputBuffer buffer;
+        REQUIRE(buffer.bytes().empty());
+    }
+
+    SECTION("Writes") {
+        OutputBuffer buffer;
+        buffer.stream() << "Hello" << ' ';
+        buffer.stream().write("World", 5);
+        REQUIRE(buffer.bytes() == "Hello World");
+    }
+
+    SECTION("Reused buffers start empty") {
+        const char* data = nullptr;
+        {
+            OutputBuffer buffer;
+            buffer.stream() << "Hello";
+            data = buffer.bytes().data();
+        }
+        OutputBuffer buffer;
+        REQUIRE(buffer.bytes().empty());
+        REQUIRE(buffer.bytes().data() == data);
+    }
+
+    SECTION("Nesting") {
+        OutputBuffer outer;
+        outer.stream() << "outer";
+        {
+            OutputBuffer inner;
+            REQUIRE(inner.bytes().empty());
+            inner.stream() << "inner";
+            REQUIRE(inner.bytes() == "inner");
+        }
+        outer.stream() << "!";
+        REQUIRE(outer.bytes() == "outer!");
+    }
+
+    SECTION("Large buffers are released") {
+        {
+            OutputBuffer buffer;
+            std::string big(OutputBuffer::max_retained + 1, 'x');
+            buffer.stream() << big;
+            REQUIRE(buffer.bytes() == big);
+        }
+        OutputBuffer buffer;
+        REQUIRE(buffer.bytes().capacity() <= OutputBuffer::max_retained);
+    }
+
+    SECTION("Threads have their own buffers") {
+        OutputBuffer buffer;
+        buffer.stream() << "main";
+        std::string other;
+        std::thread t([&other]() {
+            OutputBuffer buffer2;
+            buffer2.stream() << "other";
+            other = buffer2.bytes();
+        });
+        t.join();
+        REQUIRE(buffer.bytes() == "main");
+        REQUIRE(other == "other");
+    }
+}
+
+TEST_CASE("InputBuffer") {
+    std::string bytes("Hello World");
+
+    SECTION("Reads") {
+        InputBuffer buffer(bytes);
+        std::string word;
+        buffer.stream() >> word;
+        REQUIRE(word == "Hello");
+        buffer.stream() >> word;
+        REQUIRE(word == "World");
+        REQUIRE_FALSE(buffer.stream() >> word);
+    }
+
+    SECTION("Reads in place") {
+        InputBuffer buffer(bytes);
+        bytes[0] = 'J';
+        std::string word;
+        buffer.stream() >> word;
+        REQUIRE(word == "Jello");
+    }
+
+    SECTION("Reused buffers are reset") {
+        {
+            InputBuffer buffer(bytes);
+            std::string word;
+            while(buffer.stream() >> word) {}
+            REQUIRE(buffer.stream().fail());
+        }
+        InputBuffer buffer(std::string_view(bytes).substr(6));
+        REQUIRE(buffer.stream().good());
+        char data[5];
+        buffer.stream().read(data, 5);
+        REQUIRE(std::string(data, 5) == "World");
+    }
+
+    SECTION("Nesting") {
+        InputBuffer outer(bytes);
+        char c;
+        outer.stream().get(c);
+        {
+            InputBuffer inner(std::string_view("abc"));
+            std::string word;
+            inner.stream() >> word;
+            REQUIRE(word == "abc");
+        }
+        outer.stream().get(c);
+        REQUIRE(c == 'e');
+    }
+
+    SECTION("Round trip") {
+        OutputBuffer out;
+        const double x = 3.14;
+        out.stream().write(reinterpret_cast<const char*>(&x), sizeof(x));
+        InputBuffer in(out.bytes());
+        double y = 0.0;
+        in.stream().read(reinterpret_cast<char*>(&y), sizeof(y));
+        REQUIRE(y == x);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include <pluginplay/cache/detail_/checkpoint_bundle.hpp>
+#include <pluginplay/config/config.hpp>
+
+using namespace pluginplay::cache::detail_;
+
+TEST_CASE("CheckpointBundle") {
+    auto path = std::filesystem::temp_directory_path() / "pp_bundle_test";
+    std::filesystem::remove(path);
+
+    // N.B. Values may hold arbitrary bytes, including null characters
+    const std::string binary(3, '\0');
+
+    CheckpointBundle bundle;
+    bundle.modules         = {"mod0", "mod1"};
+    bundle.tables["cache"] = {{"key0", "value0"}, {"key1", binary}};
+    bundle.tables["uuid"]  = {{"", "empty key"}};
+    bundle.tables["empty"];
+
+    auto compare = [&](const CheckpointBundle& other) {
+        REQUIRE(other.modules == bundle.modules);
+        REQUIRE(other.tables == bundle.tables);
+    };
+
+    SECTION("Round trip") {
+        bundle.save(path.string());
+        REQUIRE(std::filesystem::exists(path));
+        REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+        compare(CheckpointBundle::load(path.string()));
+
+        // Saving again replaces the bundle
+        CheckpointBundle empty;
+        empty.save(path.string());
+        auto loaded = CheckpointBundle::load(path.string());
+        REQUIRE(loaded.modules.empty());
+        REQUIRE(loaded.tables.empty());
+    }
+
+    SECTION("Compressed") {
+        if(pluginplay::with_zlib()) {
+            bundle.save(path.string(), true);
+            compare(CheckpointBundle::load(path.string()));
+        } else {
+            REQUIRE_THROWS_AS(bundle.save(path.string(), true),
+                              std::runtime_error);
+        }
+    }
+
+    SECTION("Not a bundle") {
+        REQUIRE_THROWS_AS(CheckpointBundle::load(path.string()),
+                          std::runtime_error);
+        std::ofstream(path) << "Hello world";
+        REQUIRE_THROWS_AS(CheckpointBundle::load(path.string()),
+                          std::runtime_error);
+    }
+
+    SECTION("Corrupt") {
+        bundle.save(path.string());
+        const auto size = std::filesystem::file_size(path);
+
+        SECTION("Flipped byte") {
+            const auto mode = std::ios::in | std::ios::out | std::ios::binary;
+            std::fstream f(path, mode);
+            f.seekp(size - 1);
+            f.put('X');
+        }
+        SECTION("Truncated") { std::filesystem::resize_file(path, size - 1); }
+
+        REQUIRE_THROWS_AS(CheckpointBundle::load(path.string()),
+                          std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/detail_/codec.hpp>
+#include <pluginplay/config/config.hpp>
+
+using namespace pluginplay::cache;
+using namespace pluginplay::cache::detail_;
+
+TEST_CASE("codec_impl") {
+    REQUIRE(codec_impl(Codec::none) == nullptr);
+
+    const std::string data(1000, 'a');
+    for(auto codec : {Codec::fast, Codec::best}) {
+        auto pimpl = codec_impl(codec);
+        REQUIRE(pimpl != nullptr);
+        if(!pluginplay::with_zlib()) {
+            REQUIRE_THROWS_AS(pimpl->compress(data), std::runtime_error);
+            continue;
+        }
+        auto compressed = pimpl->compress(data);
+        REQUIRE(compressed.size() < data.size());
+        REQUIRE(pimpl->decompress(compressed, data.size()) == data);
+    }
+
+    REQUIRE_THROWS_AS(codec_impl(static_cast<Codec>(255)), std::runtime_error);
+}
+
+TEST_CASE("assert_codecs_available") {
+    CompressionPolicy policy;
+    REQUIRE_NOTHROW(assert_codecs_available(policy));
+
+    policy.codec = Codec::fast;
+    if(pluginplay::with_zlib()) {
+        REQUIRE_NOTHROW(assert_codecs_available(policy));
+    } else {
+        REQUIRE_THROWS_AS(assert_codecs_available(policy), std::runtime_error);
+    }
+}
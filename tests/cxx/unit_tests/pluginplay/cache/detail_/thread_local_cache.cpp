@@ -0,0 +1,84 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/detail_/thread_local_cache.hpp>
+#include <string>
+#include <thread>
+
+using namespace pluginplay::cache::detail_;
+
+TEST_CASE("ThreadLocalCache") {
+    using cache_type = ThreadLocalCache<int, std::string>;
+    cache_type cache;
+
+    SECTION("Disabled by default") {
+        REQUIRE(cache.capacity() == 0);
+        cache.insert(1, "one");
+        REQUIRE(cache.find(1) == nullptr);
+    }
+
+    cache.set_capacity(2);
+
+    SECTION("find/insert") {
+        REQUIRE(cache.find(1) == nullptr);
+        cache.insert(1, "one");
+        REQUIRE(*cache.find(1) == "one");
+    }
+
+    SECTION("Least recently used pair is removed") {
+        cache.insert(1, "one");
+        cache.insert(2, "two");
+        REQUIRE(*cache.find(1) == "one");
+        cache.insert(3, "three");
+        REQUIRE(cache.find(2) == nullptr);
+        REQUIRE(*cache.find(1) == "one");
+        REQUIRE(*cache.find(3) == "three");
+    }
+
+    SECTION("invalidate") {
+        cache.insert(1, "one");
+        cache.invalidate();
+        REQUIRE(cache.find(1) == nullptr);
+
+        cache.insert(1, "one");
+        cache.set_capacity(3);
+        REQUIRE(cache.find(1) == nullptr);
+    }
+
+    SECTION("Threads have their own pairs") {
+        cache.insert(1, "one");
+        bool found = true;
+        std::thread t([&]() {
+            found = cache.find(1) != nullptr;
+            cache.insert(2, "two");
+        });
+        t.join();
+        REQUIRE_FALSE(found);
+        REQUIRE(cache.find(2) == nullptr);
+        REQUIRE(*cache.find(1) == "one");
+    }
+
+    SECTION("Instances have their own pairs") {
+        cache.insert(1, "one");
+        cache_type other;
+        other.set_capacity(2);
+        REQUIRE(other.find(1) == nullptr);
+        other.insert(1, "uno");
+        REQUIRE(*cache.find(1) == "one");
+        REQUIRE(*other.find(1) == "uno");
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/detail_/zlib.hpp>
+#include <pluginplay/config/config.hpp>
+
+using namespace pluginplay::cache::detail_;
+
+TEST_CASE("zlib") {
+    const std::string data(1000, 'a');
+
+    if(!pluginplay::with_zlib()) {
+        REQUIRE_THROWS_AS(zlib_compress(data), std::runtime_error);
+        REQUIRE_THROWS_AS(zlib_decompress(data, data.size()),
+                          std::runtime_error);
+        return;
+    }
+
+    SECTION("Round trip") {
+        for(int level : {1, 6, 9}) {
+            auto compressed = zlib_compress(data, level);
+            REQUIRE(compressed.size() < data.size());
+            REQUIRE(zlib_decompress(compressed, data.size()) == data);
+        }
+        auto empty = zlib_compress("");
+        REQUIRE(zlib_decompress(empty, 0) == "");
+    }
+
+    SECTION("Wrong size") {
+        auto compressed = zlib_compress(data);
+        REQUIRE_THROWS_AS(zlib_decompress(compressed, data.size() - 1),
+                          std::runtime_error);
+    }
+
+    SECTION("Corrupt data") {
+        REQUIRE_THROWS_AS(zlib_decompress("not compressed", 10),
+                          std::runtime_error);
+    }
+}
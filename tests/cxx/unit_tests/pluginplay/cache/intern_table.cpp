@@ -0,0 +1,132 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/cache/intern_table.hpp>
+
+using namespace pluginplay;
+using namespace pluginplay::cache;
+
+namespace {
+
+ModuleInput make_input(std::vector<int> value) {
+    ModuleInput i;
+    i.set_type<std::vector<int>>();
+    i.change(std::move(value));
+    return i;
+}
+
+} // namespace
+
+TEST_CASE("InternTable") {
+    InternTable table;
+    auto i0 = make_input({1, 2, 3});
+    auto i1 = make_input({1, 2, 3});
+
+    SECTION("Defaults") {
+        REQUIRE(table.size() == 0);
+        REQUIRE(table.n_interned() == 0);
+        REQUIRE(table.bytes_saved() == 0);
+        REQUIRE(table.find(i0) == nullptr);
+        REQUIRE(table.find(ModuleInput{}) == nullptr);
+    }
+
+    SECTION("intern") {
+        // The first input's instance is the one which is shared
+        table.intern(i0, "a");
+        REQUIRE(table.size() == 1);
+        REQUIRE(*table.find(i0) == "a");
+
+        // i1 is found by its value, but doesn't share the instance yet
+        REQUIRE(*table.find(i1) == "a");
+        REQUIRE_FALSE(i1.shares_value(i0));
+
+        table.intern(i1, "a");
+        REQUIRE(i1.shares_value(i0));
+        REQUIRE(*table.find(i1) == "a");
+        REQUIRE(table.n_interned() == 1);
+        REQUIRE(table.bytes_saved() > 0);
+
+        // Already sharing is a no-op
+        table.intern(i1, "a");
+        REQUIRE(table.n_interned() == 1);
+
+        // Copies share the instance too
+        ModuleInput copy(i1);
+        REQUIRE(*table.find(copy) == "a");
+    }
+
+    SECTION("Equal values are found by their hashes") {
+        table.intern(i0, "a");
+        REQUIRE(i1.content_hash() == i0.content_hash());
+        REQUIRE(*table.find(i1) == "a");
+        REQUIRE(table.find(make_input({3, 2, 1})) == nullptr);
+
+        // Forgotten (and dead) instances are not found
+        table.forget("a");
+        REQUIRE(table.find(i1) == nullptr);
+        {
+            auto temp = make_input({1, 2, 3});
+            table.intern(temp, "b");
+        }
+        REQUIRE(table.find(i1) == nullptr);
+    }
+
+    SECTION("Dead instances are not shared") {
+        {
+            auto temp = make_input({1, 2, 3});
+            table.intern(temp, "a");
+        }
+        table.intern(i0, "a");
+        REQUIRE(*table.find(i0) == "a");
+        REQUIRE(table.n_interned() == 0);
+    }
+
+    SECTION("Values bound by reference are not shared") {
+        std::vector<int> value{1, 2, 3};
+        ModuleInput ref;
+        ref.set_type<const std::vector<int>&>();
+        ref.change(value);
+        table.intern(ref, "a");
+        REQUIRE(table.find(ref) == nullptr);
+
+        // But they can share another instance
+        table.intern(i0, "a");
+        table.intern(ref, "a");
+        REQUIRE(ref.shares_value(i0));
+    }
+
+    SECTION("forget") {
+        table.intern(i0, "a");
+        table.forget("a");
+        REQUIRE(table.find(i0) == nullptr);
+        table.intern(i1, "a");
+        REQUIRE_FALSE(i1.shares_value(i0));
+
+        // The instance can be matched to a new UUID
+        table.intern(i0, "b");
+        REQUIRE(*table.find(i0) == "b");
+        table.forget("a");
+        REQUIRE(*table.find(i0) == "b");
+    }
+
+    SECTION("clear") {
+        table.intern(i0, "a");
+        table.clear();
+        REQUIRE(table.size() == 0);
+        REQUIRE(table.find(i0) == nullptr);
+    }
+}
@@ -16,8 +16,13 @@
 
 #include "../catch.hpp"
 #include "test_cache.hpp"
+#include <atomic>
+#include <filesystem>
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
+#include <pluginplay/config/config.hpp>
+#include <thread>
+#include <vector>
 
 using namespace pluginplay::cache;
 
@@ -105,4 +110,202 @@ TEMPLATE_LIST_TEST_CASE("ModuleCache", "", testing::test_types) {
         REQUIRE_FALSE(mod_cache->count(inputs0));
         REQUIRE_FALSE(mod_cache->count(inputs1));
     }
+
+    SECTION("stats") {
+        auto s = default_mod_cache.stats();
+        REQUIRE(s.hits == 0);
+        REQUIRE(s.misses == 0);
+        REQUIRE(s.insertions == 0);
+        REQUIRE(default_mod_cache.memory_footprint() == 0);
+
+        // From the cache call above
+        s = mod_cache->stats();
+        REQUIRE(s.insertions == 1);
+        REQUIRE(s.entries == 1);
+        REQUIRE(s.bytes_in_memory == pluginplay::memory_footprint(results0));
+        REQUIRE(mod_cache->memory_footprint() == s.bytes_in_memory);
+        REQUIRE(s.hits == 0);
+        REQUIRE(s.misses == 0);
+
+        // Overwriting a result doesn't add an entry
+        mod_cache->cache(inputs0, results0);
+        s = mod_cache->stats();
+        REQUIRE(s.insertions == 2);
+        REQUIRE(s.entries == 1);
+        REQUIRE(s.bytes_in_memory == pluginplay::memory_footprint(results0));
+
+        mod_cache->count(inputs0);
+        mod_cache->count(inputs1);
+        mod_cache->count(inputs1);
+        s = mod_cache->stats();
+        REQUIRE(s.hits == 1);
+        REQUIRE(s.misses == 2);
+        REQUIRE(s.hit_rate() == Catch::Approx(1.0 / 3.0));
+
+        // uncache isn't a lookup
+        mod_cache->uncache(inputs0);
+        REQUIRE(mod_cache->stats().hits == 1);
+
+        mod_cache->clear();
+        s = mod_cache->stats();
+        REQUIRE(s.entries == 0);
+        REQUIRE(s.evictions == 1);
+        REQUIRE(s.bytes_in_memory == 0);
+    }
+
+    SECTION("tiers") {
+        using e0 = std::runtime_error;
+        REQUIRE_THROWS_AS(default_mod_cache.set_tier_policy(TierPolicy{}), e0);
+        REQUIRE(mod_cache->tier_policy().l1_capacity == 0);
+
+        REQUIRE_FALSE(mod_cache->stats().cooling);
+
+        TierPolicy policy;
+        policy.l1_capacity = 2;
+        policy.cold_after_accesses = 8;
+        policy.cold_after          = std::chrono::milliseconds(5);
+        mod_cache->set_tier_policy(policy);
+        REQUIRE(mod_cache->tier_policy().l1_capacity == 2);
+        REQUIRE(mod_cache->tier_policy().cold_after_accesses == 8);
+        REQUIRE(mod_cache->tier_policy().cold_after.count() == 5);
+
+        // Results can only be compressed with zlib
+        REQUIRE(mod_cache->stats().cooling == pluginplay::with_zlib());
+
+        // First retrieval puts the result in L1
+        REQUIRE(mod_cache->count(inputs0));
+        REQUIRE(mod_cache->uncache(inputs0) == results0);
+        REQUIRE(mod_cache->count(inputs0));
+        REQUIRE(mod_cache->uncache(inputs0) == results0);
+        auto s = mod_cache->stats();
+        REQUIRE(s.hits == 2);
+        REQUIRE(s.l1_hits == 1);
+        REQUIRE(s.l2_hits == 1);
+        REQUIRE(s.l3_hits == 0);
+        REQUIRE(s.tier_hit_rate(1) == Catch::Approx(0.5));
+
+        // Overwriting a result invalidates L1
+        mod_cache->cache(inputs0, results1);
+        REQUIRE(mod_cache->uncache(inputs0) == results1);
+
+        mod_cache->clear();
+        REQUIRE_FALSE(mod_cache->count(inputs0));
+    }
+
+    SECTION("cold results") {
+        TierPolicy policy;
+        policy.cold_after_accesses = 1;
+        mod_cache->set_tier_policy(policy);
+        mod_cache->cache(inputs1, results1);
+
+        // Sweeps for idle results happen every so many accesses
+        for(int i = 0; i < 64; ++i)
+            REQUIRE(mod_cache->uncache(inputs1) == results1);
+        const bool cooled = pluginplay::with_zlib();
+        REQUIRE((mod_cache->stats().compressions > 0) == cooled);
+
+        // A cold result inflates to the original
+        REQUIRE(mod_cache->uncache(inputs0) == results0);
+        REQUIRE((mod_cache->stats().decompressions > 0) == cooled);
+    }
+
+    SECTION("concurrent use") {
+        TierPolicy policy;
+        policy.l1_capacity = 1;
+        mod_cache->set_tier_policy(policy);
+
+        // Each thread hashes (and thus modifies) its own copies of the keys
+        std::atomic<bool> ok{true};
+        auto work = [&, inputs0, inputs1]() {
+            for(int i = 0; i < 50; ++i) {
+                if(!mod_cache->count(inputs0)) ok = false;
+                if(mod_cache->uncache(inputs0) != results0) ok = false;
+                mod_cache->cache(inputs1, results1);
+                if(mod_cache->uncache(inputs1) != results1) ok = false;
+            }
+        };
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 4; ++i) threads.emplace_back(work);
+        for(auto& t : threads) t.join();
+        REQUIRE(ok);
+        REQUIRE(mod_cache->stats().hits == 200);
+        REQUIRE(mod_cache->stats().entries == 2);
+    }
+
+    SECTION("admission") {
+        using e0 = std::runtime_error;
+        REQUIRE_THROWS_AS(default_mod_cache.admission_policy(), e0);
+        REQUIRE(default_mod_cache.admit(results0, 1.0) == Admission::skip);
+
+        // Default admits everything
+        REQUIRE(mod_cache->admit(results0, 0.0) == Admission::persistent);
+
+        AdmissionPolicy policy;
+        policy.memory_threshold     = 1.0;
+        policy.persistent_threshold = 2.0;
+        mod_cache->set_admission_policy(policy);
+        REQUIRE(mod_cache->admission_policy().memory_threshold == 1.0);
+
+        const double bytes = pluginplay::memory_footprint(results0);
+        REQUIRE(mod_cache->admit(results0, 2.0 * bytes) ==
+                Admission::persistent);
+        REQUIRE(mod_cache->admit(results0, bytes) == Admission::memory_only);
+        REQUIRE(mod_cache->admit(results0, 0.5 * bytes) == Admission::skip);
+        REQUIRE(mod_cache->stats().rejections == 1);
+
+        // Skipped results aren't cached, the other two are
+        mod_cache->cache(inputs1, results1, Admission::skip);
+        REQUIRE_FALSE(mod_cache->count(inputs1));
+        mod_cache->cache(inputs1, results1, Admission::memory_only);
+        REQUIRE(mod_cache->uncache(inputs1) == results1);
+        mod_cache->cache(inputs1, results0, Admission::persistent);
+        REQUIRE(mod_cache->uncache(inputs1) == results0);
+
+        mod_cache->clear();
+        REQUIRE_FALSE(mod_cache->count(inputs1));
+    }
+}
+
+TEST_CASE("ModuleCache : overwriting with another admission") {
+    using key_type    = ModuleCache::key_type;
+    using mapped_type = ModuleCache::mapped_type;
+
+    // Only caches which save to disk keep memory-only results separately
+    auto cache_path = std::filesystem::temp_directory_path() / "mcache_admit";
+    std::filesystem::remove_all(cache_path);
+
+    key_type inputs;
+    inputs["x"].set_type<int>().change(int{1});
+    mapped_type results0, results1;
+    results0["y"].set_type<int>().change(int{2});
+    results1["y"].set_type<int>().change(int{3});
+
+    SECTION("persistent, then memory_only") {
+        {
+            ModuleManagerCache disk(cache_path);
+            auto mod_cache = disk.get_or_make_module_cache("mod");
+            mod_cache->cache(inputs, results0, Admission::persistent);
+            mod_cache->cache(inputs, results1, Admission::memory_only);
+            REQUIRE(mod_cache->uncache(inputs) == results1);
+        }
+
+        // The stale result isn't on disk anymore
+        ModuleManagerCache disk(cache_path);
+        REQUIRE_FALSE(disk.get_or_make_module_cache("mod")->count(inputs));
+    }
+
+    SECTION("memory_only, then persistent") {
+        {
+            ModuleManagerCache disk(cache_path);
+            auto mod_cache = disk.get_or_make_module_cache("mod");
+            mod_cache->cache(inputs, results0, Admission::memory_only);
+            mod_cache->cache(inputs, results1, Admission::persistent);
+            REQUIRE(mod_cache->uncache(inputs) == results1);
+        }
+
+        ModuleManagerCache disk(cache_path);
+        auto mod_cache = disk.get_or_make_module_cache("mod");
+        REQUIRE(mod_cache->uncache(inputs) == results1);
+    }
+    std::filesystem::remove_all(cache_path);
 }
@@ -18,8 +18,23 @@
 #include <filesystem>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/config/config.hpp>
+#include <string>
+#include <thread>
 using namespace pluginplay::cache;
 
+namespace {
+
+// Comparable, but not serializable (nor default constructible)
+struct NotSerializable {
+    explicit NotSerializable(int v) : value(v) {}
+    bool operator==(const NotSerializable& rhs) const noexcept {
+        return value == rhs.value;
+    }
+    int value;
+};
+
+} // namespace
+
 /* Testing Strategy:
  *
  * As far as the user is concerned ModuleManagerCache instances are just maps
@@ -39,43 +54,505 @@ TEST_CASE("ModuleManagerCache") {
         if(std::filesystem::exists(cache_path))
             std::filesystem::remove_all(cache_path);
 
-        if(pluginplay::with_rocksdb()) {
-            // Cache shouldn't exist yet
-            REQUIRE_FALSE(std::filesystem::exists(cache_path));
+        // Cache shouldn't exist yet
+        REQUIRE_FALSE(std::filesystem::exists(cache_path));
+
+        // N.B. Works without RocksDB too (FlatFile is used instead)
+        ModuleManagerCache disk(cache_path);
+
+        // Make sure it exists now
+        REQUIRE(std::filesystem::exists(cache_path));
+    }
+
+    SECTION("change_save_location") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        REQUIRE_FALSE(std::filesystem::exists(cache_path));
+
+        memory_only.change_save_location(cache_path.string());
+        REQUIRE(std::filesystem::exists(cache_path));
+
+        // The parent dir (root_dir/cache_dir/cache_dir) DNE, this tests we
+        // can still make the child dir
+        auto multiple_nestings = root_dir / cache_dir / cache_dir / cache_dir;
+        memory_only.change_save_location(multiple_nestings);
+        REQUIRE(std::filesystem::exists(multiple_nestings));
+
+        std::filesystem::remove_all(multiple_nestings);
+    }
+
+    SECTION("Warm start") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{2});
 
+        {
             ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            pcache->cache(inputs, results);
+        } // Destructor writes the cache to disk
 
-            // Make sure it exists now
-            REQUIRE(std::filesystem::exists(cache_path));
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            REQUIRE(pcache->count(inputs));
+            REQUIRE(pcache->uncache(inputs).at("y").value<int>() == 2);
 
-        } else {
-            using e = std::runtime_error;
-            REQUIRE_THROWS_AS(ModuleManagerCache(cache_path), e);
+            // Other modules don't see the results
+            auto pother = disk.get_or_make_module_cache("other");
+            REQUIRE_FALSE(pother->count(inputs));
         }
+        std::filesystem::remove_all(cache_path);
     }
 
-    SECTION("change_save_location") {
+    SECTION("Different inputs on disk") {
         if(std::filesystem::exists(cache_path))
             std::filesystem::remove_all(cache_path);
 
-        REQUIRE_FALSE(std::filesystem::exists(cache_path));
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs1, inputs2;
+        inputs1["x"].set_type<int>().change(int{1});
+        inputs2["x"].set_type<int>().change(int{2});
+        mapped_type results1, results2;
+        results1["y"].set_type<int>().change(int{3});
+        results2["y"].set_type<int>().change(int{4});
+
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            pcache->cache(inputs1, results1);
+            REQUIRE_FALSE(pcache->count(inputs2));
+            pcache->cache(inputs2, results2);
+            REQUIRE(pcache->uncache(inputs1).at("y").value<int>() == 3);
+            REQUIRE(pcache->uncache(inputs2).at("y").value<int>() == 4);
+        }
+
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            REQUIRE(pcache->uncache(inputs1).at("y").value<int>() == 3);
+            REQUIRE(pcache->uncache(inputs2).at("y").value<int>() == 4);
+        }
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("write-behind") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{2});
+
+        WriteBehindPolicy policy;
+        policy.queue_capacity = 4;
+        policy.batch_size     = 2;
+        REQUIRE(policy.enabled());
+
+        {
+            ModuleManagerCache disk(cache_path, policy);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            pcache->cache(inputs, results);
+            REQUIRE(pcache->count(inputs));
+            disk.flush();
+            REQUIRE(pcache->uncache(inputs).at("y").value<int>() == 2);
+        } // Destructor waits for the writes
+
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            REQUIRE(pcache->uncache(inputs).at("y").value<int>() == 2);
+        }
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("open_read_only") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+        auto overlay_path = root_dir / "mmcache_test_overlay";
+        std::filesystem::remove_all(overlay_path);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs, new_inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        new_inputs["x"].set_type<int>().change(int{3});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{2});
+
+        // Must already exist
+        ModuleManagerCache reader;
+        REQUIRE_THROWS_AS(reader.open_read_only(cache_path.string()),
+                          std::runtime_error);
+
+        {
+            ModuleManagerCache disk(cache_path);
+            disk.get_or_make_module_cache("mod")->cache(inputs, results);
+        }
+
+        {
+            // Several processes can read at once
+            ModuleManagerCache reader0, reader1;
+            reader0.open_read_only(cache_path, overlay_path.string());
+            reader1.open_read_only(cache_path);
+            auto pcache0 = reader0.get_or_make_module_cache("mod");
+            auto pcache1 = reader1.get_or_make_module_cache("mod");
+            REQUIRE(pcache0->uncache(inputs).at("y").value<int>() == 2);
+            REQUIRE(pcache1->uncache(inputs).at("y").value<int>() == 2);
+
+            // New results go to the overlay
+            pcache0->cache(new_inputs, results);
+            REQUIRE(pcache0->count(new_inputs));
+            REQUIRE_FALSE(pcache1->count(new_inputs));
+        }
+
+        {
+            // Shared cache was not modified
+            ModuleManagerCache disk(cache_path);
+            REQUIRE_FALSE(disk.get_or_make_module_cache("mod")->count(
+              new_inputs));
+        }
+
+        {
+            // Overlay persists
+            ModuleManagerCache reader;
+            reader.open_read_only(cache_path, overlay_path.string());
+            auto pcache = reader.get_or_make_module_cache("mod");
+            REQUIRE(pcache->count(inputs));
+            REQUIRE(pcache->count(new_inputs));
+        }
+        std::filesystem::remove_all(cache_path);
+        std::filesystem::remove_all(overlay_path);
+    }
+
+    SECTION("compression") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        CompressionPolicy policy;
+        policy.codec    = Codec::fast;
+        policy.min_size = 0;
+
+        if(!pluginplay::with_zlib()) {
+            ModuleManagerCache disk;
+            using except_t = std::runtime_error;
+            REQUIRE_THROWS_AS(disk.set_compression_policy(policy), except_t);
+            return;
+        }
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results, other_results;
+        results["y"].set_type<std::string>().change(std::string(4096, 'a'));
+        other_results["y"].set_type<std::string>().change(std::string("b"));
+
+        {
+            ModuleManagerCache disk;
+            disk.set_compression_policy(policy);
+            disk.change_save_location(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            pcache->cache(inputs, results);
+
+            // Module which overrides the default
+            auto pother = disk.get_or_make_module_cache("other");
+            pother->set_compression_policy(CompressionPolicy{});
+            pother->cache(inputs, other_results);
+        }
+
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pcache = disk.get_or_make_module_cache("mod");
+            auto y      = pcache->uncache(inputs).at("y").value<std::string>();
+            REQUIRE(y == std::string(4096, 'a'));
+            auto pother = disk.get_or_make_module_cache("other");
+            auto z      = pother->uncache(inputs).at("y").value<std::string>();
+            REQUIRE(z == "b");
+        }
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("tiers") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs0, inputs1;
+        inputs0["x"].set_type<int>().change(int{1});
+        inputs1["x"].set_type<int>().change(int{2});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{3});
+
+        TierPolicy policy;
+        policy.l1_capacity = 1;
+        policy.l2_capacity = 1;
+
+        ModuleManagerCache disk(cache_path);
+        disk.set_tier_policy("mod", policy);
+        auto pcache = disk.get_or_make_module_cache("mod");
+        REQUIRE(pcache->tier_policy().l2_capacity == 1);
+
+        // Only one result fits in memory, the other is demoted to disk
+        pcache->cache(inputs0, results);
+        pcache->cache(inputs1, results);
+        REQUIRE(pcache->stats().demotions == 1);
+
+        // Comes from disk, then from L1
+        REQUIRE(pcache->count(inputs0));
+        REQUIRE(pcache->uncache(inputs0) == results);
+        REQUIRE(pcache->count(inputs0));
+        REQUIRE(pcache->uncache(inputs0) == results);
+
+        auto s = pcache->stats();
+        REQUIRE(s.promotions == 1);
+        REQUIRE(s.demotions == 2);
+        REQUIRE(s.l1_hits == 1);
+        REQUIRE(s.l2_hits == 0);
+        REQUIRE(s.l3_hits == 1);
+        REQUIRE(s.tier_hit_rate(3) == Catch::Approx(0.5));
+        REQUIRE(disk.stats().l3_hits == 1);
+
+        // Loaded by uncache, so the lookup is served by L2
+        policy.l1_capacity = 0;
+        pcache->set_tier_policy(policy);
+        REQUIRE(pcache->uncache(inputs1) == results);
+        REQUIRE(pcache->count(inputs1));
+        s = pcache->stats();
+        REQUIRE(s.promotions == 2);
+        REQUIRE(s.l2_hits == 1);
+        REQUIRE(s.l3_hits == 1);
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("expiration") {
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{3});
+
+        TierPolicy policy;
+        policy.l1_capacity = 1;
+        memory_only.set_tier_policy("mod", policy);
+        auto pcache = memory_only.get_or_make_module_cache("mod");
+        auto puser  = memory_only.get_or_make_module_cache("other");
+        pcache->cache(inputs, results);
+        puser->cache(inputs, results);
+        REQUIRE(pcache->uncache(inputs) == results); // Now in L1 too
+
+        REQUIRE(memory_only.generation() == 0);
+        REQUIRE(memory_only.bump_generation() == 1);
+        REQUIRE(memory_only.generation() == 1);
+        REQUIRE_FALSE(pcache->count(inputs));
+        REQUIRE_FALSE(puser->count(inputs));
+        REQUIRE_THROWS_AS(pcache->uncache(inputs), std::out_of_range);
+
+        // Results cached after the bump are fine
+        pcache->cache(inputs, results);
+        REQUIRE(pcache->count(inputs));
+
+        memory_only.set_time_to_live("mod", std::chrono::milliseconds(1));
+        REQUIRE(pcache->time_to_live().count() == 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        REQUIRE_FALSE(pcache->count(inputs));
+    }
+
+    SECTION("saved generation") {
+        std::filesystem::remove_all(cache_path);
+        {
+            ModuleManagerCache disk(cache_path);
+            disk.bump_generation();
+            REQUIRE(disk.bump_generation() == 2);
+        }
+
+        // The generation continues from the saved one
+        ModuleManagerCache disk(cache_path);
+        REQUIRE(disk.generation() == 2);
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("quotas") {
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs0, inputs1;
+        inputs0["x"].set_type<int>().change(int{1});
+        inputs1["x"].set_type<int>().change(int{2});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{3});
 
-        if(pluginplay::with_rocksdb()) {
-            memory_only.change_save_location(cache_path.string());
-            REQUIRE(std::filesystem::exists(cache_path));
+        QuotaPolicy policy;
+        policy.max_entries = 1;
+        policy.priority    = CachePriority::high;
+        memory_only.set_quota_policy("mod", policy);
+        auto pcache = memory_only.get_or_make_module_cache("mod");
+        REQUIRE(pcache->quota_policy().max_entries == 1);
+        REQUIRE(pcache->quota_policy().priority == CachePriority::high);
 
-            // The parent dir (root_dir/cache_dir/cache_dir) DNE, this tests we
-            // can still make the child dir
-            auto multiple_nestings =
-              root_dir / cache_dir / cache_dir / cache_dir;
-            memory_only.change_save_location(multiple_nestings);
-            REQUIRE(std::filesystem::exists(multiple_nestings));
+        // The most recent result is kept
+        pcache->cache(inputs0, results);
+        pcache->cache(inputs1, results);
+        REQUIRE_FALSE(pcache->count(inputs0));
+        REQUIRE(pcache->count(inputs1));
+        auto s = pcache->stats();
+        REQUIRE(s.evictions == 1);
+        REQUIRE(s.resident_entries == 1);
+        REQUIRE(s.resident_bytes > 0);
 
-            std::filesystem::remove_all(multiple_nestings);
-        } else {
-            using e = std::runtime_error;
-            REQUIRE_THROWS_AS(memory_only.change_save_location(cache_path), e);
+        // The budget takes from the low priority module first
+        policy.max_entries = 0;
+        memory_only.set_quota_policy("mod", policy);
+        policy.priority = CachePriority::low;
+        memory_only.set_quota_policy("low", policy);
+        auto plow = memory_only.get_or_make_module_cache("low");
+        for(auto* p : {pcache.get(), plow.get()}) {
+            p->cache(inputs0, results);
+            p->cache(inputs1, results);
         }
+        REQUIRE(memory_only.memory_budget() == 0);
+        const auto used = memory_only.stats().resident_bytes;
+        memory_only.set_memory_budget(used - 1);
+        REQUIRE(memory_only.memory_budget() == used - 1);
+
+        auto usage = memory_only.module_stats();
+        REQUIRE(usage.size() == 2);
+        REQUIRE(usage.at("mod").resident_entries == 2);
+        REQUIRE(usage.at("low").resident_entries == 1);
+        REQUIRE(usage.at("low").evictions == 1);
+        REQUIRE(plow->count(inputs1));
+    }
+
+    SECTION("drop_module_cache") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{2});
+
+        // N.B. The options are ignored without RocksDB
+        RocksDBOptions big;
+        big.write_buffer_size  = 1 << 20;
+        big.bloom_bits_per_key = 10.0;
+        big.compaction_style   = CompactionStyle::universal;
+
+        {
+            ModuleManagerCache disk;
+            disk.set_rocksdb_options(RocksDBOptions{});
+            disk.set_rocksdb_options("mod", big);
+            disk.change_save_location(cache_path.string());
+            auto pcache = disk.get_or_make_module_cache("mod");
+            auto pother = disk.get_or_make_module_cache("other");
+            pcache->cache(inputs, results);
+            pother->cache(inputs, results);
+            disk.backup();
+
+            disk.drop_module_cache("mod");
+            REQUIRE_FALSE(pcache->count(inputs));
+            REQUIRE(pother->count(inputs));
+
+            // The module cache is still usable
+            pcache->cache(inputs, results);
+            REQUIRE(pcache->count(inputs));
+            disk.drop_module_cache("mod");
+
+            // Modules without a cache are a no-op
+            disk.drop_module_cache("not a module");
+        }
+
+        {
+            ModuleManagerCache disk(cache_path);
+            REQUIRE_FALSE(disk.get_or_make_module_cache("mod")->count(inputs));
+            REQUIRE(disk.get_or_make_module_cache("other")->count(inputs));
+        }
+
+        ModuleManagerCache shared;
+        shared.open_read_only(cache_path.string());
+        REQUIRE_THROWS_AS(shared.drop_module_cache("other"),
+                          std::runtime_error);
+        memory_only.drop_module_cache("mod");
+        std::filesystem::remove_all(cache_path);
+    }
+
+    SECTION("checkpoint/restore") {
+        auto restart_path = root_dir / "mmcache_restart_test";
+        auto bundle_path  = root_dir / "mmcache_test.bundle";
+        for(const auto& p : {cache_path, restart_path, bundle_path})
+            if(std::filesystem::exists(p)) std::filesystem::remove_all(p);
+
+        using key_type    = ModuleCache::key_type;
+        using mapped_type = ModuleCache::mapped_type;
+        key_type inputs;
+        inputs["x"].set_type<int>().change(int{1});
+        mapped_type results;
+        results["y"].set_type<int>().change(int{2});
+        results["z"].set_type<std::string>().change(std::string("hello"));
+
+        // Results which can't be saved can't be restored
+        key_type inputs2;
+        inputs2["x"].set_type<int>().change(int{2});
+        mapped_type unsaveable;
+        unsaveable["y"].set_type<NotSerializable>().change(NotSerializable{3});
+
+        // Memory-only caches can't be checkpointed or restored
+        REQUIRE_THROWS_AS(memory_only.checkpoint(bundle_path.string()),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(memory_only.restore(bundle_path.string()),
+                          std::runtime_error);
+
+        {
+            ModuleManagerCache disk(cache_path);
+            auto pdisk = disk.get_or_make_module_cache("mod");
+            pdisk->cache(inputs, results);
+            pdisk->cache(inputs2, unsaveable);
+
+            // It's still cached, just in memory
+            auto y = pdisk->uncache(inputs2).at("y");
+            REQUIRE(y.value<const NotSerializable&>().value == 3);
+
+            SECTION("synchronous") { disk.checkpoint(bundle_path.string()); }
+            SECTION("asynchronous") {
+                auto done = disk.checkpoint_async(bundle_path.string());
+                done.get();
+            }
+        }
+        REQUIRE(std::filesystem::exists(bundle_path));
+
+        // Restarting somewhere else
+        ModuleManagerCache restart(restart_path);
+        auto pcache = restart.get_or_make_module_cache("mod");
+        REQUIRE_FALSE(pcache->count(inputs));
+        auto modules = restart.restore(bundle_path.string());
+        REQUIRE(modules == std::vector<std::string>{"mod"});
+        REQUIRE(pcache->count(inputs));
+        // The values themselves were restored, not just the keys
+        auto restored = pcache->uncache(inputs);
+        REQUIRE(restored.at("y").value<int>() == 2);
+        REQUIRE(restored.at("z").value<std::string>() == "hello");
+        REQUIRE_FALSE(pcache->count(inputs2));
+
+        // Bundles that aren't there can't be restored
+        auto not_a_bundle = (root_dir / "not_a_bundle").string();
+        REQUIRE_THROWS_AS(restart.restore(not_a_bundle), std::runtime_error);
+
+        for(const auto& p : {cache_path, restart_path, bundle_path})
+            std::filesystem::remove_all(p);
     }
 
     SECTION("get_or_make_module_cache") {
@@ -101,4 +578,24 @@ TEST_CASE("ModuleManagerCache") {
         auto pcache2 = memory_only.get_or_make_user_cache("hello");
         REQUIRE(pcache.get() == pcache2.get());
     }
+
+    SECTION("stats") {
+        // Nothing made yet
+        auto s = memory_only.stats();
+        REQUIRE(s.hits == 0);
+        REQUIRE(s.misses == 0);
+        REQUIRE(s.bytes_on_disk == 0);
+
+        // Aggregates over the module caches
+        using key_type = ModuleCache::key_type;
+        auto pcache0   = memory_only.get_or_make_module_cache("hello");
+        auto pcache1   = memory_only.get_or_make_module_cache("world");
+        pcache0->count(key_type{});
+        pcache1->count(key_type{});
+        pcache1->cache(key_type{}, ModuleCache::mapped_type{});
+        s = memory_only.stats();
+        REQUIRE(s.misses == 2);
+        REQUIRE(s.insertions == 1);
+        REQUIRE(s.entries == 1);
+    }
 }
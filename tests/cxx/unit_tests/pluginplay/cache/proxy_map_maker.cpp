@@ -61,7 +61,27 @@ TEMPLATE_LIST_TEST_CASE("ProxyMapMaker", "", testing::test_types) {
         REQUIRE(db.at(key1) == value1);
     }
 
-    SECTION("un_proxy") { REQUIRE(db.un_proxy(value0) == key0); }
+    SECTION("un_proxy") {
+        REQUIRE(db.un_proxy(value0) == key0);
+
+        // Wasn't made by db and there's no un-proxy function
+        value_type not_made{{"hello", uuid}};
+        REQUIRE_THROWS_AS(db.un_proxy(not_made), std::out_of_range);
+    }
+
+    SECTION("un_proxy with function") {
+        auto [p, pdb, uuid_db] = make_uuid_mapper<TestType>();
+        using uuid_mapper_type = decltype(uuid_db);
+        auto pmapper = std::make_unique<uuid_mapper_type>(std::move(uuid_db));
+
+        auto fxn = [=](const auto& u) {
+            REQUIRE(u == uuid);
+            return default_value;
+        };
+        db_type other(std::move(pmapper), fxn);
+        value_type not_made{{"hello", uuid}};
+        REQUIRE(other.un_proxy(not_made) == key_type{{"hello", default_value}});
+    }
 
     SECTION("free") {
         db.free(key0);
@@ -69,6 +89,31 @@ TEMPLATE_LIST_TEST_CASE("ProxyMapMaker", "", testing::test_types) {
         REQUIRE_FALSE(psub->count(default_value));
     }
 
+    SECTION("release") {
+        // No-op if references aren't counted
+        REQUIRE_FALSE(db.counts_references());
+        db.release(value0);
+        REQUIRE(psub->count(default_value));
+
+        using uuid_mapper_type = typename db_type::proxy_mapper;
+        using uuid_type        = typename uuid_mapper_type::mapped_type;
+        using id_function      = typename uuid_mapper_type::id_function;
+        using uuid_db_type     = Native<TestType, uuid_type>;
+        auto puuids            = std::make_unique<uuid_db_type>();
+        auto pdedup            = std::make_shared<DedupTable>();
+        db_type counted(std::make_unique<uuid_mapper_type>(
+          std::move(puuids), id_function{}, pdedup));
+        REQUIRE(counted.counts_references());
+
+        counted.insert(key0);
+        counted.insert(key0);
+        auto proxies = counted.at(key0);
+        counted.release(proxies);
+        REQUIRE(counted.count(key0));
+        counted.release(proxies);
+        REQUIRE_FALSE(counted.count(key0));
+    }
+
     SECTION("backup") {
         db.backup();
 
@@ -19,7 +19,9 @@
 #include "test_cache.hpp"
 #include <iostream>
 #include <pluginplay/any/any.hpp>
+#include <pluginplay/cache/database/make_any.hpp>
 #include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/intern_table.hpp>
 #include <pluginplay/cache/uuid_mapper.hpp>
 #include <pluginplay/types.hpp>
 
@@ -74,6 +76,42 @@ TEMPLATE_LIST_TEST_CASE("UUIDMapper", "", testing::test_types) {
         REQUIRE_FALSE(uuid_db.count(key1));
     }
 
+    SECTION("content ids and reference counting") {
+        auto [p, db2] = testing::make_nested_native<key_type, uuid_type>();
+        auto pdb2     = std::make_unique<decltype(db2)>(std::move(db2));
+        std::size_t n_ids = 0;
+        auto id           = [&n_ids](const key_type&) {
+            ++n_ids;
+            return typename uuid_db_type::content_id_type("content", 8);
+        };
+        auto pdedup = std::make_shared<DedupTable>();
+        uuid_db_type counted(std::move(pdb2), id, pdedup);
+        REQUIRE(counted.counts_references());
+        REQUIRE_FALSE(uuid_db.counts_references());
+
+        counted.insert(key1);
+        REQUIRE(counted.at(key1).get() == "content");
+        REQUIRE(counted.is_referenced("content"));
+
+        // Second reference reuses the object, without recomputing its id
+        counted.insert(key1);
+        REQUIRE(n_ids == 1);
+        REQUIRE(pdedup->count("content") == 2);
+        REQUIRE(pdedup->n_deduplicated() == 1);
+        REQUIRE(pdedup->bytes_saved() == 8);
+
+        // Freed with the last reference
+        counted.release(key1);
+        REQUIRE(counted.count(key1));
+        counted.release(key1);
+        REQUIRE_FALSE(counted.count(key1));
+        REQUIRE_FALSE(counted.is_referenced("content"));
+
+        // No-op if references aren't counted
+        uuid_db.release(key0);
+        REQUIRE(uuid_db.count(key0));
+    }
+
     SECTION("backup") {
         REQUIRE_FALSE(pinner->count(key0));
 
@@ -207,3 +245,55 @@ TEST_CASE("UUIDMapper<AnyField>") {
         }
     }
 }
+
+TEST_CASE("UUIDMapper<ModuleInput>") {
+    using input_type   = pluginplay::ModuleInput;
+    using any_type     = pluginplay::type::any;
+    using uuid_db_type = UUIDMapper<input_type>;
+    using uuid_type    = typename uuid_db_type::mapped_type;
+    using eraser_type  = TypeEraser<input_type, uuid_type>;
+
+    auto [p0, p1, sub] = testing::make_transposer<any_type, uuid_type>();
+    auto psub      = std::make_shared<decltype(sub)>(std::move(sub));
+    auto pinterns  = std::make_shared<InternTable>();
+    auto make_uuid = [](const input_type&) {
+        return typename uuid_db_type::content_id_type("content", 8);
+    };
+    uuid_db_type db(std::make_unique<eraser_type>(psub), make_uuid, nullptr,
+                    pinterns);
+
+    auto make_input = [](int x) {
+        input_type i;
+        i.set_type<int>();
+        i.change(x);
+        return i;
+    };
+    auto i0 = make_input(1);
+    auto i1 = make_input(1);
+    db.insert(i0);
+
+    SECTION("Equal inputs share an instance") {
+        REQUIRE(db.at(i0).get() == "content");
+        REQUIRE_FALSE(i1.shares_value(i0));
+        REQUIRE(db.at(i1).get() == "content");
+        REQUIRE(i1.shares_value(i0));
+        REQUIRE(pinterns->n_interned() == 1);
+
+        // Found without comparing values
+        REQUIRE(*pinterns->find(i1) == "content");
+        REQUIRE(db.count(i1));
+    }
+
+    SECTION("free") {
+        db.at(i0);
+        db.free(i1);
+        REQUIRE(pinterns->find(i0) == nullptr);
+        REQUIRE_FALSE(db.count(i0));
+    }
+
+    SECTION("dump") {
+        db.at(i0);
+        db.dump();
+        REQUIRE(pinterns->size() == 0);
+    }
+}
@@ -260,6 +260,72 @@ TEST_CASE("ModuleInputPIMPL") {
         }
     }
 
+    SECTION("Sharing values") {
+        ModuleInputPIMPL p, p2;
+        p.set_type(std::type_index(typeid(int)));
+        p2.set_type(std::type_index(typeid(int)));
+        REQUIRE_THROWS_AS(p.share_value(), std::runtime_error);
+        REQUIRE_THROWS_AS(p.mutable_value(), std::runtime_error);
+        p.set_value(any::make_any_field<int>(3));
+        p2.set_value(any::make_any_field<int>(3));
+
+        SECTION("Copies of unshared values are deep") {
+            ModuleInputPIMPL copy(p);
+            REQUIRE_FALSE(copy.shares_value(p));
+            REQUIRE(copy == p);
+        }
+
+        SECTION("Copies of shared values share them") {
+            auto shared = p.share_value();
+            REQUIRE(&p.value() == shared.get());
+            ModuleInputPIMPL copy(p);
+            REQUIRE(copy.shares_value(p));
+        }
+
+        SECTION("intern") {
+            REQUIRE_THROWS_AS(p2.intern(nullptr), std::runtime_error);
+            p2.intern(p.share_value());
+            REQUIRE(p2.shares_value(p));
+            REQUIRE(p2 == p);
+        }
+
+        SECTION("Shared values are copied before being modified") {
+            p2.intern(p.share_value());
+            auto& value = p2.mutable_value();
+            value       = any::make_any_field<int>(4);
+            REQUIRE_FALSE(p2.shares_value(p));
+            REQUIRE(p.value() == any::make_any_field<int>(3));
+            REQUIRE(p2.value() == any::make_any_field<int>(4));
+        }
+
+        SECTION("Setting a value stops sharing") {
+            p2.intern(p.share_value());
+            p2.set_value(any::make_any_field<int>(3));
+            REQUIRE_FALSE(p2.shares_value(p));
+        }
+    }
+
+    SECTION("content_hash") {
+        ModuleInputPIMPL p;
+        REQUIRE_FALSE(p.content_hash().has_value());
+        p.set_type(std::type_index(typeid(int)));
+        p.set_value(any::make_any_field<int>(3));
+        const auto hash = p.content_hash();
+        REQUIRE(hash == std::hash<int>{}(3));
+
+        SECTION("Copies keep the hash") {
+            ModuleInputPIMPL copy(p);
+            REQUIRE(copy.content_hash() == hash);
+        }
+
+        SECTION("Changing the value changes the hash") {
+            p.set_value(any::make_any_field<int>(4));
+            REQUIRE(p.content_hash() == std::hash<int>{}(4));
+            p.mutable_value() = any::make_any_field<int>(5);
+            REQUIRE(p.content_hash() == std::hash<int>{}(5));
+        }
+    }
+
     SECTION("description") {
         ModuleInputPIMPL p;
         SECTION("Throws if description is not set") {
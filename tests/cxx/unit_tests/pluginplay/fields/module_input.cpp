@@ -53,6 +53,41 @@ TEST_CASE("ModuleInput") {
         }
     }
 
+    SECTION("memory_footprint") {
+        ModuleInput i;
+        SECTION("No value") { REQUIRE(i.memory_footprint() == 0); }
+        SECTION("Has value") {
+            std::string s(100, 'a');
+            i.set_type<std::string>();
+            i.change(s);
+            REQUIRE(i.memory_footprint() == pluginplay::memory_footprint(s));
+            REQUIRE(i.memory_footprint() > sizeof(std::string));
+            REQUIRE(pluginplay_sizeof(i) == sizeof(i) + i.memory_footprint());
+        }
+    }
+
+    SECTION("content_hash") {
+        ModuleInput i;
+        SECTION("No value") { REQUIRE_FALSE(i.content_hash().has_value()); }
+        SECTION("Has value") {
+            // Large values are hashed lazily, that shouldn't be observable
+            std::vector<int> v(1000, 1);
+            i.set_type<std::vector<int>>();
+            i.change(v);
+            REQUIRE(i.content_hash() == pluginplay::content_hash(v));
+            ModuleInput copy(i);
+            REQUIRE(copy.content_hash() == i.content_hash());
+            i.change(std::vector<int>{1});
+            REQUIRE(i.content_hash() != copy.content_hash());
+        }
+        SECTION("By reference") {
+            std::vector<int> v{1, 2, 3};
+            i.set_type<const std::vector<int>&>();
+            i.change(v);
+            REQUIRE(i.content_hash() == pluginplay::content_hash(v));
+        }
+    }
+
     SECTION("has_description") {
         ModuleInput i;
         SECTION("No description") { REQUIRE_FALSE(i.has_description()); }
@@ -400,6 +435,35 @@ TEST_CASE("ModuleInput") {
             auto pcorr         = &i.value<const int&>();
             REQUIRE(pany == pcorr);
         }
+        SECTION("T == shared_any") {
+            i.set_type<int>();
+            i.change(int{3});
+            auto shared = i.value<ModuleInput::shared_any>();
+            REQUIRE(shared.get() == &i.value<const type::any&>());
+
+            // Copies now share the value, until it's modified
+            ModuleInput copy(i);
+            REQUIRE(copy.shares_value(i));
+            copy.value<int&>() = 4;
+            REQUIRE_FALSE(copy.shares_value(i));
+            REQUIRE(i.value<int>() == 3);
+        }
+    }
+
+    SECTION("intern") {
+        ModuleInput i, i2;
+        i.set_type<std::vector<int>>();
+        i2.set_type<std::vector<int>>();
+        REQUIRE_THROWS_AS(i2.intern(nullptr), std::runtime_error);
+        i.change(std::vector<int>{1, 2, 3});
+        i2.change(std::vector<int>{1, 2, 3});
+        REQUIRE_FALSE(i2.shares_value(i));
+
+        i2.intern(i.value<ModuleInput::shared_any>());
+        REQUIRE(i2.shares_value(i));
+        REQUIRE(i2 == i);
+        const auto& v = i.value<const std::vector<int>&>();
+        REQUIRE(&i2.value<const std::vector<int>&>() == &v);
     }
 
     SECTION("description") {
@@ -44,6 +44,23 @@ TEST_CASE("ModuleResult : has_value") {
     }
 }
 
+TEST_CASE("ModuleResult : memory_footprint") {
+    ModuleResult p;
+    SECTION("No value") { REQUIRE(p.memory_footprint() == 0); }
+    SECTION("Has a value") {
+        p.set_type<double>();
+        p.change(double{3.14});
+        REQUIRE(p.memory_footprint() == sizeof(double));
+    }
+    SECTION("Container") {
+        std::vector<double> v(10);
+        p.set_type<std::vector<double>>();
+        p.change(v);
+        REQUIRE(p.memory_footprint() == pluginplay::memory_footprint(v));
+        REQUIRE(pluginplay_sizeof(p) == sizeof(p) + p.memory_footprint());
+    }
+}
+
 TEST_CASE("ModuleResult : has_description") {
     ModuleResult p;
     SECTION("No description") { REQUIRE_FALSE(p.has_description()); }
@@ -107,6 +124,32 @@ TEST_CASE("ModuleResult : change") {
     }
 }
 
+TEST_CASE("ModuleResult : set_type_and_change") {
+    ModuleResult p;
+    const double v = 3.14;
+    auto any       = std::make_shared<const type::any>(
+      pluginplay::any::make_any_field<double>(v));
+    SECTION("Throws if value is null") {
+        using shared_any = typename ModuleResult::shared_any;
+        REQUIRE_THROWS_AS(p.set_type_and_change(shared_any{}),
+                          std::runtime_error);
+    }
+    SECTION("Sets the type if it is not set") {
+        p.set_type_and_change(any);
+        REQUIRE(p.type() == type::rtti(typeid(double)));
+        REQUIRE(p.value<double>() == v);
+    }
+    SECTION("Keeps the type if it is set") {
+        p.set_type<double>();
+        p.set_type_and_change(any);
+        REQUIRE(p.value<double>() == v);
+    }
+    SECTION("Throws if the value's type is wrong") {
+        p.set_type<int>();
+        REQUIRE_THROWS_AS(p.set_type_and_change(any), std::invalid_argument);
+    }
+}
+
 TEST_CASE("ModuleResult : set_description") {
     ModuleResult p;
     p.set_description("Hello world");
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include "pluginplay/module/detail_/memoization_advisor.hpp"
+
+using namespace pluginplay::detail_;
+
+using duration_type = typename MemoizationAdvisor::duration_type;
+
+TEST_CASE("MemoizationAdvisor") {
+    // alpha = 1 means averages are just the last sample
+    MemoizationAdvisor advisor(1.0, 2, 4);
+
+    SECTION("Defaults") {
+        MemoizationAdvisor defaulted;
+        REQUIRE_FALSE(defaulted.bypassing());
+        REQUIRE(defaulted.hit_rate() == 0.0);
+        REQUIRE(defaulted.n_probes() == 0);
+        REQUIRE(defaulted.use_cache());
+    }
+
+    SECTION("Moving averages") {
+        MemoizationAdvisor half(0.5);
+        half.record_lookup(true, duration_type(2.0));
+        REQUIRE(half.hit_rate() == 1.0);
+        REQUIRE(half.lookup_time() == 2.0);
+        half.record_lookup(false, duration_type(4.0));
+        REQUIRE(half.hit_rate() == 0.5);
+        REQUIRE(half.lookup_time() == 3.0);
+
+        half.record_compute(duration_type(1.0));
+        half.record_insert(duration_type(1.0));
+        REQUIRE(half.savings() == Catch::Approx(0.5));
+        REQUIRE(half.overhead() == Catch::Approx(3.5));
+    }
+
+    SECTION("Uses cache while warming up") {
+        advisor.record_lookup(false, duration_type(1.0));
+        advisor.record_compute(duration_type(0.0));
+        REQUIRE(advisor.use_cache());
+        REQUIRE_FALSE(advisor.bypassing());
+        REQUIRE(advisor.decision().find("warming up") != std::string::npos);
+    }
+
+    SECTION("Memoization pays off") {
+        for(int i = 0; i < 2; ++i) {
+            advisor.record_lookup(true, duration_type(0.001));
+            advisor.record_compute(duration_type(1.0));
+        }
+        REQUIRE(advisor.use_cache());
+        REQUIRE_FALSE(advisor.bypassing());
+        REQUIRE(advisor.decision().find("using cache") != std::string::npos);
+    }
+
+    SECTION("Memoization is a net loss") {
+        for(int i = 0; i < 2; ++i) {
+            advisor.record_lookup(false, duration_type(1.0));
+            advisor.record_insert(duration_type(1.0));
+            advisor.record_compute(duration_type(0.001));
+        }
+        // Bypasses three times, then probes
+        REQUIRE_FALSE(advisor.use_cache());
+        REQUIRE(advisor.bypassing());
+        REQUIRE_FALSE(advisor.use_cache());
+        REQUIRE_FALSE(advisor.use_cache());
+        REQUIRE(advisor.use_cache());
+        REQUIRE(advisor.n_probes() == 1);
+        REQUIRE(advisor.decision().find("bypassing") != std::string::npos);
+
+        // Probe finds memoization is worth it now
+        advisor.record_lookup(true, duration_type(0.001));
+        advisor.record_compute(duration_type(1.0));
+        REQUIRE(advisor.use_cache());
+        REQUIRE_FALSE(advisor.bypassing());
+    }
+}
@@ -374,6 +374,70 @@ TEST_CASE("ModulePIMPL") {
         corr[submod_key + ":" + submod_key] = submod_ptr->uuid();
 
         REQUIRE(submods.submod_uuids() == corr);
+
+        // Locked modules reuse the map
+        submods.lock();
+        REQUIRE(submods.submod_uuids() == corr);
+        REQUIRE(submods.submod_uuids() == corr);
+    }
+
+    SECTION("fingerprint") {
+        SECTION("No implementation") {
+            ModulePIMPL p, p2;
+            REQUIRE(p.fingerprint() == p2.fingerprint());
+        }
+        SECTION("Equal modules have equal fingerprints") {
+            auto mod  = make_module_pimpl<NotReadyModule>();
+            auto mod2 = make_module_pimpl<NotReadyModule>();
+            REQUIRE(mod.fingerprint() == mod2.fingerprint());
+            mod.inputs().at("Option 1").change(int{3});
+            mod2.inputs().at("Option 1").change(int{3});
+            REQUIRE(mod.fingerprint() == mod2.fingerprint());
+            // Lockedness doesn't matter
+            mod.lock();
+            REQUIRE(mod.fingerprint() == mod2.fingerprint());
+        }
+        SECTION("Changing an input changes the fingerprint") {
+            auto mod       = make_module_pimpl<NotReadyModule>();
+            const auto old = mod.fingerprint();
+            auto& input    = mod.inputs().at("Option 1");
+            input.change(int{3});
+            REQUIRE(mod.fingerprint() != old);
+        }
+        SECTION("Changing a submodule changes the fingerprint") {
+            auto mod    = make_module_pimpl<SubModModule>();
+            auto submod = make_module<NotReadyModule>();
+            mod.submods().at("Submodule 1").change(submod);
+            const auto old = mod.fingerprint();
+
+            // Changes to the submodule show up while mod is unlocked
+            submod->change_input("Option 1", int{3});
+            const auto changed = mod.fingerprint();
+            REQUIRE(changed != old);
+
+            mod.submods().at("Submodule 1").change(make_module<NullModule>());
+            REQUIRE(mod.fingerprint() != changed);
+        }
+        SECTION("Different implementations and property types") {
+            auto mod  = make_module_pimpl<NullModule>();
+            auto mod2 = make_module_pimpl<NullModule2>();
+            REQUIRE(mod.fingerprint() != mod2.fingerprint());
+
+            auto mod3 = make_module_pimpl<NullModule>();
+            mod3.property_types().insert(type::rtti{typeid(OneIn)});
+            REQUIRE(mod.fingerprint() != mod3.fingerprint());
+        }
+        SECTION("Cached while locked, recomputed once unlocked") {
+            auto mod = make_module_pimpl<NotReadyModule>();
+            mod.inputs().at("Option 1").change(int{3});
+            mod.lock();
+            const auto locked = mod.fingerprint();
+            REQUIRE(mod.fingerprint() == locked);
+
+            mod.unlock();
+            mod.inputs().at("Option 1").change(int{4});
+            REQUIRE(mod.fingerprint() != locked);
+        }
     }
 
     SECTION("is_cached") {
@@ -458,6 +522,37 @@ TEST_CASE("ModulePIMPL") {
         }
     }
 
+    SECTION("adaptive memoization") {
+        SECTION("Throws if no implementation") {
+            ModulePIMPL p;
+            using e = std::runtime_error;
+            REQUIRE_THROWS_AS(p.turn_on_adaptive_memoization(), e);
+            REQUIRE_THROWS_AS(p.turn_off_adaptive_memoization(), e);
+        }
+        SECTION("turn on/off") {
+            auto mod = make_module_pimpl_with_cache<ResultModule>();
+            REQUIRE_FALSE(mod.is_memoization_adaptive());
+            mod.turn_on_adaptive_memoization();
+            REQUIRE(mod.is_memoization_adaptive());
+            mod.turn_off_adaptive_memoization();
+            REQUIRE_FALSE(mod.is_memoization_adaptive());
+        }
+        SECTION("run") {
+            auto mod = make_module_pimpl_with_cache<ResultModule>();
+            mod.turn_on_adaptive_memoization();
+            for(int i = 0; i < 100; ++i) {
+                auto rv = mod.run(type::input_map{});
+                REQUIRE(rv.at("Result 1").value<int>() == 4);
+            }
+            auto info = mod.profile_info();
+            REQUIRE(info.find("Adaptive memoization") != std::string::npos);
+
+            mod.turn_off_adaptive_memoization();
+            info = mod.profile_info();
+            REQUIRE(info.find("Adaptive memoization") == std::string::npos);
+        }
+    }
+
     SECTION("run") {
         SECTION("Throws if no implementation") {
             ModulePIMPL p;
@@ -18,6 +18,7 @@
 #include "test_common.hpp"
 #include <pluginplay/module/module_class.hpp>
 #include <regex>
+#include <set>
 #ifdef BUILD_PYBIND11
 #include <pybind11/pybind11.h>
 #endif
@@ -528,6 +529,70 @@ struct NullModule2 : ModuleBase {
     }
 };
 
+// Has an input pluginplay_hash doesn't know how to hash
+struct UnhashableModule : ModuleBase {
+    UnhashableModule() : ModuleBase(this) {
+        satisfies_property_type<NullPT>();
+        add_input<std::set<int>>("Set");
+    }
+    pluginplay::type::result_map run_(
+      pluginplay::type::input_map,
+      pluginplay::type::submodule_map) const override {
+        return results();
+    }
+};
+
+TEST_CASE("Module : fingerprint") {
+    SECTION("No implementation") {
+        Module p, p2;
+        REQUIRE(p.fingerprint() == p2.fingerprint());
+    }
+    SECTION("Tracks change_input") {
+        auto mod  = make_module<NotReadyModule>();
+        auto mod2 = make_module<NotReadyModule>();
+        REQUIRE(mod->fingerprint() == mod2->fingerprint());
+        mod->change_input("Option 1", 3);
+        REQUIRE(mod->fingerprint() != mod2->fingerprint());
+        mod2->change_input("Option 1", 3);
+        REQUIRE(mod->fingerprint() == mod2->fingerprint());
+    }
+    SECTION("Tracks change_submod") {
+        auto mod  = make_module<SubModModule>();
+        auto mod2 = make_module<SubModModule>();
+        mod->change_submod("Submodule 1", make_module<NullModule>());
+        REQUIRE(mod->fingerprint() != mod2->fingerprint());
+        mod2->change_submod("Submodule 1", make_module<NullModule>());
+        REQUIRE(mod->fingerprint() == mod2->fingerprint());
+    }
+    SECTION("Unlocked copies can be changed") {
+        auto mod = make_module<NotReadyModule>();
+        mod->change_input("Option 1", 3);
+        mod->lock();
+        auto copy = mod->unlocked_copy();
+        REQUIRE(copy.fingerprint() == mod->fingerprint());
+        copy.change_input("Option 1", 4);
+        REQUIRE(copy.fingerprint() != mod->fingerprint());
+    }
+    SECTION("Unknown if an input can't be hashed") {
+        auto mod  = make_module<UnhashableModule>();
+        auto mod2 = make_module<UnhashableModule>();
+        REQUIRE(mod->fingerprint().has_value());
+        mod->change_input("Set", std::set<int>{1, 2});
+        REQUIRE_FALSE(mod->fingerprint().has_value());
+
+        // So modules are compared instead
+        mod2->change_input("Set", std::set<int>{1, 2});
+        REQUIRE(*mod == *mod2);
+        mod2->change_input("Set", std::set<int>{3});
+        REQUIRE(*mod != *mod2);
+
+        // Modules using it don't know their fingerprint either
+        auto parent = make_module<SubModModule>();
+        parent->change_submod("Submodule 1", mod);
+        REQUIRE_FALSE(parent->fingerprint().has_value());
+    }
+}
+
 TEST_CASE("Module : comparisons") {
     Module p;
     SECTION("Empty") {
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/utility/pluginplay_hash.hpp>
+#include <string>
+
+namespace testing {
+
+// A type std::hash doesn't know about
+struct Unhashable {
+    int x = 0;
+};
+
+// A type with a user-provided hash
+struct Hashable {
+    int x = 0;
+};
+
+inline pluginplay::content_hash_type pluginplay_hash(
+  const Hashable& h) noexcept {
+    return std::size_t(h.x);
+}
+
+} // namespace testing
+
+using pluginplay::content_hash;
+using namespace std::string_literals;
+
+TEST_CASE("content_hash") {
+    SECTION("std::hash-able types") {
+        REQUIRE(content_hash(int{3}) == std::hash<int>{}(3));
+        REQUIRE(content_hash(std::string("hello")) ==
+                std::hash<std::string>{}("hello"));
+    }
+
+    SECTION("Types which can't be hashed") {
+        REQUIRE_FALSE(content_hash(testing::Unhashable{}).has_value());
+    }
+
+    SECTION("std::vector") {
+        std::vector<double> v{1.0, 2.0};
+        REQUIRE(content_hash(v) == content_hash(std::vector<double>{1.0, 2.0}));
+        REQUIRE(content_hash(v) != content_hash(std::vector<double>{2.0, 1.0}));
+        REQUIRE(content_hash(v) != content_hash(std::vector<double>{1.0}));
+
+        std::vector<testing::Unhashable> vu(2);
+        REQUIRE_FALSE(content_hash(vu).has_value());
+    }
+
+    SECTION("std::pair") {
+        std::pair<int, std::string> p{1, "a"};
+        REQUIRE(content_hash(p) == content_hash(std::make_pair(1, "a"s)));
+        REQUIRE(content_hash(p) != content_hash(std::make_pair(2, "a"s)));
+
+        std::pair<int, testing::Unhashable> pu{1, {}};
+        REQUIRE_FALSE(content_hash(pu).has_value());
+    }
+
+    SECTION("std::map") {
+        std::map<std::string, int> m{{"a", 1}, {"b", 2}};
+        std::map<std::string, int> m2{{"b", 2}, {"a", 1}};
+        REQUIRE(content_hash(m) == content_hash(m2));
+        m2["c"] = 3;
+        REQUIRE(content_hash(m) != content_hash(m2));
+    }
+
+    SECTION("std::unordered_map") {
+        // Equal maps hash the same regardless of their iteration order
+        std::unordered_map<int, int> m, m2;
+        for(int i = 0; i < 100; ++i) m[i] = i;
+        for(int i = 99; i >= 0; --i) m2[i] = i;
+        m2.rehash(1024);
+        REQUIRE(content_hash(m) == content_hash(m2));
+        m2[0] = 1;
+        REQUIRE(content_hash(m) != content_hash(m2));
+    }
+
+    SECTION("User overload") {
+        REQUIRE(content_hash(testing::Hashable{3}) == std::size_t(3));
+
+        // Is found when nested in containers
+        std::vector<testing::Hashable> v{{1}, {2}};
+        REQUIRE(content_hash(v).has_value());
+    }
+}
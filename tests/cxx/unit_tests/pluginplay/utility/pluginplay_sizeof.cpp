@@ -0,0 +1,97 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/utility/pluginplay_sizeof.hpp>
+
+namespace testing {
+
+// A type which owns memory PluginPlay can't see
+struct Opaque {
+    std::size_t n_bytes = 0;
+};
+
+inline std::size_t pluginplay_sizeof(const Opaque& o) noexcept {
+    return sizeof(o) + o.n_bytes;
+}
+
+} // namespace testing
+
+using pluginplay::memory_footprint;
+
+TEST_CASE("memory_footprint") {
+    SECTION("Arithmetic types") {
+        REQUIRE(memory_footprint(int{3}) == sizeof(int));
+        REQUIRE(memory_footprint(double{3.14}) == sizeof(double));
+    }
+
+    SECTION("std::string") {
+        std::string empty;
+        REQUIRE(memory_footprint(empty) == sizeof(std::string));
+
+        std::string big(100, 'a');
+        REQUIRE(memory_footprint(big) >= sizeof(std::string) + 100);
+    }
+
+    SECTION("std::vector") {
+        std::vector<double> v(10);
+        const auto corr = sizeof(v) + v.capacity() * sizeof(double);
+        REQUIRE(memory_footprint(v) == corr);
+
+        std::vector<std::vector<double>> vv{v, v};
+        const auto corr2 = sizeof(vv) + vv.capacity() * sizeof(v) +
+                           2 * (corr - sizeof(v));
+        REQUIRE(memory_footprint(vv) == corr2);
+    }
+
+    SECTION("std::pair") {
+        std::vector<double> v(10);
+        std::pair<int, std::vector<double>> p{1, v};
+        const auto corr = sizeof(p) + memory_footprint(v) - sizeof(v);
+        REQUIRE(memory_footprint(p) == corr);
+    }
+
+    SECTION("std::map") {
+        std::map<int, double> m;
+        REQUIRE(memory_footprint(m) == sizeof(m));
+        m[1] = 1.0;
+        m[2] = 2.0;
+        REQUIRE(memory_footprint(m) > sizeof(m) + 2 * sizeof(double));
+
+        std::map<int, std::vector<double>> mv{{1, std::vector<double>(10)}};
+        std::map<int, std::vector<double>> me{{1, std::vector<double>{}}};
+        REQUIRE(memory_footprint(mv) ==
+                memory_footprint(me) + 10 * sizeof(double));
+    }
+
+    SECTION("std::unordered_map") {
+        std::unordered_map<int, double> m;
+        const auto empty = memory_footprint(m);
+        REQUIRE(empty >= sizeof(m));
+        m[1] = 1.0;
+        REQUIRE(memory_footprint(m) > empty);
+    }
+
+    SECTION("User overload") {
+        testing::Opaque o{100};
+        REQUIRE(memory_footprint(o) == sizeof(o) + 100);
+
+        // Is found when nested in containers
+        std::vector<testing::Opaque> v{o, o};
+        const auto corr = sizeof(v) + v.capacity() * sizeof(o) + 200;
+        REQUIRE(memory_footprint(v) == corr);
+    }
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2022 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/utility/uuid.hpp>
+
+using namespace pluginplay::utility;
+
+TEST_CASE("generate_uuid") {
+    auto u0 = generate_uuid();
+    REQUIRE(u0.size() == 36);
+    REQUIRE(u0 != generate_uuid());
+}
+
+TEST_CASE("content_uuid") {
+    auto u0 = content_uuid("Hello World");
+    REQUIRE(u0.size() == 36);
+    REQUIRE(u0 == content_uuid("Hello World"));
+    REQUIRE(u0 != content_uuid("Hello world"));
+    REQUIRE(content_uuid("") == content_uuid(std::string{}));
+}
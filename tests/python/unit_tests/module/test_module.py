@@ -132,6 +132,13 @@ class TestModule(unittest.TestCase):
         self.has_desc.turn_on_memoization()
         self.assertTrue(self.has_desc.is_memoizable())
 
+    def test_adaptive_memoization(self):
+        self.assertFalse(self.has_desc.is_memoization_adaptive())
+        self.has_desc.turn_on_adaptive_memoization()
+        self.assertTrue(self.has_desc.is_memoization_adaptive())
+        self.has_desc.turn_off_adaptive_memoization()
+        self.assertFalse(self.has_desc.is_memoization_adaptive())
+
     def test_lock(self):
         # See issue #301
         # self.assertRaises(Exception, self.defaulted.lock)